@@ -5,16 +5,19 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 #include <cctype>
 #include <cmath>
 #include <csetjmp>
+#include <cstdint>
 #include <ctime>
 
 extern "C" {
@@ -44,6 +47,7 @@ constexpr auto ERROR_FILE_EXISTS         = GP_ERROR_FILE_EXISTS;
 constexpr auto ERROR_FILE_NOT_FOUND      = GP_ERROR_FILE_NOT_FOUND;
 constexpr auto ERROR_MODEL_NOT_FOUND     = GP_ERROR_MODEL_NOT_FOUND;
 constexpr auto ERROR_NO_SPACE            = GP_ERROR_NO_SPACE;
+constexpr auto ERROR_NOT_SUPPORTED       = GP_ERROR_NOT_SUPPORTED;
 constexpr auto ERROR_OS_FAILURE          = GP_ERROR_OS_FAILURE;
 constexpr auto ERROR_PATH_NOT_ABSOLUTE   = GP_ERROR_PATH_NOT_ABSOLUTE;
 constexpr auto ERROR_UNKNOWN_PORT        = GP_ERROR_UNKNOWN_PORT;
@@ -285,15 +289,44 @@ using root_widget_ptr = widget_ptr;
 
 root_widget_ptr make_root_widget(GP2::CameraWidget * ptr);
 
+// Every widget in a camera's config tree, depth first, with each widget's name
+// and label mapped to its slot.  Built with one walk of the tree per
+// gp_camera_get_config(), so finding a property is a hash lookup instead of a
+// recursive search.  The slots are kept across refreshes as long as the tree's
+// layout doesn't change.
+struct widget_entry
+{
+    child_widget_ptr      widget {nullptr};
+    GP2::CameraWidgetType type {GP2::GP_WIDGET_WINDOW};
+};
+
+struct widget_index
+{
+    std::vector<widget_entry>                      widgets;
+    std::unordered_map<std::string, std::uint32_t> slots;
+    std::size_t                                    layout {0};
+};
+
 using camera_to_root     = std::map<camera_ptr, root_widget_ptr>;
-using property_map       = std::unordered_map<std::string, child_widget_ptr>;
-using camera_to_property = std::map<camera_ptr, property_map>;
+using camera_to_index    = std::map<camera_ptr, widget_index>;
 using choice_set         = CaseInsensitiveMap;
 using choice_map         = std::unordered_map<std::string, choice_set>;
 using camera_to_choice   = std::map<camera_ptr, choice_map>;
 using shutterspeed_map   = std::unordered_map<camera_ptr, ShutterSpeedCache>;
+using camera_set         = std::set<std::weak_ptr<GP2::Camera>, std::owner_less<>>;
 
 
+// Guards the structure of the per-camera cache maps below.  Each camera may be
+// driven from its own thread, so inserts and erases for one camera can race
+// with lookups for another.  Only held for the map access, never across USB.
+inline
+std::mutex &
+_cache_mutex()
+{
+    static std::mutex instance;
+    return instance;
+}
+
 // Maps: camera_ptr -> (Normalized String -> Raw Camera String)
 inline
 shutterspeed_map &
@@ -312,11 +345,11 @@ _get_camera_to_root()
 }
 
 inline
-camera_to_property &
-_get_camera_to_property()
+camera_to_index &
+_get_camera_to_index()
 {
-    static auto _camera_to_property = camera_to_property();
-    return _camera_to_property;
+    static auto _camera_to_index = camera_to_index();
+    return _camera_to_index;
 }
 
 inline
@@ -327,6 +360,17 @@ _get_camera_to_choice()
     return _camera_to_choice;
 }
 
+// Cameras whose driver doesn't implement gp_camera_get_single_config() and
+// gp_camera_set_single_config().  Outlives reset_cache() and doesn't keep the
+// cameras open.
+inline
+camera_set &
+_get_no_single_config()
+{
+    static auto _no_single_config = camera_set();
+    return _no_single_config;
+}
+
 inline
 bool
 _list_all_folders_recursively(
@@ -436,19 +480,20 @@ inline
 void
 reset_cache(const camera_ptr & camera)
 {
+    std::lock_guard<std::mutex> lock(_cache_mutex());
     auto & cam_to_root = _get_camera_to_root();
     const auto itor1 = cam_to_root.find(camera);
     if (itor1 != cam_to_root.end())
     {
-        // Cache hit!  Must free the root widgit and clear the property map.
+        // Cache hit!  Must free the root widgit and clear the widget index.
         cam_to_root.erase(itor1);
 
-        // Discard the property cache.
-        auto & cam_to_prop = _get_camera_to_property();
-        auto itor2 = cam_to_prop.find(camera);
-        if (itor2 != cam_to_prop.end())
+        // Discard the widget index.
+        auto & cam_to_index = _get_camera_to_index();
+        auto itor2 = cam_to_index.find(camera);
+        if (itor2 != cam_to_index.end())
         {
-            cam_to_prop.erase(itor2);
+            cam_to_index.erase(itor2);
         }
 
         // Discard the choice cache.
@@ -631,60 +676,103 @@ open_camera(const std::string & port)
 }
 
 
+// Appends the widgets under parent to the index, depth first, in the order
+// libgphoto2's gp_widget_get_child_by_name() searches them, and folds their
+// names and types into the index's layout.
 inline
-int
-_lookup_widget(
-    GP2::CameraWidget * widget,
-    const char * name,
-    GP2::CameraWidget ** result)
+void
+_index_widgets(GP2::CameraWidget * parent, widget_index & index)
 {
-    // From gphoto2/actions.c(1618) _find_widget_by_name().
-    //
-    int ret = GP2::gp_widget_get_child_by_name(widget, name, result);
-    if (ret == GP2::OK)
+    const int count = GP2::gp_widget_count_children(parent);
+    for (int i = 0; i < count; i++)
     {
-        // Found it, result should be the child widget.
-        return GP2::OK;
+        widget_entry entry;
+        if (GP2::gp_widget_get_child(parent, i, &entry.widget) < GP2::OK or
+            GP2::gp_widget_get_type(entry.widget, &entry.type) < GP2::OK)
+        {
+            continue;
+        }
+
+        const char * name {nullptr};
+        if (GP2::gp_widget_get_name(entry.widget, &name) < GP2::OK or name == nullptr)
+        {
+            name = "";
+        }
+
+        index.layout = index.layout * 31 + std::hash<std::string_view>{}(name);
+        index.layout = index.layout * 31 + entry.type;
+
+        index.widgets.push_back(entry);
+
+        _index_widgets(entry.widget, index);
     }
+}
 
-    ret = GP2::gp_widget_get_child_by_label(widget, name, result);
-    if (ret == GP2::OK)
+
+// Maps every name, then every label, to its widget's slot.  The first widget
+// wins, as with looking them up by name and then by label in the tree.
+inline
+void
+_index_slots(widget_index & index)
+{
+    index.slots.clear();
+    index.slots.reserve(index.widgets.size() * 2);
+
+    for (std::uint32_t slot = 0; slot < index.widgets.size(); ++slot)
     {
-        // Found it, result should be the child widget.
-        return GP2::OK;
+        const char * name {nullptr};
+        if (GP2::gp_widget_get_name(index.widgets[slot].widget, &name) == GP2::OK and name)
+        {
+            index.slots.emplace(name, slot);
+        }
     }
 
-    // Not found, iterate through all children to see if any are containers that
-    // we can search recursively.
-    int count = GP2::gp_widget_count_children(widget);
-    for (int i = 0; i < count; i++)
+    for (std::uint32_t slot = 0; slot < index.widgets.size(); ++slot)
     {
-        GP2::CameraWidget * child {nullptr};
-        ret = GP2::gp_widget_get_child(widget, i, &child);
-        if (ret < GP2::OK)
+        const char * label {nullptr};
+        if (GP2::gp_widget_get_label(index.widgets[slot].widget, &label) == GP2::OK and label)
         {
-            continue;
+            index.slots.emplace(label, slot);
         }
+    }
+}
 
-        // Get the type of the child widget.
-        GP2::CameraWidgetType type;
 
-        ret = GP2::gp_widget_get_type(child, &type);
-        if (ret < GP2::OK)
+// Finds the property's widget by name or label in the index read_config()
+// built, root keeps the widget alive.
+inline
+bool
+_find_widget(
+    const camera_ptr & camera,
+    const std::string & property,
+    root_widget_ptr & root,
+    widget_entry & entry)
+{
+    {
+        std::lock_guard<std::mutex> lock(_cache_mutex());
+        auto & cam_to_root = _get_camera_to_root();
+        auto itor1 = cam_to_root.find(camera);
+        if (itor1 != cam_to_root.end())
         {
-            continue;
+            root = itor1->second;
+            const auto & index = _get_camera_to_index()[camera];
+            auto itor2 = index.slots.find(property);
+            if (itor2 != index.slots.end())
+            {
+                entry = index.widgets[itor2->second];
+                return true;
+            }
         }
+    }
 
-        ret = _lookup_widget(child, name, result);
-        if (ret == GP2::OK)
-        {
-            // Found it, result should be the child widget.
-            return GP2::OK;
-        }
+    if (root == nullptr)
+    {
+        GPHOTO2CPP_ERROR_LOG << "must call read_config() first!" << std::endl;
+        return false;
     }
 
-    // We've finished searching, give up.
-    return GP2::ERROR_BAD_PARAMETERS;
+    GPHOTO2CPP_ERROR_LOG << "failed to look up widget '" << property << "', aborting" << std::endl;
+    return false;
 }
 
 
@@ -692,7 +780,14 @@ inline
 bool
 read_config(const camera_ptr & camera)
 {
-    reset_cache(camera);
+    widget_index index;
+    {
+        // The old tree goes, the index keeps its slots until it's rebuilt.
+        std::lock_guard<std::mutex> lock(_cache_mutex());
+        _get_camera_to_root().erase(camera);
+        _get_camera_to_choice().erase(camera);
+        index.widgets.reserve(_get_camera_to_index()[camera].widgets.size());
+    }
 
     // Read the full camera configuration.
     GP2::CameraWidget * raw_root {nullptr};
@@ -706,8 +801,23 @@ read_config(const camera_ptr & camera)
         false
     );
 
-    // Wrap in std::shared_ptr and store in the cache.
-    _get_camera_to_root()[camera] = make_root_widget(raw_root);
+    // Wrap in std::shared_ptr and index every widget once.
+    auto root = make_root_widget(raw_root);
+    _index_widgets(root.get(), index);
+
+    std::lock_guard<std::mutex> lock(_cache_mutex());
+    auto & cached = _get_camera_to_index()[camera];
+    if (index.layout == cached.layout and index.widgets.size() == cached.widgets.size())
+    {
+        // Same tree as last time, only the widgets are new.
+        cached.widgets.swap(index.widgets);
+    }
+    else
+    {
+        _index_slots(index);
+        cached = std::move(index);
+    }
+    _get_camera_to_root()[camera] = root;
 
     return true;
 }
@@ -715,43 +825,129 @@ read_config(const camera_ptr & camera)
 
 inline
 bool
-read_property(
-    const camera_ptr & camera,
-    const std::string & property,
-    std::string & output)
+_copy_widget_value(GP2::CameraWidget * from, GP2::CameraWidget * to)
 {
-    auto & cam_to_root = _get_camera_to_root();
-    auto itor1 = cam_to_root.find(camera);
-    if (itor1 == cam_to_root.end())
+    GP2::CameraWidgetType widget_type;
+    GPHOTO2CPP_SAFE_CALL(
+        gp_widget_get_type(from, &widget_type),
+        false
+    );
+
+    switch(widget_type)
     {
-        GPHOTO2CPP_ERROR_LOG << "must call read_config() first!" << std::endl;
-        return false;
+        case GP2::GP_WIDGET_MENU:  // fall through
+        case GP2::GP_WIDGET_TEXT:  // fall through
+        case GP2::GP_WIDGET_RADIO:
+        {
+            char * value {nullptr};
+            GPHOTO2CPP_SAFE_CALL(GP2::gp_widget_get_value(from, &value), false);
+            GPHOTO2CPP_SAFE_CALL(GP2::gp_widget_set_value(to, value), false);
+            break;
+        }
+        case GP2::GP_WIDGET_DATE: // fall through
+        case GP2::GP_WIDGET_TOGGLE:
+        {
+            int value {0};
+            GPHOTO2CPP_SAFE_CALL(GP2::gp_widget_get_value(from, &value), false);
+            GPHOTO2CPP_SAFE_CALL(GP2::gp_widget_set_value(to, &value), false);
+            break;
+        }
+        case GP2::GP_WIDGET_RANGE:
+        {
+            float value {0};
+            GPHOTO2CPP_SAFE_CALL(GP2::gp_widget_get_value(from, &value), false);
+            GPHOTO2CPP_SAFE_CALL(GP2::gp_widget_set_value(to, &value), false);
+            break;
+        }
+        default:
+        {
+            return false;
+        }
+    }
+
+    // It's what the camera has, nothing to write back.
+    GPHOTO2CPP_SAFE_CALL(GP2::gp_widget_set_changed(to, 0), false);
+
+    return true;
+}
+
+
+// Refreshes only the named properties with one gp_camera_get_single_config()
+// each, instead of fetching the whole widget tree, read_property() then sees
+// their new values.  Falls back to read_config(camera) before the first full
+// read and for drivers without single config support.
+inline
+bool
+read_config(const camera_ptr & camera, const std::vector<std::string> & properties)
+{
+    bool full {false};
+    {
+        std::lock_guard<std::mutex> lock(_cache_mutex());
+        full = not _get_camera_to_root().contains(camera) or
+               _get_no_single_config().contains(camera);
     }
-    auto & root = itor1->second;
-    auto & cam_to_prop = _get_camera_to_property()[camera];
-    auto itor2 = cam_to_prop.find(property);
-    if (itor2 == cam_to_prop.end())
+    if (full)
     {
-        // Cache miss, fetch the child widget from libgphoto2.
-        child_widget_ptr child {nullptr};
+        return read_config(camera);
+    }
 
-        if (GP2::OK != _lookup_widget(root.get(), property.c_str(), &child))
+    for (const auto & property : properties)
+    {
+        root_widget_ptr root;
+        widget_entry entry;
+        if (not _find_widget(camera, property, root, entry))
         {
-            GPHOTO2CPP_ERROR_LOG << "Failed to look up widget '" << property << "', aborting" << std::endl;
             return false;
         }
-        cam_to_prop[property] = child;
+
+        GP2::CameraWidget * raw {nullptr};
+        const auto ret = GP2::gp_camera_get_single_config(
+            camera.get(),
+            property.c_str(),
+            &raw,
+            get_context().get()
+        );
+
+        if (ret == GP2::ERROR_NOT_SUPPORTED)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_cache_mutex());
+                _get_no_single_config().insert(camera);
+            }
+            return read_config(camera);
+        }
+
+        GPHOTO2CPP_SAFE_CALL(ret, false);
+
+        const auto fresh = make_root_widget(raw);
+        if (not _copy_widget_value(fresh.get(), entry.widget))
+        {
+            GPHOTO2CPP_ERROR_LOG << "failed to refresh '" << property << "', aborting" << std::endl;
+            return false;
+        }
     }
 
-    auto child = cam_to_prop[property];
+    return true;
+}
 
-    GP2::CameraWidgetType widget_type;
-    GPHOTO2CPP_SAFE_CALL(
-        gp_widget_get_type(child, &widget_type),
-        false
-    );
 
-    switch(widget_type)
+inline
+bool
+read_property(
+    const camera_ptr & camera,
+    const std::string & property,
+    std::string & output)
+{
+    root_widget_ptr root;
+    widget_entry entry;
+    if (not _find_widget(camera, property, root, entry))
+    {
+        return false;
+    }
+
+    auto child = entry.widget;
+
+    switch(entry.type)
     {
         // char * types.
         case GP2::GP_WIDGET_MENU:  // fall through
@@ -812,7 +1008,7 @@ read_property(
 
         default:
         {
-            GPHOTO2CPP_ERROR_LOG << "widget has bad type " << widget_type << "\n";
+            GPHOTO2CPP_ERROR_LOG << "widget has bad type " << entry.type << "\n";
             return false;
         }
     }
@@ -971,22 +1167,18 @@ _read_choices_from_gp2(const camera_ptr & camera, const std::string & property,
     }
 
     // Grab the child pointer in order to iterate over choices for the property.
-
-    auto & prop_to_child = _get_camera_to_property()[camera];
-    auto & child = prop_to_child[property];
-
-    // Grab the widget type.
-    GP2::CameraWidgetType widget_type;
-    if (GP2::OK != gp_widget_get_type(child, &widget_type))
+    root_widget_ptr root;
+    widget_entry entry;
+    if (not _find_widget(camera, property, root, entry))
     {
-        GPHOTO2CPP_ERROR_LOG
-            << "gp_widget_get_type(\"" << property << "\") failed"
-            << std::endl;
+        return;
     }
 
+    auto child = entry.widget;
+
     // Iterate over the choices and insert into the CaseInsensitiveMap and
     // output vector.
-    switch(widget_type)
+    switch(entry.type)
     {
         case GP2::GP_WIDGET_MENU: // Fall through.
         case GP2::GP_WIDGET_RADIO:
@@ -1032,19 +1224,24 @@ _read_shutterspeed_choices(const camera_ptr & camera, std::vector<std::string> &
 {
     out.clear();
 
-    auto & speed_cam_to_cache = _get_shutterspeed_reverse_map();
-    auto itor = speed_cam_to_cache.find(camera);
-
-    // First time for this camera_ptr.
-    if (itor == speed_cam_to_cache.end())
+    ShutterSpeedCache * cache_ptr {nullptr};
     {
-        speed_cam_to_cache[camera] = ShutterSpeedCache {};
-        itor = speed_cam_to_cache.find(camera);
+        std::lock_guard<std::mutex> lock(_cache_mutex());
+        auto & speed_cam_to_cache = _get_shutterspeed_reverse_map();
+        auto itor = speed_cam_to_cache.find(camera);
+
+        // First time for this camera_ptr.
+        if (itor == speed_cam_to_cache.end())
+        {
+            speed_cam_to_cache[camera] = ShutterSpeedCache {};
+            itor = speed_cam_to_cache.find(camera);
+        }
+        cache_ptr = &itor->second;
     }
 
     // norm_to_raw_map now is a reference for mapping the normailzied to raw
     // shutterspeed strings.
-    auto & shutterspeed_cache = itor->second;
+    auto & shutterspeed_cache = *cache_ptr;
 
     // Cache hit!
     if (not shutterspeed_cache.empty())
@@ -1083,18 +1280,23 @@ _read_choices(const camera_ptr & camera, const std::string & property, std::vect
     // choice_map        maps    property_str -> choice_set
     // choice_set        maps    lower_case   -> ProperCase string
 
-    auto & cam_to_choices = _get_camera_to_choice();
-    auto itor1 = cam_to_choices.find(camera);
-
-    // First time for this camera_ptr.
-    if (itor1 == cam_to_choices.end())
+    choice_map * ch_map_ptr {nullptr};
     {
-        cam_to_choices[camera] = choice_map {};
-        itor1 = cam_to_choices.find(camera);
+        std::lock_guard<std::mutex> lock(_cache_mutex());
+        auto & cam_to_choices = _get_camera_to_choice();
+        auto itor1 = cam_to_choices.find(camera);
+
+        // First time for this camera_ptr.
+        if (itor1 == cam_to_choices.end())
+        {
+            cam_to_choices[camera] = choice_map {};
+            itor1 = cam_to_choices.find(camera);
+        }
+        ch_map_ptr = &itor1->second;
     }
 
-    // itor1->second is now the cohice_map.
-    auto & ch_map = itor1->second;
+    // ch_map_ptr now points at the cohice_map.
+    auto & ch_map = *ch_map_ptr;
     auto itor2 = ch_map.find(property);
 
     // First time reading this property of the camera.
@@ -1140,37 +1342,15 @@ inline
 bool
 write_property(camera_ptr & camera, const std::string & property, const std::string & value)
 {
-    auto & cam_to_root = _get_camera_to_root();
-    auto itor1 = cam_to_root.find(camera);
-    if (itor1 == cam_to_root.end())
+    root_widget_ptr root;
+    widget_entry entry;
+    if (not _find_widget(camera, property, root, entry))
     {
-        GPHOTO2CPP_ERROR_LOG << "must call read_config() first!" << std::endl;
         return false;
     }
 
-    auto & root = itor1->second;
-    auto & cam_to_prop = _get_camera_to_property()[camera];
-    auto itor2 = cam_to_prop.find(property);
-    if (itor2 == cam_to_prop.end())
-    {
-        // Cache miss, fetch the child widget from libgphoto2.
-        child_widget_ptr child {nullptr};
-
-        if (GP2::OK != _lookup_widget(root.get(), property.c_str(), &child))
-        {
-            GPHOTO2CPP_ERROR_LOG << "failed to look up widget '" << property << "', aborting" << std::endl;
-            return false;
-        };
-        cam_to_prop[property] = child;
-    }
-
-    auto child = cam_to_prop[property];
-
-    GP2::CameraWidgetType widget_type;
-    GPHOTO2CPP_SAFE_CALL(
-        gp_widget_get_type(child, &widget_type),
-        false
-    );
+    auto child = entry.widget;
+    const auto widget_type = entry.type;
 
     // Before writing a new value, clear the changed flag so we only read a
     // changed status if the value we wrote changes the child.
@@ -1415,7 +1595,11 @@ inline
 bool
 write_config(camera_ptr & camera)
 {
-    auto root = _get_camera_to_root()[camera];
+    root_widget_ptr root;
+    {
+        std::lock_guard<std::mutex> lock(_cache_mutex());
+        root = _get_camera_to_root()[camera];
+    }
 
     // Quick return if noting to write.
     if (not GP2::gp_widget_changed(root.get()))
@@ -1442,6 +1626,129 @@ write_config(camera_ptr & camera)
 }
 
 
+// gp_widget_changed() only reads the flag, once written the widgets and the
+// root are marked unchanged again so the next write skips them.
+inline
+bool
+_clear_changed(
+    const root_widget_ptr & root,
+    const std::vector<std::pair<const std::string *, child_widget_ptr>> & written)
+{
+    for (const auto & [property, child] : written)
+    {
+        GPHOTO2CPP_SAFE_CALL(
+            GP2::gp_widget_set_changed(child, 0),
+            false
+        );
+    }
+
+    GPHOTO2CPP_SAFE_CALL(
+        GP2::gp_widget_set_changed(root.get(), 0),
+        false
+    );
+
+    return true;
+}
+
+
+// Only sends the named properties' widgets that changed since the last write,
+// one gp_camera_set_single_config() each.  Drivers without single config
+// support get the whole tree, as write_config(camera) does.
+inline
+bool
+write_config(camera_ptr & camera, const std::vector<std::string> & properties)
+{
+    root_widget_ptr root;
+    std::vector<std::pair<const std::string *, child_widget_ptr>> changed;
+    changed.reserve(properties.size());
+    bool single {true};
+    {
+        std::lock_guard<std::mutex> lock(_cache_mutex());
+        auto & cam_to_root = _get_camera_to_root();
+        auto itor = cam_to_root.find(camera);
+        if (itor == cam_to_root.end())
+        {
+            GPHOTO2CPP_ERROR_LOG << "must call read_config() first!" << std::endl;
+            return false;
+        }
+        root = itor->second;
+        single = not _get_no_single_config().contains(camera);
+
+        const auto & index = _get_camera_to_index()[camera];
+        for (const auto & property : properties)
+        {
+            auto slot = index.slots.find(property);
+            if (slot != index.slots.end())
+            {
+                changed.emplace_back(&property, index.widgets[slot->second].widget);
+            }
+        }
+    }
+
+    // Quick return if noting to write.
+    if (not GP2::gp_widget_changed(root.get()))
+    {
+        return true;
+    }
+
+    // The root is marked by any change, named or not, only send the named
+    // properties whose widgets were actually set since the last write.
+    std::erase_if(
+        changed,
+        [](const auto & pair) { return not GP2::gp_widget_changed(pair.second); }
+    );
+
+    if (single)
+    {
+        for (const auto & [property, child] : changed)
+        {
+            const auto ret = GP2::gp_camera_set_single_config(
+                camera.get(),
+                property->c_str(),
+                child,
+                get_context().get()
+            );
+
+            if (ret == GP2::ERROR_NOT_SUPPORTED)
+            {
+                single = false;
+                break;
+            }
+
+            GPHOTO2CPP_SAFE_CALL(ret, false);
+        }
+
+        if (single)
+        {
+            return _clear_changed(root, changed);
+        }
+
+        std::lock_guard<std::mutex> lock(_cache_mutex());
+        _get_no_single_config().insert(camera);
+    }
+
+    // The driver only sends the widgets marked changed.
+    for (const auto & [property, child] : changed)
+    {
+        GPHOTO2CPP_SAFE_CALL(
+            GP2::gp_widget_set_changed(child, 1),
+            false
+        );
+    }
+
+    GPHOTO2CPP_SAFE_CALL(
+        GP2::gp_camera_set_config(
+            camera.get(),
+            root.get(),
+            get_context().get()
+        ),
+        false
+    );
+
+    return _clear_changed(root, changed);
+}
+
+
 inline
 bool
 trigger(const camera_ptr & camera)
@@ -1,4 +1,5 @@
 #include <camera_control/Camera.h>
+#include <camera_control/CameraWorker.h>
 #include <camera_control/Event.h>
 
 #include <common/io.h>
@@ -10,33 +11,67 @@
 namespace pycontrol
 {
 
+const Symbol Camera::NOT_AVAILABLE = intern("N/A");
+
+
 Camera::
 Camera(
     interface::GPhoto2Cpp & gp2cpp,
+    interface::WallClock & clock,
     gphoto2cpp::camera_ptr & camera,
     const std::string & port,
     const std::string & serial,
-    const std::string & config_file)
+    const std::string & config_file,
+    const camera_profile_map * profiles)
 :
     _gp2cpp(gp2cpp),
+    _clock(clock),
     _camera{camera},
     _info{.connected = true, .serial = serial, .port = port}
 {
-    // Expensive read, reads all the camera's configuration.
-    _gp2cpp.read_config(_camera);
-
+    // The caller has just read the camera's whole config to find its serial
+    // number, the properties below come from that.
     std::string make;
     std::string model;
 
     _gp2cpp.read_property(_camera, "manufacturer", make);
     _gp2cpp.read_property(_camera, "cameramodel", model);
     _info.desc = make + " " + model;
+    _model = _info.desc;
 
-    _query_props();
+    _connect(profiles);
 }
 
 Camera::~Camera(){}
 
+
+void
+Camera::
+_connect(const camera_profile_map * profiles)
+{
+    std::string firmware;
+    if (not _gp2cpp.read_property(_camera, "deviceversion", firmware) or firmware.empty())
+    {
+        firmware = "N/A";
+    }
+    _firmware = firmware;
+
+    if (profiles)
+    {
+        const auto itor = profiles->find(profile_key());
+        if (itor != profiles->end())
+        {
+            _use_profile(itor->second);
+            return;
+        }
+    }
+
+    // Another body or firmware, its choices may differ.
+    _choices.clear();
+    _query_props();
+}
+
+
 void
 Camera::_query_props()
 {
@@ -48,6 +83,8 @@ Camera::_query_props()
     _have_num_avail = _gp2cpp.read_property(_camera, "availableshots", value);
     _have_shooting_speed = _gp2cpp.read_property(_camera, "shootingspeed", value);
 
+    _set_status_properties();
+
     std::cout
         << "    availableshots: " << _have_num_avail << "\n"
         << "       burstnumber: " << _have_burst_number << "\n"
@@ -58,12 +95,63 @@ Camera::_query_props()
 
 
 void
-Camera::reconnect(gphoto2cpp::camera_ptr & camera, const std::string & port)
+Camera::
+_use_profile(const CameraProfile & profile)
 {
-    _camera = camera;
-    _info.port = port;
+    INFO_LOG << "using the profile for " << _model << " " << _firmware << std::endl;
+
+    _have_burst_number = profile.have.contains("burstnumber");
+    _have_capture_mode = profile.have.contains("capturemode");
+    _have_capturetarget = profile.have.contains("capturetarget");
+    _have_num_avail = profile.have.contains("availableshots");
+    _have_shooting_speed = profile.have.contains("shootingspeed");
+
+    _set_status_properties();
+
+    _choices = profile.choices;
+}
+
+
+void
+Camera::
+_set_status_properties()
+{
+    _status_properties = {
+        "batterylevel",
+        "shutterspeed",
+        "expprogram",
+        "f-number",
+        "iso",
+        "imagequality",
+    };
+    if (_have_num_avail) _status_properties.emplace_back("availableshots");
+    if (_have_burst_number) _status_properties.emplace_back("burstnumber");
+    if (_have_capture_mode) _status_properties.emplace_back("capturemode");
+    if (_have_shooting_speed) _status_properties.emplace_back("shootingspeed");
+    if (_have_capturetarget) _status_properties.emplace_back("capturetarget");
+}
+
+
+
+void
+Camera::
+reconnect(const Camera & opened)
+{
+    // The worker reads the handle and the status properties.
+    std::lock_guard<std::mutex> lock(_usb_mutex);
+    _camera = opened._camera;
+    _info.port = opened._info.port;
     _info.connected = true;
-    _query_props();
+    _model = opened._model;
+    _firmware = opened._firmware;
+
+    _have_num_avail = opened._have_num_avail;
+    _have_burst_number = opened._have_burst_number;
+    _have_capture_mode = opened._have_capture_mode;
+    _have_shooting_speed = opened._have_shooting_speed;
+    _have_capturetarget = opened._have_capturetarget;
+    _status_properties = opened._status_properties;
+    _choices = opened._choices;
 }
 
 
@@ -83,11 +171,91 @@ std::vector<std::string>
 Camera::
 read_choices(const std::string & property) const
 {
+    const auto itor = _choices.find(property);
+    if (itor != _choices.end())
+    {
+        return itor->second;
+    }
+
+    // The worker may be in the middle of a job, the USB is left to it.
+    if (_worker)
+    {
+        return {};
+    }
+
+    std::lock_guard<std::mutex> lock(_usb_mutex);
     std::vector<std::string> out;
     for (auto & choice : _gp2cpp.read_choices(_camera, property))
     {
         out.emplace_back(choice);
     }
+    if (not out.empty())
+    {
+        _choices[property] = out;
+    }
+    return out;
+}
+
+
+result
+Camera::
+request_choices(const std::string & property)
+{
+    if (_choices.contains(property))
+    {
+        return result::success;
+    }
+
+    // Taken back by _apply(), straight away without a worker.
+    ++_choices_pending;
+
+    CameraJob job {.type = CameraJob::Type::read_choices, .property = property};
+    if (result::failure == _submit(std::move(job)))
+    {
+        // Only a full worker queue fails.
+        --_choices_pending;
+        return result::failure;
+    }
+
+    return result::success;
+}
+
+
+CameraProfile
+Camera::
+profile() const
+{
+    CameraProfile out {.model = _model, .firmware = _firmware};
+
+    str_vec properties = {"expprogram", "f-number", "imagequality", "iso", "shutterspeed"};
+
+    if (_have_burst_number) out.have.insert("burstnumber");
+    if (_have_num_avail) out.have.insert("availableshots");
+    if (_have_capture_mode)
+    {
+        out.have.insert("capturemode");
+        properties.emplace_back("capturemode");
+    }
+    if (_have_capturetarget)
+    {
+        out.have.insert("capturetarget");
+        properties.emplace_back("capturetarget");
+    }
+    if (_have_shooting_speed)
+    {
+        out.have.insert("shootingspeed");
+        properties.emplace_back("shootingspeed");
+    }
+
+    for (const auto & property : properties)
+    {
+        auto choices = read_choices(property);
+        if (not choices.empty())
+        {
+            out.choices[property] = std::move(choices);
+        }
+    }
+
     return out;
 }
 
@@ -101,31 +269,31 @@ write_property(const std::string & property, const std::string & value)
     }
     else if (property == "capturemode")
     {
-        set_capture_mode(value);
+        set_capture_mode(intern(value));
     }
     else if (property == "expprogram")
     {
-        set_mode(value);
+        set_mode(intern(value));
     }
     else if (property == "f-number")
     {
-        set_fstop(value);
+        set_fstop(intern(value));
     }
     else if (property == "iso")
     {
-        set_iso(value);
+        set_iso(intern(value));
     }
     else if (property == "imagequality")
     {
-        set_quality(value);
+        set_quality(intern(value));
     }
     else if (property == "shootingspeed")
     {
-        set_shooting_speed(value);
+        set_shooting_speed(intern(value));
     }
     else if (property == "shutterspeed")
     {
-        set_shutter(value);
+        set_shutter(intern(value));
     }
     else
     {
@@ -135,48 +303,413 @@ write_property(const std::string & property, const std::string & value)
     return result::success;
 }
 
+
+void
+Camera::
+start_worker()
+{
+    if (_worker) return;
+
+    _worker = std::make_unique<CameraWorker>(
+        "cam " + _info.serial,
+        [this](CameraJob & job) { _run(job); }
+    );
+}
+
+
 result
 Camera::read_config()
 {
     if (not _info.connected) return result::success;
 
-    // Big, expesive camera state fetch.
-    if (not _gp2cpp.read_config(_camera))
+    return _submit(
+        CameraJob{
+            .type = CameraJob::Type::read_config,
+            .info = _info,
+            .version = _settings_version
+        }
+    );
+}
+
+
+result
+Camera::read_status()
+{
+    if (not _info.connected) return result::success;
+
+    return _submit(
+        CameraJob{
+            .type = CameraJob::Type::read_status,
+            .info = _info,
+            .version = _settings_version
+        }
+    );
+}
+
+
+result
+Camera::write_config()
+{
+    if (_info.dirty == 0) return result::success;
+
+    return _submit_dirty(CameraJob{.type = CameraJob::Type::write_config, .info = _info});
+}
+
+
+result
+Camera::trigger()
+{
+    return _submit(CameraJob{.type = CameraJob::Type::trigger});
+}
+
+
+result
+Camera::trigger(nanoseconds deadline_ns, const std::shared_ptr<TriggerGate> & gate)
+{
+    const auto lead_ns = deadline_ns > 0 ? _latency.lead_ns() : 0;
+
+    // Inline the job would wait on a gate that isn't closed yet.
+    if (not _worker or not gate)
     {
-        disconnect();
+        return _submit(
+            CameraJob{
+                .type = CameraJob::Type::trigger,
+                .deadline_ns = deadline_ns - lead_ns,
+                .lead_ns = lead_ns
+            }
+        );
+    }
+
+    ABORT_ON_FAILURE(
+        _submit(
+            CameraJob{
+                .type = CameraJob::Type::trigger,
+                .gate = gate,
+                .deadline_ns = deadline_ns - lead_ns,
+                .lead_ns = lead_ns
+            }
+        ),
+        "failed to queue trigger",
+        result::failure
+    );
+
+    // Joining after the post is fine, the worker can't pass the gate until the
+    // control thread closes it.
+    gate->join();
+
+    return result::success;
+}
+
+
+result
+Camera::calibrate_trigger(std::uint32_t shots)
+{
+    ABORT_IF(_calibrating > 0, "already calibrating", result::failure);
+
+    _latency.reset();
+
+    // Counted up front, without a worker each shot is applied as it's
+    // submitted.
+    _calibrating = shots;
+
+    for (std::uint32_t i = 0; i < shots; ++i)
+    {
+        if (result::failure == _submit(CameraJob{.type = CameraJob::Type::trigger, .calibrate = true}))
+        {
+            // The shots that never ran won't be applied.
+            _calibrating -= shots - i - (_worker ? 0 : 1);
+
+            ERROR_LOG << "camera " << _info.serial << ": calibration shot "
+                      << i + 1 << " of " << shots << " failed" << std::endl;
+            return result::failure;
+        }
+    }
+
+    return result::success;
+}
+
+
+result
+Camera::capture_histogram()
+{
+    return _submit_dirty(CameraJob{.type = CameraJob::Type::capture_histogram, .info = _info});
+}
+
+
+result
+Camera::
+_submit_dirty(CameraJob && job)
+{
+    const auto dirty = job.info.dirty;
+    _info.dirty = 0;
+
+    if (result::failure == _submit(std::move(job)))
+    {
+        _info.dirty |= dirty;
+        return result::failure;
+    }
+
+    return result::success;
+}
+
+
+result
+Camera::
+_submit(CameraJob && job)
+{
+    if (_worker)
+    {
+        ABORT_ON_FAILURE(
+            _worker->post(std::move(job)),
+            "camera " << _info.serial << " has too many USB jobs pending",
+            result::failure
+        );
+        ++_num_pending;
+        return result::success;
+    }
+
+    // No worker, run the job here and now.
+    _run(job);
+    _apply(job);
+
+    return job.res;
+}
+
+
+void
+Camera::
+collect()
+{
+    if (not _worker) return;
+
+    CameraJob job;
+    while (_worker->poll(job))
+    {
+        --_num_pending;
+
+        if (job.res == result::failure)
+        {
+            ERROR_LOG << "camera " << _info.serial << ": "
+                      << to_string(job.type) << " failed" << std::endl;
+        }
+
+        _apply(job);
+    }
+}
+
+
+void
+Camera::
+_apply(CameraJob & job)
+{
+    _info.num_photos += job.photos_added;
+
+    switch (job.type)
+    {
+        case CameraJob::Type::read_config:  // Fall through.
+        case CameraJob::Type::read_status:
+        {
+            _poll_usb.add(job.usb_ns);
+            _poll_usb_total_ns += job.usb_ns;
+            if (job.type == CameraJob::Type::read_config)
+            {
+                ++_full_reads;
+            }
+
+            if (job.disconnected)
+            {
+                disconnect();
+                break;
+            }
+            _info.battery_level  = job.info.battery_level;
+            _info.num_avail      = job.info.num_avail;
+
+            // A setting changed locally after this read was queued, keep the
+            // local settings, they are on their way to the camera.
+            if (job.version != _settings_version or _info.dirty != 0)
+            {
+                break;
+            }
+
+            _info.shutter        = job.info.shutter;
+            _info.mode           = job.info.mode;
+            _info.fstop          = job.info.fstop;
+            _info.iso            = job.info.iso;
+            _info.quality        = job.info.quality;
+            _info.burst_number   = job.info.burst_number;
+            _info.capture_mode   = job.info.capture_mode;
+            _info.shooting_speed = job.info.shooting_speed;
+            _info.capture_target = job.info.capture_target;
+            break;
+        }
+        case CameraJob::Type::read_choices:
+        {
+            --_choices_pending;
+            if (not job.choices.empty())
+            {
+                _choices[job.property] = std::move(job.choices);
+            }
+            break;
+        }
+        case CameraJob::Type::capture_histogram:
+        {
+            if (job.res == result::success)
+            {
+                _hist.swap(job.hist);
+                ++_num_histograms;
+            }
+            else
+            {
+                _info.dirty |= job.info.dirty;
+            }
+            break;
+        }
+        case CameraJob::Type::trigger:
+        {
+            _fire_ns = job.fire_ns + job.lead_ns;
+            _trigger_gate = std::move(job.gate);
+            if (job.deadline_ns > 0)
+            {
+                _trigger_lateness.add(job.fire_ns - job.deadline_ns);
+            }
+            if (job.res == result::success)
+            {
+                _latency.add(job.return_ns - job.fire_ns);
+            }
+            if (job.file_added_ns > 0)
+            {
+                _latency.file_added_ns = job.file_added_ns - job.fire_ns;
+            }
+            if (job.calibrate and _calibrating > 0)
+            {
+                --_calibrating;
+            }
+            break;
+        }
+        case CameraJob::Type::write_config:
+        {
+            // Try again on the next flush.
+            if (job.res == result::failure)
+            {
+                _info.dirty |= job.info.dirty;
+            }
+            break;
+        }
+        case CameraJob::Type::none:
+        {
+            break;
+        }
+    }
+}
+
+
+void
+Camera::
+_run(CameraJob & job)
+{
+    std::lock_guard<std::mutex> lock(_usb_mutex);
+
+    switch (job.type)
+    {
+        case CameraJob::Type::read_config:  // Fall through.
+        case CameraJob::Type::read_status:
+        {
+            const auto start_ns = _clock.monotonic_ns();
+            job.res = _usb_read_config(job);
+            job.usb_ns = _clock.monotonic_ns() - start_ns;
+            break;
+        }
+        case CameraJob::Type::write_config:
+        {
+            job.res = _usb_write_config(job);
+            break;
+        }
+        case CameraJob::Type::trigger:
+        {
+            job.res = _usb_trigger(job);
+            break;
+        }
+        case CameraJob::Type::capture_histogram:
+        {
+            job.res = _usb_capture_histogram(job);
+            break;
+        }
+        case CameraJob::Type::read_choices:
+        {
+            for (auto & choice : _gp2cpp.read_choices(_camera, job.property))
+            {
+                job.choices.emplace_back(std::move(choice));
+            }
+            job.res = result::success;
+            break;
+        }
+        case CameraJob::Type::none:
+        {
+            job.res = result::success;
+            break;
+        }
+    }
+}
+
+
+result
+Camera::
+_usb_read_config(CameraJob & job)
+{
+    auto & info = job.info;
+
+    // Big, expesive camera state fetch, otherwise only the widgets read below.
+    const bool ok = job.type == CameraJob::Type::read_config ?
+                    _gp2cpp.read_config(_camera) :
+                    _gp2cpp.read_config(_camera, _status_properties);
+    if (not ok)
+    {
+        job.disconnected = true;
         return result::success;
     }
 
     // Battery can be read event if camera isn't turned on.
     ABORT_IF_NOT(
-        _gp2cpp.read_property(_camera, "batterylevel", _info.battery_level),
+        _gp2cpp.read_property(_camera, "batterylevel", info.battery_level),
         "reasing batterylevel failed",
         result::failure
     );
 
-    if (not _gp2cpp.read_property(_camera, "shutterspeed", _info.shutter))
+    // Settings are read as text and interned.
+    std::string text;
+    const auto read_setting = [&](const char * property, Symbol & out)
+    {
+        if (not _gp2cpp.read_property(_camera, property, text))
+        {
+            return false;
+        }
+        out = intern(text);
+        return true;
+    };
+
+    if (not read_setting("shutterspeed", info.shutter))
     {
-        disconnect();
+        job.disconnected = true;
         return result::success;
     }
 
     ABORT_IF_NOT(
-        _gp2cpp.read_property(_camera, "expprogram", _info.mode),
+        read_setting("expprogram", info.mode),
         "reading mode failed",
         result::failure
     );
     ABORT_IF_NOT(
-        _gp2cpp.read_property(_camera, "f-number", _info.fstop),
+        read_setting("f-number", info.fstop),
         "reading fstop failed",
         result::failure
     );
     ABORT_IF_NOT(
-        _gp2cpp.read_property(_camera, "iso", _info.iso),
+        read_setting("iso", info.iso),
         "reading iso failed",
         result::failure
     );
     ABORT_IF_NOT(
-        _gp2cpp.read_property(_camera, "imagequality", _info.quality),
+        read_setting("imagequality", info.quality),
         "reading quality failed",
         result::failure
     );
@@ -190,7 +723,7 @@ Camera::read_config()
             result::failure
         );
         ABORT_ON_FAILURE(
-            as_type<int>(num_avail, _info.num_avail),
+            as_type<int>(num_avail, info.num_avail),
             "failure",
             result::failure
         );
@@ -205,7 +738,7 @@ Camera::read_config()
             result::failure
         );
         ABORT_ON_FAILURE(
-            as_type<int>(burst_number, _info.burst_number),
+            as_type<int>(burst_number, info.burst_number),
             "failure",
             result::failure
         );
@@ -214,7 +747,7 @@ Camera::read_config()
     if (_have_capture_mode)
     {
         ABORT_IF_NOT(
-            _gp2cpp.read_property(_camera, "capturemode", _info.capture_mode),
+            read_setting("capturemode", info.capture_mode),
             "reading capturemode failed",
             result::failure
         );
@@ -223,7 +756,7 @@ Camera::read_config()
     if (_have_shooting_speed)
     {
         ABORT_IF_NOT(
-            _gp2cpp.read_property(_camera, "shootingspeed", _info.shooting_speed),
+            read_setting("shootingspeed", info.shooting_speed),
             "reading shootingspeed failed",
             result::failure
         );
@@ -232,14 +765,14 @@ Camera::read_config()
     if (_have_capturetarget)
     {
         ABORT_IF_NOT(
-            _gp2cpp.read_property(_camera, "capturetarget", _info.capture_target),
+            read_setting("capturetarget", info.capture_target),
             "reading capturetarget failed",
             result::failure
         );
     }
 
     ABORT_ON_FAILURE(
-        drain_events(),
+        _usb_drain_events(job),
         "failure",
         result::failure
     );
@@ -249,7 +782,8 @@ Camera::read_config()
 
 
 result
-Camera::drain_events()
+Camera::
+_usb_drain_events(CameraJob & job)
 {
     // Drain the camera event queue, in order to count photos taken.
     bool have_events = true;
@@ -268,7 +802,7 @@ Camera::drain_events()
         {
             case GP2::GP_EVENT_FILE_ADDED:
             {
-                ++_info.num_photos;
+                ++job.photos_added;
                 break;
             }
             case GP2::GP_EVENT_TIMEOUT:
@@ -287,117 +821,148 @@ Camera::drain_events()
     return result::success;
 }
 
+
 result
-Camera::write_config()
+Camera::
+_usb_write_config(CameraJob & job)
 {
-    ABORT_IF_NOT(
-        _gp2cpp.write_property(_camera, "shutterspeed", _info.shutter),
-        "failed to write 'shutterspeed': " << _info.shutter,
-        result::failure
-    );
-    ABORT_IF_NOT(
-        _gp2cpp.write_property(_camera, "expprogram", _info.mode),
-        "failed to write 'expprogram': " << _info.mode,
-        result::failure
-    );
-    ABORT_IF_NOT(
-        _gp2cpp.write_property(_camera, "f-number", _info.fstop),
-        "failed to write 'f-number': " << _info.fstop,
-        result::failure
-    );
-    ABORT_IF_NOT(
-        _gp2cpp.write_property(_camera, "iso", _info.iso),
-        "failed to write 'iso': " << _info.iso,
-        result::failure
-    );
-    ABORT_IF_NOT(
-        _gp2cpp.write_property(_camera, "imagequality", _info.quality),
-        "failed to write 'imagequality': " << _info.quality,
-        result::failure
-    );
-    if (_have_burst_number)
+    const auto & info = job.info;
+
+    // Settings are only turned back into text here, on their way to the
+    // camera.
+    const auto burst_number = info.dirty & dirty_burst_number ?
+                              std::to_string(info.burst_number) :
+                              std::string();
+
+    struct Setting
     {
+        Dirty               bit;
+        const char *        property;
+        const std::string & value;
+        bool                have;
+    };
+
+    const Setting settings[] = {
+        {dirty_shutter,        "shutterspeed",  to_string(info.shutter),         true},
+        {dirty_mode,           "expprogram",    to_string(info.mode),            true},
+        {dirty_fstop,          "f-number",      to_string(info.fstop),           true},
+        {dirty_iso,            "iso",           to_string(info.iso),             true},
+        {dirty_quality,        "imagequality",  to_string(info.quality),         true},
+        {dirty_burst_number,   "burstnumber",   burst_number,                    _have_burst_number},
+        {dirty_capture_target, "capturetarget", to_string(info.capture_target),  _have_capturetarget},
+    };
+
+    std::vector<std::string> properties;
+    for (const auto & setting : settings)
+    {
+        if (not (info.dirty & setting.bit) or not setting.have)
+        {
+            continue;
+        }
         ABORT_IF_NOT(
-            _gp2cpp.write_property(_camera, "burstnumber", std::to_string(_info.burst_number)),
-            "failed to write 'burstnumber': " << _info.burst_number,
+            _gp2cpp.write_property(_camera, setting.property, setting.value),
+            "failed to write '" << setting.property << "': " << setting.value,
             result::failure
         );
+        properties.emplace_back(setting.property);
     }
-    if (_have_capturetarget)
+
+    if (properties.empty())
     {
-        ABORT_IF_NOT(
-            _gp2cpp.write_property(_camera, "capturetarget", _info.capture_target),
-            "failed to write 'capturetarget': " << _info.capture_target,
-            result::failure
-        );
+        return result::success;
     }
+
     ABORT_IF_NOT(
-        _gp2cpp.write_config(_camera),
+        _gp2cpp.write_config(_camera, properties),
         "failed to flush settings",
         result::failure
     );
 
-    ABORT_ON_FAILURE(drain_events(), "failure", result::failure);
+    ABORT_ON_FAILURE(_usb_drain_events(job), "failure", result::failure);
 
     return result::success;
 }
 
 
 void
-Camera::set_shutter(const std::string & speed)
+Camera::set_shutter(Symbol speed)
 {
+    if (speed != _info.shutter) _info.dirty |= dirty_shutter;
     _info.shutter = speed;
+    ++_settings_version;
 }
 
 
 void
-Camera::set_mode(const std::string & mode)
+Camera::set_mode(Symbol mode)
 {
+    if (mode != _info.mode) _info.dirty |= dirty_mode;
     _info.mode = mode;
+    ++_settings_version;
 }
 
 
 void
-Camera::set_fstop(const std::string & fstop)
+Camera::set_fstop(Symbol fstop)
 {
+    if (fstop != _info.fstop) _info.dirty |= dirty_fstop;
     _info.fstop = fstop;
+    ++_settings_version;
 }
 
 
 void
-Camera::set_iso(const std::string & iso)
+Camera::set_iso(Symbol iso)
 {
+    if (iso != _info.iso) _info.dirty |= dirty_iso;
     _info.iso = iso;
+    ++_settings_version;
 }
 
 void
-Camera::set_quality(const std::string & quality)
+Camera::set_quality(Symbol quality)
 {
+    if (quality != _info.quality) _info.dirty |= dirty_quality;
     _info.quality = quality;
+    ++_settings_version;
 }
 
 void
 Camera::set_burst_number(const std::string & burst_number)
 {
-    as_type<int>(burst_number, _info.burst_number);
+    int value = _info.burst_number;
+    as_type<int>(burst_number, value);
+    set_burst_number(value);
 }
 
 void
-Camera::set_capture_mode(const std::string & capture_mode)
+Camera::set_burst_number(int burst_number)
+{
+    if (burst_number != _info.burst_number) _info.dirty |= dirty_burst_number;
+    _info.burst_number = burst_number;
+    ++_settings_version;
+}
+
+void
+Camera::set_capture_mode(Symbol capture_mode)
 {
     _info.capture_mode = capture_mode;
+    ++_settings_version;
 }
 
 void
-Camera::set_capture_target(const std::string & capture_target)
+Camera::set_capture_target(Symbol capture_target)
 {
+    if (capture_target != _info.capture_target) _info.dirty |= dirty_capture_target;
     _info.capture_target = capture_target;
+    ++_settings_version;
 }
 
 void
-Camera::set_shooting_speed(const std::string & shooting_speed)
+Camera::set_shooting_speed(Symbol shooting_speed)
 {
     _info.shooting_speed = shooting_speed;
+    ++_settings_version;
 }
 
 result
@@ -407,17 +972,17 @@ Camera::handle(const Event & event)
     {
         case Channel::burst_number:
         {
-            set_burst_number(event.channel_value);
+            set_burst_number(event.value.num);
             break;
         }
         case Channel::capture_mode:
         {
-            set_capture_mode(event.channel_value);
+            set_capture_mode(event.value.text);
             break;
         }
         case Channel::capture_target:
         {
-            set_capture_target(event.channel_value);
+            set_capture_target(event.value.text);
             break;
         }
         case Channel::fps:
@@ -427,32 +992,40 @@ Camera::handle(const Event & event)
         }
         case Channel::fstop:
         {
-            set_fstop(event.channel_value);
+            set_fstop(event.value.text);
             break;
         }
         case Channel::iso:
         {
-            set_iso(event.channel_value);
+            set_iso(event.value.text);
+            break;
+        }
+        case Channel::late_policy:
+        {
+            _late_policy.set(
+                static_cast<LatePolicy::Mode>(event.value.num),
+                event.value.den
+            );
             break;
         }
         case Channel::mode:
         {
-            set_mode(event.channel_value);
+            set_mode(event.value.text);
             break;
         }
         case Channel::quality:
         {
-            set_quality(event.channel_value);
+            set_quality(event.value.text);
             break;
         }
         case Channel::shooting_speed:
         {
-            set_shooting_speed(event.channel_value);
+            set_shooting_speed(event.value.text);
             break;
         }
         case Channel::shutter_speed:
         {
-            set_shutter(event.channel_value);
+            set_shutter(event.value.text);
             break;
         }
         case Channel::trigger:
@@ -470,42 +1043,100 @@ Camera::handle(const Event & event)
     return result::success;
 }
 
+
 result
-Camera::trigger()
+Camera::
+_usb_trigger(CameraJob & job)
 {
+    if (job.gate and not job.gate->arrive_and_wait())
+    {
+        ERROR_LOG << "timed out waiting for the other cameras, firing anyway"
+                  << std::endl;
+    }
+
+    if (job.deadline_ns > 0)
+    {
+        _clock.sleep_until_ns(job.deadline_ns);
+    }
+
+    job.fire_ns = _clock.monotonic_ns();
+
+    if (job.gate)
+    {
+        job.gate->fired(job.fire_ns + job.lead_ns);
+    }
+
     ABORT_IF_NOT(
         _gp2cpp.trigger(_camera),
         "failed to trigger camera",
         result::failure
     );
 
-    return result::success;
-}
+    job.return_ns = _clock.monotonic_ns();
+
+    if (not job.calibrate)
+    {
+        return result::success;
+    }
 
+    // Time the file showing up, this also keeps calibration shots from
+    // overlapping.
+    constexpr int file_added_timeout_ms = 3000;
 
-struct ScopedSettings
-{
-    explicit ScopedSettings(Camera::Info & info) : _read_write(info), _saved(info) {}
-    ~ScopedSettings() {_read_write = _saved;}
-private:
-    Camera::Info &     _read_write;
-    const Camera::Info _saved;
-};
+    const auto give_up_ns = job.return_ns + file_added_timeout_ms * 1'000'000LL;
+
+    while (true)
+    {
+        const auto now_ns = _clock.monotonic_ns();
+        if (now_ns >= give_up_ns)
+        {
+            ERROR_LOG << "calibration shot, no file added after "
+                      << file_added_timeout_ms << " ms" << std::endl;
+            break;
+        }
+
+        gphoto2cpp::Event event;
+        const int timeout_ms = static_cast<int>((give_up_ns - now_ns) / 1'000'000) + 1;
+
+        ABORT_IF_NOT(
+            _gp2cpp.wait_for_event(_camera, timeout_ms, event),
+            "failure",
+            result::failure
+        );
+
+        if (event.type == GP2::GP_EVENT_FILE_ADDED)
+        {
+            job.file_added_ns = _clock.monotonic_ns();
+            ++job.photos_added;
+            break;
+        }
+        if (event.type == GP2::GP_EVENT_TIMEOUT)
+        {
+            ERROR_LOG << "calibration shot, no file added after "
+                      << file_added_timeout_ms << " ms" << std::endl;
+            break;
+        }
+    }
+
+    return result::success;
+}
 
 
 result
-Camera::capture_histogram()
+Camera::
+_usb_capture_histogram(CameraJob & job)
 {
     INFO_LOG << "Starting capture" << std::endl;
 
-    auto before = ScopedSettings(_info);
+    // The job carries its own copy of the settings, so the camera's current
+    // settings are left as they were once the capture completes.
 
     // Set camera quality to JPEG.
     //set_quality("JPEG Basic");
     //set_capture_target("sdram");
 
     ABORT_ON_FAILURE(
-        write_config(),
+        _usb_write_config(job),
         "failure",
         result::failure
     );
@@ -555,14 +1186,15 @@ Camera::capture_histogram()
     INFO_LOG << "Computing histogram" << std::endl;
 
     // Reset with zeros.
-    _hist.assign(256, 0);
+    auto & hist = job.hist;
+    hist.assign(256, 0);
 
     // Black and white capture?
     if (num_channels == 1)
     {
         for (const auto pix : _pixels)
         {
-            ++_hist[pix];
+            ++hist[pix];
         }
     }
 
@@ -593,17 +1225,18 @@ Camera::capture_histogram()
             std::uint32_t b = _pixels[i + 2];
             std::uint32_t luminance = (13933 * r + 46871 * g + 4732 * b) >> 16;
 
-            ++_hist[luminance];
+            ++hist[luminance];
         }
     }
 
     return result::success;
 }
 
+
 float
 Camera::shutter_speed(const std::string & value) const
 {
-    const auto ss = value.empty() ? _info.shutter : value;
+    const auto & ss = value.empty() ? to_string(_info.shutter) : value;
 
     if (ss.empty() or ss == "bulb" or ss == "time" or ss == "x 200")
     {
@@ -645,7 +1278,7 @@ Camera::shutter_speed(const std::string & value) const
 unsigned int
 Camera::iso(const std::string & value) const
 {
-    const auto iso_ = value.empty() ? _info.iso : value;
+    const auto & iso_ = value.empty() ? to_string(_info.iso) : value;
 
     std::stringstream ss;
     ss << iso_;
@@ -679,11 +1312,11 @@ Camera::_step_camera_property(const std::string & property, int step)
 
     if (property == "shutterspeed2")
     {
-        tmp = _info.shutter;
+        tmp = to_string(_info.shutter);
     }
     else if (property == "iso")
     {
-        tmp = _info.iso;
+        tmp = to_string(_info.iso);
     }
     else
     {
@@ -723,11 +1356,11 @@ Camera::_step_camera_property(const std::string & property, int step)
 
     if (property == "shutterspeed" or property == "shutterspeed2")
     {
-        set_shutter(all_choices[new_index]);
+        set_shutter(intern(all_choices[new_index]));
     }
     else if (property == "iso")
     {
-        set_iso(all_choices[new_index]);
+        set_iso(intern(all_choices[new_index]));
     }
 }
 
@@ -1,16 +1,29 @@
 #pragma once
 
+#include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 
+#include <common/LatencyStats.h>
+#include <common/Symbol.h>
 #include <common/types.h>
 
 #include <interface/GPhoto2Cpp.h>
+#include <interface/WallClock.h>
+
+#include <camera_control/CameraProfile.h>
+#include <camera_control/LatePolicy.h>
+#include <camera_control/TriggerLatency.h>
 
 namespace pycontrol
 {
 
-class Event;
+struct Event;
+class CameraWorker;
+class TriggerGate;
+struct CameraJob;
 
 using hist_vec = std::vector<std::uint64_t>;
 using pixel_vec = std::vector<std::uint8_t>;
@@ -20,66 +33,169 @@ class Camera
 {
 public:
 
+    // "N/A", a setting not read yet.
+    static const Symbol NOT_AVAILABLE;
+
+    // The settings are kept as the choice's text interned, so a sequence
+    // event sets one without copying a string, the text is only looked up
+    // when the camera worker writes it.
     struct Info
     {
         bool        connected      {false};
         std::string serial         {"N/A"};
         std::string port           {"N/A"};
         std::string desc           {"N/A"};
-        std::string mode           {"N/A"};
-        std::string shutter        {"N/A"};
-        std::string fstop          {"N/A"};
-        std::string iso            {"N/A"};
-        std::string quality        {"N/A"};
+        Symbol      mode           {NOT_AVAILABLE};
+        Symbol      shutter        {NOT_AVAILABLE};
+        Symbol      fstop          {NOT_AVAILABLE};
+        Symbol      iso            {NOT_AVAILABLE};
+        Symbol      quality        {NOT_AVAILABLE};
         std::string battery_level  {"N/A"};
-        std::string capture_mode   {"N/A"};
-        std::string shooting_speed {"N/A"};
-        std::string capture_target {"N/A"};
+        Symbol      capture_mode   {NOT_AVAILABLE};
+        Symbol      shooting_speed {NOT_AVAILABLE};
+        Symbol      capture_target {NOT_AVAILABLE};
 
         int num_avail             {0};
         int num_photos            {0};
         int burst_number          {0};
+
+        // The settings changed since the last write_config(), see Dirty.
+        std::uint32_t dirty       {0};
     };
 
+    // Settings write_config() sends to the camera.
+    enum Dirty : std::uint32_t
+    {
+        dirty_shutter        = 1u << 0,
+        dirty_mode           = 1u << 1,
+        dirty_fstop          = 1u << 2,
+        dirty_iso            = 1u << 3,
+        dirty_quality        = 1u << 4,
+        dirty_burst_number   = 1u << 5,
+        dirty_capture_target = 1u << 6,
+    };
+
+    // The camera's config must already be read, see GPhoto2Cpp::read_config().
     Camera(
         interface::GPhoto2Cpp & gp2cpp,
+        interface::WallClock & clock,
         gphoto2cpp::camera_ptr & camera,
         const std::string & port,
         const std::string & serial,
-        const std::string & config_file
+        const std::string & config_file,
+        const camera_profile_map * profiles = nullptr
     );
     ~Camera();
 
     const Info & info() { return _info; }
 
-    void reconnect(gphoto2cpp::camera_ptr & camera, const std::string & port);
+    // Takes the handle, port and probed properties of the same camera opened
+    // again, see CameraOpener.  No USB I/O, call it once the worker is idle.
+    void reconnect(const Camera & opened);
     void disconnect();
 
     result handle(const Event & event);
 
+    // Cached after the first read of each property, or taken from the profile.
+    // With a worker the control thread never reads them from the camera, a
+    // property not cached yet is empty until request_choices() is collected.
     std::vector<std::string>
     read_choices(const std::string & property) const;
+
+    // Reads property's choices into the cache, queued to the worker if there
+    // is one.  choices_pending() counts the reads not collected yet.
+    result request_choices(const std::string & property);
+    std::size_t choices_pending() const { return _choices_pending; }
+
+    // The camera's model and firmware, what its CameraProfile is kept under.
+    std::string profile_key() const { return CameraProfile::profile_key(_model, _firmware); }
+
+    // Everything a CameraProfile records about the camera, reads the choices
+    // not read yet.
+    CameraProfile profile() const;
+
     result write_property(
         const std::string & property,
         const std::string & value);
 
+    // USB operations.  Without a worker these block until the camera
+    // responds.  After start_worker() they are queued to the camera's worker
+    // thread, return as soon as the job is queued and their outcome is applied
+    // by collect().
     result read_config();
+
+    // Only refreshes the settings and status shown in telemetry, one widget at
+    // a time rather than the whole config tree.
+    result read_status();
+
+    // Only writes the settings that changed since the last call, nothing at
+    // all if none did.
     result write_config();
     result trigger();
-    result drain_events();
+
+    // Exposes at the monotonic deadline rather than as soon as possible, and
+    // together with every other camera joined to gate.  The trigger is sent
+    // the learned trigger latency ahead of the deadline.  Without a worker the
+    // gate is ignored and the calling thread sleeps until the deadline.
+    result trigger(
+        nanoseconds deadline_ns,
+        const std::shared_ptr<TriggerGate> & gate = nullptr);
+
+    // Fires shots triggers back to back, restarting the trigger latency model
+    // from their timings.
+    result calibrate_trigger(std::uint32_t shots);
+
+    // Calibration shots still to complete.
+    std::uint32_t calibrating() const { return _calibrating; }
+
+    const TriggerLatency & trigger_latency() const { return _latency; }
+    void set_trigger_latency(const TriggerLatency & latency) { _latency = latency; }
+
+    // Estimated monotonic time of the last exposure and the gate it went
+    // through, if any.
+    nanoseconds fire_ns() const { return _fire_ns; }
+    const std::shared_ptr<TriggerGate> & trigger_gate() const { return _trigger_gate; }
+
+    // How late triggers with a deadline fired, in nanoseconds.
+    const LatencyStats & trigger_lateness() const { return _trigger_lateness; }
+
+    // USB time spent by each read_config() and read_status(), in nanoseconds,
+    // their total and how many were full config reads.
+    const LatencyStats & poll_usb() const { return _poll_usb; }
+    nanoseconds poll_usb_total_ns() const { return _poll_usb_total_ns; }
+    std::uint64_t full_reads() const { return _full_reads; }
+
+    // What the control loop does with this camera's late triggers, set from
+    // the config and by the sequence's late_policy events.
+    LatePolicy & late_policy() { return _late_policy; }
+    const LatePolicy & late_policy() const { return _late_policy; }
 
     result capture_histogram();
     const hist_vec & histogram() const { return _hist; }
 
+    // Increments each time a new histogram is available.
+    std::uint32_t num_histograms() const { return _num_histograms; }
+
+    // Moves all USB I/O for this camera onto its own thread.
+    void start_worker();
+
+    // Applies finished worker jobs to info(), call once per control tick.
+    void collect();
+
+    // Number of USB jobs queued or running on the worker.
+    std::size_t pending() const { return _num_pending; }
+    bool busy() const { return _num_pending > 0; }
+
     void set_burst_number(const std::string & burst_number);
-    void set_capture_mode(const std::string & capture_mode);
-    void set_capture_target(const std::string & capture_target);
-    void set_fstop(const std::string & fstop);
-    void set_iso(const std::string & iso);
-    void set_mode(const std::string & mode);
-    void set_quality(const std::string & quality);
-    void set_shooting_speed(const std::string & shooting_speed);
-    void set_shutter(const std::string & speed);
+    void set_burst_number(int burst_number);
+    void set_capture_mode(Symbol capture_mode);
+    void set_capture_target(Symbol capture_target);
+    void set_fstop(Symbol fstop);
+    void set_iso(Symbol iso);
+    void set_mode(Symbol mode);
+    void set_quality(Symbol quality);
+    void set_shooting_speed(Symbol shooting_speed);
+    void set_shutter(Symbol speed);
 
     bool have_num_avail() const { return _have_num_avail; }
     bool have_burst_number() const { return _have_burst_number; }
@@ -95,12 +211,33 @@ public:
 
 private:
 
+    void _connect(const camera_profile_map * profiles);
     void _query_props();
+    void _use_profile(const CameraProfile & profile);
+    void _set_status_properties();
     void _step_camera_property(const std::string & property, int step);
 
+    result _submit(CameraJob && job);
+
+    // Submits a job that writes the dirty settings, they're only dirty again
+    // if it fails.
+    result _submit_dirty(CameraJob && job);
+    void _apply(CameraJob & job);
+
+    // Worker side, only touches the job, the camera handle and _hist_capture.
+    void _run(CameraJob & job);
+    result _usb_read_config(CameraJob & job);
+    result _usb_write_config(CameraJob & job);
+    result _usb_trigger(CameraJob & job);
+    result _usb_capture_histogram(CameraJob & job);
+    result _usb_drain_events(CameraJob & job);
+
     interface::GPhoto2Cpp &        _gp2cpp;
+    interface::WallClock &         _clock;
     gphoto2cpp::camera_ptr         _camera;
     Info                           _info;
+    std::string                    _model {};
+    std::string                    _firmware {};
 
     bool                           _have_num_avail {false};
     bool                           _have_burst_number {false};
@@ -108,9 +245,39 @@ private:
     bool                           _have_shooting_speed {false};
     bool                           _have_capturetarget {false};
 
+    // What read_status() refreshes, set by _set_status_properties().
+    std::vector<std::string>       _status_properties {};
+
+    // The choices of each setting, only used from the control thread.
+    mutable std::map<std::string, str_vec> _choices {};
+
     pixel_vec                                          _pixels {};
     hist_vec                                           _hist {};
     std::unique_ptr<pycontrol::interface::FileCapture> _hist_capture {nullptr};
+    std::uint32_t                                      _num_histograms {0};
+
+    // Serializes libgphoto2 access to this camera between the worker and
+    // reconnect().
+    mutable std::mutex                                 _usb_mutex;
+    std::size_t                                        _num_pending {0};
+    std::size_t                                        _choices_pending {0};
+
+    // Bumped by every setter, lets collect() spot reads that are older than
+    // the local settings.
+    std::uint32_t                                      _settings_version {0};
+
+    nanoseconds                                        _fire_ns {0};
+    std::shared_ptr<TriggerGate>                       _trigger_gate {nullptr};
+    LatencyStats                                       _trigger_lateness {256};
+    LatencyStats                                       _poll_usb {256};
+    nanoseconds                                        _poll_usb_total_ns {0};
+    std::uint64_t                                      _full_reads {0};
+    TriggerLatency                                     _latency {};
+    LatePolicy                                         _late_policy {};
+    std::uint32_t                                      _calibrating {0};
+
+    // Declared last so the thread is joined before anything it uses is gone.
+    std::unique_ptr<CameraWorker>                      _worker {nullptr};
 };
 
 
@@ -1,15 +1,25 @@
+#include <common/ShmTelemetry.h>
+#include <common/Tokenizer.h>
 #include <common/str_utils.h>
 #include <camera_control/Camera.h>
 #include <camera_control/CameraControl.h>
 #include <camera_control/CameraSequence.h>
-#include <camera_control/CameraSequenceFileReader.h>
+#include <camera_control/TriggerGate.h>
 
 #include <interface/UdpSocket.h>
 #include <interface/GPhoto2Cpp.h>
 #include <interface/WallClock.h>
 
+#include <pthread.h>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <cmath>
+#include <cstdlib>
+#include <fstream>
 #include <numeric>
+#include <thread>
 
 namespace pycontrol
 {
@@ -33,1244 +43,2095 @@ CameraControl(
         _serial_to_id[serial] = id;
         _id_to_serial[id] = serial;
     }
+
+    // Nothing answered yet.
+    _begin_response({});
 }
 
-void
+
 CameraControl::
-_camera_scan()
+~CameraControl()
 {
-    const auto new_detections = _gp2cpp.auto_detect();
-    const auto detections = port_set(new_detections.begin(), new_detections.end());
-    const bool cameras_changed = detections != _current_ports;
-    if (cameras_changed)
-    {
-        // Add or update cameras.
-        for (const auto & port : detections)
-        {
-            if (not _current_ports.contains(port))
-            {
-                auto camera = _gp2cpp.open_camera(port);
-                if (not camera)
-                {
-                    INFO_LOG << "gphoto2cpp::open_camera() failed, ignoring" << std::endl;
-                    continue;
-                }
+    // Keep the drift the estimates picked up from this session's triggers.
+    _save_trigger_latencies();
+}
 
-                if (not _gp2cpp.read_config(camera))
-                {
-                    ERROR_LOG
-                        << "gphoto2cpp::read_config(camera) failed"
-                        << std::endl;
-                    continue;
-                };
-
-                std::string serial;
-                if (not _gp2cpp.read_property(camera, "serialnumber", serial))
-                {
-                    ERROR_LOG
-                        << "gphoto2cpp::read_property(\"serialnumber\") failed"
-                        << std::endl;
-                    continue;
 
-                }
+result
+CameraControl::
+load_trigger_latencies(const std::string & filename)
+{
+    _trigger_latency_filename = filename;
+    _trigger_latencies.clear();
 
-                // Add new camera.
-                if (not _cameras.contains(serial))
-                {
-                    auto cam = std::make_shared<Camera>(
-                        _gp2cpp,
-                        camera,
-                        port,
-                        serial,
-                        "camera.config"
-                    );
-                    _cameras[serial] = cam;
-                    if (not _serial_to_id.contains(serial))
-                    {
-                        const auto & id = cam->info().desc;
-                        _serial_to_id[serial] = id;
-                        _id_to_serial[id] = serial;
-                    }
-                }
+    if (not std::ifstream(filename).is_open())
+    {
+        INFO_LOG << "no trigger latencies in '" << filename
+                 << "', cameras start uncalibrated" << std::endl;
+        return result::success;
+    }
 
-                // Update existing camera.
-                else
-                {
-                    _cameras[serial]->reconnect(camera, port);
-                }
+    ABORT_ON_FAILURE(
+        read_trigger_latencies(filename, _trigger_latencies),
+        "failed to read trigger latencies",
+        result::failure
+    );
 
-                INFO_LOG
-                    << "adding "
-                    << "port=" << port << " "
-                    << "serial=" << serial << " "
-                    << "desc=" << _serial_to_id[serial] << "\n";
+    for (const auto & [serial, latency] : _trigger_latencies)
+    {
+        INFO_LOG << "trigger latency " << serial << ": "
+                 << latency.estimate_ns / 1000 << " us over "
+                 << latency.samples << " samples" << std::endl;
+    }
 
-                _current_ports.insert(port);
-            }
-        }
+    return result::success;
+}
 
-        // Mark any cameras not detected as disconnected.
-        for (auto & pair : _cameras)
-        {
-            auto & cam = pair.second;
-            const auto & info = cam->info();
-            const auto & port = info.port;
-            if (not detections.contains(port))
-            {
-                std::size_t num_erased = _current_ports.erase(port);
-                if (num_erased > 0)
-                {
-                    INFO_LOG
-                        << "removing "
-                        << "port=" << port << " "
-                        << "serial=" << info.serial << " "
-                        << "desc=" << _serial_to_id[info.serial] << "\n";
-                    cam->disconnect();
-                }
-            }
-        }
+
+result
+CameraControl::
+load_camera_profiles(const std::string & filename)
+{
+    _camera_profile_filename = filename;
+    _camera_profiles.clear();
+
+    if (not std::ifstream(filename).is_open())
+    {
+        INFO_LOG << "no camera profiles in '" << filename
+                 << "', cameras are probed on connect" << std::endl;
+        return result::success;
     }
 
-    // Always read the camera configuration to reflect the camera state.
-    for (auto & [_, camera] : _cameras)
+    ABORT_ON_FAILURE(
+        read_camera_profiles(filename, _camera_profiles),
+        "failed to read camera profiles",
+        result::failure
+    );
+
+    for (const auto & [_, profile] : _camera_profiles)
     {
-        camera->read_config();
+        INFO_LOG << "camera profile " << profile.model << " " << profile.firmware
+                 << ": " << profile.choices.size() << " settings" << std::endl;
     }
+
+    return result::success;
 }
 
 
 result
 CameraControl::
-_send_telemetry()
+load_camera_models(const std::string & filename)
 {
-    _telem_message.seekp(0, std::ios::beg);
+    auto models = std::make_shared<camera_model_map>();
 
-    //-------------------------------------------------------------------------
-    // state
-    //
-    _telem_message << "{\"state\":\"" << _state << "\",";
+    ABORT_ON_FAILURE(
+        read_camera_models(filename, *models),
+        "failed to read camera models",
+        result::failure
+    );
 
-    //-------------------------------------------------------------------------
-    // time
-    //
-    _telem_message << "\"time\":" << _control_time << ",";
+    _camera_models = std::move(models);
 
-    //-------------------------------------------------------------------------
-    // command_response
-    //
-    _telem_message << "\"command_response\":" << _command_response << ",";
+    return result::success;
+}
 
-    //-------------------------------------------------------------------------
-    // detected_cameras
-    //
-    _telem_message << "\"detected_cameras\":[";
-    {
-        std::size_t idx = 0;
-        for (const auto & [serial, cam_ptr] : _cameras)
-        {
-            _telem_message << "{";
 
-            const auto & info = cam_ptr->info();
-            const auto & entry = _serial_to_id.find(serial);
+void
+CameraControl::
+set_late_policy(const LatePolicy & policy)
+{
+    _late_policy = policy;
 
-            const auto desc = entry != _serial_to_id.end() ?
-                              entry->second :
-                              info.desc;
+    for (auto & [_, cam_ptr] : _cameras)
+    {
+        cam_ptr->late_policy().set(policy.mode(), policy.late_ms());
+    }
+}
 
-            // TODO: cam_ptr->to_json(desc);
 
-            _telem_message
-                << std::boolalpha
-                << "\"connected\":"  << info.connected     << ","
-                << "\"serial\":\""   << info.serial        << "\","
-                << "\"port\":\""     << info.port          << "\","
-                << "\"desc\":\""     << desc               << "\","
-                << "\"mode\":\""     << info.mode          << "\","
-                << "\"shutter\":\""  << info.shutter       << "\","
-                << "\"fstop\":\""    << info.fstop         << "\","
-                << "\"iso\":\""      << info.iso           << "\","
-                << "\"quality\":\""  << info.quality       << "\","
-                << "\"batt\":\""     << info.battery_level << "\","
-                << "\"num_photos\":" << info.num_photos;
+void
+CameraControl::
+_learn_camera_profile(const Camera & camera)
+{
+    const auto key = camera.profile_key();
+    if (_camera_profiles.contains(key))
+    {
+        return;
+    }
 
-            if (cam_ptr->have_num_avail())
-            {
-                _telem_message << ",\"num_avail\":" << info.num_avail;
-            }
-            if (cam_ptr->have_burst_number())
-            {
-                _telem_message << ",\"burst_number\":" << info.burst_number;
-            }
-            _telem_message << "}";
+    _camera_profiles[key] = camera.profile();
 
-            if (++idx < _cameras.size()) _telem_message << ",";
-        }
+    if (_camera_profile_filename.empty())
+    {
+        return;
     }
-    _telem_message << "],";
 
-    //-------------------------------------------------------------------------
-    // events
-    //
-    _telem_message << "\"events\":{";
+    if (result::failure == write_camera_profiles(_camera_profile_filename, _camera_profiles))
     {
-        std::size_t idx = 0;
-        for (const auto & [event_id, timestamp] : _event_map)
-        {
-            _telem_message << "\"" << event_id << "\":" << timestamp;
-            if (++idx < _event_map.size()) _telem_message << ",";
-        }
+        ERROR_LOG << "failed to save camera profiles" << std::endl;
     }
-    _telem_message << "},";
+}
 
-    //-------------------------------------------------------------------------
-    // sequence
-    //
-    _telem_message << "\"sequence\":\"" << _sequence_filename << "\",";
 
-    //-------------------------------------------------------------------------
-    // sequence_state
-    //
-    _telem_message << "\"sequence_state\":[";
+void
+CameraControl::
+_save_trigger_latencies()
+{
+    if (_trigger_latency_filename.empty())
     {
-        std::size_t idx = 0;
-        for (const auto & [cam_id, sequence] : _sequence_map)
-        {
-            _telem_message
-                << "{\"num_events\":" << sequence->size() << ","
-                << "\"id\":\"" << cam_id << "\","
-                << "\"events\":[";
-
-            auto itor = sequence->begin();
-            auto pos = sequence->pos();
-            int count = 0;
-            bool erase_comma = false;
-            while (itor < sequence->end())
-            {
-                if (++count > 10)
-                {
-                    break;
-                }
-                const auto & event = *itor;
-                const auto event_time = _get_event_time(event);
-
-                const auto eta = event_time == MAX_TIME ?
-                    "N/A" :
-                    convert_milliseconds_to_hms(event_time - _control_time);
-
-                _telem_message
-                    << "{"
-                    << "\"pos\":" << pos++ << ","
-                    << "\"event_id\":\"" << event.event_id << "\","
-                    << "\"event_time_offset\":\"" << convert_milliseconds_to_hms(event.event_time_offset_ms) << "\","
-                    << "\"eta\":\"" << eta << "\","
-                    << "\"channel\":\"" << cam_id << "." << to_string(event.channel) << "\","
-                    << "\"value\":\"" << event.channel_value << "\""
-                    << "}";
-
-                erase_comma = true;
-                _telem_message << ",";
-
-                ++itor;
-            }
-            // Overwrite the trailing comma.
-            if (erase_comma)
-            {
-                auto last_pos = _telem_message.tellp() - std::streamoff(1);
-                _telem_message.seekp(last_pos);
-            }
-            _telem_message << "]}";
-        }
+        return;
+    }
 
-        if (++idx < _sequence_map.size())
+    for (const auto & [serial, cam_ptr] : _cameras)
+    {
+        if (cam_ptr->trigger_latency().samples > 0)
         {
-            _telem_message << ",";
+            _trigger_latencies[serial] = cam_ptr->trigger_latency();
         }
     }
-    _telem_message << "],";
 
-    //-------------------------------------------------------------------------
-    // timelapse
-    //
-    switch (_state)
+    if (result::failure == write_trigger_latencies(_trigger_latency_filename, _trigger_latencies))
     {
-        case State::timelapse_idle:
-        case State::timelapse_running:
-        {
-            _telem_message << "\"timelapse\":{\"histogram\":[";
+        ERROR_LOG << "failed to save trigger latencies" << std::endl;
+    }
+}
 
-            if (_cameras.contains(_timelapse_serial))
-            {
-                auto cam = _cameras[_timelapse_serial];
-                const auto hist_vec = cam->histogram();
-                if (not hist_vec.empty())
-                {
-                    for (const auto h : hist_vec)
-                    {
-                        _telem_message << h << ",";
-                    }
-                    // Overwrite last ',';
-                    _telem_message.seekp(-1, std::ios_base::cur);
-                }
-            }
 
-            const std::string serial = _timelapse_serial.empty() ? "none" : _timelapse_serial;
-            const float interval = static_cast<float>(_timelapse_interval) / 1000.0f;
+void
+CameraControl::
+_update_clock()
+{
+    // Anything bigger than a slew can manage in one control period.
+    constexpr nanoseconds step_threshold_ns = 10'000'000;
 
-            const int target_bin = _timelapse_target_bin + _timelapse_target_offset;
-            const int current_bin = target_bin + _timelapse_target_error;
+    const auto mono_ns = _clock.monotonic_ns();
+    const auto offset_ns = _clock.utc_offset_ns();
 
-            _telem_message
-                << "],"
-                << "\"serial\":\""       << serial                    << "\","
-                << "\"interval\":"       << interval                  << ","
-                << "\"min_shutter\":"    << _timelapse_min_shutter    << ","
-                << "\"max_shutter\":"    << _timelapse_max_shutter    << ","
-                << "\"min_iso\":"        << _timelapse_min_iso        << ","
-                << "\"max_iso\":"        << _timelapse_max_iso        << ","
-                << "\"min_hist_mask\":"  << _timelapse_min_hist_mask  << ","
-                << "\"max_hist_mask\":"  << _timelapse_max_hist_mask  << ","
-                << "\"min_deadband\":"   << _timelapse_min_deadband   << ","
-                << "\"max_deadband\":"   << _timelapse_max_deadband   << ","
-                << "\"current_bin\":"    << current_bin               << ","
-                << "\"target_bin\":"     << target_bin                << ","
-                << "\"target_offset\":"  << _timelapse_target_offset  << ","
-                << "\"target_percent\":" << _timelapse_target_percent << ","
-                << "\"target_error\":"   << _timelapse_target_error   << ","
-                << "\"num_captures\":"   << _timelapse_capture_count  << ","
-                << "\"pixel_count\":"    << _timelapse_pixel_count
-                << "}";
+    const auto change_ns = offset_ns - _system_offset_ns;
+    _system_offset_ns = offset_ns;
 
-            break;
-        }
-        default:
-        {
-            _telem_message << "\"timelapse\":{}";
-            break;
-        }
+    if (not _have_utc_offset)
+    {
+        _utc_offset_ns = offset_ns;
+        _have_utc_offset = true;
     }
+    else if (std::abs(change_ns) > step_threshold_ns)
+    {
+        ++_clock_steps;
+        _clock_step_ns = change_ns;
 
-    _telem_message << "}";
+        INFO_LOG << "system clock stepped by " << change_ns / 1'000'000 << " ms" << std::endl;
+    }
+    else
+    {
+        _utc_offset_ns += change_ns;
+    }
 
-    // Mark the end of the stream and rewind before sending.
-    _telem_message << '\0';
-    _telem_message.seekp(0, std::ios::beg);
+    // Deadlines already handed to a camera worker stay put on the monotonic
+    // clock.  Those are the events due within a control period plus the
+    // largest trigger lead, a step is held only while one is, or until
+    // clock_sync.
+    const bool precise = _camera_workers and _control_period > 0;
+    const auto handed_ms = precise ? _control_period + _max_trigger_lead_ms() : 0;
+    const bool handed = _get_next_event_time() <= mono_ns / 1'000'000 + handed_ms;
 
-    ABORT_ON_FAILURE(
-        _telem_socket.send(_telem_message.str()),
-        "UdpSocket::send() failed",
-        result::failure
-    );
+    if (_utc_offset_ns != _system_offset_ns and not handed)
+    {
+        INFO_LOG << "applying clock step of "
+                 << (_system_offset_ns - _utc_offset_ns) / 1'000'000 << " ms" << std::endl;
+        _utc_offset_ns = _system_offset_ns;
+    }
 
-    return result::success;
+    if (_start_ns < 0)
+    {
+        _start_ns = mono_ns;
+    }
+
+    _mono_time = mono_ns / 1'000'000;
+    _control_time = (mono_ns + _utc_offset_ns) / 1'000'000;
 }
 
-result
+
+void
 CameraControl::
-_read_command(bool & got_message, State & next_state)
+_connect_cameras(std::vector<UsbPort> & ports)
 {
-    got_message = false;
-
-    ABORT_ON_FAILURE(
-        _command_socket.recv(_command_buffer),
-        "UdpSocket::read() failed",
-        result::failure
-    );
-
-    // No message avialable.
-    if (_command_buffer.empty() or _command_buffer.size() == 0)
+    // One batch at a time, ports found meanwhile wait in ports for the next.
+    if (ports.empty() or _camera_opener.busy() or _open_batch)
     {
-        return result::success;
+        return;
     }
 
-    std::uint32_t cmd_id = 0;
-    std::string command;
-
-    std::ostringstream oss;
-
-    // Copy and strip extraneous whitespace.
-    std::string raw_cmd(_command_buffer.c_str());
-    strip(raw_cmd, ' ');
-    strip(raw_cmd, '\n');
-
-    std::istringstream iss(raw_cmd);
-
-    if (not (iss >> cmd_id))
+    auto batch = std::make_unique<CameraOpenBatch>();
+    batch->begin_ns = _clock.monotonic_ns();
+    batch->profiles = _camera_profiles;
+    for (const auto & port : ports)
     {
-        ++_last_rejected_command_id;
-        oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-            << ",\"last_rejected_id\":" << _last_rejected_command_id
-            << ",\"message\":\"failed to parse command ID from '" << _command_buffer << "'\"}";
-        _command_response = oss.str();
-        got_message = true;
-        return result::success;
+        batch->openings.push_back(CameraOpening{.port = port});
+        _opening_ports.insert(port);
     }
+    ports.clear();
 
-    if (not (iss >> command))
+    // Each camera takes most of a second to open and read, so cameras plugged
+    // in together are opened together.
+    if (result::failure == _camera_opener.open(std::move(batch)))
     {
-        _last_rejected_command_id = cmd_id;
-        oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-            << ",\"last_rejected_id\":" << _last_rejected_command_id
-            << ",\"message\":\"failed to parse command from '" << _command_buffer << "'\"}";
-        _command_response = oss.str();
-        got_message = true;
-        return result::success;
+        ERROR_LOG << "_camera_opener.open() failed, ignoring" << std::endl;
+        return;
     }
 
-    // Nothing new to process.  How do we handle cmd_id rollover?
-    if (cmd_id <= std::max(_last_accepted_command_id, _last_rejected_command_id))
+    if (not _background_open)
     {
-        return result::success;
+        _collect_camera_opens(true);
     }
+}
 
-    DEBUG_LOG << "read_command(): control_time: " << _control_time << " cmd: '" << _command_buffer << "'" << std::endl;
 
-    // We have a message, reset the send time so there's no latency to
-    // responding to commands.
-    got_message = true;
+void
+CameraControl::
+_collect_camera_opens(bool wait)
+{
+    if (not _open_batch)
+    {
+        _open_batch = _camera_opener.poll(wait);
+        if (not _open_batch)
+        {
+            return;
+        }
+    }
 
-    //-------------------------------------------------------------------------
-    // set_camera_id
-    //
-    if (command == "set_camera_id")
+    // Merge on the control thread.
+    auto & batch = *_open_batch;
+    bool merged = true;
+    bool failed = false;
+    for (auto & opening : batch.openings)
     {
-        std::string serial;
-        std::string cam_id;
-        if (not (iss >> serial >> cam_id))
+        if (opening.merged)
         {
-            _last_rejected_command_id = cmd_id;
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"Got bad camera rename message: '" << _command_buffer << "'\"}";
-            _command_response = oss.str();
-            return result::success;
+            continue;
         }
 
-        if (not _cameras.contains(serial))
+        if (not opening.camera)
         {
-            _last_rejected_command_id = cmd_id;
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"serial '" << serial << "' does not exist\"}";
-            _command_response = oss.str();
-            return result::success;
+            opening.merged = true;
+            failed = true;
+            _opening_ports.erase(opening.port);
+            continue;
         }
 
-        if (_id_to_serial.contains(cam_id))
+        const auto & serial = opening.serial;
+        const auto itor = _cameras.find(serial);
+
+        if (itor == _cameras.end())
         {
-            _last_rejected_command_id = cmd_id;
+            // Add new camera.
+            auto & cam = opening.camera;
+            if (_camera_workers)
             {
-                std::ostringstream msg_oss;
-                msg_oss << "id '" << cam_id << "' already exists";
-                _last_rejected_message = msg_oss.str();
+                cam->start_worker();
             }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
+            const auto latency = _trigger_latencies.find(serial);
+            if (latency != _trigger_latencies.end())
+            {
+                cam->set_trigger_latency(latency->second);
+            }
+            cam->late_policy().set(_late_policy.mode(), _late_policy.late_ms());
+            _cameras[serial] = cam;
+            if (not _serial_to_id.contains(serial))
+            {
+                const auto & id = cam->info().desc;
+                _serial_to_id[serial] = id;
+                _id_to_serial[id] = serial;
+            }
+        }
+        else if (std::ranges::any_of(
+                     batch.openings,
+                     [&](const auto & other) { return other.camera == itor->second; }))
+        {
+            ERROR_LOG
+                << "serial=" << serial << " "
+                << "is already on another port, ignoring port=" << opening.port
+                << std::endl;
+            opening.merged = true;
+            _opening_ports.erase(opening.port);
+            continue;
+        }
+        else if (itor->second->busy())
+        {
+            // Its worker is still draining jobs for the old handle, merged
+            // on a later tick.
+            merged = false;
+            continue;
+        }
+        else
+        {
+            itor->second->reconnect(*opening.camera);
         }
 
-        INFO_LOG << "mapping serial " << serial << " to " << cam_id << "\n";
+        _learn_camera_profile(*_cameras[serial]);
 
-        // First, remove any previous name.
-        const auto & old_id = _serial_to_id[serial];
-        _id_to_serial.erase(old_id);
+        INFO_LOG
+            << "adding "
+            << "port=" << opening.port << " "
+            << "serial=" << serial << " "
+            << "desc=" << _serial_to_id[serial] << "\n";
 
-        // Update with the new id.
-        _serial_to_id[serial] = cam_id;
-        _id_to_serial[cam_id] = serial;
+        opening.merged = true;
+        _opening_ports.erase(opening.port);
+        _current_ports.insert(opening.port);
+        ++batch.connected;
     }
-    //-------------------------------------------------------------------------
-    // set_events
-    //
-    else if (command == "set_events")
+
+    if (failed)
     {
-        bool parse_error = false;
-        auto new_event_map = event_map();
-        while (not iss.eof())
-        {
-            std::string event_id;
-            milliseconds timestamp;
+        // Likely still settling, e.g. udev hasn't given us access yet, see
+        // what's plugged in on the next scan.
+        _detect_time = _mono_time;
+    }
 
-            parse_error = parse_error or not (iss >> event_id);
-            parse_error = parse_error or not (iss >> timestamp);
+    if (not merged)
+    {
+        return;
+    }
 
-            if (parse_error)
-            {
-                break;
-            }
+    const auto count = batch.connected;
+    if (count > 0)
+    {
+        const auto end_ns = _clock.monotonic_ns();
 
-            new_event_map[event_id] = timestamp;
-        }
+        _open_cameras = static_cast<std::uint32_t>(count);
+        _open_ms = (end_ns - batch.begin_ns) / 1'000'000;
 
-        if (parse_error)
+        if (_ready_ms == 0)
         {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "failed to parse events from '" << _command_buffer << "'";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
+            _ready_ms = std::max<milliseconds>((end_ns - _start_ns) / 1'000'000, 1);
         }
 
-        // All good, update the event map!
-        _event_map = new_event_map;
-    }
-    //-------------------------------------------------------------------------
-    // load_sequence
-    //
-    else if (command == "load_sequence")
-    {
-        std::string sequence_fn;
-        if (not (std::getline(iss, sequence_fn)))
-        {
-            _last_rejected_command_id = cmd_id;
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"failed to parse command '" << _command_buffer << "'\"}";
-            _command_response = oss.str();
-            return result::success;
-        }
-        strip(sequence_fn, ' ');
+        INFO_LOG
+            << "opened " << count << " of " << batch.openings.size() << " cameras in "
+            << _open_ms << " ms, "
+            << _ready_ms << " ms after startup to the first ready"
+            << std::endl;
 
-        // Load the camer sequence file.
-        auto seq_reader = CameraSequenceFileReader();
-        if (result::failure == seq_reader.read_file(sequence_fn))
-        {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "failed to parse camera sequence file '" << sequence_fn << "'";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
-        }
-        _sequence_filename = sequence_fn;
-        _sequence_map.clear();
+        _compile_timeline();
+    }
 
-        const auto & event_seq = seq_reader.get_events();
-        const auto & cam_ids = seq_reader.get_camera_ids();
+    _open_batch.reset();
+}
 
-        for (const auto & id : cam_ids)
-        {
-            auto cam_seq = std::make_shared<CameraSequence>();
-            if (not cam_seq)
-            {
-                _last_rejected_command_id = cmd_id;
-                oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                    << ",\"last_rejected_id\":" << _last_rejected_command_id
-                    << ",\"message\":\"failed to allocate CameraSequence\"}";
-                _command_response = oss.str();
-                return result::success;
-            }
-            if (result::failure == cam_seq->load(id, event_seq))
-            {
-                _last_rejected_command_id = cmd_id;
-                oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                    << ",\"last_rejected_id\":" << _last_rejected_command_id
-                    << ",\"message\":\"CameraSequence.load() failed\"}";
-                _command_response = oss.str();
-                return result::success;
-            }
-            _sequence_map[id] = cam_seq;
-        }
 
-        command = "reset_sequence";
+bool
+CameraControl::
+_disconnect_port(const UsbPort & port)
+{
+    if (_current_ports.erase(port) == 0)
+    {
+        return false;
     }
-    //-------------------------------------------------------------------------
-    // read_choices
-    //
-    else if (command == "read_choices")
-    {
-        std::string serial;
-        std::string property;
-        if (not (iss >> serial >> property))
-        {
-            _last_rejected_command_id = cmd_id;
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\""
-                << "Failed to parse read_choices command: '" << _command_buffer << "'\"}";
-            _command_response = oss.str();
-            return result::success;
-        }
 
-        if (not _cameras.contains(serial))
+    for (auto & [_, cam] : _cameras)
+    {
+        const auto & info = cam->info();
+        if (info.connected and info.port == port)
         {
-            _last_rejected_command_id = cmd_id;
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"serial '" << serial << "' does not exist\"}";
-            _command_response = oss.str();
-            return result::success;
+            INFO_LOG
+                << "removing "
+                << "port=" << port << " "
+                << "serial=" << info.serial << " "
+                << "desc=" << _serial_to_id[info.serial] << "\n";
+            cam->disconnect();
         }
+    }
 
-        auto choice_vec = _cameras[serial]->read_choices(property);
+    return true;
+}
 
-        // If the vector is empty, probably doesn't exist.
-        if (choice_vec.empty())
-        {
-            _last_rejected_command_id = cmd_id;
+
+void
+CameraControl::
+_hot_plug_scan()
+{
+    _hot_plug_events.clear();
+    if (result::failure == _hot_plug->poll(_hot_plug_events))
+    {
+        // Events were lost, see what's plugged in on the next scan.
+        _detect_time = _mono_time;
+    }
+
+    bool cameras_changed = false;
+    for (const auto & event : _hot_plug_events)
+    {
+        if (event.type == interface::HotPlug::Event::Type::remove)
+        {
+            cameras_changed |= _disconnect_port(event.port);
+        }
+        else if (not _current_ports.contains(event.port) and
+                 not _opening_ports.contains(event.port) and
+                 std::ranges::find(_new_ports, event.port) == _new_ports.end())
+        {
+            _new_ports.push_back(event.port);
+        }
+    }
+
+    _connect_cameras(_new_ports);
+
+    if (cameras_changed)
+    {
+        _compile_timeline();
+    }
+}
+
+
+void
+CameraControl::
+_camera_scan()
+{
+    // With hot-plug events, asking libgphoto2 what's plugged in is only a
+    // slow fallback.
+    if (_hot_plug == nullptr or _detect_time <= _mono_time)
+    {
+        _detect_time = _mono_time + HOT_PLUG_FALLBACK_MS;
+
+        const auto new_detections = _gp2cpp.auto_detect();
+        const auto detections = port_set(new_detections.begin(), new_detections.end());
+        const bool cameras_changed = detections != _current_ports;
+        if (cameras_changed)
+        {
+            // Add or update cameras.
+            for (const auto & port : detections)
             {
-                std::ostringstream msg_oss;
-                msg_oss << "property '" << property << "' does not exist";
-                _last_rejected_message = msg_oss.str();
+                if (not _current_ports.contains(port) and
+                    not _opening_ports.contains(port) and
+                    std::ranges::find(_new_ports, port) == _new_ports.end())
+                {
+                    _new_ports.push_back(port);
+                }
             }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
+            _connect_cameras(_new_ports);
+
+            // Mark any cameras not detected as disconnected.
+            for (const auto & port : port_set(_current_ports))
+            {
+                if (not detections.contains(port))
+                {
+                    _disconnect_port(port);
+                }
+            }
+
+            _compile_timeline();
+        }
+    }
+
+    // Always poll the camera status to reflect the camera state, unless the
+    // camera's worker is still busy with earlier requests.  The whole config
+    // tree is only read on connect or by the read_config command.
+    for (auto & [_, camera] : _cameras)
+    {
+        if (not camera->busy())
+        {
+            camera->read_status();
+        }
+    }
+}
+
+
+template <typename Writer>
+void
+CameraControl::
+_write_telemetry(Writer & out)
+{
+    out.begin_object();
+
+    //-------------------------------------------------------------------------
+    // seq
+    //
+    out.key("seq").value(_telem_seq);
+
+    //-------------------------------------------------------------------------
+    // state
+    //
+    out.key("state").value(to_string(_state));
+
+    //-------------------------------------------------------------------------
+    // time
+    //
+    out.key("time").value(_control_time);
+
+    //-------------------------------------------------------------------------
+    // clock
+    //
+    out.key("clock").begin_object();
+    out.key("utc_offset_ms").value(_utc_offset_ns / 1'000'000);
+    out.key("steps").value(_clock_steps);
+    out.key("last_step_ms").value(_clock_step_ns / 1'000'000);
+    out.key("held_ms").value((_system_offset_ns - _utc_offset_ns) / 1'000'000);
+    out.end_object();
+
+    //-------------------------------------------------------------------------
+    // command_response
+    //
+    const auto & response = _command_response;
+    out.key("command_response").begin_object();
+    out.key("last_accepted_id").value(response.last_accepted_id);
+    out.key("last_rejected_id").value(response.last_rejected_id);
+    out.key("message").value(response.message);
+    if (response.loading)
+    {
+        out.key("loading").begin_object();
+        out.key("id").value(response.loading_id);
+        out.key("percent").value(response.loading_percent);
+        out.end_object();
+    }
+    if (response.has_data)
+    {
+        out.key("data").begin_array();
+        for (const auto & choice : response.data)
+        {
+            out.value(choice);
+        }
+        out.end_array();
+    }
+    out.end_object();
+
+    // How long commands waited to be read.
+    const auto queue = _command_queue.summary();
+    out.key("command_queue_us").begin_object();
+    out.key("count").value(queue.count);
+    out.key("p50").value(queue.p50 / 1000);
+    out.key("p99").value(queue.p99 / 1000);
+    out.key("max").value(queue.max / 1000);
+    out.end_object();
+
+    //-------------------------------------------------------------------------
+    // detected_cameras
+    //
+    out.key("detected_cameras").begin_array();
+    for (const auto & [serial, cam_ptr] : _cameras)
+    {
+        out.begin_object();
+
+        const auto & info = cam_ptr->info();
+        const auto & entry = _serial_to_id.find(serial);
+
+        const auto & desc = entry != _serial_to_id.end() ?
+                            entry->second :
+                            info.desc;
+
+        out.key("connected").value(info.connected);
+        out.key("serial").value(info.serial);
+        out.key("port").value(info.port);
+        out.key("desc").value(desc);
+        out.key("mode").value(to_string(info.mode));
+        out.key("shutter").value(to_string(info.shutter));
+        out.key("fstop").value(to_string(info.fstop));
+        out.key("iso").value(to_string(info.iso));
+        out.key("quality").value(to_string(info.quality));
+        out.key("batt").value(info.battery_level);
+        out.key("num_photos").value(info.num_photos);
+        out.key("usb_pending").value(cam_ptr->pending());
+
+        if (cam_ptr->have_num_avail())
+        {
+            out.key("num_avail").value(info.num_avail);
+        }
+        if (cam_ptr->have_burst_number())
+        {
+            out.key("burst_number").value(info.burst_number);
+        }
+
+        // How far behind the first camera of its group this one fired.
+        const auto & gate = cam_ptr->trigger_gate();
+        if (gate and gate->complete())
+        {
+            out.key("fire_offset_us").value((cam_ptr->fire_ns() - gate->first_fire_ns()) / 1000);
+        }
+
+        // How late triggers fired after their deadline.
+        const auto lateness = cam_ptr->trigger_lateness().summary();
+        out.key("trigger_lateness_us").begin_object();
+        out.key("count").value(lateness.count);
+        out.key("min").value(lateness.min / 1000);
+        out.key("p50").value(lateness.p50 / 1000);
+        out.key("p99").value(lateness.p99 / 1000);
+        out.key("max").value(lateness.max / 1000);
+        out.end_object();
+
+        // USB time spent polling the camera's status.
+        const auto poll = cam_ptr->poll_usb().summary();
+        out.key("poll_usb_us").begin_object();
+        out.key("count").value(poll.count);
+        out.key("full").value(cam_ptr->full_reads());
+        out.key("p50").value(poll.p50 / 1000);
+        out.key("max").value(poll.max / 1000);
+        out.key("total").value(cam_ptr->poll_usb_total_ns() / 1000);
+        out.end_object();
+
+        // The learned trigger latency.
+        const auto & latency = cam_ptr->trigger_latency();
+        out.key("trigger_latency").begin_object();
+        out.key("us").value(latency.estimate_ns / 1000);
+        out.key("dev_us").value(latency.deviation_ns / 1000);
+        out.key("samples").value(latency.samples);
+        out.key("file_added_us").value(latency.file_added_ns / 1000);
+        out.key("calibrating").value(cam_ptr->calibrating());
+        out.end_object();
+
+        // What the late policy did with each trigger.
+        const auto & policy = cam_ptr->late_policy();
+        const auto & counts = policy.counts();
+        out.key("late_policy").begin_object();
+        out.key("mode").value(to_string(policy.mode()));
+        out.key("late_ms").value(policy.late_ms());
+        out.key("compressing").value(policy.compressing());
+        out.key("fired").value(counts.fired);
+        out.key("late").value(counts.late);
+        out.key("skipped").value(counts.skipped);
+        out.key("compressed").value(counts.compressed);
+        out.end_object();
+
+        out.end_object();
+    }
+    out.end_array();
+
+    //-------------------------------------------------------------------------
+    // trigger_skew
+    //
+    out.key("trigger_skew").begin_object();
+    out.key("groups").value(_trigger_groups);
+    out.key("cameras").value(_trigger_group_size);
+    out.key("skew_us").value(_trigger_skew_ns / 1000);
+    out.key("max_skew_us").value(_trigger_max_skew_ns / 1000);
+    out.key("timeouts").value(_trigger_timeouts);
+    out.end_object();
+
+    //-------------------------------------------------------------------------
+    // camera_open
+    //
+    out.key("camera_open").begin_object();
+    out.key("cameras").value(_open_cameras);
+    out.key("ms").value(_open_ms);
+    out.key("ready_ms").value(_ready_ms);
+    out.end_object();
+
+    //-------------------------------------------------------------------------
+    // events
+    //
+    out.key("events").begin_object();
+    for (const auto & [event_id, timestamp] : _event_map)
+    {
+        out.key(event_id).value(timestamp);
+    }
+    out.end_object();
+
+    //-------------------------------------------------------------------------
+    // sequence
+    //
+    out.key("sequence").value(_sequence_filename);
+
+    //-------------------------------------------------------------------------
+    // sequence_state
+    //
+    out.key("sequence_state").begin_array();
+    for (const auto & [cam_id, sequence] : _sequence_map)
+    {
+        out.begin_object();
+        out.key("num_events").value(sequence->size());
+        out.key("id").value(cam_id);
+
+        out.key("warnings").begin_array();
+        const auto prediction = _predictions.find(cam_id);
+        if (prediction != _predictions.end())
+        {
+            for (const auto & warning : prediction->second.warnings)
+            {
+                out.value(warning);
+            }
+        }
+        out.end_array();
+
+        out.key("events").begin_array();
+        int count = 0;
+        for (auto idx = sequence->next(); idx < sequence->size(); ++idx)
+        {
+            if (sequence->done(idx))
+            {
+                continue;
+            }
+            if (++count > 10)
+            {
+                break;
+            }
+            const auto & event = sequence->event(idx);
+            const auto event_time = sequence->time(idx);
+
+            char hms[HMS_SIZE];
+
+            out.begin_object();
+            out.key("pos").value(idx + 1);
+            out.key("event_id").value(to_string(event.event_id));
+            out.key("event_time_offset").value(
+                std::string_view(hms, format_milliseconds_as_hms(event.event_time_offset_ms, hms)));
+
+            if (event_time == MAX_TIME)
+            {
+                out.key("eta").value("N/A");
+            }
+            else
+            {
+                const auto eta = event_time - _utc_offset_ns / 1'000'000 - _mono_time;
+                out.key("eta").value(std::string_view(hms, format_milliseconds_as_hms(eta, hms)));
+            }
+
+            out.key("channel").begin_string().append(cam_id).append(".").append(to_string(event.channel)).end_string();
+            out.key("value").value(to_string(event.value.text));
+            out.end_object();
+        }
+        out.end_array();
+
+        out.end_object();
+    }
+    out.end_array();
+
+    //-------------------------------------------------------------------------
+    // timelapse
+    //
+    out.key("timelapse").begin_object();
+    switch (_state)
+    {
+        case State::timelapse_idle:
+        case State::timelapse_running:
+        {
+            out.key("histogram").begin_array();
+            const auto cam = _cameras.find(_timelapse_serial);
+            if (cam != _cameras.end())
+            {
+                for (const auto h : cam->second->histogram())
+                {
+                    out.value(h);
+                }
+            }
+            out.end_array();
+
+            const std::string_view serial = _timelapse_serial.empty() ? "none" : _timelapse_serial;
+            const float interval = static_cast<float>(_timelapse_interval) / 1000.0f;
+
+            const int target_bin = _timelapse_target_bin + _timelapse_target_offset;
+            const int current_bin = target_bin + _timelapse_target_error;
+
+            out.key("serial").value(serial);
+            out.key("interval").value(interval);
+            out.key("min_shutter").value(_timelapse_min_shutter);
+            out.key("max_shutter").value(_timelapse_max_shutter);
+            out.key("min_iso").value(_timelapse_min_iso);
+            out.key("max_iso").value(_timelapse_max_iso);
+            out.key("min_hist_mask").value(_timelapse_min_hist_mask);
+            out.key("max_hist_mask").value(_timelapse_max_hist_mask);
+            out.key("min_deadband").value(_timelapse_min_deadband);
+            out.key("max_deadband").value(_timelapse_max_deadband);
+            out.key("current_bin").value(current_bin);
+            out.key("target_bin").value(target_bin);
+            out.key("target_offset").value(_timelapse_target_offset);
+            out.key("target_percent").value(_timelapse_target_percent);
+            out.key("target_error").value(_timelapse_target_error);
+            out.key("num_captures").value(_timelapse_capture_count);
+            out.key("pixel_count").value(_timelapse_pixel_count);
+
+            break;
+        }
+        default:
+        {
+            break;
         }
+    }
+    out.end_object();
+
+    out.end_object();
+}
+
+
+result
+CameraControl::
+_send_telemetry()
+{
+    ++_telem_seq;
+
+    if (_binary_telemetry)
+    {
+        _telem_binary.clear();
+        _write_telemetry(_telem_binary);
 
-        _last_accepted_command_id = cmd_id;
-        oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-            << ",\"last_rejected_id\":" << _last_rejected_command_id
-            << ",\"message\":\"" << _last_rejected_message << "\""
-            << ",\"data\":[";
-        std::size_t idx = 0;
-        for (const auto & choice : choice_vec)
+        if (_telem_shm)
         {
-            oss << "\"" << choice << "\"";
-            if (++idx < choice_vec.size()) oss << ",";
+            ABORT_ON_FAILURE(
+                _telem_shm->publish(_telem_binary.view()),
+                "ShmPublisher::publish() failed",
+                result::failure
+            );
         }
-        oss << "]}";
-        _command_response = oss.str();
+
+        ABORT_ON_FAILURE(
+            _telem_socket.send_frame(_telem_binary.view()),
+            "UdpSocket::send_frame() failed",
+            result::failure
+        );
+
         return result::success;
     }
-    else if (command == "set_choice")
+
+    auto & json = _telem_json;
+
+    json.clear();
+    _write_telemetry(json);
+
+    if (_telem_shm)
+    {
+        ABORT_ON_FAILURE(
+            _telem_shm->publish(json.view()),
+            "ShmPublisher::publish() failed",
+            result::failure
+        );
+    }
+
+    //-------------------------------------------------------------------------
+    // In delta mode, only what changed since the last keyframe until the next
+    // one is due or the telemetry changes shape.
+    //
+    if (_keyframe_period > 0)
+    {
+        auto & delta = _delta_json;
+        delta.clear();
+        delta.begin_object();
+        delta.key("keyframe").value(_keyframe_seq);
+        delta.key("delta").begin_object();
+
+        if (_mono_time < _keyframe_time and _telem_delta.diff(json.view(), delta))
+        {
+            delta.end_object();
+            delta.end_object();
+
+            ABORT_ON_FAILURE(
+                _telem_socket.send_frame(delta.view()),
+                "UdpSocket::send_frame() failed",
+                result::failure
+            );
+
+            return result::success;
+        }
+
+        _telem_delta.set_keyframe(json.view());
+        _keyframe_seq = _telem_seq;
+        _keyframe_time = _mono_time + _keyframe_period;
+    }
+
+    ABORT_ON_FAILURE(
+        _telem_socket.send_frame(json.view()),
+        "UdpSocket::send_frame() failed",
+        result::failure
+    );
+
+    return result::success;
+}
+
+
+void
+CameraControl::
+_begin_response(std::string_view message)
+{
+    auto & out = _command_response;
+    out.last_accepted_id = _last_accepted_command_id;
+    out.last_rejected_id = _last_rejected_command_id;
+    out.message = message;
+    out.loading = _sequence_loader.busy();
+    out.loading_id = _loading_command_id;
+    out.loading_percent = _loading_percent;
+    out.has_data = false;
+}
+
+
+void
+CameraControl::
+_accept(std::uint32_t cmd_id)
+{
+    _last_accepted_command_id = cmd_id;
+    _begin_response(_last_rejected_message);
+}
+
+
+void
+CameraControl::
+_reject(std::uint32_t cmd_id, std::string_view message, bool remember)
+{
+    _last_rejected_command_id = cmd_id;
+    if (remember)
+    {
+        _last_rejected_message = message;
+    }
+    _begin_response(message);
+}
+
+
+std::string_view
+CameraControl::
+_format(std::string_view pattern, std::string_view arg)
+{
+    static constexpr std::string_view ARG = "{arg}";
+    static constexpr std::string_view COMMAND = "{command}";
+
+    _command_message.clear();
+
+    while (not pattern.empty())
+    {
+        const auto brace = pattern.find('{');
+        _command_message.append(pattern.substr(0, brace));
+        if (brace == std::string_view::npos)
+        {
+            break;
+        }
+        pattern.remove_prefix(brace);
+
+        if (pattern.starts_with(ARG))
+        {
+            _command_message.append(arg);
+            pattern.remove_prefix(ARG.size());
+        }
+        else if (pattern.starts_with(COMMAND))
+        {
+            _command_message.append(_command_text);
+            pattern.remove_prefix(COMMAND.size());
+        }
+        else
+        {
+            _command_message.push_back('{');
+            pattern.remove_prefix(1);
+        }
+    }
+
+    return _command_message;
+}
+
+
+template <typename... Text>
+std::string_view
+CameraControl::
+_message(const Text & ... text)
+{
+    _command_message.clear();
+    (_command_message.append(text), ...);
+    return _command_message;
+}
+
+
+//-----------------------------------------------------------------------------
+// Commands, their arguments in order and the reject when one doesn't parse,
+// see CommandTable.h.
+//
+namespace
+{
+    constexpr ArgSpec SET_CAMERA_ID_ARGS[] = {
+        {"serial", ArgType::string},
+        {"id", ArgType::string},
+    };
+
+    constexpr ArgSpec LOAD_SEQUENCE_ARGS[] = {
+        {"filename", ArgType::rest},
+    };
+
+    constexpr ArgSpec READ_CHOICES_ARGS[] = {
+        {"serial", ArgType::string},
+        {"property", ArgType::string},
+    };
+
+    constexpr ArgSpec SET_CHOICE_ARGS[] = {
+        {"serial", ArgType::string},
+        {"property", ArgType::string},
+        {"value", ArgType::rest},
+    };
+
+    constexpr ArgSpec TIMELAPSE_UPDATE_ARGS[] = {
+        {"serial", ArgType::serial},
+        {"interval", ArgType::f32},
+        {"min_shutter", ArgType::string},
+        {"max_shutter", ArgType::string},
+        {"min_iso", ArgType::string},
+        {"max_iso", ArgType::string},
+        {"min_hist_mask", ArgType::i32},
+        {"max_hist_mask", ArgType::i32},
+        {"min_deadband", ArgType::i32},
+        {"max_deadband", ArgType::i32},
+        {"target_offset", ArgType::i32},
+        {"target_percent", ArgType::f32},
+    };
+
+    constexpr ArgSpec SERIAL_ARGS[] = {
+        {"serial", ArgType::serial},
+    };
+
+    constexpr ArgSpec CALIBRATE_TRIGGER_ARGS[] = {
+        {"serial", ArgType::string},
+        {"shots", ArgType::count},
+    };
+}
+
+
+result
+CameraControl::
+_read_commands(bool & got_message, State & next_state)
+{
+    got_message = false;
+
+    ABORT_ON_FAILURE(
+        _command_socket.recv_all(_command_batch, _command_count),
+        "UdpSocket::recv_all() failed",
+        result::failure
+    );
+
+    for (std::size_t i = 0; i < _command_count; ++i)
+    {
+        const auto & command = _command_batch[i];
+
+        if (command.utc_ns > 0)
+        {
+            _command_queue.add(_clock.monotonic_ns() + _system_offset_ns - command.utc_ns);
+        }
+
+        // A load_sequence read just before is done already without a loader
+        // thread, it's swapped in before the next command.
+        if (i > 0)
+        {
+            _answer_sequence_load(got_message);
+        }
+
+        // A response only holds the last command's, the one before goes out
+        // before the next is read.
+        _flush_response(got_message);
+
+        _read_command(command.data, got_message, next_state);
+    }
+
+    return result::success;
+}
+
+
+void
+CameraControl::
+_flush_response(bool & got_message)
+{
+    if (not got_message)
+    {
+        return;
+    }
+
+    if (result::failure == _send_telemetry())
+    {
+        ERROR_LOG << "_send_telemetry() failed, ignoring" << std::endl;
+    }
+    got_message = false;
+}
+
+
+void
+CameraControl::
+_read_command(std::string_view text, bool & got_message, State & next_state)
+{
+    using Spec = CommandSpec<CommandHandler>;
+
+    static constexpr CommandTable commands {std::array{
+        Spec{"set_camera_id", &CameraControl::_set_camera_id, SET_CAMERA_ID_ARGS,
+             "Got bad camera rename message: '{command}'", false},
+        Spec{"set_events", &CameraControl::_set_events},
+        Spec{"load_sequence", &CameraControl::_load_sequence, LOAD_SEQUENCE_ARGS,
+             "failed to parse command '{command}'", false},
+        Spec{"read_choices", &CameraControl::_read_choices, READ_CHOICES_ARGS,
+             "Failed to parse read_choices command: '{command}'", false},
+        Spec{"set_choice", &CameraControl::_set_choice, SET_CHOICE_ARGS,
+             "Failed to parse set_choice command: '{command}'"},
+        Spec{"timelapse_enable", &CameraControl::_timelapse_enable},
+        Spec{"timelapse_update", &CameraControl::_timelapse_update, TIMELAPSE_UPDATE_ARGS,
+             "Failed to parse timelapse {arg} from: '{command}'"},
+        Spec{"timelapse_start", &CameraControl::_timelapse_start},
+        Spec{"timelapse_stop", &CameraControl::_timelapse_stop},
+        Spec{"timelapse_disable", &CameraControl::_timelapse_disable},
+        Spec{"trigger", &CameraControl::_trigger, SERIAL_ARGS,
+             "Failed to parse trigger command: '{command}'"},
+        // A missing serial is one that doesn't exist.
+        Spec{"read_config", &CameraControl::_read_config, SERIAL_ARGS,
+             "serial '' does not exist"},
+        Spec{"calibrate_trigger", &CameraControl::_calibrate_trigger, CALIBRATE_TRIGGER_ARGS,
+             "Failed to parse calibrate_trigger command: '{command}'"},
+        Spec{"telem_keyframe", &CameraControl::_telem_keyframe},
+        Spec{"reset_sequence", &CameraControl::_reset_sequence},
+        Spec{"clock_sync", &CameraControl::_clock_sync},
+    }};
+
+    _command_text = text;
+
+    // Up to any NUL, less extraneous whitespace.
+    const auto line = stripped(stripped(text.substr(0, text.find('\0')), ' '), '\n');
+
+    Tokenizer tok(line);
+    std::uint32_t cmd_id = 0;
+    std::string_view command;
+
+    if (not tok.next(cmd_id))
+    {
+        _reject(_last_rejected_command_id + 1, _format("failed to parse command ID from '{command}'"), false);
+        got_message = true;
+        return;
+    }
+
+    if (not tok.next(command))
+    {
+        _reject(cmd_id, _format("failed to parse command from '{command}'"), false);
+        got_message = true;
+        return;
+    }
+
+    // Nothing new to process.  A load answered late can take the accepted id
+    // back, so the last command read counts too.  How do we handle cmd_id
+    // rollover?
+    if (cmd_id <= std::max({_last_accepted_command_id, _last_rejected_command_id, _last_command_id}))
+    {
+        return;
+    }
+
+    DEBUG_LOG << "read_command(): control_time: " << _control_time << " cmd: '" << text << "'" << std::endl;
+
+    // We have a message, reset the send time so there's no latency to
+    // responding to commands.
+    got_message = true;
+
+    // Resending the load in progress is expected while waiting for it.
+    if (_sequence_loader.busy() and cmd_id == _loading_command_id)
+    {
+        got_message = false;
+        return;
+    }
+
+    _last_command_id = cmd_id;
+
+    const auto * spec = commands.find(command);
+    if (not spec)
+    {
+        _reject(cmd_id, _message("Unknown command: '", command, "', ignorning"));
+        ERROR_LOG << _last_rejected_message << std::endl;
+        return;
+    }
+
+    // The load in progress is swapped in over the sequence and the event
+    // times, commands that change those wait until it's done.  The rest carry
+    // on as usual.
+    const auto handler = spec->handler;
+    if (_sequence_loader.busy() and (
+            handler == &CameraControl::_load_sequence or
+            handler == &CameraControl::_set_events or
+            handler == &CameraControl::_set_camera_id or
+            handler == &CameraControl::_reset_sequence))
+    {
+        _reject(cmd_id, "a sequence file is still loading");
+        return;
+    }
+
+    CommandArgs args;
+    for (std::size_t i = 0; i < spec->args.size(); ++i)
+    {
+        const auto & [name, type] = spec->args[i];
+        if (not parse_arg(tok, type, args[i]))
+        {
+            _reject(cmd_id, _format(spec->parse_error, name), spec->remember);
+            return;
+        }
+
+        if (type == ArgType::serial and not _cameras.contains(args[i].text))
+        {
+            _reject(cmd_id, _message("serial '", args[i].text, "' does not exist"), spec->remember);
+            return;
+        }
+    }
+
+    (this->*spec->handler)(cmd_id, args, tok, next_state);
+}
+
+
+//-----------------------------------------------------------------------------
+// set_camera_id
+//
+void
+CameraControl::
+_set_camera_id(std::uint32_t cmd_id, const CommandArgs & args, Tokenizer &, State &)
+{
+    const auto serial = args[0].text;
+    const auto cam_id = args[1].text;
+
+    if (not _cameras.contains(serial))
+    {
+        _reject(cmd_id, _message("serial '", serial, "' does not exist"), false);
+        return;
+    }
+
+    if (_id_to_serial.contains(cam_id))
+    {
+        _reject(cmd_id, _message("id '", cam_id, "' already exists"));
+        return;
+    }
+
+    INFO_LOG << "mapping serial " << serial << " to " << cam_id << "\n";
+
+    // First, remove any previous name.
+    auto & id = _serial_to_id[Serial(serial)];
+    _id_to_serial.erase(id);
+
+    // Update with the new id.
+    id = cam_id;
+    _id_to_serial[id] = serial;
+
+    _compile_timeline();
+
+    _accept(cmd_id);
+}
+
+
+//-----------------------------------------------------------------------------
+// set_events
+//
+// Pairs of event id and time to the end of the command.
+//
+void
+CameraControl::
+_set_events(std::uint32_t cmd_id, const CommandArgs &, Tokenizer & tok, State &)
+{
+    auto new_event_map = event_map();
+    while (not tok.eof())
+    {
+        std::string_view event_id;
+        milliseconds timestamp;
+
+        if (not (tok.next(event_id) and tok.next(timestamp)))
+        {
+            _reject(cmd_id, _format("failed to parse events from '{command}'"));
+            return;
+        }
+
+        new_event_map[std::string(event_id)] = timestamp;
+    }
+
+    // All good, update the event map!
+    _event_map = new_event_map;
+
+    _compile_timeline();
+
+    _accept(cmd_id);
+}
+
+
+//-----------------------------------------------------------------------------
+// load_sequence
+//
+void
+CameraControl::
+_load_sequence(std::uint32_t cmd_id, const CommandArgs & args, Tokenizer &, State &)
+{
+    // Read and compile the file off the control thread, the command is
+    // answered when the result is swapped in.
+    auto request = std::make_unique<SequenceLoad>();
+    request->cmd_id = cmd_id;
+    request->filename = args[0].text;
+    request->event_times = _event_map;
+    request->cameras = _timeline_cameras();
+    request->generation = _timeline_generation;
+    request->models = _camera_models;
+
+    if (_background_loading)
+    {
+        _sequence_loader.start_thread();
+    }
+
+    // Can't fail, another load is refused while one is in progress.
+    _sequence_loader.load(std::move(request));
+
+    _loading_command_id = cmd_id;
+    _set_loading_response(0);
+}
+
+
+//-----------------------------------------------------------------------------
+// read_choices
+//
+void
+CameraControl::
+_read_choices(std::uint32_t cmd_id, const CommandArgs & args, Tokenizer &, State &)
+{
+    const auto serial = args[0].text;
+    const auto property = args[1].text;
+
+    const auto camera = _cameras.find(serial);
+    if (camera == _cameras.end())
+    {
+        _reject(cmd_id, _message("serial '", serial, "' does not exist"), false);
+        return;
+    }
+
+    if (_choices_command_id != 0)
+    {
+        _reject(cmd_id, "choices are still being read");
+        return;
+    }
+
+    auto & cam = *camera->second;
+    if (result::failure == cam.request_choices(std::string(property)))
+    {
+        _reject(cmd_id, "the camera's USB queue is full");
+        return;
+    }
+
+    // Answered once the worker is done.
+    if (cam.choices_pending() > 0)
+    {
+        _choices_command_id = cmd_id;
+        _choices_serial = serial;
+        _choices_property = property;
+        return;
+    }
+
+    _respond_choices(cmd_id, cam, property);
+}
+
+
+void
+CameraControl::
+_respond_choices(std::uint32_t cmd_id, const Camera & camera, std::string_view property)
+{
+    const auto choice_vec = camera.read_choices(std::string(property));
+
+    // If the vector is empty, probably doesn't exist.
+    if (choice_vec.empty())
+    {
+        _reject(cmd_id, _message("property '", property, "' does not exist"));
+        return;
+    }
+
+    _last_accepted_command_id = cmd_id;
+    _begin_response(_last_rejected_message);
+    _command_response.has_data = true;
+    _command_response.data = choice_vec;
+}
+
+
+void
+CameraControl::
+_answer_read_choices(bool & got_message)
+{
+    if (_choices_command_id == 0)
+    {
+        return;
+    }
+
+    // Cameras are never removed, only disconnected.
+    const auto & camera = *_cameras.at(_choices_serial);
+    if (camera.choices_pending() > 0)
+    {
+        return;
+    }
+
+    // Another command's response goes out before this one's.
+    if (_last_command_id != _choices_command_id)
+    {
+        _flush_response(got_message);
+    }
+
+    _respond_choices(_choices_command_id, camera, _choices_property);
+    _choices_command_id = 0;
+    got_message = true;
+}
+
+
+//-----------------------------------------------------------------------------
+// set_choice
+//
+void
+CameraControl::
+_set_choice(std::uint32_t cmd_id, const CommandArgs & args, Tokenizer &, State &)
+{
+    const auto serial = args[0].text;
+    const auto property = args[1].text;
+    const auto value = args[2].text;
+
+    const auto camera = _cameras.find(serial);
+    if (camera == _cameras.end())
+    {
+        _reject(cmd_id, _message("serial '", serial, "' does not exist"));
+        return;
+    }
+
+    auto & cam = *camera->second;
+
+    INFO_LOG << "setting '" << property << "' to '" << value << "'" << std::endl;
+
+    if (result::failure == cam.write_property(std::string(property), std::string(value)))
+    {
+        _reject(cmd_id, _message("property '", property, "' does not exist"));
+        return;
+    }
+
+    if (result::failure == cam.write_config())
+    {
+        _reject(cmd_id, _message("writing '", property, "' with '", value, "' failed"));
+        return;
+    }
+
+    _accept(cmd_id);
+}
+
+
+//-----------------------------------------------------------------------------
+// timelapse_enable, timelapse_start, timelapse_stop and timelapse_disable
+//
+void
+CameraControl::
+_timelapse_enable(std::uint32_t cmd_id, const CommandArgs &, Tokenizer &, State & next_state)
+{
+    switch (_state)
+    {
+        // If we're already running, ingore, probably due to webapp UI
+        // reloading.
+        // TODO: We should fix the webapp instead.
+        case CameraControl::State::timelapse_running:
+        {
+            next_state = CameraControl::State::timelapse_running;
+            break;
+        }
+        default:
+        {
+            next_state = CameraControl::State::timelapse_idle;
+        }
+    }
+    _accept(cmd_id);
+}
+
+
+void
+CameraControl::
+_timelapse_start(std::uint32_t cmd_id, const CommandArgs &, Tokenizer &, State & next_state)
+{
+    next_state = CameraControl::State::timelapse_running;
+    _accept(cmd_id);
+}
+
+
+void
+CameraControl::
+_timelapse_stop(std::uint32_t cmd_id, const CommandArgs &, Tokenizer &, State & next_state)
+{
+    next_state = CameraControl::State::timelapse_idle;
+    _accept(cmd_id);
+}
+
+
+void
+CameraControl::
+_timelapse_disable(std::uint32_t cmd_id, const CommandArgs &, Tokenizer &, State & next_state)
+{
+    // reset capture count.
+    next_state = CameraControl::State::monitor;
+    _accept(cmd_id);
+}
+
+
+//-----------------------------------------------------------------------------
+// timelapse_update
+//
+void
+CameraControl::
+_timelapse_update(std::uint32_t cmd_id, const CommandArgs & args, Tokenizer &, State &)
+{
+    const auto target_percent = args[11].real;
+    if (target_percent < 0.0f or target_percent > 1.0f)
+    {
+        // As std::ostream writes a float.
+        char number[32];
+        const auto end = std::to_chars(
+            number,
+            number + sizeof(number),
+            target_percent,
+            std::chars_format::general,
+            6
+        ).ptr;
+        _reject(cmd_id, _message("Bad target_percent: ", std::string_view(number, end - number)));
+        return;
+    }
+
+    _timelapse_serial = args[0].text;
+    const auto & camera = _cameras.find(_timelapse_serial)->second;
+
+    // Interval is in seconds, so scale it to milliseconds.
+    _timelapse_interval = static_cast<milliseconds>(args[1].real * 1000.0f);
+
+    _timelapse_min_shutter = camera->shutter_speed(std::string(args[2].text));
+    _timelapse_max_shutter = camera->shutter_speed(std::string(args[3].text));
+    _timelapse_min_iso = camera->iso(std::string(args[4].text));
+    _timelapse_max_iso = camera->iso(std::string(args[5].text));
+    _timelapse_min_hist_mask = args[6].i32();
+    _timelapse_max_hist_mask = args[7].i32();
+    _timelapse_min_deadband = args[8].i32();
+    _timelapse_max_deadband = args[9].i32();
+    _timelapse_target_offset = args[10].i32();
+    _timelapse_target_percent = target_percent;
+
+    _accept(cmd_id);
+}
+
+
+//-----------------------------------------------------------------------------
+// trigger
+//
+void
+CameraControl::
+_trigger(std::uint32_t cmd_id, const CommandArgs & args, Tokenizer &, State &)
+{
+    _trigger_serial = args[0].text;
+
+    switch (_state)
+    {
+        case CameraControl::State::timelapse_idle:
+        case CameraControl::State::timelapse_running:
+        {
+            _trigger_type = TriggerType::histogram;
+            break;
+        }
+        default:
+        {
+            _trigger_type = TriggerType::trigger;
+            break;
+        }
+    }
+
+    _accept(cmd_id);
+}
+
+
+//-----------------------------------------------------------------------------
+// read_config
+//
+void
+CameraControl::
+_read_config(std::uint32_t cmd_id, const CommandArgs & args, Tokenizer &, State &)
+{
+    const auto serial = args[0].text;
+
+    if (result::failure == _cameras.find(serial)->second->read_config())
+    {
+        _reject(cmd_id, _message("reading the config of '", serial, "' failed"));
+        return;
+    }
+
+    _accept(cmd_id);
+}
+
+
+//-----------------------------------------------------------------------------
+// calibrate_trigger
+//
+void
+CameraControl::
+_calibrate_trigger(std::uint32_t cmd_id, const CommandArgs & args, Tokenizer &, State &)
+{
+    const auto serial = args[0].text;
+
+    const auto camera = _cameras.find(serial);
+    if (camera == _cameras.end())
+    {
+        _reject(cmd_id, _message("serial '", serial, "' does not exist"));
+        return;
+    }
+
+    if (result::failure == camera->second->calibrate_trigger(args[1].u32()))
+    {
+        _reject(cmd_id, _message("failed to start trigger calibration on '", serial, "'"));
+        return;
+    }
+
+    _calibrating.insert(camera->first);
+    _accept(cmd_id);
+}
+
+
+//-----------------------------------------------------------------------------
+// telem_keyframe
+//
+// The next telemetry is a keyframe.
+//
+void
+CameraControl::
+_telem_keyframe(std::uint32_t cmd_id, const CommandArgs &, Tokenizer &, State &)
+{
+    _telem_delta.clear();
+    _accept(cmd_id);
+}
+
+
+//-----------------------------------------------------------------------------
+// reset_sequence
+//
+// A loaded sequence is reset when it's swapped in, see
+// _collect_sequence_load().
+//
+void
+CameraControl::
+_reset_sequence(std::uint32_t cmd_id, const CommandArgs &, Tokenizer &, State &)
+{
+    // Events in the past stay dispatched.
+    for (auto & [id, cam_seq] : _sequence_map)
+    {
+        cam_seq->reset(_control_time);
+    }
+    _timeline.reset(_control_time);
+
+    for (const auto & lane : _timeline.lanes())
+    {
+        lane.camera->late_policy().rewind();
+    }
+
+    _accept(cmd_id);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// clock_sync
+//
+// Applies a held clock step, pending events move to the new UTC time.  Those
+// now in the past are late, see late_policy, or follow with reset_sequence to
+// skip them.
+//
+void
+CameraControl::
+_clock_sync(std::uint32_t cmd_id, const CommandArgs &, Tokenizer &, State &)
+{
+    if (_utc_offset_ns != _system_offset_ns)
+    {
+        INFO_LOG << "applying clock step of "
+                 << (_system_offset_ns - _utc_offset_ns) / 1'000'000 << " ms" << std::endl;
+        _utc_offset_ns = _system_offset_ns;
+        _control_time = _mono_time + _utc_offset_ns / 1'000'000;
+    }
+    _accept(cmd_id);
+}
+
+
+SequenceLoad::camera_ids
+CameraControl::
+_timeline_cameras() const
+{
+    SequenceLoad::camera_ids cameras;
+    for (const auto & [serial, cam_ptr] : _cameras)
+    {
+        if (not cam_ptr->info().connected)
+        {
+            continue;
+        }
+        const auto & id = _serial_to_id.find(serial);
+        if (id == _serial_to_id.end())
+        {
+            continue;
+        }
+        cameras.emplace_back(cam_ptr, id->second);
+    }
+    return cameras;
+}
+
+
+void
+CameraControl::
+_compile_timeline()
+{
+    ++_timeline_generation;
+
+    for (auto & [_, seq] : _sequence_map)
+    {
+        seq->compile(_event_map);
+    }
+
+    std::vector<EventTimeline::Lane> lanes;
+    for (const auto & [cam_ptr, id] : _timeline_cameras())
+    {
+        const auto & seq = _sequence_map.find(id);
+        if (seq == _sequence_map.end())
+        {
+            continue;
+        }
+        lanes.push_back(EventTimeline::Lane{cam_ptr, seq->second});
+    }
+
+    _timeline.compile(std::move(lanes));
+    _lane_blocked.resize(_timeline.lanes().size());
+
+    // The times being compressed have moved.
+    for (const auto & lane : _timeline.lanes())
+    {
+        lane.camera->late_policy().rewind();
+    }
+}
+
+
+void
+CameraControl::
+_set_loading_response(std::uint32_t percent)
+{
+    _loading_percent = percent;
+
+    _begin_response(_last_rejected_message);
+}
+
+
+bool
+CameraControl::
+_collect_sequence_load()
+{
+    if (not _sequence_loader.busy())
+    {
+        return false;
+    }
+
+    auto loaded = _sequence_loader.poll();
+    if (not loaded)
     {
-        std::string serial;
-        std::string property;
-        std::string value;
-        if (not ((iss >> serial >> property) and (std::getline(iss, value))))
+        const auto percent = _sequence_loader.percent();
+        if (percent != _loading_percent)
         {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "Failed to parse set_choice command: '" << _command_buffer << "'";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
+            _set_loading_response(percent);
         }
+        return false;
+    }
 
-        if (not _cameras.contains(serial))
-        {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "serial '" << serial << "' does not exist";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
-        }
-        strip(value, ' ');
+    if (loaded->res == result::failure)
+    {
+        _reject(loaded->cmd_id, loaded->message);
+        _sequence_loader.recycle(std::move(loaded));
+        return true;
+    }
 
-        auto cam = _cameras[serial];
+    // Swap in the new sequence, the old one goes back to the loader to free.
+    std::swap(_sequence_filename, loaded->filename);
+    std::swap(_sequence_map, loaded->sequences);
+    std::swap(_timeline, loaded->timeline);
+    std::swap(_predictions, loaded->predictions);
 
-        INFO_LOG << "setting '" << property << "' to '" << value << "'" << std::endl;
+    // The event times or cameras changed while it loaded.
+    if (loaded->generation != _timeline_generation)
+    {
+        _compile_timeline();
+    }
+    _lane_blocked.resize(_timeline.lanes().size());
 
-        if (result::failure == cam->write_property(property, value))
-        {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "property '" << property << "' does not exist";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
-        }
+    // The new sequence sets its own late policies.
+    for (auto & [_, cam_ptr] : _cameras)
+    {
+        cam_ptr->late_policy().set(_late_policy.mode(), _late_policy.late_ms());
+        cam_ptr->late_policy().rewind();
+    }
 
-        if (result::failure == cam->write_config())
-        {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "writing '" << property << "' with '" << value << "' failed";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
-        }
+    // Events in the past stay dispatched.
+    for (auto & [id, cam_seq] : _sequence_map)
+    {
+        cam_seq->reset(_control_time);
+    }
+    _timeline.reset(_control_time);
 
-        _last_accepted_command_id = cmd_id;
-        oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-            << ",\"last_rejected_id\":" << _last_rejected_command_id
-            << ",\"message\":\"" << _last_rejected_message << "\"}";
-        _command_response = oss.str();
-        return result::success;
+    _accept(loaded->cmd_id);
+    _sequence_loader.recycle(std::move(loaded));
+
+    return true;
+}
+
+
+void
+CameraControl::
+_answer_sequence_load(bool & got_message)
+{
+    if (not _sequence_loader.busy())
+    {
+        return;
     }
-    else if (command == "timelapse_enable")
+
+    // Another command's response goes out before the load's, the load's own
+    // progress is superseded.
+    if (_last_command_id != _loading_command_id)
     {
-        switch (_state)
-        {
-            // If we're already running, ingore, probably due to webapp UI
-            // reloading.
-            // TODO: We should fix the webapp instead.
-            case CameraControl::State::timelapse_running:
-            {
-                next_state = CameraControl::State::timelapse_running;
-                break;
-            }
-            default:
-            {
-                next_state = CameraControl::State::timelapse_idle;
-            }
-        }
-        _last_accepted_command_id = cmd_id;
-        oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-            << ",\"last_rejected_id\":" << _last_rejected_command_id
-            << ",\"message\":\"" << _last_rejected_message << "\"}";
-        _command_response = oss.str();
-        return result::success;
+        _flush_response(got_message);
     }
-    else if (command == "timelapse_update")
+
+    if (_collect_sequence_load())
     {
-        if (not (iss >> _timelapse_serial))
-        {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "Failed to parse timelapse serial from: '" << _command_buffer << "'";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
-        }
+        got_message = true;
+    }
+}
 
-        if (not _cameras.contains(_timelapse_serial))
-        {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "serial '" << _timelapse_serial << "' does not exist";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
-        }
-        auto camera = _cameras[_timelapse_serial];
 
-        float interval;
-        if (not (iss >> interval))
-        {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "Failed to parse timelapse interval from: '" << _command_buffer << "'";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
-        }
+milliseconds
+CameraControl::
+_get_next_event_time() const
+{
+    // Event times are UTC, the scheduler runs on monotonic time.
+    if (_timeline.empty())
+    {
+        return MAX_TIME;
+    }
+    return _timeline.front().time - _utc_offset_ns / 1'000'000;
+}
 
-        std::string min_shutter;
-        std::string max_shutter;
-        std::string min_iso;
-        std::string max_iso;
 
-        if (not (iss >> min_shutter))
-        {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "Failed to parse timelapse min_shutter from: '" << _command_buffer << "'";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
-        }
+milliseconds
+CameraControl::
+_max_trigger_lead_ms() const
+{
+    milliseconds max_lead_ms = 0;
+    for (const auto & lane : _timeline.lanes())
+    {
+        max_lead_ms = std::max(max_lead_ms, lane.camera->trigger_latency().lead_ns() / 1'000'000);
+    }
+    return max_lead_ms;
+}
 
-        if (not (iss >> max_shutter))
-        {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "Failed to parse timelapse max_shutter from: '" << _command_buffer << "'";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
-        }
 
-        if (not (iss >> min_iso))
-        {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "Failed to parse timelapse min_iso from: '" << _command_buffer << "'";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
-        }
+result
+CameraControl::
+_dispatch_camera_events()
+{
+    // Triggers due at the same time share a gate so the camera workers fire
+    // them together.
+    using gate_ptr = std::shared_ptr<TriggerGate>;
+    _tick_gates.clear();
 
-        if (not (iss >> max_iso))
-        {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "Failed to parse timelapse max_iso from: '" << _command_buffer << "'";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
-        }
+    const bool fanout = _camera_workers and _trigger_fanout;
 
-        int min_hist_mask;
-        int max_hist_mask;
+    // Events due before the next dispatch are handled now, triggers wait for
+    // their deadline so they aren't up to a period late.  Only a camera worker
+    // waits, without one the wait would stall the control loop.
+    const bool precise = _camera_workers and _control_period > 0;
+    const auto horizon = _mono_time + (precise ? _control_period : 0);
 
-        if (not (iss >> min_hist_mask))
+    auto gate_for = [this](milliseconds event_time) -> const gate_ptr &
+    {
+        for (const auto & [time, gate] : _tick_gates)
         {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "Failed to parse timelapse min_hist_mask from: '" << _command_buffer << "'";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
+            if (time == event_time) return gate;
         }
+        _tick_gates.emplace_back(event_time, _acquire_trigger_gate());
+        return _tick_gates.back().second;
+    };
 
-        if (not (iss >> max_hist_mask))
-        {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "Failed to parse timelapse max_hist_mask from: '" << _command_buffer << "'";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
-        }
+    // Triggers go out early by their camera's learned latency, look ahead by
+    // the largest.
+    const auto max_lead_ms = precise ? _max_trigger_lead_ms() : 0;
+
+    std::fill(_lane_blocked.begin(), _lane_blocked.end(), 0);
 
-        int min_deadband;
-        int max_deadband;
+    const auto utc_offset_ms = _utc_offset_ns / 1'000'000;
 
-        if (not (iss >> min_deadband))
+    for (const auto & entry : _timeline)
+    {
+        const auto event_time = entry.time - utc_offset_ms;
+        if (event_time - max_lead_ms > horizon)
         {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "Failed to parse timelapse min_deadband from: '" << _command_buffer << "'";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
+            break;
         }
 
-        if (not (iss >> max_deadband))
+        const auto & [cam_ptr, seq] = _timeline.lane(entry.lane);
+        if (seq->done(entry.idx) or _lane_blocked[entry.lane])
         {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "Failed to parse timelapse max_deadband from: '" << _command_buffer << "'";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
+            continue;
         }
 
-        int target_offset;
-        float target_percent;
+        const auto & event = seq->event(entry.idx);
+        const bool is_trigger = event.channel == Channel::trigger;
+        const auto latency_ms = cam_ptr->trigger_latency().lead_ns() / 1'000'000;
+        const auto lead_ms = precise and is_trigger ? latency_ms : 0;
+
+        // Triggers being compressed come due later than scheduled.
+        auto & policy = cam_ptr->late_policy();
+        const auto due = is_trigger ? policy.due(entry.time) : entry.time;
+        const auto due_time = due - utc_offset_ms;
 
-        if (not (iss >> target_offset))
+        // A camera's events go out in order, one not yet due holds back the
+        // rest of the camera's events.
+        if (due_time - lead_ms > horizon)
         {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "Failed to parse timelapse target_offset from: '" << _command_buffer << "'";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
+            _lane_blocked[entry.lane] = 1;
+            continue;
         }
 
-        if (not (iss >> target_percent))
+        // The camera won't fire before the USB jobs it still has queued.
+        // Without workers the triggers before this one blocked, so the clock
+        // is read again rather than trusting the start of the tick.
+        if (is_trigger)
         {
-            _last_rejected_command_id = cmd_id;
+            const auto now_ms = _clock.monotonic_ns() / 1'000'000;
+            const auto queued_ms = static_cast<milliseconds>(cam_ptr->pending()) * latency_ms;
+            const auto fire_time = std::max(due_time, now_ms + queued_ms);
+
+            if (not policy.admit(entry.time, fire_time + utc_offset_ms, seq->last_trigger_time()))
             {
-                std::ostringstream msg_oss;
-                msg_oss << "Failed to parse timelapse target_percent from: '" << _command_buffer << "'";
-                _last_rejected_message = msg_oss.str();
+                seq->set_done(entry.idx);
+                continue;
             }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
         }
 
-        if (target_percent < 0.0f or target_percent > 1.0f)
+        // Execute the camera event.
+        result res1;
+        if (is_trigger and (precise or fanout))
         {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "Bad target_percent: " << target_percent;
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
+            const auto deadline_ns = precise ? due * 1'000'000 - _utc_offset_ns : 0;
+            res1 = cam_ptr->trigger(
+                deadline_ns,
+                fanout ? gate_for(due_time) : nullptr
+            );
         }
-
-        // Interval is in seconds, so scale it to milliseconds.
-        _timelapse_interval = static_cast<milliseconds>(interval * 1000.0f);
-
-        _timelapse_min_shutter = camera->shutter_speed(min_shutter);
-        _timelapse_max_shutter = camera->shutter_speed(max_shutter);
-        _timelapse_min_iso = camera->iso(min_iso);
-        _timelapse_max_iso = camera->iso(max_iso);
-        _timelapse_min_hist_mask = min_hist_mask;
-        _timelapse_max_hist_mask = max_hist_mask;
-        _timelapse_min_deadband = min_deadband;
-        _timelapse_max_deadband = max_deadband;
-        _timelapse_target_offset = target_offset;
-        _timelapse_target_percent = target_percent;
-
-        next_state = _state;
-        _last_accepted_command_id = cmd_id;
-        oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-            << ",\"last_rejected_id\":" << _last_rejected_command_id
-            << ",\"message\":\"" << _last_rejected_message << "\"}";
-        _command_response = oss.str();
-        return result::success;
-    }
-    else if (command == "timelapse_start")
-    {
-        next_state = CameraControl::State::timelapse_running;
-        _last_accepted_command_id = cmd_id;
-        oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-            << ",\"last_rejected_id\":" << _last_rejected_command_id
-            << ",\"message\":\"" << _last_rejected_message << "\"}";
-        _command_response = oss.str();
-        return result::success;
-    }
-    else if (command == "timelapse_stop")
-    {
-        next_state = CameraControl::State::timelapse_idle;
-        _last_accepted_command_id = cmd_id;
-        oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-            << ",\"last_rejected_id\":" << _last_rejected_command_id
-            << ",\"message\":\"" << _last_rejected_message << "\"}";
-        _command_response = oss.str();
-        return result::success;
-    }
-    else if (command == "timelapse_disable")
-    {
-        // reset capture count.
-        next_state = CameraControl::State::monitor;
-        _last_accepted_command_id = cmd_id;
-        oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-            << ",\"last_rejected_id\":" << _last_rejected_command_id
-            << ",\"message\":\"" << _last_rejected_message << "\"}";
-        _command_response = oss.str();
-        return result::success;
-    }
-    else if (command == "trigger")
-    {
-        std::string serial;
-        if (not (iss >> serial))
+        else
         {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "Failed to parse trigger command: '" << _command_buffer << "'";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
+            res1 = cam_ptr->handle(event);
         }
 
-        if (not _cameras.contains(serial))
+        if (res1 == result::failure)
         {
-            _last_rejected_command_id = cmd_id;
-            {
-                std::ostringstream msg_oss;
-                msg_oss << "serial '" << serial << "' does not exist";
-                _last_rejected_message = msg_oss.str();
-            }
-            oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-                << ",\"last_rejected_id\":" << _last_rejected_command_id
-                << ",\"message\":\"" << _last_rejected_message << "\"}";
-            _command_response = oss.str();
-            return result::success;
+            ERROR_LOG << "camera->handle(event) failed" << std::endl;
+            // TODO count camera errors and report to UI.
         }
-        _trigger_serial = serial;
 
-        switch (_state)
+        seq->set_done(entry.idx);
+
+        // Flush camera settings if the next event is a trigger.
+        const auto next = entry.idx + 1;
+        if (next < seq->size() and seq->event(next).channel == Channel::trigger)
         {
-            case CameraControl::State::timelapse_idle:
-            case CameraControl::State::timelapse_running:
-            {
-                _trigger_type = TriggerType::histogram;
-                break;
-            }
-            default:
+            auto res2 = cam_ptr->write_config();
+            if (res2 == result::failure)
             {
-                _trigger_type = TriggerType::trigger;
-                break;
+                ERROR_LOG << "camera->write-settings() failed" << std::endl;
+                // TODO count camera errors and report to UI.
             }
         }
-
-        _last_accepted_command_id = cmd_id;
-        oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-            << ",\"last_rejected_id\":" << _last_rejected_command_id
-            << ",\"message\":\"" << _last_rejected_message << "\"}";
-        _command_response = oss.str();
-        return result::success;
     }
 
-    // Unknown command error.
-    else if (command != "reset_sequence")
-    {
-        _last_rejected_command_id = cmd_id;
-        {
-            std::ostringstream msg_oss;
-            msg_oss << "Unknown command: '" << command << "', ignorning";
-            _last_rejected_message = msg_oss.str();
-        }
-        oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-            << ",\"last_rejected_id\":" << _last_rejected_command_id
-            << ",\"message\":\"" << _last_rejected_message << "\"}";
-        _command_response = oss.str();
-        ERROR_LOG << _last_rejected_message << std::endl;
-        return result::success;
-    }
+    _timeline.advance();
 
-    //-------------------------------------------------------------------------
-    // reset_sequence
-    //
-    // Note breaking up the if else chain so we can reset the sequence when a
-    // sequence file is loaded.
-    if (command == "reset_sequence")
+    // Every trigger is queued, let the workers through.
+    for (auto & [_, gate] : _tick_gates)
     {
-        for (auto & [id, cam_seq] : _sequence_map)
+        gate->close();
+        if (gate->size() > 0)
         {
-            cam_seq->reset();
-
-            // Pop off events that are in the past.
-            while (
-                not cam_seq->empty() and
-                _get_event_time(cam_seq->front()) < _control_time
-            )
-            {
-                cam_seq->pop();
-            }
+            _trigger_gates.push_back(std::move(gate));
         }
     }
+    _tick_gates.clear();
 
-    _last_accepted_command_id = cmd_id;
-    oss << "{\"last_accepted_id\":" << _last_accepted_command_id
-        << ",\"last_rejected_id\":" << _last_rejected_command_id
-        << ",\"message\":\"" << _last_rejected_message << "\"}";
-    _command_response = oss.str();
     return result::success;
 }
 
-milliseconds
+
+std::shared_ptr<TriggerGate>
 CameraControl::
-_get_event_time(const Event & event) const
+_acquire_trigger_gate()
 {
-    const auto & event_time_ms = _event_map.find(event.event_id);
-    if (event_time_ms != _event_map.end())
+    // Only the pool can hand a gate out, one it alone holds stays free.
+    for (const auto & gate : _trigger_gate_pool)
     {
-        return event_time_ms->second + event.event_time_offset_ms;
+        if (gate.use_count() == 1)
+        {
+            // Pairs with the release of the last worker's reference.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            gate->reset();
+            return gate;
+        }
     }
-    return MAX_TIME;
+
+    _trigger_gate_pool.push_back(std::make_shared<TriggerGate>());
+    return _trigger_gate_pool.back();
 }
 
-milliseconds
+
+void
 CameraControl::
-_get_next_event_time() const
+_collect_trigger_gates()
 {
-    milliseconds next_event = MAX_TIME;
-
-    for (const auto & [serial, cam_ptr] : _cameras)
+    auto itor = _trigger_gates.begin();
+    while (itor != _trigger_gates.end())
     {
-        if (not cam_ptr->info().connected)
+        const auto & gate = *itor;
+        if (not gate->complete())
         {
+            gate->expire();
+            ++itor;
             continue;
         }
-        const auto & id = _serial_to_id.find(serial);
-        if (id == _serial_to_id.end())
-        {
-            continue;
-        }
-        const auto & seq = _sequence_map.find(id->second);
-        if (seq == _sequence_map.end() or seq->second->empty())
+
+        ++_trigger_groups;
+        _trigger_group_size = gate->size();
+        _trigger_skew_ns = gate->skew_ns();
+        _trigger_max_skew_ns = std::max(_trigger_max_skew_ns, _trigger_skew_ns);
+        if (gate->timed_out())
         {
-            continue;
+            ++_trigger_timeouts;
         }
 
-        next_event = std::min(
-            next_event,
-            _get_event_time(seq->second->front())
-        );
-    }
+        INFO_LOG << "triggered " << _trigger_group_size << " cameras, skew "
+                 << _trigger_skew_ns / 1000 << " us" << std::endl;
 
-    return next_event;
+        itor = _trigger_gates.erase(itor);
+    }
 }
 
 
 result
 CameraControl::
-_dispatch_camera_events()
+_timelapse_dispatch()
 {
-    for (auto & [serial, cam_ptr] : _cameras)
+    auto itor = _cameras.find(_timelapse_serial);
+
+    // Time for the next capture?
+    if (_timelapse_time <= _mono_time)
     {
-        const auto & id = _serial_to_id.find(serial);
-        if (id == _serial_to_id.end())
+        if (_timelapse_time == 0)
         {
-            continue;
+            _timelapse_time = _mono_time;
         }
-        const auto & seq_itor = _sequence_map.find(id->second);
-        if (seq_itor == _sequence_map.end() or seq_itor->second->empty())
+        _timelapse_time += _timelapse_interval;
+
+        if (itor == _cameras.end())
         {
-            continue;
+            ERROR_LOG << "_timelapse_serial not found in _cameras, aborting" << std::endl;
+            return result::failure;
         }
 
-        auto & seq = seq_itor->second;
-
-        if (seq->empty())
+        // Still working on the previous capture, skip this interval.
+        if (itor->second->busy())
         {
-            continue;
+            ERROR_LOG << "camera busy, skipping timelapse capture" << std::endl;
+            return result::success;
         }
 
-        auto event_time = _get_event_time(seq->front());
+        _timelapse_hist_seen = itor->second->num_histograms();
+        _timelapse_waiting = true;
 
-        while (event_time <= _control_time)
+        if (result::success != itor->second->capture_histogram())
         {
-            // Execute the camera event.
-            auto res1 = cam_ptr->handle(seq->front());
-
-            if (res1 == result::failure)
-            {
-                ERROR_LOG << "camera->handle(event) failed" << std::endl;
-                // TODO count camera errors and report to UI.
-            }
-
-            // Move to the next event.
-            seq->pop();
-            if (seq->empty())
-            {
-                // Hit the end of the event sequence.
-                break;
-            }
-
-            event_time = _get_event_time(seq->front());
-
-            // Flush camera settings if the next event is a trigger.
-            if (seq->front().channel == Channel::trigger)
-            {
-                auto res2 = cam_ptr->write_config();
-                if (res2 == result::failure)
-                {
-                    ERROR_LOG << "camera->write-settings() failed" << std::endl;
-                    // TODO count camera errors and report to UI.
-                }
-            }
+            _timelapse_waiting = false;
+            ERROR_LOG << "camera->capture_histogram() failed, aborting" << std::endl;
+            return result::failure;
         }
     }
-    return result::success;
-}
 
-
-result
-CameraControl::
-_timelapse_dispatch()
-{
-    if (_timelapse_time > _control_time)
+    // Process the histogram once the capture has completed, which is right
+    // away without a camera worker.
+    if (not _timelapse_waiting or
+        itor == _cameras.end() or
+        itor->second->num_histograms() == _timelapse_hist_seen)
     {
         return result::success;
     }
-
-    if (_timelapse_time == 0)
-    {
-        _timelapse_time = _control_time;
-    }
-    _timelapse_time += _timelapse_interval;
-
-    // Trigger the camera and process the histogram.
-    auto itor = _cameras.find(_timelapse_serial);
-    if (itor == _cameras.end())
-    {
-        ERROR_LOG << "_timelapse_serial not found in _cameras, aborting" << std::endl;
-        return result::failure;
-    }
+    _timelapse_waiting = false;
 
     auto camera = itor->second;
 
-    if (result::success != camera->capture_histogram())
-    {
-        ERROR_LOG << "camera->capture_histogram() failed, aborting" << std::endl;
-        return result::failure;
-    }
     _timelapse_capture_count += 1;
 
     // Grab the histogram an count the total number of pixels.
@@ -1401,7 +2262,34 @@ dispatch()
     auto next_state = CameraControl::State::init;
     bool scan_cameras = true;
 
-    _control_time = _clock.now();
+    _update_clock();
+
+    // Apply any USB work the camera workers have completed.
+    for (auto & [_, camera] : _cameras)
+    {
+        camera->collect();
+    }
+    _collect_camera_opens(false);
+    _collect_trigger_gates();
+
+    // Save finished calibrations straight away.
+    for (auto itor = _calibrating.begin(); itor != _calibrating.end();)
+    {
+        const auto & camera = _cameras[*itor];
+        if (camera->calibrating() > 0)
+        {
+            ++itor;
+            continue;
+        }
+
+        const auto & latency = camera->trigger_latency();
+        INFO_LOG << "calibrated trigger latency " << *itor << ": "
+                 << latency.estimate_ns / 1000 << " us +/- "
+                 << latency.deviation_ns / 1000 << " us" << std::endl;
+
+        itor = _calibrating.erase(itor);
+        _save_trigger_latencies();
+    }
 
     bool got_message = false;
 
@@ -1409,9 +2297,9 @@ dispatch()
     {
         case CameraControl::State::init:
         {
-            _scan_time += _control_time;
-            _send_time += _control_time;
-            _read_time += _control_time;
+            _scan_time += _mono_time;
+            _send_time += _mono_time;
+            _read_time += _mono_time;
             next_state = State::scan;
             break;
         }
@@ -1443,7 +2331,7 @@ dispatch()
         {
             const auto next_event_time = _get_next_event_time();
 
-            if (next_event_time < (_control_time + 60'000))
+            if (next_event_time < (_mono_time + 60'000))
             {
                 next_state = CameraControl::State::executing;
             }
@@ -1467,7 +2355,7 @@ dispatch()
             const auto next_event_time = _get_next_event_time();
 
             // Transition back to execute_ready if the next event is far away.
-            if (next_event_time >= (_control_time + 60'000))
+            if (next_event_time >= (_mono_time + 60'000))
             {
                 next_state = State::execute_ready;
             }
@@ -1485,6 +2373,7 @@ dispatch()
             _timelapse_target_error = 0;
             _timelapse_target_bin = -1;
             _timelapse_time = 0;
+            _timelapse_waiting = false;
             scan_cameras = false;
             break;
         }
@@ -1507,11 +2396,14 @@ dispatch()
         }
     }
 
-    if (result::failure == _read_command(got_message, next_state))
+    if (result::failure == _read_commands(got_message, next_state))
     {
-        ERROR_LOG << "_read_command() failed, ignoring" << std::endl;
+        ERROR_LOG << "_read_commands() failed, ignoring" << std::endl;
     }
 
+    _answer_sequence_load(got_message);
+    _answer_read_choices(got_message);
+
     if (_state != next_state)
     {
         INFO_LOG << "time: " << _control_time
@@ -1528,18 +2420,22 @@ dispatch()
             ERROR_LOG << "_send_telemetry() failed, ignoring" << std::endl;
         }
     }
-    else if (_send_time <= _control_time)
+    else if (_send_time <= _mono_time)
     {
         // Send out 4 Hz telemetry unless we are monitoring cameras.
         if (scan_cameras or
             _state == State::timelapse_idle or
             _state == State::timelapse_running)
         {
-            _send_time = _control_time + 1000;  // 1 Hz.
+            _send_time = _mono_time + 1000;  // 1 Hz.
+        }
+        else if (_keyframe_period > 0 and _state == State::executing)
+        {
+            _send_time = _mono_time + DELTA_SEND_MS;
         }
         else
         {
-            _send_time = _control_time + 250;  // 4 Hz.
+            _send_time = _mono_time + 250;  // 4 Hz.
         }
         if (result::failure == _send_telemetry())
         {
@@ -1575,10 +2471,16 @@ dispatch()
     }
     _trigger_type = TriggerType::none;
 
+    // Hot-plug events are handled as soon as they arrive.
+    if (scan_cameras and _hot_plug)
+    {
+        _hot_plug_scan();
+    }
+
     // Scan for camera changes.
-    if (_scan_time <= _control_time)
+    if (_scan_time <= _mono_time)
     {
-        _scan_time = _control_time + 1000;  // 1 Hz.
+        _scan_time = _mono_time + 1000;  // 1 Hz.
         if (scan_cameras)
         {
             _camera_scan();
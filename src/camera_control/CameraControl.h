@@ -5,25 +5,42 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include <common/BinaryWriter.h>
+#include <common/JsonDelta.h>
+#include <common/JsonWriter.h>
+#include <common/LatencyStats.h>
 #include <common/io.h>
 #include <common/types.h>
 
+#include <interface/HotPlug.h>
+#include <interface/UdpSocket.h>
+
+#include <camera_control/CameraOpener.h>
+#include <camera_control/CameraProfile.h>
+#include <camera_control/CommandTable.h>
+#include <camera_control/EventTimeline.h>
+#include <camera_control/LatePolicy.h>
+#include <camera_control/SequenceLoader.h>
+#include <camera_control/TelemetrySchema.h>
+#include <camera_control/TriggerLatency.h>
+
 namespace pycontrol
 {
 
 // Forwards.
 namespace interface
 {
-    class UdpSocket;
     class GPhoto2Cpp;
     class WallClock;
 }
 
 class Camera;
 class CameraSequence;
-struct Event;
+class ShmPublisher;
+class TriggerGate;
 
 
 class CameraControl
@@ -49,55 +66,304 @@ public:
         const kv_pair_vec & cam_to_ids
     );
 
+    ~CameraControl();
+
     result dispatch();
 
+    // When enabled, each camera detected from here on gets its own USB worker
+    // thread and dispatch() only queues and collects camera I/O.
+    void enable_camera_workers(bool enable) { _camera_workers = enable; }
+
+    // When enabled, along with camera workers, sequence triggers due at the
+    // same time on several cameras are released together through a
+    // TriggerGate rather than one camera after the other.
+    void enable_trigger_fanout(bool enable) { _trigger_fanout = enable; }
+
+    // When enabled, load_sequence reads and compiles the file on a background
+    // thread and is answered once the new sequence is swapped in, the command
+    // response reports progress until then.
+    void enable_background_loading(bool enable) { _background_loading = enable; }
+
+    // When enabled, new cameras are opened while dispatch() carries on and
+    // are added on the first tick after the whole batch is open.  Otherwise
+    // dispatch() waits for them.
+    void enable_background_open(bool enable) { _background_open = enable; }
+
+    // Cameras plugged in or unplugged are picked up from hot_plug's events as
+    // they happen, asking libgphoto2 what's plugged in becomes a fallback
+    // every HOT_PLUG_FALLBACK_MS.  Not owned.
+    void enable_hot_plug(interface::HotPlug * hot_plug) { _hot_plug = hot_plug; }
+
+    static constexpr milliseconds HOT_PLUG_FALLBACK_MS = 10'000;
+
+    // When enabled, the whole telemetry is sent as a keyframe every
+    // keyframe_period and in between only the values that changed since,
+    // see docs/camera_control_commands.md.  Telemetry is sent every
+    // DELTA_SEND_MS while executing then.  0 sends the whole telemetry every
+    // time.
+    void enable_telem_delta(milliseconds keyframe_period) { _keyframe_period = keyframe_period; }
+
+    static constexpr milliseconds DELTA_SEND_MS = 100;
+
+    // When enabled, telemetry is sent as binary, see BinaryWriter.h and
+    // TelemetrySchema.h, rather than JSON.  Binary telemetry is always whole,
+    // deltas are JSON only.
+    void enable_binary_telemetry(bool enable) { _binary_telemetry = enable; }
+
+    // Every telemetry message is also published whole to shm for readers on
+    // the same host, in the same encoding, see ShmTelemetry.h.  Not owned.
+    void enable_shm_telemetry(ShmPublisher * shm) { _telem_shm = shm; }
+
+    // UTC time of the current dispatch.
     const milliseconds & control_time() const { return _control_time; }
     const milliseconds & control_period() const { return _control_period; }
 
+    // The period dispatch() is called at.  When set, along with camera
+    // workers, sequence events due before the next dispatch are handled a tick
+    // early and triggers fire at their exact time on an absolute deadline
+    // rather than on the tick after.
+    void set_control_period(milliseconds period) { _control_period = period; }
+
+    // Learned trigger latencies by serial.  Cameras detected from here on
+    // start with their saved model and finished calibrations are written
+    // back to the same file.  A missing file is not an error.
+    result load_trigger_latencies(const std::string & filename);
+
+    // Learned camera profiles by model and firmware, see CameraProfile.h.  A
+    // known body is brought up from its profile, new ones are learned on
+    // connect and written back to the same file.  A missing file is not an
+    // error.
+    result load_camera_profiles(const std::string & filename);
+
+    // Camera performance models, see SequenceSimulator.h.  Sequences loaded
+    // from here on are simulated against them and what a camera is predicted
+    // not to keep up with is reported with its sequence_state.
+    result load_camera_models(const std::string & filename);
+
+    // How cameras handle triggers they've fallen behind on, see LatePolicy.h.
+    // Cameras go back to it whenever a sequence is loaded, a sequence's
+    // late_policy events override it per camera.
+    void set_late_policy(const LatePolicy & policy);
+
 private:
 
     CameraControl(const CameraControl & copy) = delete;
     CameraControl & operator=(const CameraControl & rhs) = delete;
 
+    void _update_clock();
     void _camera_scan();
+    void _hot_plug_scan();
+    // Queues ports to open unless a batch is already opening, clears ports
+    // once queued.
+    void _connect_cameras(std::vector<UsbPort> & ports);
+    void _collect_camera_opens(bool wait);
+    bool _disconnect_port(const UsbPort & port);
+    template <typename Writer>
+    void _write_telemetry(Writer & out);
     result _send_telemetry();
-    result _read_command(bool & got_message, State & next_state);
+
+    // Sends the pending command response, if there is one, and clears
+    // got_message.
+    void _flush_response(bool & got_message);
+
+    result _read_commands(bool & got_message, State & next_state);
+    void _read_command(std::string_view text, bool & got_message, State & next_state);
+
+    // Command handlers, see _read_command() for the table of commands and
+    // their arguments.  Each answers the command with _accept() or _reject().
+    using CommandHandler = void (CameraControl::*)(
+        std::uint32_t cmd_id,
+        const CommandArgs & args,
+        Tokenizer & tok,
+        State & next_state
+    );
+
+    void _set_camera_id(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+    void _set_events(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+    void _load_sequence(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+    void _read_choices(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+    void _set_choice(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+    void _timelapse_enable(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+    void _timelapse_update(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+    void _timelapse_start(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+    void _timelapse_stop(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+    void _timelapse_disable(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+    void _trigger(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+    void _read_config(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+    void _calibrate_trigger(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+    void _telem_keyframe(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+    void _reset_sequence(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+    void _clock_sync(std::uint32_t, const CommandArgs &, Tokenizer &, State &);
+
+    // The response to the last command, ids and message, without data.
+    void _begin_response(std::string_view message);
+
+    // Answers cmd_id, accepted with the last rejected message or rejected
+    // with message.  Rejects that aren't remembered leave the last rejected
+    // message as it was.
+    void _accept(std::uint32_t cmd_id);
+    void _reject(std::uint32_t cmd_id, std::string_view message, bool remember = true);
+
+    // A reject message in _command_message, pattern with "{arg}" replaced by
+    // arg and "{command}" by the command, or text... joined.
+    std::string_view _format(std::string_view pattern, std::string_view arg = {});
+    template <typename... Text>
+    std::string_view _message(const Text & ... text);
+
     result _dispatch_camera_events();
     result _timelapse_dispatch();
+    void _collect_trigger_gates();
+    std::shared_ptr<TriggerGate> _acquire_trigger_gate();
+    void _save_trigger_latencies();
+    void _learn_camera_profile(const Camera & camera);
+    void _compile_timeline();
+    SequenceLoad::camera_ids _timeline_cameras() const;
+    bool _collect_sequence_load();
+
+    // Answers a load_sequence once its sequence is swapped in, sets
+    // got_message when it does.
+    void _answer_sequence_load(bool & got_message);
+    void _set_loading_response(std::uint32_t percent);
+
+    // Answers a read_choices once the camera's worker has read them, sets
+    // got_message when it does.
+    void _answer_read_choices(bool & got_message);
+    void _respond_choices(std::uint32_t cmd_id, const Camera & camera, std::string_view property);
 
-    milliseconds _get_event_time(const Event & event) const;
     milliseconds _get_next_event_time() const;
 
+    // The largest trigger lead of the timeline's cameras, triggers are handed
+    // to their workers that much before the control period they're due in.
+    milliseconds _max_trigger_lead_ms() const;
+
     using event_map = std::map<std::string, milliseconds>;
     using port_set = std::set<UsbPort>;
-    using camera_map = std::map<Serial, std::shared_ptr<Camera>>;
-    using serial_to_id = std::map<Serial, CamId>;
-    using id_to_serial = std::map<CamId, Serial>;
+    using camera_map = std::map<Serial, std::shared_ptr<Camera>, std::less<>>;
+    using serial_to_id = std::map<Serial, CamId, std::less<>>;
+    using id_to_serial = std::map<CamId, Serial, std::less<>>;
     using sequence_map = std::map<CamId, std::shared_ptr<CameraSequence>>;
 
     State             _state   {State::init};
+    bool              _camera_workers {false};
+    bool              _trigger_fanout {true};
+    bool              _background_loading {false};
     camera_map        _cameras {};
     serial_to_id      _serial_to_id {};
     id_to_serial      _id_to_serial {};
     port_set          _current_ports {};
 
-    std::string       _command_buffer = std::string(1024, '\0');
-    std::string       _command_response = "{\"last_accepted_id\":0,\"last_rejected_id\":0,\"message\":\"\"}";
-    std::stringstream _telem_message = std::stringstream(std::string(4096, '\0'));
+    interface::HotPlug * _hot_plug {nullptr};
+    std::vector<interface::HotPlug::Event> _hot_plug_events {};
+    std::vector<UsbPort> _new_ports {};
+    milliseconds      _detect_time {0};
+
+    // New ports are opened in parallel, at most this many at once.  The batch
+    // being opened or merged, it's merged once every camera already known
+    // has an idle worker.
+    static constexpr std::size_t OPEN_THREADS = 4;
+    bool              _background_open {false};
+    std::unique_ptr<CameraOpenBatch> _open_batch {};
+    port_set          _opening_ports {};
 
+    // The last batch of cameras opened and how long it took, and how long
+    // after the first dispatch() the first cameras were ready.
+    nanoseconds       _start_ns {-1};
+    std::uint32_t     _open_cameras {0};
+    milliseconds      _open_ms {0};
+    milliseconds      _ready_ms {0};
+
+    // Commands received this tick, the first _command_count are new, and
+    // the one being read.
+    std::vector<interface::Datagram> _command_batch {};
+    std::size_t       _command_count {0};
+    std::string_view  _command_text {};
+
+    // How long commands waited to be read after the kernel received them.
+    LatencyStats      _command_queue {256};
+
+    // The response to the last command, written into every telemetry
+    // message in its encoding.
+    struct CommandResponse
+    {
+        std::uint32_t last_accepted_id {0};
+        std::uint32_t last_rejected_id {0};
+        std::string   message {};
+
+        // While a sequence loads in the background.
+        bool          loading {false};
+        std::uint32_t loading_id {0};
+        std::uint32_t loading_percent {0};
+
+        // The choices read_choices read.
+        bool          has_data {false};
+        str_vec       data {};
+    };
+
+    CommandResponse   _command_response {};
+    std::string       _command_message {};
+    JsonWriter        _telem_json {4096};
+
+    // Every telemetry message is numbered, deltas are against the keyframe
+    // numbered _keyframe_seq.
+    std::uint64_t     _telem_seq {0};
+    milliseconds      _keyframe_period {0};
+    milliseconds      _keyframe_time {0};
+    std::uint64_t     _keyframe_seq {0};
+    JsonDelta         _telem_delta {};
+    JsonWriter        _delta_json {1024};
+
+    bool              _binary_telemetry {false};
+    BinaryWriter      _telem_binary {TELEMETRY_KEYS, TELEMETRY_VERSION};
+
+    ShmPublisher *    _telem_shm {nullptr};
+
+    // The scheduler runs on monotonic time, UTC is only used to convert event
+    // times and to report the time.  _utc_offset_ns follows the system clock's
+    // slews but not its steps, those are held while events are pending, see
+    // _update_clock().
     milliseconds      _control_time {0};
+    milliseconds      _mono_time {0};
     milliseconds      _control_period {0};
+    nanoseconds       _utc_offset_ns {0};
+    nanoseconds       _system_offset_ns {0};
+    nanoseconds       _clock_step_ns {0};
+    std::uint32_t     _clock_steps {0};
+    bool              _have_utc_offset {false};
     milliseconds      _scan_time {0};
     milliseconds      _send_time {0};
     milliseconds      _read_time {500};  // Keeping it out of phase
 
     std::uint32_t     _last_accepted_command_id {0};
     std::uint32_t     _last_rejected_command_id {0};
+    std::uint32_t     _last_command_id {0};
     std::string       _last_rejected_message {};
     std::string       _sequence_filename {};
     event_map         _event_map {};
     sequence_map      _sequence_map {};
 
+    // The sequences of the connected cameras in time order, and scratch space
+    // for holding back a camera's events behind one not yet due.
+    EventTimeline     _timeline {};
+    std::vector<std::uint8_t> _lane_blocked {};
+
+    // Bumped whenever the timeline is recompiled, a sequence that finishes
+    // loading against an older generation is recompiled when swapped in.
+    std::uint64_t     _timeline_generation {0};
+
+    SequenceLoader    _sequence_loader {};
+    std::uint32_t     _loading_command_id {0};
+    std::uint32_t     _loading_percent {0};
+
+    // The read_choices waiting on a camera's worker, one at a time.
+    std::uint32_t     _choices_command_id {0};
+    Serial            _choices_serial {};
+    std::string       _choices_property {};
+
+    std::shared_ptr<const camera_model_map> _camera_models {};
+    SequenceLoad::prediction_map _predictions {};
+
+    LatePolicy        _late_policy {};
+
     // TODO: To constrol multiple cameras in timelapse mode with one raspberry
     //       pi, make this a map of camera serial to a struct with these
     //       settings.
@@ -118,6 +384,31 @@ private:
     int               _timelapse_max_deadband {1};
     std::uint32_t     _timelapse_capture_count {0};
     std::uint32_t     _timelapse_pixel_count {0};
+    std::uint32_t     _timelapse_hist_seen {0};
+    bool              _timelapse_waiting {false};
+
+    // Trigger fan-out groups still waiting for a camera to fire, and the
+    // skew stats of the ones that have.
+    std::vector<std::shared_ptr<TriggerGate>> _trigger_gates {};
+
+    // The gates opened this tick, by due time, and the gates reused once no
+    // camera or worker holds them anymore.
+    std::vector<std::pair<milliseconds, std::shared_ptr<TriggerGate>>> _tick_gates {};
+    std::vector<std::shared_ptr<TriggerGate>> _trigger_gate_pool {};
+    std::uint32_t     _trigger_groups {0};
+    std::uint32_t     _trigger_group_size {0};
+    std::uint32_t     _trigger_timeouts {0};
+    std::int64_t      _trigger_skew_ns {0};
+    std::int64_t      _trigger_max_skew_ns {0};
+
+    // Learned trigger latencies and the cameras still calibrating theirs.
+    trigger_latency_map _trigger_latencies {};
+    std::string       _trigger_latency_filename {};
+    std::set<Serial>  _calibrating {};
+
+    // Profiles of the models and firmware seen so far, with this session's.
+    camera_profile_map _camera_profiles {};
+    std::string       _camera_profile_filename {};
 
     enum class TriggerType {none, trigger, histogram};
 
@@ -128,23 +419,34 @@ private:
     interface::UdpSocket &  _telem_socket;
     interface::GPhoto2Cpp & _gp2cpp;
     interface::WallClock &  _clock;
+
+    // Last, its threads stop before anything they use goes away.
+    CameraOpener      _camera_opener {_gp2cpp, _clock, OPEN_THREADS};
 };
 
 
 inline
-std::ostream & operator<<(std::ostream & out, const CameraControl::State & s)
+std::string_view
+to_string(const CameraControl::State & s)
 {
     switch(s)
     {
-        case CameraControl::State::init: out << "init"; break;
-        case CameraControl::State::scan: out << "scan"; break;
-        case CameraControl::State::monitor: out << "monitor"; break;
-        case CameraControl::State::execute_ready: out << "execute_ready"; break;
-        case CameraControl::State::executing: out << "executing"; break;
-        case CameraControl::State::timelapse_idle: out << "timelapse_idle"; break;
-        case CameraControl::State::timelapse_running: out << "timelapse_running"; break;
+        case CameraControl::State::init: return "init";
+        case CameraControl::State::scan: return "scan";
+        case CameraControl::State::monitor: return "monitor";
+        case CameraControl::State::execute_ready: return "execute_ready";
+        case CameraControl::State::executing: return "executing";
+        case CameraControl::State::timelapse_idle: return "timelapse_idle";
+        case CameraControl::State::timelapse_running: return "timelapse_running";
     }
-    return out;
+    return "";
+}
+
+
+inline
+std::ostream & operator<<(std::ostream & out, const CameraControl::State & s)
+{
+    return out << to_string(s);
 }
 
 
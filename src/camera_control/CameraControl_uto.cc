@@ -1,6 +1,12 @@
 #include <common/str_utils.h>
 #include <camera_control/CameraControl_uto.h>
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 void
 UtoSocket::reset()
 {
@@ -14,6 +20,25 @@ UtoSocket::recv(std::string & out)
     return result::success;
 }
 
+result
+UtoSocket::recv_all(std::vector<interface::Datagram> & out, std::size_t & count)
+{
+    if (_to_recv_all.empty())
+    {
+        return interface::UdpSocket::recv_all(out, count);
+    }
+
+    out.resize(std::max(out.size(), _to_recv_all.size()));
+    for (count = 0; count < _to_recv_all.size(); ++count)
+    {
+        out[count] = {_to_recv_all[count], 0};
+    }
+
+    _to_recv = _to_recv_all.back();
+    _to_recv_all.clear();
+    return result::success;
+}
+
 result
 UtoSocket::send(const std::string & out)
 {
@@ -26,12 +51,33 @@ UtoSocket::send(const std::string & out)
     return result::success;
 }
 
+result
+UtoSocket::send_binary(std::string_view out)
+{
+    _from_send.emplace_back(out);
+    return result::success;
+}
+
+result
+UtoSocket::send_frame(std::string_view out)
+{
+    // Whole, as the webapp puts it back together.
+    _from_send.emplace_back(out);
+    return result::success;
+}
+
 void
 UtoSocket::to_recv(const std::string & message)
 {
     _to_recv = message;
 }
 
+void
+UtoSocket::to_recv_all(const str_vec & messages)
+{
+    _to_recv_all = messages;
+}
+
 str_vec &
 UtoSocket::from_send()
 {
@@ -86,6 +132,7 @@ UtoGp2Cpp::add_camera(test_camera_ptr cam)
 str_vec
 UtoGp2Cpp::auto_detect()
 {
+    auto_detect_count++;
     str_vec out;
     for (auto & cam : _test_cams)
     {
@@ -113,18 +160,36 @@ UtoGp2Cpp::open_camera(const std::string & port)
         if (test_cam->port == port)
         {
             auto ptr = std::make_shared<GP2::Camera>();
+            std::unique_lock<std::mutex> lock(_mutex);
             _camera_to_test[ptr] = test_cam;
             test_cam->open_count++;
+            lock.unlock();
+
+            const auto now_opening = ++opening;
+            auto most = max_opening.load();
+            while (now_opening > most and not max_opening.compare_exchange_weak(most, now_opening))
+            {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(test_cam->open_sleep_ms));
+            --opening;
+
             return ptr;
         }
     }
     return nullptr;
 }
 
+test_camera_ptr
+UtoGp2Cpp::_lookup(const camera_ptr & camera)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _camera_to_test[camera];
+}
+
 str_vec
 UtoGp2Cpp::read_choices(const camera_ptr & camera, const std::string & property)
 {
-    auto test_cam = _camera_to_test[camera];
+    auto test_cam = _lookup(camera);
     test_cam->read_choices_count++;
     return test_cam->choice_map[property];
 }
@@ -132,8 +197,25 @@ UtoGp2Cpp::read_choices(const camera_ptr & camera, const std::string & property)
 bool
 UtoGp2Cpp::read_config(const camera_ptr & camera)
 {
-    auto test_cam = _camera_to_test[camera];
+    auto test_cam = _lookup(camera);
     test_cam->read_config_count++;
+    if (clock)
+    {
+        clock->time_ms += test_cam->read_config_ms;
+    }
+    return test_cam->read_config_result;
+}
+
+bool
+UtoGp2Cpp::read_config(const camera_ptr & camera, const str_vec & properties)
+{
+    auto test_cam = _lookup(camera);
+    test_cam->read_status_count++;
+    test_cam->read_properties = properties;
+    if (clock)
+    {
+        clock->time_ms += test_cam->read_widget_ms * static_cast<milliseconds>(properties.size());
+    }
     return test_cam->read_config_result;
 }
 
@@ -143,7 +225,7 @@ UtoGp2Cpp::read_property(
     const std::string & property,
     std::string & output)
 {
-    auto test_cam = _camera_to_test[camera];
+    auto test_cam = _lookup(camera);
     test_cam->read_property_count++;
 
     if (property == "manufacturer")
@@ -162,6 +244,14 @@ UtoGp2Cpp::read_property(
         }
     }
 
+    else if (property == "deviceversion")
+    {
+        if(test_cam->read_property_result)
+        {
+            output = test_cam->firmware;
+        }
+    }
+
     else if (property == "serialnumber")
     {
         if(test_cam->read_property_result)
@@ -236,17 +326,26 @@ UtoGp2Cpp::read_property(
 void
 UtoGp2Cpp::reset_cache(const camera_ptr & camera)
 {
-    auto test_cam = _camera_to_test[camera];
+    auto test_cam = _lookup(camera);
     test_cam->reset_cache_count++;
 }
 
 bool
 UtoGp2Cpp::trigger(const camera_ptr & camera)
 {
-    auto test_cam = _camera_to_test[camera];
+    auto test_cam = _lookup(camera);
     test_cam->trigger_count++;
+    if (clock)
+    {
+        clock->time_ms += test_cam->trigger_ms;
+    }
+    if (test_cam->file_added_events and test_cam->trigger_result)
+    {
+        test_cam->files_pending++;
+    }
     std::stringstream ss;
     ss << "/root/img_" << test_cam->trigger_count << ".jpg";
+    std::lock_guard<std::mutex> lock(_mutex);
     _filenames.push_back(ss.str());
     return test_cam->trigger_result;
 }
@@ -254,18 +353,27 @@ UtoGp2Cpp::trigger(const camera_ptr & camera)
 bool
 UtoGp2Cpp::write_config(camera_ptr & camera)
 {
-    auto test_cam = _camera_to_test[camera];
+    auto test_cam = _lookup(camera);
     test_cam->write_config_count++;
     return test_cam->write_config_result;
 }
 
+bool
+UtoGp2Cpp::write_config(camera_ptr & camera, const str_vec & properties)
+{
+    auto test_cam = _lookup(camera);
+    test_cam->write_config_count++;
+    test_cam->written_properties = properties;
+    return test_cam->write_config_result;
+}
+
 bool
 UtoGp2Cpp::write_property(
     camera_ptr & camera,
     const std::string & property,
     const std::string & value)
 {
-    auto test_cam = _camera_to_test[camera];
+    auto test_cam = _lookup(camera);
     test_cam->write_property_count++;
 
     // Read-only property.
@@ -352,7 +460,13 @@ UtoGp2Cpp::wait_for_event(
     const int timeout_ms,
     gphoto2cpp::Event & out)
 {
-    // TODO: do something usefull.
+    auto test_cam = _lookup(camera);
+    if (test_cam->files_pending > 0)
+    {
+        test_cam->files_pending--;
+        out.type = GP2::GP_EVENT_FILE_ADDED;
+        return true;
+    }
     out.type = GP2::GP_EVENT_TIMEOUT;
     return true;
 }
@@ -408,12 +522,71 @@ UtoGp2Cpp::make_file_capture(const gphoto2cpp::camera_ptr &)
 milliseconds
 FakeClock::now()
 {
-    return time_ms;
+    return time_ms + utc_offset_ms;
+}
+
+nanoseconds
+FakeClock::monotonic_ns()
+{
+    return time_ms * 1'000'000;
+}
+
+nanoseconds
+FakeClock::utc_offset_ns()
+{
+    return utc_offset_ms * 1'000'000;
+}
+
+void
+FakeClock::sleep_until_ns(nanoseconds deadline)
+{
+    ++sleep_count;
+    last_sleep_ns = deadline;
+
+    const milliseconds deadline_ms = deadline / 1'000'000;
+    auto now = time_ms.load();
+    while (now < deadline_ms and not time_ms.compare_exchange_weak(now, deadline_ms))
+    {
+    }
+}
+
+void
+FakeClock::step(milliseconds ms)
+{
+    utc_offset_ms += ms;
+}
+
+result
+UtoHotPlug::poll(std::vector<Event> & out)
+{
+    out.insert(out.end(), events.begin(), events.end());
+    events.clear();
+    return poll_result;
+}
+
+void
+UtoHotPlug::plug(const std::string & port)
+{
+    events.push_back({.type = Event::Type::add, .port = port});
+}
+
+void
+UtoHotPlug::unplug(const std::string & port)
+{
+    events.push_back({.type = Event::Type::remove, .port = port});
+}
+
+
+TempFile::TempFile(const std::string & filename)
+{
+    static std::atomic<int> count {0};
+    path = std::filesystem::temp_directory_path() / (
+        "pycontrol_" + std::to_string(::getpid()) + "_" + std::to_string(count++) + "_" + filename);
 }
 
 TempFile::TempFile(const std::string & filename, const std::string & content)
+    : TempFile(filename)
 {
-    path = std::filesystem::temp_directory_path() / filename;
     std::ofstream file_stream(path);
     file_stream << content;
     file_stream.close();
@@ -432,7 +605,9 @@ Harness::Harness()
     , gp2cpp()
     , clock()
     , cc(cmd_socket, tlm_socket, gp2cpp, clock, {})
-{}
+{
+    gp2cpp.clock = &clock;
+}
 
 result
 Harness::dispatch(milliseconds ms)
@@ -450,9 +625,7 @@ Harness::dispatch_to(milliseconds destination)
         REQUIRE(cc.dispatch() == result::success);
         clock.time_ms += 50;
     }
-    auto & telem_vec = tlm_socket.from_send();
-    auto current_size = telem_vec.size();
-    return parse_telem(telem_vec[current_size - 1]);
+    return read_telem(tlm_socket.from_send().size() - 1);
 }
 
 Telem
@@ -465,5 +638,55 @@ Harness::dispatch_to_next_message(milliseconds ms)
         REQUIRE(cc.dispatch() == result::success);
         clock.time_ms += ms;
     }
-    return parse_telem(telem_vec[current_size]);
+    return read_telem(current_size);
+}
+
+void
+Harness::wait_for_triggers(const test_camera_ptr & cam, int count)
+{
+    for (int i = 0; i < 1000 and cam->trigger_count < count; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE( cam->trigger_count == count );
+}
+
+Telem
+Harness::read_telem(std::size_t index)
+{
+    auto & telem_vec = tlm_socket.from_send();
+    if (_applied > telem_vec.size())
+    {
+        _applied = 0;
+    }
+
+    // Deltas need the keyframes sent before them.
+    for (; _applied < index; ++_applied)
+    {
+        apply_telem_delta(_keyframe, telem_vec[_applied]);
+    }
+    return parse_telem(apply_telem_delta(_keyframe, telem_vec[index]));
+}
+
+Telem
+Harness::wait_for_workers()
+{
+    Telem data;
+    for (int i = 0; i < 100; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        data = dispatch_to_next_message();
+        REQUIRE( not data.detected_cameras.empty() );
+
+        bool idle = true;
+        for (const auto & cam : data.detected_cameras)
+        {
+            idle = idle and cam.usb_pending == 0;
+        }
+        if (idle)
+        {
+            break;
+        }
+    }
+    return data;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <interface/HotPlug.h>
 #include <interface/UdpSocket.h>
 #include <interface/GPhoto2Cpp.h>
 #include <interface/WallClock.h>
@@ -10,8 +11,10 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <atomic>
 #include <fstream>
 #include <filesystem>
+#include <mutex>
 #include <stdexcept>
 
 
@@ -24,12 +27,20 @@ struct UtoSocket : interface::UdpSocket
 
     void reset();
     result recv(std::string & out) override;
+    result recv_all(std::vector<interface::Datagram> & out, std::size_t & count) override;
     result send(const std::string & out) override;
+    result send_binary(std::string_view out) override;
+    result send_frame(std::string_view out) override;
     void to_recv(const std::string & message);
+
+    // Queued together for the next recv_all(), recv() repeats the last after.
+    void to_recv_all(const str_vec & messages);
+
     str_vec & from_send();
 
 private:
     std::string _to_recv;
+    str_vec _to_recv_all;
     str_vec _from_send;
 };
 
@@ -40,6 +51,7 @@ struct TestCamera
 {
     std::string maker = "N/A";
     std::string model = "N/A";
+    std::string firmware = "V1.00";
 
     bool connected = false;
     std::string serial = "N/A";
@@ -57,20 +69,41 @@ struct TestCamera
     choice_map_t choice_map;
 
     int open_count = 0;
-    int read_choices_count = 0;
+    std::atomic<int> read_choices_count {0};
     int read_config_count = 0;
+    int read_status_count = 0;
     int read_property_count = 0;
     int reset_cache_count = 0;
-    int trigger_count = 0;
+    std::atomic<int> trigger_count {0};
     int write_config_count = 0;
     int write_property_count = 0;
 
+    // The properties sent by the last write_config(camera, properties).
+    str_vec written_properties;
+
     bool read_config_result = true;
     bool read_property_result = true;
     bool trigger_result = true;
     bool write_config_result = true;
     bool write_property_result = true;
 
+    // Simulated shutter lag, trigger() advances the fake clock this much.
+    milliseconds trigger_ms = 0;
+
+    // Real time open_camera() blocks for, so cameras opened side by side
+    // overlap.
+    milliseconds open_sleep_ms = 0;
+
+    // Simulated USB time reading the whole config tree or a single widget.
+    milliseconds read_config_ms = 0;
+    milliseconds read_widget_ms = 0;
+
+    // The properties refreshed by the last read_config(camera, properties).
+    str_vec read_properties;
+
+    // When set, wait_for_event() reports a file added for each trigger.
+    bool file_added_events = false;
+    int files_pending = 0;
 };
 
 using test_camera_ptr = std::shared_ptr<TestCamera>;
@@ -83,6 +116,8 @@ make_test_camera(
 
 using gphoto2cpp::camera_ptr;
 
+struct FakeClock;
+
 
 struct UtoGp2Cpp : interface::GPhoto2Cpp
 {
@@ -94,8 +129,17 @@ struct UtoGp2Cpp : interface::GPhoto2Cpp
     str_vec read_choices(const camera_ptr & camera, const std::string & property) override;
 
     bool _read_config_result = true;
+    int auto_detect_count = 0;
+
+    // open_camera() calls in progress, and the most at once.
+    std::atomic<int> opening {0};
+    std::atomic<int> max_opening {0};
+
+    // Advanced by each camera's trigger_ms, if set.
+    FakeClock * clock = nullptr;
 
     bool read_config(const camera_ptr & camera) override;
+    bool read_config(const camera_ptr & camera, const str_vec & properties) override;
     bool read_property(
         const camera_ptr & camera,
         const std::string & property,
@@ -103,6 +147,7 @@ struct UtoGp2Cpp : interface::GPhoto2Cpp
     void reset_cache(const camera_ptr & camera) override;
     bool trigger(const camera_ptr & camera) override;
     bool write_config(camera_ptr & camera) override;
+    bool write_config(camera_ptr & camera, const str_vec & properties) override;
     bool write_property(
         camera_ptr & camera,
         const std::string & property,
@@ -118,21 +163,55 @@ struct UtoGp2Cpp : interface::GPhoto2Cpp
 
 private:
 
+    // Cameras with a worker call in from their own thread.
+    test_camera_ptr _lookup(const camera_ptr & camera);
+    std::mutex _mutex;
+
     std::set<test_camera_ptr> _test_cams;
     std::map<camera_ptr, test_camera_ptr> _camera_to_test;
     str_vec _filenames;
 
 };
 
+// Hands out the events queued with plug() and unplug() on the next poll.
+struct UtoHotPlug : interface::HotPlug
+{
+    result poll(std::vector<Event> & out) override;
+
+    void plug(const std::string & port);
+    void unplug(const std::string & port);
+
+    std::vector<Event> events;
+    result poll_result = result::success;
+};
+
 struct FakeClock : public interface::WallClock
 {
     milliseconds now() override;
-    milliseconds time_ms = 0;
+    nanoseconds monotonic_ns() override;
+    nanoseconds utc_offset_ns() override;
+
+    // Doesn't sleep, jumps time forward to the deadline.
+    void sleep_until_ns(nanoseconds deadline) override;
+
+    // Steps the UTC time as chrony would, monotonic time is unaffected.
+    void step(milliseconds ms);
+
+    // Monotonic time, advanced by the harness.  Camera workers read it too.
+    std::atomic<milliseconds> time_ms {0};
+    std::atomic<milliseconds> utc_offset_ms {0};
+    int sleep_count = 0;
+    std::atomic<nanoseconds> last_sleep_ns {0};
 };
 
 
+// A file under the temp directory, removed with it.  The path is unique to the
+// process and the TempFile, so test runs side by side never share a file, and
+// ends in filename.
 struct TempFile
 {
+    // A path for a file the test writes itself, none is created.
+    explicit TempFile(const std::string & filename);
     TempFile(const std::string & filename, const std::string & content);
     ~TempFile();
     std::filesystem::path path;
@@ -152,5 +231,21 @@ struct Harness
     result dispatch(milliseconds ms = 50);
     Telem dispatch_to(milliseconds destination);
     Telem dispatch_to_next_message(milliseconds ms = 50);
+
+    // The camera workers run in real time while the harness runs on a fake
+    // clock, so give them a moment between telemetry messages until the queue
+    // drains.
+    Telem wait_for_workers();
+
+    // Camera workers fire on their own threads, waits for cam to have fired
+    // count times without moving the clock.
+    void wait_for_triggers(const test_camera_ptr & cam, int count);
+
+    // The telemetry sent index'th, delta telemetry applied to its keyframe.
+    Telem read_telem(std::size_t index);
+
+private:
+    std::string _keyframe;
+    std::size_t _applied = 0;
 };
 
@@ -0,0 +1,140 @@
+#include <chrono>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraControl_uto.h>
+
+TEST_CASE("CameraControl", "[CameraControl][camera_open]")
+{
+    //-------------------------------------------------------------------------
+    // Cameras found by the same scan are opened side by side, reading their
+    // whole config once each.
+    //
+    {
+        Harness harness;
+
+        auto data = harness.dispatch_to(2000);
+        CHECK( data.camera_open.cameras == 0 );
+        CHECK( data.camera_open.ready_ms == 0 );
+
+        std::vector<test_camera_ptr> cams = {
+            make_test_camera("Z 7", "usb:001,001", "1111"),
+            make_test_camera("Z 7", "usb:001,002", "2222"),
+            make_test_camera("Z 8", "usb:001,003", "3333"),
+        };
+        for (auto & cam : cams)
+        {
+            cam->open_sleep_ms = 100;
+            harness.gp2cpp.add_camera(cam);
+        }
+
+        data = harness.dispatch_to_next_message();
+        data = harness.dispatch_to_next_message();
+
+        REQUIRE( data.detected_cameras.size() == 3 );
+        for (const auto & detected : data.detected_cameras)
+        {
+            CHECK( detected.connected == true );
+        }
+        CHECK( harness.gp2cpp.max_opening == 3 );
+
+        for (const auto & cam : cams)
+        {
+            CHECK( cam->open_count == 1 );
+            CHECK( cam->read_config_count == 1 );
+        }
+
+        CHECK( data.camera_open.cameras == 3 );
+        CHECK( data.camera_open.ready_ms >= 2000 );
+        CHECK( data.camera_open.ready_ms < 3100 );
+
+        //---------------------------------------------------------------------
+        // Startup happens once, later cameras don't move it.
+        //
+        const auto ready_ms = data.camera_open.ready_ms;
+
+        auto cam4 = make_test_camera("Z 6", "usb:001,004", "4444");
+        harness.gp2cpp.add_camera(cam4);
+
+        data = harness.dispatch_to_next_message();
+        data = harness.dispatch_to_next_message();
+
+        REQUIRE( data.detected_cameras.size() == 4 );
+        CHECK( data.camera_open.cameras == 1 );
+        CHECK( data.camera_open.ready_ms == ready_ms );
+    }
+
+    //-------------------------------------------------------------------------
+    // No more than 4 at a time, a camera that fails to open doesn't hold up
+    // the others.
+    //
+    {
+        Harness harness;
+
+        for (int i = 1; i <= 6; ++i)
+        {
+            auto cam = make_test_camera(
+                "Z 7", "usb:001,00" + std::to_string(i), std::to_string(i * 1111));
+            cam->open_sleep_ms = 50;
+            if (i == 2)
+            {
+                cam->read_config_result = false;
+            }
+            harness.gp2cpp.add_camera(cam);
+        }
+
+        auto data = harness.dispatch_to_next_message();
+        data = harness.dispatch_to_next_message();
+
+        CHECK( data.detected_cameras.size() == 5 );
+        CHECK( harness.gp2cpp.max_opening > 1 );
+        CHECK( harness.gp2cpp.max_opening <= 4 );
+        CHECK( data.camera_open.cameras == 5 );
+    }
+
+    //-------------------------------------------------------------------------
+    // In the background, ticks carry on while the cameras open.  A camera
+    // plugged back in is reconnected by the tick that merges it.
+    //
+    {
+        Harness harness;
+        harness.cc.enable_camera_workers(true);
+        harness.cc.enable_background_open(true);
+
+        auto cam = make_test_camera("Z 7", "usb:001,001", "1111");
+        cam->open_sleep_ms = 1000;
+        harness.gp2cpp.add_camera(cam);
+
+        const auto start = std::chrono::steady_clock::now();
+        auto data = harness.dispatch_to_next_message();
+        data = harness.dispatch_to_next_message();
+        CHECK( std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500) );
+        CHECK( data.detected_cameras.empty() );
+
+        for (int i = 0; i < 200 and data.detected_cameras.empty(); ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            data = harness.dispatch_to_next_message();
+        }
+        REQUIRE( data.detected_cameras.size() == 1 );
+        CHECK( data.detected_cameras[0].connected == true );
+        CHECK( data.camera_open.cameras == 1 );
+
+        cam->connected = false;
+        data = harness.dispatch_to(harness.cc.control_time() + 2000);
+        REQUIRE( data.detected_cameras.size() == 1 );
+        CHECK( data.detected_cameras[0].connected == false );
+
+        cam->open_sleep_ms = 0;
+        cam->connected = true;
+        for (int i = 0; i < 200 and not data.detected_cameras[0].connected; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            data = harness.dispatch_to_next_message();
+        }
+        REQUIRE( data.detected_cameras.size() == 1 );
+        CHECK( data.detected_cameras[0].connected == true );
+        CHECK( cam->open_count == 2 );
+    }
+}
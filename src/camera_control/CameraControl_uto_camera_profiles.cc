@@ -0,0 +1,87 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraControl_uto.h>
+
+TEST_CASE("CameraControl", "[CameraControl][camera_profiles]")
+{
+    const auto file = TempFile("camera_profiles.config");
+    const auto filename = file.path.string();
+
+    //-------------------------------------------------------------------------
+    // A new model is probed and learned on connect.
+    //
+    {
+        Harness harness;
+
+        // No file yet, cameras are probed.
+        REQUIRE( harness.cc.load_camera_profiles(filename) == result::success );
+
+        auto cam1 = make_test_camera();
+        harness.gp2cpp.add_camera(cam1);
+        auto data = harness.dispatch_to_next_message();
+        data = harness.dispatch_to_next_message();
+
+        REQUIRE( data.detected_cameras.size() == 1 );
+        CHECK( cam1->read_choices_count == 5 );
+
+        camera_profile_map profiles;
+        REQUIRE( read_camera_profiles(filename, profiles) == result::success );
+        REQUIRE( profiles.size() == 1 );
+
+        const auto & profile = profiles.begin()->second;
+        CHECK( profile.model == "Nikon Corporation Z 7" );
+        CHECK( profile.firmware == "V1.00" );
+        CHECK( profile.choices.size() == 5 );
+        CHECK( profile.choices.at("imagequality") == str_vec({"NEF (Raw)", "JPEG Basic", "JPEG Fine"}) );
+
+        // Answered from the profile.
+        harness.cmd_socket.to_recv("1 read_choices 1234 iso");
+        data = harness.dispatch_to_next_message();
+
+        CHECK( data.command_response.last_accepted_id == 1 );
+        CHECK( data.command_response.data == str_vec({"64", "100", "200", "500"}) );
+        CHECK( cam1->read_choices_count == 5 );
+    }
+
+    //-------------------------------------------------------------------------
+    // A known body, say after a restart, comes up from its profile without
+    // reading any choices from the camera.
+    //
+    {
+        Harness harness;
+        REQUIRE( harness.cc.load_camera_profiles(filename) == result::success );
+
+        auto cam1 = make_test_camera("Z 7", "usb:001,001", "4321");
+        cam1->choice_map.clear();
+        harness.gp2cpp.add_camera(cam1);
+        auto data = harness.dispatch_to_next_message();
+        data = harness.dispatch_to_next_message();
+
+        REQUIRE( data.detected_cameras.size() == 1 );
+        CHECK( data.detected_cameras[0].connected == true );
+
+        harness.cmd_socket.to_recv("1 read_choices 4321 imagequality");
+        data = harness.dispatch_to_next_message();
+
+        CHECK( data.command_response.last_accepted_id == 1 );
+        CHECK( data.command_response.data == str_vec({"NEF (Raw)", "JPEG Basic", "JPEG Fine"}) );
+        CHECK( cam1->read_choices_count == 0 );
+
+        //---------------------------------------------------------------------
+        // New firmware on the same model is learned again.
+        //
+        auto cam2 = make_test_camera("Z 7", "usb:001,002", "5678");
+        cam2->firmware = "V1.10";
+        harness.gp2cpp.add_camera(cam2);
+        data = harness.dispatch_to_next_message();
+        data = harness.dispatch_to_next_message();
+
+        REQUIRE( data.detected_cameras.size() == 2 );
+        CHECK( cam2->read_choices_count == 5 );
+
+        camera_profile_map profiles;
+        REQUIRE( read_camera_profiles(filename, profiles) == result::success );
+        CHECK( profiles.size() == 2 );
+        CHECK( profiles.contains(CameraProfile::profile_key("Nikon Corporation Z 7", "V1.10")) );
+    }
+}
@@ -0,0 +1,192 @@
+#include <camera_control/CameraControl_uto.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+
+TEST_CASE("CameraControl", "[CameraControl][camera_worker]")
+{
+    Harness harness;
+    harness.cc.enable_camera_workers(true);
+
+    //-------------------------------------------------------------------------
+    // Add a camera, initially connected.
+    //
+    auto cam1 = make_test_camera();
+    cam1->choice_map["whitebalance"] = {"Auto", "Sunny", "Cloudy"};
+    harness.gp2cpp.add_camera(cam1);
+    auto data = harness.dispatch_to_next_message();
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.state == "monitor" );
+    REQUIRE( data.detected_cameras.size() == 1 );
+
+    data = harness.wait_for_workers();
+
+    CHECK( data.state == "monitor" );
+    REQUIRE( data.detected_cameras.size() == 1 );
+
+    // z7
+    auto obj1 = data.detected_cameras[0];
+    CHECK( obj1.connected == true );
+    CHECK( obj1.serial == "1234" );
+    CHECK( obj1.desc == "Nikon Corporation Z 7" );
+    CHECK( obj1.mode == "M" );
+    CHECK( obj1.shutter == "1/1000" );
+    CHECK( obj1.fstop == "F/8" );
+    CHECK( obj1.iso == "64" );
+    CHECK( obj1.quality == "NEF (Raw)" );
+    CHECK( obj1.batt == "100%" );
+    CHECK( obj1.usb_pending == 0 );
+
+    CHECK( cam1->trigger_count == 0 );
+
+    //-------------------------------------------------------------------------
+    // Trigger the camera, the command is accepted once the trigger is queued.
+    //
+    harness.cmd_socket.to_recv("1 trigger 1234");
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 1 );
+    CHECK( data.command_response.last_rejected_id == 0 );
+    CHECK( data.command_response.message.empty() );
+
+    data = harness.wait_for_workers();
+
+    REQUIRE( data.detected_cameras.size() == 1 );
+    CHECK( data.detected_cameras[0].usb_pending == 0 );
+    CHECK( cam1->trigger_count == 1 );
+
+    //-------------------------------------------------------------------------
+    // Change a setting, the write is flushed by the worker.
+    //
+    const auto write_count = cam1->write_config_count;
+
+    harness.cmd_socket.to_recv("2 set_choice 1234 iso 200");
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 2 );
+    CHECK( data.command_response.last_rejected_id == 0 );
+
+    data = harness.wait_for_workers();
+
+    REQUIRE( data.detected_cameras.size() == 1 );
+    CHECK( data.detected_cameras[0].usb_pending == 0 );
+    CHECK( data.detected_cameras[0].iso == "200" );
+    CHECK( cam1->write_config_count == write_count + 1 );
+    CHECK( cam1->iso == "200" );
+
+    //-------------------------------------------------------------------------
+    // Choices not read yet are read by the worker, the command is answered
+    // once they're collected.
+    //
+    const int choices_count = cam1->read_choices_count;
+
+    harness.cmd_socket.to_recv("3 read_choices 1234 whitebalance");
+    data = harness.dispatch_to_next_message();
+
+    for (int i = 0; i < 100 and data.command_response.last_accepted_id != 3; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        data = harness.dispatch_to_next_message();
+    }
+
+    CHECK( data.command_response.last_accepted_id == 3 );
+    CHECK( data.command_response.last_rejected_id == 0 );
+    CHECK( data.command_response.data == str_vec{"Auto", "Sunny", "Cloudy"} );
+    CHECK( cam1->read_choices_count == choices_count + 1 );
+
+    // Cached from then on.
+    harness.cmd_socket.to_recv("4 read_choices 1234 whitebalance");
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 4 );
+    CHECK( data.command_response.data == str_vec{"Auto", "Sunny", "Cloudy"} );
+    CHECK( cam1->read_choices_count == choices_count + 1 );
+
+    // A setting the camera doesn't have.
+    harness.cmd_socket.to_recv("5 read_choices 1234 nope");
+    data = harness.dispatch_to_next_message();
+
+    for (int i = 0; i < 100 and data.command_response.last_rejected_id != 5; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        data = harness.dispatch_to_next_message();
+    }
+
+    CHECK( data.command_response.last_rejected_id == 5 );
+    CHECK( data.command_response.message == "property 'nope' does not exist" );
+}
+
+
+TEST_CASE("CameraControl", "[CameraControl][camera_worker][trigger_fanout]")
+{
+    Harness harness;
+    harness.cc.enable_camera_workers(true);
+
+    //-------------------------------------------------------------------------
+    // Two cameras sharing a trigger time.
+    //
+    auto cam1 = make_test_camera("Z 7", "usb:001,001", "1234");
+    auto cam2 = make_test_camera("Z 8", "usb:001,002", "5678");
+    harness.gp2cpp.add_camera(cam1);
+    harness.gp2cpp.add_camera(cam2);
+
+    auto data = harness.dispatch_to_next_message();
+    data = harness.dispatch_to_next_message();
+    data = harness.wait_for_workers();
+
+    REQUIRE( data.detected_cameras.size() == 2 );
+    CHECK( data.trigger_skew.groups == 0 );
+    CHECK( data.trigger_skew.cameras == 0 );
+    CHECK( data.detected_cameras[0].fire_offset_us == -1 );
+    CHECK( data.detected_cameras[1].fire_offset_us == -1 );
+
+    harness.cmd_socket.to_recv("1 set_camera_id 1234 z7");
+    data = harness.dispatch_to_next_message();
+    harness.cmd_socket.to_recv("2 set_camera_id 5678 z8");
+    data = harness.dispatch_to_next_message();
+
+    auto seq = TempFile(
+        "fanout.seq",
+        R"(
+            e1 0.0 z7.trigger 1
+            e1 0.0 z8.trigger 1
+        )"
+    );
+
+    harness.cmd_socket.to_recv("3 load_sequence " + seq.path.string());
+    data = harness.dispatch_to_next_message();
+
+    const auto e1 = data.time + 2'000;
+    harness.cmd_socket.to_recv("4 set_events e1 " + std::to_string(e1));
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 4 );
+    CHECK( data.command_response.last_rejected_id == 0 );
+
+    //-------------------------------------------------------------------------
+    // Both triggers go through one gate.
+    //
+    data = harness.dispatch_to(e1 + 50);
+    data = harness.wait_for_workers();
+
+    CHECK( cam1->trigger_count == 1 );
+    CHECK( cam2->trigger_count == 1 );
+
+    CHECK( data.trigger_skew.groups == 1 );
+    CHECK( data.trigger_skew.cameras == 2 );
+    CHECK( data.trigger_skew.timeouts == 0 );
+    CHECK( data.trigger_skew.skew_us >= 0 );
+    CHECK( data.trigger_skew.max_skew_us == data.trigger_skew.skew_us );
+
+    REQUIRE( data.detected_cameras.size() == 2 );
+
+    const auto offset1 = data.detected_cameras[0].fire_offset_us;
+    const auto offset2 = data.detected_cameras[1].fire_offset_us;
+
+    // The first camera to fire has no offset, the other is the group's skew.
+    CHECK( std::min(offset1, offset2) == 0 );
+    CHECK( std::max(offset1, offset2) == data.trigger_skew.skew_us );
+}
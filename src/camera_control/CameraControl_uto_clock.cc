@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraControl_uto.h>
+
+TEST_CASE("CameraControl", "[CameraControl][clock]")
+{
+    Harness harness;
+    harness.cc.enable_camera_workers(true);
+    harness.cc.set_control_period(50);
+
+    //-------------------------------------------------------------------------
+    // Add a camera with a single trigger 5 seconds from now.
+    //
+    auto cam1 = make_test_camera();
+    harness.gp2cpp.add_camera(cam1);
+    auto data = harness.dispatch_to_next_message();
+    data = harness.wait_for_workers();
+
+    CHECK( data.state == "monitor" );
+    CHECK( data.time == 1'000 );
+    CHECK( data.clock.utc_offset_ms == 0 );
+    CHECK( data.clock.steps == 0 );
+    CHECK( data.clock.last_step_ms == 0 );
+
+    harness.cmd_socket.to_recv("1 set_camera_id 1234 z7");
+    data = harness.dispatch_to_next_message();
+
+    auto seq = TempFile(
+        "clock.seq",
+        R"(
+            e1 0.020 z7.trigger 1
+        )"
+    );
+
+    harness.cmd_socket.to_recv("2 load_sequence " + seq.path.string());
+    data = harness.dispatch_to_next_message();
+
+    const auto e1 = data.time + 5'000;
+    harness.cmd_socket.to_recv("3 set_events e1 " + std::to_string(e1));
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 3 );
+    CHECK( data.command_response.last_rejected_id == 0 );
+
+    //-------------------------------------------------------------------------
+    // The system clock is stepped forward an hour.  The step is counted, e1 is
+    // further off than the triggers handed to the camera workers, so the step
+    // is applied at once.  e1 is now in the past and fires.
+    //
+    const auto time0 = data.time;
+    harness.clock.step(3'600'000);
+    data = harness.dispatch_to_next_message();
+    harness.wait_for_triggers(cam1, 1);
+
+    CHECK( data.time > time0 + 3'600'000 );
+    CHECK( data.time <= time0 + 3'600'000 + 1'000 );
+    CHECK( data.clock.utc_offset_ms == 3'600'000 );
+    CHECK( data.clock.steps == 1 );
+    CHECK( data.clock.last_step_ms == 3'600'000 );
+    CHECK( data.clock.held_ms == 0 );
+
+    //-------------------------------------------------------------------------
+    // Stepped back with a trigger due in the next control period.  Its
+    // deadline is handed to the worker, the step is held and the trigger
+    // fires on its monotonic deadline.
+    //
+    // e1 is set first, loading marks the events already past as dispatched.
+    const auto e2 = data.time + 2'000;
+    harness.cmd_socket.to_recv("4 set_events e1 " + std::to_string(e2));
+    data = harness.dispatch_to_next_message();
+
+    harness.cmd_socket.to_recv("5 load_sequence " + seq.path.string());
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 5 );
+
+    data = harness.dispatch_to(e2 - 50);
+    CHECK( cam1->trigger_count == 1 );
+
+    harness.clock.step(-3'600'000);
+    REQUIRE( harness.cc.dispatch() == result::success );
+
+    CHECK( harness.cc.control_time() == e2 );
+
+    harness.wait_for_triggers(cam1, 2);
+    CHECK( harness.clock.last_sleep_ns == (e2 + 20 - 3'600'000) * 1'000'000 );
+
+    //-------------------------------------------------------------------------
+    // Nothing else pending, the held step is applied.
+    //
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.time > e2 - 3'600'000 );
+    CHECK( data.time <= e2 - 3'600'000 + 1'000 );
+    CHECK( data.clock.utc_offset_ms == 0 );
+    CHECK( data.clock.steps == 2 );
+    CHECK( data.clock.last_step_ms == -3'600'000 );
+    CHECK( data.clock.held_ms == 0 );
+
+    //-------------------------------------------------------------------------
+    // clock_sync with no step held changes nothing.
+    //
+    harness.cmd_socket.to_recv("6 clock_sync");
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 6 );
+    CHECK( data.clock.utc_offset_ms == 0 );
+    CHECK( data.clock.held_ms == 0 );
+
+    //-------------------------------------------------------------------------
+    // A slew is not a step.
+    //
+    harness.clock.step(5);
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.clock.utc_offset_ms == 5 );
+    CHECK( data.clock.steps == 2 );
+    CHECK( data.clock.last_step_ms == -3'600'000 );
+    CHECK( data.clock.held_ms == 0 );
+}
@@ -0,0 +1,64 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraControl_uto.h>
+
+TEST_CASE("CameraControl", "[CameraControl][command_burst]")
+{
+    Harness harness;
+
+    //-------------------------------------------------------------------------
+    // Inital message.
+    //
+    auto data = harness.dispatch_to_next_message();
+
+    CHECK( data.state == "scan" );
+    CHECK( data.command_response.last_accepted_id == 0 );
+    CHECK( data.command_response.last_rejected_id == 0 );
+
+    //-------------------------------------------------------------------------
+    // Several commands queued in one tick are all read in that tick, each
+    // answered with its own telemetry, repeats ignored.
+    //
+    harness.cmd_socket.to_recv_all({
+        "1 set_events e1 1000",
+        "2 set_events e1 1000 e2 2000",
+        "3 bogus",
+        "3 bogus",
+        "4 telem_keyframe",
+    });
+
+    auto & telem_vec = harness.tlm_socket.from_send();
+    const auto before = telem_vec.size();
+
+    REQUIRE( harness.dispatch() == result::success );
+    REQUIRE( telem_vec.size() == before + 4 );
+
+    data = harness.read_telem(before);
+    CHECK( data.command_response.last_accepted_id == 1 );
+    CHECK( data.command_response.last_rejected_id == 0 );
+
+    data = harness.read_telem(before + 1);
+    CHECK( data.command_response.last_accepted_id == 2 );
+    CHECK( data.command_response.last_rejected_id == 0 );
+
+    data = harness.read_telem(before + 2);
+    CHECK( data.command_response.last_accepted_id == 2 );
+    CHECK( data.command_response.last_rejected_id == 3 );
+    CHECK( data.command_response.message == "Unknown command: 'bogus', ignorning" );
+
+    // The state changes at the end of the tick, with the last response.
+    data = harness.read_telem(before + 3);
+    CHECK( data.state == "monitor" );
+    CHECK( data.command_response.last_accepted_id == 4 );
+    CHECK( data.command_response.last_rejected_id == 3 );
+    REQUIRE( data.events.size() == 2 );
+    CHECK( data.events["e1"] == 1'000 );
+    CHECK( data.events["e2"] == 2'000 );
+
+    //-------------------------------------------------------------------------
+    // The last one repeats on the socket after, nothing new.
+    //
+    const auto after = telem_vec.size();
+    REQUIRE( harness.dispatch() == result::success );
+    CHECK( telem_vec.size() == after );
+}
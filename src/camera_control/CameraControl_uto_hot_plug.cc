@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraControl_uto.h>
+
+TEST_CASE("CameraControl", "[CameraControl][hot_plug]")
+{
+    Harness harness;
+    UtoHotPlug hot_plug;
+    harness.cc.enable_hot_plug(&hot_plug);
+
+    //-------------------------------------------------------------------------
+    // Cameras already plugged in are found by the first scan.
+    //
+    auto cam1 = make_test_camera();
+    harness.gp2cpp.add_camera(cam1);
+    auto data = harness.dispatch_to_next_message();
+    data = harness.dispatch_to_next_message();
+
+    REQUIRE( data.detected_cameras.size() == 1 );
+    CHECK( data.detected_cameras[0].connected == true );
+    CHECK( harness.gp2cpp.auto_detect_count == 1 );
+
+    //-------------------------------------------------------------------------
+    // Unplugged, handled on the next tick without asking libgphoto2.
+    //
+    cam1->connected = false;
+    hot_plug.unplug("usb:001,001");
+    REQUIRE( harness.dispatch() == result::success );
+
+    data = harness.dispatch_to_next_message();
+    REQUIRE( data.detected_cameras.size() == 1 );
+    CHECK( data.detected_cameras[0].connected == false );
+    CHECK( harness.gp2cpp.auto_detect_count == 1 );
+
+    // Other USB devices going away are ignored.
+    hot_plug.unplug("usb:001,009");
+    REQUIRE( harness.dispatch() == result::success );
+
+    //-------------------------------------------------------------------------
+    // Plugged in, opened on the next tick.
+    //
+    auto cam2 = make_test_camera("Z 8", "usb:001,002", "5678");
+    harness.gp2cpp.add_camera(cam2);
+    hot_plug.plug("usb:001,002");
+    REQUIRE( harness.dispatch() == result::success );
+    CHECK( cam2->open_count == 1 );
+
+    data = harness.dispatch_to_next_message();
+    REQUIRE( data.detected_cameras.size() == 2 );
+    CHECK( harness.gp2cpp.auto_detect_count == 1 );
+
+    // The same camera plugged in again is only opened once.
+    hot_plug.plug("usb:001,002");
+    REQUIRE( harness.dispatch() == result::success );
+    CHECK( cam2->open_count == 1 );
+
+    //-------------------------------------------------------------------------
+    // libgphoto2 is still asked now and then in case events were missed.
+    //
+    data = harness.dispatch_to(harness.cc.control_time() + CameraControl::HOT_PLUG_FALLBACK_MS);
+    CHECK( harness.gp2cpp.auto_detect_count == 2 );
+
+    //-------------------------------------------------------------------------
+    // Lost events force a scan.
+    //
+    hot_plug.poll_result = result::failure;
+    data = harness.dispatch_to(harness.cc.control_time() + 1000);
+    CHECK( harness.gp2cpp.auto_detect_count > 2 );
+
+    hot_plug.poll_result = result::success;
+    data = harness.dispatch_to(harness.cc.control_time() + 2000);
+    const auto count = harness.gp2cpp.auto_detect_count;
+
+    //-------------------------------------------------------------------------
+    // A camera that can't be opened yet is retried by the next scan.
+    //
+    auto cam3 = make_test_camera("Z 6", "usb:001,003", "9012");
+    hot_plug.plug("usb:001,003");
+    REQUIRE( harness.dispatch() == result::success );
+    CHECK( cam3->open_count == 0 );
+
+    harness.gp2cpp.add_camera(cam3);
+    data = harness.dispatch_to(harness.cc.control_time() + 1000);
+    CHECK( harness.gp2cpp.auto_detect_count == count + 1 );
+    CHECK( cam3->open_count == 1 );
+
+    data = harness.dispatch_to_next_message();
+    CHECK( data.detected_cameras.size() == 3 );
+}
@@ -0,0 +1,150 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraControl_uto.h>
+
+
+namespace
+{
+
+// Ten triggers 100 ms apart starting 100 ms after e1, e1 returned.
+milliseconds
+setup(Harness & harness, test_camera_ptr cam1, const std::string & policy)
+{
+    harness.gp2cpp.add_camera(cam1);
+    auto data = harness.dispatch_to_next_message();
+    data = harness.dispatch_to_next_message();
+
+    harness.cmd_socket.to_recv("1 set_camera_id 1234 z7");
+    data = harness.dispatch_to_next_message();
+
+    std::string content = "e1 0.0 z7.late_policy " + policy + "\n";
+    for (int i = 1; i <= 10; ++i)
+    {
+        content += "e1 " + std::to_string(i * 0.1) + " z7.trigger 1\n";
+    }
+    auto seq = TempFile("late_policy.seq", content);
+
+    harness.cmd_socket.to_recv("2 load_sequence " + seq.path.string());
+    data = harness.dispatch_to_next_message();
+    REQUIRE( data.command_response.last_accepted_id == 2 );
+
+    const auto e1 = data.time + 1'000;
+    harness.cmd_socket.to_recv("3 set_events e1 " + std::to_string(e1));
+    data = harness.dispatch_to_next_message();
+    REQUIRE( data.command_response.last_accepted_id == 3 );
+
+    return e1;
+}
+
+} /* namespace */
+
+
+TEST_CASE("CameraControl", "[CameraControl][late_policy]")
+{
+    //-------------------------------------------------------------------------
+    // strict, a camera that takes 250 ms per trigger overruns the sequence.
+    //
+    {
+        Harness harness;
+        auto cam1 = make_test_camera();
+        cam1->trigger_ms = 250;
+        const auto e1 = setup(harness, cam1, "strict 100");
+
+        harness.dispatch_to(e1 + 1'000);
+        CHECK( cam1->trigger_count == 10 );
+        CHECK( harness.clock.time_ms >= e1 + 2'500 );
+
+        const auto data = harness.dispatch_to_next_message();
+        REQUIRE( data.detected_cameras.size() == 1 );
+        const auto policy = data.detected_cameras[0].late_policy;
+        CHECK( policy.mode == "strict" );
+        CHECK( policy.late_ms == 100 );
+        CHECK( policy.fired == 10 );
+        CHECK( policy.late == 9 );
+        CHECK( policy.skipped == 0 );
+        CHECK( policy.compressed == 0 );
+    }
+
+    //-------------------------------------------------------------------------
+    // skip-late, the first trigger stalls the camera for 500 ms.  The
+    // triggers it can't get to in time are dropped and the rest fire on time.
+    //
+    {
+        Harness harness;
+        auto cam1 = make_test_camera();
+        cam1->trigger_ms = 500;
+        const auto e1 = setup(harness, cam1, "skip-late 100");
+
+        harness.dispatch_to(e1 + 100);
+        REQUIRE( cam1->trigger_count == 1 );
+        cam1->trigger_ms = 0;
+
+        // 200 to 500 ms are dropped, 600 ms is only 50 ms late.
+        harness.dispatch_to(e1 + 650);
+        CHECK( cam1->trigger_count == 2 );
+
+        harness.dispatch_to(e1 + 950);
+        CHECK( cam1->trigger_count == 5 );
+        harness.dispatch_to(e1 + 1'000);
+        CHECK( cam1->trigger_count == 6 );
+
+        const auto data = harness.dispatch_to_next_message();
+        REQUIRE( data.detected_cameras.size() == 1 );
+        const auto policy = data.detected_cameras[0].late_policy;
+        CHECK( policy.mode == "skip-late" );
+        CHECK( policy.fired == 6 );
+        CHECK( policy.late == 0 );
+        CHECK( policy.skipped == 4 );
+    }
+
+    //-------------------------------------------------------------------------
+    // compress, the same stall and the remaining triggers are respaced to
+    // still finish at e1 + 1 s instead of all firing as soon as the camera
+    // frees up.
+    //
+    {
+        Harness harness;
+        auto cam1 = make_test_camera();
+        cam1->trigger_ms = 500;
+        const auto e1 = setup(harness, cam1, "compress 100");
+
+        harness.dispatch_to(e1 + 100);
+        REQUIRE( cam1->trigger_count == 1 );
+        cam1->trigger_ms = 0;
+
+        // 200 ms fires late at 650 ms, 300 ms is respaced to 693 ms.
+        harness.dispatch_to(e1 + 650);
+        CHECK( cam1->trigger_count == 2 );
+        harness.dispatch_to(e1 + 700);
+        CHECK( cam1->trigger_count == 3 );
+
+        harness.dispatch_to(e1 + 950);
+        CHECK( cam1->trigger_count == 8 );
+        harness.dispatch_to(e1 + 1'000);
+        CHECK( cam1->trigger_count == 10 );
+
+        auto data = harness.dispatch_to_next_message();
+        REQUIRE( data.detected_cameras.size() == 1 );
+        auto policy = data.detected_cameras[0].late_policy;
+        CHECK( policy.mode == "compress" );
+        CHECK( policy.compressing );
+        CHECK( policy.fired == 10 );
+        CHECK( policy.late == 1 );
+        CHECK( policy.compressed == 7 );
+        CHECK( policy.skipped == 0 );
+
+        // Loading a sequence goes back to the configured policy.
+        harness.cc.set_late_policy(LatePolicy(LatePolicy::Mode::skip_late, 50));
+        auto seq = TempFile("late_policy_2.seq", "e1 9.0 z7.trigger 1\n");
+        harness.cmd_socket.to_recv("4 load_sequence " + seq.path.string());
+        data = harness.dispatch_to_next_message();
+        data = harness.dispatch_to_next_message();
+        REQUIRE( data.command_response.last_accepted_id == 4 );
+
+        policy = data.detected_cameras[0].late_policy;
+        CHECK( policy.mode == "skip-late" );
+        CHECK( policy.late_ms == 50 );
+        CHECK_FALSE( policy.compressing );
+        CHECK( policy.fired == 10 );
+    }
+}
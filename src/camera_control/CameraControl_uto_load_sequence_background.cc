@@ -0,0 +1,145 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraControl_uto.h>
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+
+TEST_CASE("CameraControl background load", "[CameraControl][load_sequence][background]")
+{
+    Harness harness;
+    harness.cc.enable_background_loading(true);
+
+    auto data = harness.dispatch_to_next_message();
+    CHECK( data.command_response.loading_id == 0 );
+
+    constexpr int num_events = 100'000;
+
+    std::ostringstream content;
+    for (int i = 0; i < num_events; ++i)
+    {
+        content << "e1 " << i * 0.01 << " z7.trigger 1\n";
+    }
+    auto seq = TempFile("big.seq", content.str());
+
+    //-------------------------------------------------------------------------
+    // The command isn't answered until the sequence is swapped in, the
+    // response reports the load in progress.
+    //
+    const auto start = std::chrono::steady_clock::now();
+
+    harness.cmd_socket.to_recv("1 load_sequence " + seq.path.string());
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 0 );
+    CHECK( data.command_response.last_rejected_id == 0 );
+    CHECK( data.command_response.loading_id == 1 );
+    CHECK( data.command_response.loading_percent >= 0 );
+    CHECK( data.sequence.empty() );
+
+    // Resending the same command doesn't start another load, commands that
+    // change the sequence are refused until it's done.
+    harness.cmd_socket.to_recv("1 load_sequence " + seq.path.string());
+    REQUIRE( harness.dispatch() == result::success );
+
+    harness.cmd_socket.to_recv("2 reset_sequence");
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 0 );
+    CHECK( data.command_response.last_rejected_id == 2 );
+    CHECK( data.command_response.message == "a sequence file is still loading" );
+    CHECK( data.command_response.loading_id == 1 );
+
+    // The rest are answered as usual.
+    harness.cmd_socket.to_recv("3 telem_keyframe");
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 3 );
+    CHECK( data.command_response.last_rejected_id == 2 );
+    CHECK( data.command_response.loading_id == 1 );
+
+    //-------------------------------------------------------------------------
+    // The loop keeps running while it loads.
+    //
+    std::chrono::steady_clock::duration longest {0};
+    int dispatches = 0;
+    while (data.command_response.last_accepted_id != 1)
+    {
+        REQUIRE( std::chrono::steady_clock::now() - start < std::chrono::seconds(60) );
+
+        const auto before = std::chrono::steady_clock::now();
+        data = harness.dispatch_to_next_message();
+        longest = std::max(longest, std::chrono::steady_clock::now() - before);
+        ++dispatches;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    CHECK( dispatches > 1 );
+    CHECK( longest < elapsed / 2 );
+
+    CHECK( data.command_response.last_accepted_id == 1 );
+    CHECK( data.command_response.last_rejected_id == 2 );
+    CHECK( data.command_response.loading_id == 0 );
+    CHECK( data.sequence == seq.path.string() );
+
+    REQUIRE( data.sequence_state.size() == 1 );
+    CHECK( data.sequence_state[0].id == "z7" );
+    CHECK( data.sequence_state[0].num_events == num_events );
+
+    //-------------------------------------------------------------------------
+    // A file that fails to load is rejected and keeps the current sequence.
+    //
+    harness.cmd_socket.to_recv("4 load_sequence /nope/does-not-exist.seq");
+    data = harness.dispatch_to_next_message();
+    while (data.command_response.last_rejected_id != 4)
+    {
+        data = harness.dispatch_to_next_message();
+    }
+
+    CHECK( data.command_response.last_accepted_id == 1 );
+    CHECK( data.command_response.message == "failed to parse camera sequence file '/nope/does-not-exist.seq'" );
+    CHECK( data.sequence == seq.path.string() );
+}
+
+
+TEST_CASE("CameraControl sequence warnings", "[CameraControl][load_sequence][camera_models]")
+{
+    Harness harness;
+
+    auto models = TempFile(
+        "camera_models.config",
+        R"(
+            z7  trigger_latency  430
+        )"
+    );
+    REQUIRE( harness.cc.load_camera_models(models.path.string()) == result::success );
+
+    auto seq = TempFile(
+        "test.seq",
+        R"(
+            c2  -2.00  z7.trigger  1
+            c2  -1.75  z7.trigger  1
+            c2  -1.50  z7.trigger  1
+            c2  -2.00  z8.trigger  1
+            c2  -1.75  z8.trigger  1
+        )"
+    );
+
+    harness.cmd_socket.to_recv("1 load_sequence " + seq.path.string());
+    auto data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 1 );
+    REQUIRE( data.sequence_state.size() == 2 );
+
+    CHECK( data.sequence_state[0].id == "z7" );
+    REQUIRE( data.sequence_state[0].warnings.size() == 1 );
+    CHECK( data.sequence_state[0].warnings[0] == "falls behind by up to 360 ms, at c2 -00:00:01.500" );
+
+    CHECK( data.sequence_state[1].id == "z8" );
+    CHECK( data.sequence_state[1].warnings.empty() );
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraControl_uto.h>
+
+TEST_CASE("CameraControl", "[CameraControl][precise_trigger]")
+{
+    Harness harness;
+    harness.cc.enable_camera_workers(true);
+    harness.cc.set_control_period(50);
+
+    //-------------------------------------------------------------------------
+    // Two triggers that fall between control ticks.
+    //
+    auto cam1 = make_test_camera();
+    harness.gp2cpp.add_camera(cam1);
+    auto data = harness.dispatch_to_next_message();
+    data = harness.wait_for_workers();
+
+    REQUIRE( data.detected_cameras.size() == 1 );
+    CHECK( data.detected_cameras[0].trigger_lateness_us.count == 0 );
+
+    harness.cmd_socket.to_recv("1 set_camera_id 1234 z7");
+    data = harness.dispatch_to_next_message();
+
+    auto seq = TempFile(
+        "precise.seq",
+        R"(
+            e1 0.020 z7.trigger 1
+            e1 0.270 z7.trigger 1
+        )"
+    );
+
+    harness.cmd_socket.to_recv("2 load_sequence " + seq.path.string());
+    data = harness.dispatch_to_next_message();
+
+    const auto e1 = data.time + 2'000;
+    harness.cmd_socket.to_recv("3 set_events e1 " + std::to_string(e1));
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 3 );
+    CHECK( data.command_response.last_rejected_id == 0 );
+
+    //-------------------------------------------------------------------------
+    // The tick before each trigger has the camera worker sleep to the
+    // trigger's deadline instead of leaving it to the next tick.  The clock is
+    // left alone while the worker sleeps.
+    //
+    data = harness.dispatch_to(e1 - 50);
+
+    CHECK( cam1->trigger_count == 0 );
+    CHECK( harness.clock.sleep_count == 0 );
+
+    REQUIRE( harness.cc.dispatch() == result::success );
+    harness.wait_for_triggers(cam1, 1);
+
+    CHECK( harness.clock.sleep_count == 1 );
+    CHECK( harness.clock.last_sleep_ns == (e1 + 20) * 1'000'000 );
+
+    // The fake sleep jumped the clock to the deadline.
+    CHECK( harness.clock.time_ms == e1 + 20 );
+
+    data = harness.dispatch_to(e1 + 170);
+
+    CHECK( cam1->trigger_count == 1 );
+
+    REQUIRE( harness.cc.dispatch() == result::success );
+    harness.wait_for_triggers(cam1, 2);
+
+    CHECK( harness.clock.sleep_count == 2 );
+    CHECK( harness.clock.last_sleep_ns == (e1 + 270) * 1'000'000 );
+
+    data = harness.wait_for_workers();
+
+    REQUIRE( data.detected_cameras.size() == 1 );
+    const auto lateness = data.detected_cameras[0].trigger_lateness_us;
+    CHECK( lateness.count == 2 );
+    CHECK( lateness.min == 0 );
+    CHECK( lateness.p50 == 0 );
+    CHECK( lateness.p99 == 0 );
+    CHECK( lateness.max == 0 );
+}
@@ -0,0 +1,76 @@
+#include <camera_control/CameraControl_uto.h>
+
+
+TEST_CASE("CameraControl", "[CameraControl][status_poll]")
+{
+    Harness harness;
+    harness.cc.enable_camera_workers(true);
+
+    auto cam1 = make_test_camera();
+    cam1->read_config_ms = 300;
+    cam1->read_widget_ms = 2;
+    harness.gp2cpp.add_camera(cam1);
+    auto data = harness.dispatch_to_next_message();
+    data = harness.wait_for_workers();
+
+    REQUIRE( data.detected_cameras.size() == 1 );
+
+    // Only the reads on connect are the whole tree.
+    const auto config_count = cam1->read_config_count;
+    CHECK( config_count > 0 );
+
+    //-------------------------------------------------------------------------
+    // Each scan only refreshes the widgets shown in telemetry.
+    //
+    const auto status_count = cam1->read_status_count;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        harness.dispatch_to(data.time + 1'000);
+        data = harness.wait_for_workers();
+    }
+
+    CHECK( cam1->read_config_count == config_count );
+    CHECK( cam1->read_status_count >= status_count + 3 );
+    CHECK( cam1->read_properties == str_vec({
+        "batterylevel",
+        "shutterspeed",
+        "expprogram",
+        "f-number",
+        "iso",
+        "imagequality",
+        "availableshots",
+    }));
+
+    REQUIRE( data.detected_cameras.size() == 1 );
+    auto poll = data.detected_cameras[0].poll_usb_us;
+    CHECK( poll.count >= 3 );
+    CHECK( poll.full == 0 );
+
+    // The harness's clock keeps ticking while the worker reads, so at least.
+    CHECK( poll.p50 >= 14'000 );
+    CHECK( poll.p50 < 300'000 );
+    CHECK( poll.total >= 14'000 * poll.count );
+
+    //-------------------------------------------------------------------------
+    // The whole tree is read on request.
+    //
+    harness.cmd_socket.to_recv("1 read_config 1234");
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 1 );
+    CHECK( data.command_response.last_rejected_id == 0 );
+
+    data = harness.wait_for_workers();
+
+    CHECK( cam1->read_config_count == config_count + 1 );
+    poll = data.detected_cameras[0].poll_usb_us;
+    CHECK( poll.full == 1 );
+    CHECK( poll.max >= 300'000 );
+
+    harness.cmd_socket.to_recv("2 read_config 9999");
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_rejected_id == 2 );
+    CHECK( data.command_response.message == "serial '9999' does not exist" );
+}
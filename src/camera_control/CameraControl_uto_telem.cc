@@ -1,4 +1,6 @@
 #include <camera_control/CameraControl_uto_telem.h>
+#include <camera_control/TelemetrySchema.h>
+#include <common/BinaryWriter.h>
 
 // This tells Catch to provide a main() - only do this in one cpp file
 #define CATCH_CONFIG_MAIN
@@ -8,8 +10,12 @@
 // The heavy-duty external heaer.
 #include <nlohmann/json.hpp>
 
-#include <iostream>
+#include <bit>
+#include <charconv>
+#include <cstdlib>
 #include <exception>
+#include <iostream>
+#include <stdexcept>
 
 using json = nlohmann::json;
 using pycontrol::str_vec;
@@ -20,15 +26,30 @@ Telem parse_telem(const std::string & json_str)
     Telem out;
     auto data = json::parse(json_str);
 
+    out.seq = data["seq"];
     out.state = data["state"];
     out.time = data["time"];
 
+    auto clock = data["clock"];
+
+    out.clock.utc_offset_ms = clock["utc_offset_ms"];
+    out.clock.steps = clock["steps"];
+    out.clock.last_step_ms = clock["last_step_ms"];
+    out.clock.held_ms = clock["held_ms"];
+
     auto cmd = data["command_response"];
 
     out.command_response.last_accepted_id = cmd["last_accepted_id"];
     out.command_response.last_rejected_id = cmd["last_rejected_id"];
     out.command_response.message = cmd.value("message", "");
     out.command_response.data = cmd.value("data", str_vec());
+    out.command_response.loading_id = 0;
+    out.command_response.loading_percent = -1;
+    if (cmd.contains("loading"))
+    {
+        out.command_response.loading_id = cmd["loading"]["id"];
+        out.command_response.loading_percent = cmd["loading"]["percent"];
+    }
 
     for (const auto & cam_obj : data["detected_cameras"])
     {
@@ -44,10 +65,56 @@ Telem parse_telem(const std::string & json_str)
             cam_obj["quality"],
             cam_obj["batt"],
             cam_obj["num_avail"],
-            cam_obj["num_photos"]
+            cam_obj["num_photos"],
+            cam_obj.value("usb_pending", 0),
+            cam_obj.value("fire_offset_us", -1),
+            Lateness{
+                cam_obj["trigger_lateness_us"]["count"],
+                cam_obj["trigger_lateness_us"]["min"],
+                cam_obj["trigger_lateness_us"]["p50"],
+                cam_obj["trigger_lateness_us"]["p99"],
+                cam_obj["trigger_lateness_us"]["max"]
+            },
+            TriggerLatencyTelem{
+                cam_obj["trigger_latency"]["us"],
+                cam_obj["trigger_latency"]["dev_us"],
+                cam_obj["trigger_latency"]["samples"],
+                cam_obj["trigger_latency"]["file_added_us"],
+                cam_obj["trigger_latency"]["calibrating"]
+            },
+            LatePolicyTelem{
+                cam_obj["late_policy"]["mode"],
+                cam_obj["late_policy"]["late_ms"],
+                cam_obj["late_policy"]["compressing"],
+                cam_obj["late_policy"]["fired"],
+                cam_obj["late_policy"]["late"],
+                cam_obj["late_policy"]["skipped"],
+                cam_obj["late_policy"]["compressed"]
+            },
+            PollUsbTelem{
+                cam_obj["poll_usb_us"]["count"],
+                cam_obj["poll_usb_us"]["full"],
+                cam_obj["poll_usb_us"]["p50"],
+                cam_obj["poll_usb_us"]["max"],
+                cam_obj["poll_usb_us"]["total"]
+            }
         );
     }
 
+    auto skew = data["trigger_skew"];
+
+    out.trigger_skew.groups = skew["groups"];
+    out.trigger_skew.cameras = skew["cameras"];
+    out.trigger_skew.skew_us = skew["skew_us"];
+    out.trigger_skew.max_skew_us = skew["max_skew_us"];
+    out.trigger_skew.timeouts = skew["timeouts"];
+
+    auto open = data["camera_open"];
+
+    out.camera_open.cameras = open["cameras"];
+    out.camera_open.ms = open["ms"];
+    out.camera_open.ready_ms = open["ready_ms"];
+
     for (auto & [event_id, timestamp] : data["events"].items())
     {
         out.events[event_id] = timestamp;
@@ -61,6 +128,7 @@ Telem parse_telem(const std::string & json_str)
 
         ss.num_events = data_seq_state["num_events"];
         ss.id = data_seq_state["id"];
+        ss.warnings = data_seq_state.value("warnings", str_vec());
 
         for (auto & cam_event : data_seq_state["events"])
         {
@@ -79,3 +147,200 @@ Telem parse_telem(const std::string & json_str)
 
     return out;
 }
+
+
+std::string
+apply_telem_delta(std::string & keyframe, const std::string & json_str)
+{
+    if (json_str.starts_with(pycontrol::BinaryWriter::MAGIC))
+    {
+        keyframe = binary_telem_to_json(json_str);
+        return keyframe;
+    }
+
+    if (not json_str.starts_with("{\"keyframe\":"))
+    {
+        keyframe = json_str;
+        return json_str;
+    }
+
+    auto data = json::parse(json_str);
+
+    auto out = json::parse(keyframe);
+    if (out["seq"] != data["keyframe"])
+    {
+        throw std::runtime_error("delta against keyframe " + data["keyframe"].dump() +
+                                 ", have " + out["seq"].dump());
+    }
+
+    for (auto & [path, value] : data["delta"].items())
+    {
+        out[json::json_pointer(path)] = value;
+    }
+
+    return out.dump();
+}
+
+
+namespace
+{
+    using Tag = pycontrol::BinaryWriter::Tag;
+
+    struct BinaryReader
+    {
+        const std::string & bytes;
+        std::size_t pos;
+
+        std::uint64_t
+        get(std::size_t size)
+        {
+            if (pos + size > bytes.size())
+            {
+                throw std::runtime_error("binary telemetry ends early");
+            }
+            std::uint64_t out = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                out |= std::uint64_t{static_cast<std::uint8_t>(bytes[pos++])} << (8 * i);
+            }
+            return out;
+        }
+
+        std::string
+        text(std::size_t length_size)
+        {
+            const auto length = get(length_size);
+            if (pos + length > bytes.size())
+            {
+                throw std::runtime_error("binary telemetry ends early");
+            }
+            pos += length;
+            return bytes.substr(pos - length, length);
+        }
+
+        // As JSON writes a float, 0.05f is 0.05 rather than 0.0500000007.
+        static double
+        shortest(float number)
+        {
+            char digits[32];
+            *std::to_chars(digits, digits + sizeof(digits) - 1, number).ptr = '\0';
+            return std::strtod(digits, nullptr);
+        }
+
+        template <typename T>
+        T
+        as(std::size_t size)
+        {
+            return static_cast<T>(get(size));
+        }
+
+        // Returns false at an end tag.
+        bool
+        value(json & out)
+        {
+            switch (static_cast<Tag>(get(1)))
+            {
+                case Tag::null:        out = nullptr; break;
+                case Tag::false_value: out = false; break;
+                case Tag::true_value:  out = true; break;
+                case Tag::uint8:       out = get(1); break;
+                case Tag::uint16:      out = get(2); break;
+                case Tag::uint32:      out = get(4); break;
+                case Tag::uint64:      out = get(8); break;
+                case Tag::int8:        out = as<std::int8_t>(1); break;
+                case Tag::int16:       out = as<std::int16_t>(2); break;
+                case Tag::int32:       out = as<std::int32_t>(4); break;
+                case Tag::int64:       out = as<std::int64_t>(8); break;
+                case Tag::float32:     out = shortest(std::bit_cast<float>(as<std::uint32_t>(4))); break;
+                case Tag::float64:     out = std::bit_cast<double>(get(8)); break;
+                case Tag::string:      out = text(2); break;
+                case Tag::json:        out = json::parse(text(2)); break;
+                case Tag::end:         return false;
+                case Tag::array:
+                {
+                    out = json::array();
+                    json item;
+                    while (value(item))
+                    {
+                        out.push_back(item);
+                    }
+                    break;
+                }
+                case Tag::object:
+                {
+                    out = json::object();
+                    while (true)
+                    {
+                        std::string name;
+                        const auto tag = static_cast<Tag>(get(1));
+                        if (tag == Tag::end)
+                        {
+                            break;
+                        }
+                        else if (tag == Tag::key_index)
+                        {
+                            name = pycontrol::TELEMETRY_KEYS[get(1)];
+                        }
+                        else if (tag == Tag::key_string)
+                        {
+                            name = text(1);
+                        }
+                        else
+                        {
+                            throw std::runtime_error("expected a key in binary telemetry");
+                        }
+                        value(out[name]);
+                    }
+                    break;
+                }
+                default:
+                {
+                    throw std::runtime_error("unknown tag in binary telemetry");
+                }
+            }
+            return true;
+        }
+    };
+}
+
+
+std::string
+binary_telem_to_json(const std::string & bytes)
+{
+    BinaryReader reader {bytes, pycontrol::BinaryWriter::MAGIC.size()};
+    if (reader.get(2) != pycontrol::TELEMETRY_VERSION)
+    {
+        throw std::runtime_error("unknown binary telemetry version");
+    }
+    reader.get(2);
+
+    json out;
+    reader.value(out);
+    if (reader.pos != bytes.size())
+    {
+        throw std::runtime_error("binary telemetry has bytes left over");
+    }
+    return out.dump();
+}
+
+
+bool
+same_telem(
+    const std::string & a,
+    const std::string & b,
+    const std::vector<std::string> & ignore)
+{
+    auto a_data = json::parse(a);
+    auto b_data = json::parse(b);
+    for (const auto & key : ignore)
+    {
+        a_data.erase(key);
+        b_data.erase(key);
+    }
+    if (a_data != b_data)
+    {
+        std::cerr << "a: " << a_data.dump() << "\nb: " << b_data.dump() << std::endl;
+        return false;
+    }
+    return true;
+}
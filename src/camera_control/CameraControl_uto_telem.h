@@ -9,12 +9,60 @@
 #include <common/types.h>
 
 
+struct ClockState
+{
+    pycontrol::milliseconds utc_offset_ms;
+    unsigned int steps;
+    pycontrol::milliseconds last_step_ms;
+    pycontrol::milliseconds held_ms;
+};
+
 struct CommandResponse
 {
     unsigned int last_accepted_id;
     unsigned int last_rejected_id;
     std::string message;
     std::vector<std::string> data;
+    unsigned int loading_id;
+    int loading_percent;
+};
+
+struct Lateness
+{
+    unsigned int count;
+    int min;
+    int p50;
+    int p99;
+    int max;
+};
+
+struct TriggerLatencyTelem
+{
+    int us;
+    int dev_us;
+    unsigned int samples;
+    int file_added_us;
+    unsigned int calibrating;
+};
+
+struct LatePolicyTelem
+{
+    std::string mode;
+    int late_ms;
+    bool compressing;
+    unsigned int fired;
+    unsigned int late;
+    unsigned int skipped;
+    unsigned int compressed;
+};
+
+struct PollUsbTelem
+{
+    unsigned int count;
+    unsigned int full;
+    int p50;
+    int max;
+    std::int64_t total;
 };
 
 struct DetectedCamera
@@ -31,6 +79,28 @@ struct DetectedCamera
     std::string batt;
     int num_avail;
     int num_photos;
+    int usb_pending;
+    int fire_offset_us;
+    Lateness trigger_lateness_us;
+    TriggerLatencyTelem trigger_latency;
+    LatePolicyTelem late_policy;
+    PollUsbTelem poll_usb_us;
+};
+
+struct TriggerSkew
+{
+    unsigned int groups;
+    unsigned int cameras;
+    int skew_us;
+    int max_skew_us;
+    unsigned int timeouts;
+};
+
+struct CameraOpen
+{
+    unsigned int cameras;
+    int ms;
+    int ready_ms;
 };
 
 struct CameraEvent
@@ -47,16 +117,21 @@ struct SequenceState
 {
     unsigned int num_events;
     std::string id;
+    std::vector<std::string> warnings;
     std::vector<CameraEvent> events;
 };
 
 
 struct Telem
 {
+    std::uint64_t seq;
     std::string state;
     pycontrol::milliseconds time;
+    ClockState clock;
     CommandResponse command_response;
     std::vector<DetectedCamera> detected_cameras;
+    TriggerSkew trigger_skew;
+    CameraOpen camera_open;
     std::map<std::string, pycontrol::milliseconds> events;
     std::string sequence;
     std::vector<SequenceState> sequence_state;
@@ -64,3 +139,17 @@ struct Telem
 
 
 Telem parse_telem(const std::string & json_str);
+
+// Whole telemetry becomes the keyframe and is returned as JSON, a delta is
+// applied to the keyframe it was taken against and the whole telemetry
+// returned.
+std::string apply_telem_delta(std::string & keyframe, const std::string & json_str);
+
+// Binary telemetry as JSON, see BinaryWriter.h.
+std::string binary_telem_to_json(const std::string & bytes);
+
+// The same JSON values, but for the top level keys ignored.
+bool same_telem(
+    const std::string & a,
+    const std::string & b,
+    const std::vector<std::string> & ignore);
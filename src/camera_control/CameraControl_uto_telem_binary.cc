@@ -0,0 +1,70 @@
+#include <algorithm>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraControl_uto.h>
+#include <camera_control/TelemetrySchema.h>
+
+TEST_CASE("CameraControl", "[CameraControl][telem_binary]")
+{
+    Harness harness;
+    harness.cc.enable_binary_telemetry(true);
+
+    const auto & messages = harness.tlm_socket.from_send();
+
+    //-------------------------------------------------------------------------
+    // Binary telemetry reads back as the JSON would.
+    //
+    harness.gp2cpp.add_camera(make_test_camera());
+    auto data = harness.dispatch_to(2000);
+
+    REQUIRE( messages.back().starts_with("PCTB") );
+    REQUIRE( data.detected_cameras.size() == 1 );
+    CHECK( data.detected_cameras[0].serial == "1234" );
+    CHECK( data.detected_cameras[0].connected == true );
+
+    harness.cmd_socket.to_recv("1 set_camera_id 1234 z7");
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 1 );
+    CHECK( data.detected_cameras[0].desc == "z7" );
+
+    // The command response is an object like any other, not JSON text.
+    const auto response_key = std::ranges::find(TELEMETRY_KEYS, "command_response") - std::begin(TELEMETRY_KEYS);
+    const std::string response_object {'\x40', static_cast<char>(response_key), '\x31'};
+    CHECK( messages.back().find(response_object) != std::string::npos );
+
+    harness.cmd_socket.to_recv("2 read_choices 1234 iso");
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 2 );
+    CHECK( data.command_response.data == str_vec{"64", "100", "200", "500"} );
+
+    //-------------------------------------------------------------------------
+    // The same values as the JSON telemetry, negative numbers, floats, event
+    // ids as keys and all, in fewer bytes.
+    //
+    Harness other;
+    other.cc.enable_binary_telemetry(true);
+
+    other.cmd_socket.to_recv("1 set_events e1 1750627393194 e2 -1000");
+    other.dispatch_to_next_message();
+    other.cmd_socket.to_recv("2 timelapse_enable");
+    other.dispatch_to_next_message();
+    data = other.dispatch_to_next_message();
+
+    CHECK( data.state == "timelapse_idle" );
+    CHECK( data.events.size() == 2 );
+
+    const auto binary = other.tlm_socket.from_send().back();
+    REQUIRE( binary.starts_with("PCTB") );
+
+    other.cc.enable_binary_telemetry(false);
+    other.dispatch_to_next_message();
+
+    const auto text = other.tlm_socket.from_send().back();
+    REQUIRE( text.starts_with("{") );
+
+    CHECK( same_telem(binary_telem_to_json(binary), text, {"seq", "time"}) );
+    CHECK( binary.size() < text.size() );
+}
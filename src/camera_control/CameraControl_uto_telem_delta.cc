@@ -0,0 +1,162 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraControl_uto.h>
+
+namespace
+{
+    bool
+    is_delta(const std::string & message)
+    {
+        return message.starts_with("{\"keyframe\":");
+    }
+
+    // The telemetry sent since, whole or delta.
+    std::pair<std::size_t, std::size_t>
+    count(const str_vec & messages, std::size_t since)
+    {
+        std::size_t keyframes = 0;
+        std::size_t deltas = 0;
+        for (auto i = since; i < messages.size(); ++i)
+        {
+            if (is_delta(messages[i]))
+            {
+                ++deltas;
+            }
+            else
+            {
+                ++keyframes;
+            }
+        }
+        return {keyframes, deltas};
+    }
+}
+
+TEST_CASE("CameraControl", "[CameraControl][telem_delta]")
+{
+    //-------------------------------------------------------------------------
+    // Off by default, every message is whole.
+    //
+    {
+        Harness harness;
+        harness.gp2cpp.add_camera(make_test_camera());
+
+        auto data = harness.dispatch_to(3000);
+        CHECK( data.detected_cameras.size() == 1 );
+
+        for (const auto & message : harness.tlm_socket.from_send())
+        {
+            CHECK( not is_delta(message) );
+        }
+    }
+
+    Harness harness;
+    harness.cc.enable_telem_delta(5000);
+
+    harness.gp2cpp.add_camera(make_test_camera("Z 7", "usb:001,001", "1111"));
+    harness.gp2cpp.add_camera(make_test_camera("Z 8", "usb:001,002", "2222"));
+
+    auto data = harness.dispatch_to(2000);
+    CHECK( data.detected_cameras.size() == 2 );
+
+    const auto & messages = harness.tlm_socket.from_send();
+
+    //-------------------------------------------------------------------------
+    // A keyframe every 5 seconds, numbered deltas against it in between, each
+    // much smaller than the whole telemetry.  Telemetry is 1 Hz while
+    // monitoring cameras.
+    //
+    auto since = messages.size();
+    auto seq = data.seq;
+    std::size_t keyframe_size = 0;
+    for (const auto & message : messages)
+    {
+        if (not is_delta(message))
+        {
+            keyframe_size = message.size();
+        }
+    }
+
+    for (int i = 0; i < 10; ++i)
+    {
+        data = harness.dispatch_to_next_message();
+        CHECK( data.seq == ++seq );
+        CHECK( data.detected_cameras.size() == 2 );
+
+        if (is_delta(messages.back()))
+        {
+            CHECK( messages.back().size() * 4 < keyframe_size );
+        }
+        else
+        {
+            keyframe_size = messages.back().size();
+        }
+    }
+    CHECK( count(messages, since) == std::make_pair<std::size_t, std::size_t>(2, 8) );
+
+    //-------------------------------------------------------------------------
+    // A rename is only the renamed camera's desc and the command response.
+    //
+    harness.cmd_socket.to_recv("1 set_camera_id 2222 z8");
+    data = harness.dispatch_to_next_message();
+
+    REQUIRE( is_delta(messages.back()) );
+    CHECK( messages.back().find("\"/detected_cameras/1/desc\":\"z8\"") != std::string::npos );
+    CHECK( messages.back().find("\"/command_response/last_accepted_id\":1") != std::string::npos );
+    CHECK( messages.back().find("serial") == std::string::npos );
+
+    CHECK( data.command_response.last_accepted_id == 1 );
+    CHECK( data.detected_cameras[0].desc == "Nikon Corporation Z 7" );
+    CHECK( data.detected_cameras[1].desc == "z8" );
+
+    //-------------------------------------------------------------------------
+    // A client that missed its keyframe asks for another.
+    //
+    harness.cmd_socket.to_recv("2 telem_keyframe");
+    data = harness.dispatch_to_next_message();
+
+    CHECK( not is_delta(messages.back()) );
+    CHECK( data.command_response.last_accepted_id == 2 );
+    CHECK( data.detected_cameras[1].desc == "z8" );
+
+    //-------------------------------------------------------------------------
+    // A camera plugged in changes the shape, that's a keyframe too.
+    //
+    harness.gp2cpp.add_camera(make_test_camera("Z 6", "usb:001,003", "3333"));
+    for (int i = 0; i < 4 and data.detected_cameras.size() == 2; ++i)
+    {
+        data = harness.dispatch_to_next_message();
+    }
+
+    REQUIRE( data.detected_cameras.size() == 3 );
+    CHECK( not is_delta(messages.back()) );
+
+    //-------------------------------------------------------------------------
+    // Executing, telemetry is sent every DELTA_SEND_MS.
+    //
+    auto sequence = TempFile(
+        "telem_delta.seq",
+        R"(
+            e1 0.0 z8.trigger 1
+        )"
+    );
+
+    harness.cmd_socket.to_recv("3 load_sequence " + sequence.path.string());
+    data = harness.dispatch_to_next_message();
+
+    harness.cmd_socket.to_recv("4 set_events e1 " + std::to_string(data.time + 3'000));
+    data = harness.dispatch_to_next_message();
+    CHECK( data.command_response.last_accepted_id == 4 );
+
+    for (int i = 0; i < 20 and data.state != "executing"; ++i)
+    {
+        data = harness.dispatch_to_next_message();
+    }
+    REQUIRE( data.state == "executing" );
+
+    const auto time0 = data.time;
+    data = harness.dispatch_to_next_message();
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.state == "executing" );
+    CHECK( data.time - time0 == 2 * CameraControl::DELTA_SEND_MS );
+}
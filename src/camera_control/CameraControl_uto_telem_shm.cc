@@ -0,0 +1,72 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraControl_uto.h>
+#include <common/ShmTelemetry.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+TEST_CASE("CameraControl", "[CameraControl][telem_shm]")
+{
+    const auto name = "pycontrol_uto_telem_" + std::to_string(::getpid());
+
+    ShmPublisher publisher;
+    REQUIRE( publisher.open(name) == result::success );
+
+    ShmReader reader;
+    REQUIRE( reader.open(name) == result::success );
+
+    std::string snapshot;
+    std::uint64_t frame = 0;
+    std::int64_t time_ns = 0;
+
+    //-------------------------------------------------------------------------
+    // The same telemetry as sent, frame for frame.
+    //
+    Harness harness;
+    harness.cc.enable_shm_telemetry(&publisher);
+    harness.gp2cpp.add_camera(make_test_camera());
+
+    const auto & messages = harness.tlm_socket.from_send();
+
+    auto data = harness.dispatch_to(2000);
+    REQUIRE( data.detected_cameras.size() == 1 );
+
+    REQUIRE( reader.read(snapshot, frame, time_ns) );
+    CHECK( snapshot == messages.back() );
+    CHECK( frame == messages.size() );
+
+    //-------------------------------------------------------------------------
+    // Always whole, even while deltas are sent.
+    //
+    harness.cc.enable_telem_delta(5000);
+    harness.dispatch_to_next_message();
+    harness.cmd_socket.to_recv("1 set_camera_id 1234 z7");
+    harness.dispatch_to_next_message();
+
+    REQUIRE( messages.back().starts_with("{\"keyframe\":") );
+
+    std::string keyframe;
+    std::string whole;
+    for (const auto & message : messages)
+    {
+        whole = apply_telem_delta(keyframe, message);
+    }
+
+    REQUIRE( reader.read(snapshot, frame, time_ns) );
+    CHECK( frame == messages.size() );
+    CHECK( same_telem(snapshot, whole, {}) );
+    CHECK( snapshot.find("\"desc\":\"z7\"") != std::string::npos );
+
+    //-------------------------------------------------------------------------
+    // And in the binary encoding when that's what's sent.
+    //
+    harness.cc.enable_binary_telemetry(true);
+    harness.dispatch_to_next_message();
+
+    REQUIRE( reader.read(snapshot, frame, time_ns) );
+    CHECK( snapshot.starts_with("PCTB") );
+    CHECK( snapshot == messages.back() );
+
+    ::shm_unlink(("/" + name).c_str());
+}
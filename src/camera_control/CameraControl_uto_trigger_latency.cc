@@ -0,0 +1,136 @@
+#include <filesystem>
+#include <fstream>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraControl_uto.h>
+
+TEST_CASE("CameraControl", "[CameraControl][calibrate_trigger]")
+{
+    const auto file = TempFile("calibrate_trigger.config");
+    const auto filename = file.path.string();
+
+    // The control's destructor saves the file again.
+    {
+        Harness harness;
+
+        // No file yet, cameras start uncalibrated.
+        REQUIRE( harness.cc.load_trigger_latencies(filename) == result::success );
+
+        auto cam1 = make_test_camera();
+        cam1->trigger_ms = 40;
+        cam1->file_added_events = true;
+        harness.gp2cpp.add_camera(cam1);
+        auto data = harness.dispatch_to_next_message();
+        data = harness.dispatch_to_next_message();
+
+        REQUIRE( data.detected_cameras.size() == 1 );
+        CHECK( data.detected_cameras[0].trigger_latency.samples == 0 );
+        CHECK( data.detected_cameras[0].trigger_latency.us == 0 );
+
+        //---------------------------------------------------------------------
+        // Bad commands.
+        //
+        harness.cmd_socket.to_recv("1 calibrate_trigger 1234");
+        data = harness.dispatch_to_next_message();
+        CHECK( data.command_response.last_rejected_id == 1 );
+
+        harness.cmd_socket.to_recv("2 calibrate_trigger 9999 5");
+        data = harness.dispatch_to_next_message();
+        CHECK( data.command_response.last_rejected_id == 2 );
+        CHECK( data.command_response.message == "serial '9999' does not exist" );
+
+        CHECK( cam1->trigger_count == 0 );
+
+        //---------------------------------------------------------------------
+        // Five shots, each taking the fake 40 ms to fire.
+        //
+        harness.cmd_socket.to_recv("3 calibrate_trigger 1234 5");
+        data = harness.dispatch_to_next_message();
+        data = harness.dispatch_to_next_message();
+
+        CHECK( data.command_response.last_accepted_id == 3 );
+        CHECK( cam1->trigger_count == 5 );
+
+        REQUIRE( data.detected_cameras.size() == 1 );
+        const auto latency = data.detected_cameras[0].trigger_latency;
+        CHECK( latency.us == 40'000 );
+        CHECK( latency.dev_us == 0 );
+        CHECK( latency.samples == 5 );
+        CHECK( latency.file_added_us == 40'000 );
+        CHECK( latency.calibrating == 0 );
+        CHECK( data.detected_cameras[0].num_photos == 5 );
+
+        // Saved as soon as the calibration finished.
+        trigger_latency_map saved;
+        REQUIRE( read_trigger_latencies(filename, saved) == result::success );
+        REQUIRE( saved.contains("1234") );
+        CHECK( saved["1234"].estimate_ns == 40'000'000 );
+        CHECK( saved["1234"].samples == 5 );
+    }
+}
+
+
+TEST_CASE("CameraControl", "[CameraControl][trigger_latency]")
+{
+    auto file = TempFile(
+        "trigger_latency.config",
+        "1234  30000  1000  10  0\n"
+    );
+
+    Harness harness;
+    harness.cc.enable_camera_workers(true);
+    harness.cc.set_control_period(50);
+    REQUIRE( harness.cc.load_trigger_latencies(file.path.string()) == result::success );
+
+    auto cam1 = make_test_camera();
+    cam1->trigger_ms = 30;
+    harness.gp2cpp.add_camera(cam1);
+    auto data = harness.dispatch_to_next_message();
+    data = harness.wait_for_workers();
+
+    REQUIRE( data.detected_cameras.size() == 1 );
+    CHECK( data.detected_cameras[0].trigger_latency.us == 30'000 );
+    CHECK( data.detected_cameras[0].trigger_latency.samples == 10 );
+
+    harness.cmd_socket.to_recv("1 set_camera_id 1234 z7");
+    data = harness.dispatch_to_next_message();
+
+    auto seq = TempFile(
+        "trigger_latency.seq",
+        R"(
+            e1 0.020 z7.trigger 1
+        )"
+    );
+
+    harness.cmd_socket.to_recv("2 load_sequence " + seq.path.string());
+    data = harness.dispatch_to_next_message();
+
+    const auto e1 = data.time + 2'000;
+    harness.cmd_socket.to_recv("3 set_events e1 " + std::to_string(e1));
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 3 );
+
+    //-------------------------------------------------------------------------
+    // The trigger goes out 30 ms early so the exposure lands on e1 + 20.
+    //
+    data = harness.dispatch_to(e1 - 100);
+
+    CHECK( cam1->trigger_count == 0 );
+
+    REQUIRE( harness.cc.dispatch() == result::success );
+    harness.wait_for_triggers(cam1, 1);
+
+    CHECK( harness.clock.sleep_count == 1 );
+    CHECK( harness.clock.last_sleep_ns == (e1 + 20 - 30) * 1'000'000 );
+
+    data = harness.wait_for_workers();
+
+    REQUIRE( data.detected_cameras.size() == 1 );
+    CHECK( data.detected_cameras[0].trigger_lateness_us.max == 0 );
+
+    // The trigger added a sample that agreed with the model.
+    CHECK( data.detected_cameras[0].trigger_latency.us == 30'000 );
+    CHECK( data.detected_cameras[0].trigger_latency.samples == 11 );
+}
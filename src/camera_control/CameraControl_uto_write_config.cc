@@ -0,0 +1,94 @@
+#include <camera_control/CameraControl_uto.h>
+
+
+TEST_CASE("CameraControl", "[CameraControl][write_config]")
+{
+    Harness harness;
+
+    auto cam1 = make_test_camera();
+    harness.gp2cpp.add_camera(cam1);
+    auto data = harness.dispatch_to_next_message();
+    data = harness.dispatch_to_next_message();
+
+    REQUIRE( data.detected_cameras.size() == 1 );
+    CHECK( data.detected_cameras[0].iso == "64" );
+    CHECK( data.detected_cameras[0].shutter == "1/1000" );
+
+    const auto write_count = cam1->write_config_count;
+    const auto property_count = cam1->write_property_count;
+
+    //-------------------------------------------------------------------------
+    // Setting what the camera already has writes nothing.
+    //
+    harness.cmd_socket.to_recv("1 set_choice 1234 iso 64");
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 1 );
+    CHECK( cam1->write_config_count == write_count );
+    CHECK( cam1->write_property_count == property_count );
+
+    //-------------------------------------------------------------------------
+    // Only the setting that changed is written.
+    //
+    harness.cmd_socket.to_recv("2 set_choice 1234 iso 200");
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 2 );
+    CHECK( data.detected_cameras[0].iso == "200" );
+    CHECK( cam1->write_config_count == write_count + 1 );
+    CHECK( cam1->write_property_count == property_count + 1 );
+    CHECK( cam1->written_properties == str_vec({"iso"}) );
+
+    //-------------------------------------------------------------------------
+    // A failed write is sent again with the next flush.
+    //
+    cam1->write_config_result = false;
+
+    harness.cmd_socket.to_recv("3 set_choice 1234 iso 500");
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_rejected_id == 3 );
+    CHECK( cam1->write_config_count == write_count + 2 );
+
+    cam1->write_config_result = true;
+
+    harness.cmd_socket.to_recv("4 set_choice 1234 shutterspeed 1/250");
+    data = harness.dispatch_to_next_message();
+
+    CHECK( data.command_response.last_accepted_id == 4 );
+    CHECK( cam1->write_config_count == write_count + 3 );
+    CHECK( cam1->written_properties == str_vec({"shutterspeed", "iso"}) );
+
+    //-------------------------------------------------------------------------
+    // Nothing changed since, a sequence's flush before its trigger is skipped.
+    //
+    harness.cmd_socket.to_recv("5 set_camera_id 1234 z7");
+    data = harness.dispatch_to_next_message();
+
+    auto seq = TempFile(
+        "write_config.seq",
+        "e1 0.0 z7.iso 500\n"
+        "e1 0.1 z7.trigger 1\n"
+        "e1 0.2 z7.shutter_speed 1/500\n"
+        "e1 0.2 z7.iso 500\n"
+        "e1 0.3 z7.trigger 1\n"
+    );
+
+    harness.cmd_socket.to_recv("6 load_sequence " + seq.path.string());
+    data = harness.dispatch_to_next_message();
+    REQUIRE( data.command_response.last_accepted_id == 6 );
+
+    const auto e1 = data.time + 1'000;
+    harness.cmd_socket.to_recv("7 set_events e1 " + std::to_string(e1));
+    data = harness.dispatch_to_next_message();
+    REQUIRE( data.command_response.last_accepted_id == 7 );
+
+    harness.dispatch_to(e1 + 100);
+    CHECK( cam1->trigger_count == 1 );
+    CHECK( cam1->write_config_count == write_count + 3 );
+
+    harness.dispatch_to(e1 + 300);
+    CHECK( cam1->trigger_count == 2 );
+    CHECK( cam1->write_config_count == write_count + 4 );
+    CHECK( cam1->written_properties == str_vec({"shutterspeed"}) );
+}
@@ -0,0 +1,181 @@
+#include <pthread.h>
+
+#include <algorithm>
+
+#include <camera_control/Camera.h>
+#include <camera_control/CameraOpener.h>
+
+#include <common/io.h>
+
+namespace pycontrol
+{
+
+
+CameraOpener::
+CameraOpener(
+    interface::GPhoto2Cpp & gp2cpp,
+    interface::WallClock & clock,
+    std::size_t num_threads)
+:
+    _gp2cpp(gp2cpp),
+    _clock(clock),
+    _num_threads{std::max<std::size_t>(num_threads, 1)}
+{
+}
+
+
+CameraOpener::
+~CameraOpener()
+{
+    if (not _threads.empty())
+    {
+        // Threads still opening finish their camera first.
+        _stop.store(true, std::memory_order_release);
+        _wake.release(static_cast<std::ptrdiff_t>(_threads.size()));
+        for (auto & thread : _threads)
+        {
+            thread.join();
+        }
+    }
+
+    delete _batch.exchange(nullptr);
+}
+
+
+result
+CameraOpener::
+open(std::unique_ptr<CameraOpenBatch> && batch)
+{
+    ABORT_IF(_busy, "cameras are already opening", result::failure);
+
+    if (_threads.empty())
+    {
+        for (std::size_t i = 0; i < _num_threads; ++i)
+        {
+            _threads.emplace_back(&CameraOpener::_loop, this);
+            pthread_setname_np(_threads.back().native_handle(), "camera_open");
+        }
+    }
+
+    _busy = true;
+
+    // Every thread woken works on this batch until it runs out of ports.
+    const auto num_threads = std::min(batch->openings.size(), _threads.size());
+    batch->threads.store(num_threads, std::memory_order_relaxed);
+    _batch.store(batch.release(), std::memory_order_release);
+
+    if (num_threads == 0)
+    {
+        _finished.release();
+        return result::success;
+    }
+
+    _wake.release(static_cast<std::ptrdiff_t>(num_threads));
+
+    return result::success;
+}
+
+
+std::unique_ptr<CameraOpenBatch>
+CameraOpener::
+poll(bool wait)
+{
+    if (not _busy)
+    {
+        return nullptr;
+    }
+
+    if (wait)
+    {
+        _finished.acquire();
+    }
+    else if (not _finished.try_acquire())
+    {
+        return nullptr;
+    }
+
+    _busy = false;
+
+    return std::unique_ptr<CameraOpenBatch>(
+        _batch.exchange(nullptr, std::memory_order_acq_rel));
+}
+
+
+void
+CameraOpener::
+_loop()
+{
+    while (true)
+    {
+        _wake.acquire();
+
+        if (_stop.load(std::memory_order_acquire))
+        {
+            break;
+        }
+
+        auto * batch = _batch.load(std::memory_order_acquire);
+        auto & openings = batch->openings;
+        for (auto idx = batch->next++; idx < openings.size(); idx = batch->next++)
+        {
+            _open(openings[idx], batch->profiles);
+        }
+
+        // The batch belongs to the control thread again once the last thread
+        // leaves it.
+        if (batch->threads.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            _finished.release();
+        }
+    }
+}
+
+
+void
+CameraOpener::
+_open(CameraOpening & opening, const camera_profile_map & profiles)
+{
+    auto camera = _gp2cpp.open_camera(opening.port);
+    if (not camera)
+    {
+        INFO_LOG << "gphoto2cpp::open_camera() failed, ignoring" << std::endl;
+        return;
+    }
+
+    // The only full read, the Camera is initialized from it.
+    if (not _gp2cpp.read_config(camera))
+    {
+        ERROR_LOG
+            << "gphoto2cpp::read_config(camera) failed"
+            << std::endl;
+        return;
+    }
+
+    if (not _gp2cpp.read_property(camera, "serialnumber", opening.serial))
+    {
+        ERROR_LOG
+            << "gphoto2cpp::read_property(\"serialnumber\") failed"
+            << std::endl;
+        return;
+    }
+
+    opening.camera = std::make_shared<Camera>(
+        _gp2cpp,
+        _clock,
+        camera,
+        opening.port,
+        opening.serial,
+        "camera.config",
+        &profiles
+    );
+
+    // A profile learned from this camera records its choices, read them here
+    // rather than from the control thread.
+    if (not profiles.contains(opening.camera->profile_key()))
+    {
+        opening.camera->profile();
+    }
+}
+
+
+} /* namespace pycontrol */
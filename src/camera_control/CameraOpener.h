@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+#include <common/types.h>
+
+#include <interface/GPhoto2Cpp.h>
+#include <interface/WallClock.h>
+
+#include <camera_control/CameraProfile.h>
+
+namespace pycontrol
+{
+
+class Camera;
+
+
+// One new port's USB setup, everything up to handing the camera to the
+// control thread.  The Camera is built for every port opened, for a serial
+// already known the control thread only takes its handle and probes, see
+// Camera::reconnect().
+struct CameraOpening
+{
+    UsbPort                 port;
+    Serial                  serial {};
+    std::shared_ptr<Camera> camera {};  // nullptr when the port failed to open.
+    bool                    merged {false};
+};
+
+
+// The ports found by one scan, opened side by side and merged together.
+struct CameraOpenBatch
+{
+    // Request.
+    std::vector<CameraOpening> openings {};
+    nanoseconds                begin_ns {0};
+
+    // A copy, the control thread keeps learning profiles while the batch
+    // opens.
+    camera_profile_map         profiles {};
+
+    // The pool threads claim openings by index, the last thread out hands the
+    // batch back.
+    std::atomic<std::size_t>   next {0};
+    std::atomic<std::size_t>   threads {0};
+
+    // Merge, filled in by the control thread.
+    std::size_t                connected {0};
+};
+
+
+// A small persistent pool of threads opening new cameras, each open and full
+// config read takes most of a second.  The threads are started by the first
+// open() and live until the opener is destroyed.
+//
+// open(), poll() and busy() must be called from the same thread, the control
+// thread.  One batch is opened at a time.
+class CameraOpener
+{
+public:
+
+    CameraOpener(
+        interface::GPhoto2Cpp & gp2cpp,
+        interface::WallClock & clock,
+        std::size_t num_threads);
+    ~CameraOpener();
+
+    // Fails if a batch is already opening.
+    result open(std::unique_ptr<CameraOpenBatch> && batch);
+
+    // The opened batch, or nullptr if it's still opening.  With wait, blocks
+    // until it's opened.
+    std::unique_ptr<CameraOpenBatch> poll(bool wait = false);
+
+    bool busy() const { return _busy; }
+
+private:
+
+    CameraOpener(const CameraOpener & copy) = delete;
+    CameraOpener & operator=(const CameraOpener & rhs) = delete;
+
+    void _loop();
+    void _open(CameraOpening & opening, const camera_profile_map & profiles);
+
+    interface::GPhoto2Cpp &     _gp2cpp;
+    interface::WallClock &      _clock;
+    std::size_t                 _num_threads;
+
+    // Only replaced while no batch is opening, the semaphores order it.
+    std::atomic<CameraOpenBatch *> _batch {nullptr};
+    bool                        _busy {false};
+
+    std::counting_semaphore<>   _wake {0};
+    std::counting_semaphore<>   _finished {0};
+    std::atomic<bool>           _stop {false};
+
+    std::vector<std::thread>    _threads {};
+};
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,125 @@
+#include <camera_control/CameraProfile.h>
+
+#include <common/io.h>
+#include <common/str_utils.h>
+
+#include <cstdio>
+#include <fstream>
+
+namespace pycontrol
+{
+
+
+result
+read_camera_profiles(const std::string & filename, camera_profile_map & out)
+{
+    out.clear();
+
+    std::ifstream fin(filename);
+
+    ABORT_IF_NOT(fin.is_open(), "error opening file '" << filename << "'", result::failure);
+
+    CameraProfile * profile {nullptr};
+
+    std::string line;
+    while (std::getline(fin, line))
+    {
+        auto tokens = split(line, "\t");
+
+        if (tokens.empty() or tokens[0][0] == '#')
+        {
+            continue;
+        }
+
+        const auto & kind = tokens[0];
+
+        if (kind == "profile")
+        {
+            ABORT_IF(
+                tokens.size() != 3,
+                filename << ": expecting 'profile model firmware', got '" << line << "'",
+                result::failure
+            );
+
+            CameraProfile next {.model = tokens[1], .firmware = tokens[2]};
+            profile = &(out[next.key()] = std::move(next));
+            continue;
+        }
+
+        ABORT_IF(
+            profile == nullptr,
+            filename << ": expecting a profile line before '" << line << "'",
+            result::failure
+        );
+
+        if (kind == "have")
+        {
+            profile->have.insert(tokens.begin() + 1, tokens.end());
+        }
+        else if (kind == "choices")
+        {
+            ABORT_IF(
+                tokens.size() < 3,
+                filename << ": expecting 'choices property choice...', got '" << line << "'",
+                result::failure
+            );
+            profile->choices[tokens[1]] = str_vec(tokens.begin() + 2, tokens.end());
+        }
+        else
+        {
+            ABORT_IF(true, filename << ": unknown line '" << line << "'", result::failure);
+        }
+    }
+
+    return result::success;
+}
+
+
+result
+write_camera_profiles(const std::string & filename, const camera_profile_map & in)
+{
+    // Write a temporary and rename it over the original so a crash never
+    // leaves a half written file.
+    const auto temp = filename + ".tmp";
+    {
+        std::ofstream fout(temp);
+
+        ABORT_IF_NOT(fout.is_open(), "error opening file '" << temp << "'", result::failure);
+
+        fout << "# Learned by camera_control_bin, tab separated.\n";
+        for (const auto & [_, profile] : in)
+        {
+            fout << "profile\t" << profile.model << "\t" << profile.firmware << "\n";
+
+            fout << "have";
+            for (const auto & property : profile.have)
+            {
+                fout << "\t" << property;
+            }
+            fout << "\n";
+
+            for (const auto & [property, choices] : profile.choices)
+            {
+                fout << "choices\t" << property;
+                for (const auto & choice : choices)
+                {
+                    fout << "\t" << choice;
+                }
+                fout << "\n";
+            }
+        }
+
+        ABORT_IF_NOT(fout.good(), "error writing file '" << temp << "'", result::failure);
+    }
+
+    ABORT_IF(
+        std::rename(temp.c_str(), filename.c_str()) != 0,
+        "error renaming '" << temp << "' to '" << filename << "'",
+        result::failure
+    );
+
+    return result::success;
+}
+
+
+} /* namespace pycontrol */
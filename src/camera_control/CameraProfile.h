@@ -0,0 +1,47 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <common/types.h>
+
+namespace pycontrol
+{
+
+
+// What a camera model and firmware supports, learned the first time such a
+// body connects: the optional properties it has and the choices of each of its
+// settings.  Kept on disk so a known body skips probing for them and its
+// choices are served without going near USB.  A firmware update can change
+// either, so it's part of the key.
+struct CameraProfile
+{
+    std::string                    model    {};
+    std::string                    firmware {};
+    str_set                        have     {};
+    std::map<std::string, str_vec> choices  {};
+
+    std::string key() const { return profile_key(model, firmware); }
+
+    static std::string profile_key(const std::string & model, const std::string & firmware)
+    {
+        return model + "\t" + firmware;
+    }
+};
+
+
+// By CameraProfile::key().
+using camera_profile_map = std::map<std::string, CameraProfile>;
+
+
+// Tab separated, as choices have spaces in them, each profile line followed
+// by the profile's have and choices lines:
+//
+//     profile  model  firmware
+//     have     property...
+//     choices  property  choice...
+result read_camera_profiles(const std::string & filename, camera_profile_map & out);
+result write_camera_profiles(const std::string & filename, const camera_profile_map & in);
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,72 @@
+#include <filesystem>
+#include <fstream>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraControl_uto.h>
+#include <camera_control/CameraProfile.h>
+
+using namespace pycontrol;
+
+
+TEST_CASE("CameraProfile: read and write", "[CameraProfile]")
+{
+    const auto file = TempFile("camera_profile.config");
+    const auto filename = file.path.string();
+
+    camera_profile_map out;
+    {
+        CameraProfile z7 {.model = "Nikon Corporation Z 7", .firmware = "V1.00"};
+        z7.have = {"availableshots", "capturetarget"};
+        z7.choices["imagequality"] = {"NEF (Raw)", "JPEG Basic", "JPEG Fine"};
+        z7.choices["shutterspeed"] = {"1/8000", "1/6400", "30"};
+        out[z7.key()] = z7;
+
+        CameraProfile z8 {.model = "Nikon Corporation Z 8", .firmware = "V2.00"};
+        out[z8.key()] = z8;
+    }
+
+    REQUIRE( write_camera_profiles(filename, out) == result::success );
+
+    camera_profile_map in;
+    REQUIRE( read_camera_profiles(filename, in) == result::success );
+
+    REQUIRE( in.size() == 2 );
+
+    const auto & z7 = in[CameraProfile::profile_key("Nikon Corporation Z 7", "V1.00")];
+    CHECK( z7.model == "Nikon Corporation Z 7" );
+    CHECK( z7.firmware == "V1.00" );
+    CHECK( z7.have == str_set({"availableshots", "capturetarget"}) );
+    REQUIRE( z7.choices.size() == 2 );
+    CHECK( z7.choices.at("imagequality") == str_vec({"NEF (Raw)", "JPEG Basic", "JPEG Fine"}) );
+    CHECK( z7.choices.at("shutterspeed") == str_vec({"1/8000", "1/6400", "30"}) );
+
+    const auto & z8 = in[CameraProfile::profile_key("Nikon Corporation Z 8", "V2.00")];
+    CHECK( z8.have.empty() );
+    CHECK( z8.choices.empty() );
+
+    //-------------------------------------------------------------------------
+    // Malformed files.
+    //
+    {
+        std::ofstream fout(filename);
+        fout << "choices\tiso\t100\t200\n";
+    }
+    CHECK( read_camera_profiles(filename, in) == result::failure );
+
+    {
+        std::ofstream fout(filename);
+        fout << "profile\tNikon Corporation Z 7\n";
+    }
+    CHECK( read_camera_profiles(filename, in) == result::failure );
+
+    {
+        std::ofstream fout(filename);
+        fout << "profile\tNikon Corporation Z 7\tV1.00\nmenus\tiso\n";
+    }
+    CHECK( read_camera_profiles(filename, in) == result::failure );
+
+    std::filesystem::remove(filename);
+
+    CHECK( read_camera_profiles(filename, in) == result::failure );
+}
@@ -1,6 +1,8 @@
 #include <common/io.h>
 #include <camera_control/CameraSequence.h>
 
+#include <algorithm>
+
 
 namespace pycontrol
 {
@@ -9,91 +11,94 @@ result
 CameraSequence::
 load(const std::string & camera_id, const std::vector<Event> & sequence)
 {
-    _sequence.clear();
+    _steps.clear();
 
+    const auto id = intern(camera_id);
     for (const auto & event : sequence)
     {
-        if (event.camera_id == camera_id)
+        if (event.camera_id == id)
         {
-            _sequence.push_back(event);
+            _steps.push_back(Step{event, MAX_TIME, false});
         }
     }
 
     ABORT_IF(
-        _sequence.empty(),
+        _steps.empty(),
         "No events found for '" << camera_id << "'!",
         result::failure
     );
 
-    reset();
+    _next = 0;
 
     return result::success;
 }
 
 
+void
+CameraSequence::
+compile(const event_time_map & event_times)
+{
+    for (auto & step : _steps)
+    {
+        const auto itor = event_times.find(to_string(step.event.event_id));
+        step.time = itor != event_times.end() ?
+                    itor->second + step.event.event_time_offset_ms :
+                    MAX_TIME;
+    }
+
+    std::stable_sort(
+        _steps.begin(),
+        _steps.end(),
+        [](const Step & lhs, const Step & rhs) { return lhs.time < rhs.time; }
+    );
+
+    _next = 0;
+    while (_next < _steps.size() and _steps[_next].done)
+    {
+        ++_next;
+    }
+
+    _last_trigger_time = MAX_TIME;
+    for (auto itor = _steps.rbegin(); itor != _steps.rend(); ++itor)
+    {
+        if (itor->time != MAX_TIME and itor->event.channel == Channel::trigger)
+        {
+            _last_trigger_time = itor->time;
+            break;
+        }
+    }
+}
+
+
+void
+CameraSequence::
+reset(milliseconds utc_time)
+{
+    const auto first = std::partition_point(
+        _steps.begin(),
+        _steps.end(),
+        [utc_time](const Step & step) { return step.time < utc_time; }
+    );
+
+    for (auto itor = _steps.begin(); itor != _steps.end(); ++itor)
+    {
+        itor->done = itor < first;
+    }
+
+    _next = std::distance(_steps.begin(), first);
+}
+
 
-//~static const Event null_event {
-//~    "N/A",
-//~    MAX_TIME,
-//~    "N/A",
-//~    Channel::null,
-//~    "N/A"
-//~};
-
-//~const Event &
-//~CameraSequence::
-//~front() const
-//~{
-//~    if (_idx < _sequence.size())
-//~    {
-//~        return _sequence[_idx];
-//~    }
-
-//~    ERROR_LOG << "Out of bounds idx: " << _idx << " size: " << _sequence.size()
-//~              << std::endl;
-
-//~    return null_event;
-//~}
-
-//~void
-//~CameraSequence::
-//~pop()
-//~{
-//~    ++_pos;
-//~}
-
-//~bool
-//~CameraSequence::
-//~empty() const
-//~{
-//~    return _sequence.empty() or _idx >= _sequence.size();
-//~}
-
-//~std::size_t
-//~CameraSequence::
-//~size() const
-//~{
-//~    return _sequence.size();
-//~}
-
-//~const Event &
-//~CameraSequence::
-//~peek(const std::size_t & offset) const
-//~{
-//~    if (empty())
-//~    {
-//~        ERROR_LOG << "CameraSequences is empty!" << std::endl;
-//~        return null_event;
-//~    }
-
-//~    if (_idx + offset >= size())
-//~    {
-//~        ERROR_LOG << "CameraSequences pos + offset out of bounds!" << std::endl;
-//~        return null_event;
-//~    }
-
-//~    return _sequence[_idx + offset];
-//~}
+void
+CameraSequence::
+set_done(std::size_t idx)
+{
+    _steps[idx].done = true;
+    while (_next < _steps.size() and _steps[_next].done)
+    {
+        ++_next;
+    }
+}
 
 
 } /* namespace */
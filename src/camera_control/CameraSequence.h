@@ -3,32 +3,56 @@
 #include <common/types.h>
 #include <camera_control/CameraSequenceFileReader.h>
 
-#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
 
 namespace pycontrol
 {
 
 using event_vec = std::vector<Event>;
 
+// Event id to UTC time in milliseconds.
+using event_time_map = std::map<std::string, milliseconds>;
+
 class CameraSequence
 {
-private:
-    event_vec _sequence {};
-    event_vec::const_iterator _pos {};
-
 public:
     result load(const std::string & camera_id, const std::vector<Event> & sequence);
 
-    const Event & front() const { return *_pos; }
-    void pop() { ++_pos; }
-    void reset() {_pos = _sequence.begin();}
-    bool empty() {return _pos >= _sequence.end();}
-    std::size_t size() const { return _sequence.size(); }
-    std::size_t pos() const {return std::distance(_sequence.begin(), _pos) + 1; }
+    // Resolves each event's UTC time and sorts the events by it, ties keep
+    // their file order.  Events without a time yet go last.  Events already
+    // dispatched stay dispatched.
+    void compile(const event_time_map & event_times);
+
+    // Marks the events before the UTC time dispatched and the rest pending.
+    void reset(milliseconds utc_time);
+
+    const Event & event(std::size_t idx) const { return _steps[idx].event; }
+    milliseconds time(std::size_t idx) const { return _steps[idx].time; }
+    bool done(std::size_t idx) const { return _steps[idx].done; }
+    void set_done(std::size_t idx);
+
+    // UTC time of the last trigger with a time, MAX_TIME if there's none.
+    milliseconds last_trigger_time() const { return _last_trigger_time; }
+
+    // The first pending event.
+    std::size_t next() const { return _next; }
+    bool empty() const { return _next >= _steps.size(); }
+    std::size_t size() const { return _steps.size(); }
+
+private:
 
-    event_vec::const_iterator begin() const { return _pos; }
-    event_vec::const_iterator end() const { return _sequence.end(); }
+    struct Step
+    {
+        Event        event;
+        milliseconds time;
+        bool         done;
+    };
 
+    std::vector<Step> _steps {};
+    std::size_t _next {0};
+    milliseconds _last_trigger_time {MAX_TIME};
 };
 
 } /* namespace */
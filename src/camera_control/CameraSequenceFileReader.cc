@@ -1,14 +1,19 @@
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
 #include <sstream>
+#include <string_view>
 
 #include <common/io.h>
 #include <common/str_utils.h>
 #include <camera_control/CameraSequenceFileReader.h>
+#include <camera_control/LatePolicy.h>
+#include <camera_control/SequenceBinary.h>
 
 namespace {
 
@@ -119,6 +124,77 @@ const std::set<std::string> _valid_triggers = {
     "1",
 };
 
+
+// Digits with an optional decimal point, 5.6 is 56 with a scale of 10.
+bool
+parse_decimal(std::string_view str, std::int32_t & mantissa, std::int32_t & scale)
+{
+    constexpr std::size_t max_digits = 9;
+
+    mantissa = 0;
+    scale = 1;
+
+    std::size_t digits = 0;
+    bool point = false;
+    for (const auto c : str)
+    {
+        if (c == '.' and not point)
+        {
+            point = true;
+            continue;
+        }
+        if (c < '0' or c > '9' or ++digits > max_digits)
+        {
+            return false;
+        }
+        mantissa = mantissa * 10 + (c - '0');
+        if (point)
+        {
+            scale *= 10;
+        }
+    }
+
+    return digits > 0;
+}
+
+
+// "a" or "a/b" as an integer ratio, either part may have decimals.
+bool
+parse_ratio(std::string_view str, pycontrol::ChannelValue & out)
+{
+    std::int32_t num = 0;
+    std::int32_t num_scale = 1;
+    std::int32_t den = 1;
+    std::int32_t den_scale = 1;
+
+    const auto slash = str.find('/');
+    if (not parse_decimal(str.substr(0, slash), num, num_scale))
+    {
+        return false;
+    }
+    if (slash != std::string_view::npos and
+        not parse_decimal(str.substr(slash + 1), den, den_scale))
+    {
+        return false;
+    }
+    if (den == 0)
+    {
+        return false;
+    }
+
+    const auto ratio_num = static_cast<std::int64_t>(num) * den_scale;
+    const auto ratio_den = static_cast<std::int64_t>(den) * num_scale;
+    if (ratio_num > INT32_MAX or ratio_den > INT32_MAX)
+    {
+        return false;
+    }
+
+    out.num = static_cast<std::int32_t>(ratio_num);
+    out.den = static_cast<std::int32_t>(ratio_den);
+
+    return true;
+}
+
 } /* namespace */
 
 
@@ -192,19 +268,53 @@ _is_valid_trigger_value(const std::string& value) const
 
 result
 CameraSequenceFileReader::
-read_file(const std::string & file_path)
+read_file(const std::string & file_path, std::atomic<std::uint32_t> * percent)
 {
     clear();
 
+    // Prefer the compiled sequence next to the text if it's current.
+    const auto binary_path = file_path + "b";
+    if (std::filesystem::exists(binary_path))
+    {
+        if (read_sequence_binary(binary_path, file_path, _sequence) == result::success)
+        {
+            for (const auto & event : _sequence)
+            {
+                _cam_ids.insert(to_string(event.camera_id));
+            }
+            _from_binary = true;
+            return result::success;
+        }
+
+        INFO_LOG << "Ignoring " << binary_path << ", parsing " << file_path << std::endl;
+        clear();
+    }
+
+    return _parse_text(file_path, percent);
+}
+
+result
+CameraSequenceFileReader::
+_parse_text(const std::string & file_path, std::atomic<std::uint32_t> * percent)
+{
     std::ifstream file(file_path);
     ABORT_IF_NOT(file.is_open(), "Could not open file " << file_path, result::failure);
 
+    std::error_code error;
+    const auto file_size = std::filesystem::file_size(file_path, error);
+
     std::string line;
     unsigned int line_number = 0;
     while (std::getline(file, line))
     {
         line_number++;
 
+        if (percent and not error and file_size > 0 and line_number % 4096 == 0)
+        {
+            const auto pos = static_cast<std::uint64_t>(file.tellg());
+            percent->store(static_cast<std::uint32_t>(pos * 90 / file_size), std::memory_order_relaxed);
+        }
+
         // Strip comments from the line first.
         size_t comment_pos = line.find('#');
         if (comment_pos != std::string::npos)
@@ -303,13 +413,15 @@ read_file(const std::string & file_path)
 
         bool validation_ok = false;
         Channel channel;
+        ChannelValue value {.text = intern(channel_value_str)};
 
         if (channel_name == "burst_number")
         {
-            int num;
+            int num = 0;
             validation_ok = result::success == as_type<int>(channel_value_str, num);
             validation_ok = validation_ok and num >= 0;
             channel = Channel::burst_number;
+            value.num = num;
         }
         else if (channel_name == "capture_target")
         {
@@ -326,16 +438,27 @@ read_file(const std::string & file_path)
         {
             validation_ok = _is_valid_fps_value(channel_value_str);
             channel = Channel::fps;
+            parse_ratio(channel_value_str, value);
         }
         else if (channel_name == "fstop")
         {
             validation_ok = _is_valid_fstop(channel_value_str);
             channel = Channel::fstop;
+            validation_ok = validation_ok and parse_ratio(std::string_view(channel_value_str).substr(2), value);
         }
         else if (channel_name == "iso")
         {
             validation_ok = true;
             channel = Channel::iso;
+            parse_ratio(channel_value_str, value);
+        }
+        else if (channel_name == "late_policy")
+        {
+            LatePolicy policy;
+            validation_ok = result::success == LatePolicy::parse(channel_value_str, policy);
+            channel = Channel::late_policy;
+            value.num = static_cast<std::int32_t>(policy.mode());
+            value.den = static_cast<std::int32_t>(policy.late_ms());
         }
         else if (channel_name == "mode")
         {
@@ -359,18 +482,20 @@ read_file(const std::string & file_path)
         {
             validation_ok = _is_valid_shutter_speed(channel_value_str);
             channel = Channel::shutter_speed;
+            validation_ok = validation_ok and parse_ratio(channel_value_str, value);
         }
         else if (channel_name == "trigger")
         {
             validation_ok = _is_valid_trigger_value(channel_value_str);
             channel = Channel::trigger;
+            validation_ok = validation_ok and parse_ratio(channel_value_str, value);
         }
         else
         {
             ERROR_LOG << file_path << "(" << line_number << "): Parse Error: "
                       << ": Invalid channel name '"
                       << channel_name
-                      << "'. Allowed: shutter_speed, fstop, iso, quality, fps, trigger."
+                      << "'. Allowed: shutter_speed, fstop, iso, quality, fps, trigger, late_policy."
                       << std::endl;
             clear();
             return result::failure;
@@ -389,12 +514,14 @@ read_file(const std::string & file_path)
             return result::failure;
         }
 
-        _sequence.emplace_back(
-            event_id_str,
-            event_time_offset_ms,
-            camera_id,
-            channel,
-            channel_value_str
+        _sequence.push_back(
+            Event{
+                .event_id = intern(event_id_str),
+                .camera_id = intern(camera_id),
+                .event_time_offset_ms = event_time_offset_ms,
+                .channel = channel,
+                .value = value
+            }
         );
     }
 
@@ -421,6 +548,7 @@ clear()
 {
     _sequence.clear();
     _cam_ids.clear();
+    _from_binary = false;
 }
 
 } /* namespace */
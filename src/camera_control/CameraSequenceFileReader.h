@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <set>
@@ -14,13 +16,23 @@ namespace pycontrol
 class CameraSequenceFileReader
 {
 public:
-    result read_file(const std::string & file_path);
+    // Reads the sequence, from the compiled file_path + "b" when it was
+    // compiled from the file's current contents.  Parsing progress from 0 to
+    // 90 is stored in percent when given.
+    result read_file(
+        const std::string & file_path,
+        std::atomic<std::uint32_t> * percent = nullptr);
     const std::vector<Event> & get_events() const;
     const std::set<CamId> & get_camera_ids() const;
     void clear();
 
+    // True if the last read_file() loaded the compiled sequence.
+    bool from_binary() const { return _from_binary; }
+
 private:
 
+    result _parse_text(const std::string & file_path, std::atomic<std::uint32_t> * percent);
+
     std::string _strip(const std::string& str) const;
 
     bool _is_ignorable_line(const std::string& line) const;
@@ -32,6 +44,7 @@ private:
 
     std::vector<Event> _sequence {};
     std::set<CamId> _cam_ids {};
+    bool _from_binary {false};
 };
 
 
@@ -4,6 +4,7 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <camera_control/CameraSequenceFileReader.h>
+#include <camera_control/LatePolicy.h>
 
 using namespace pycontrol;
 
@@ -40,6 +41,7 @@ TEST_CASE("CameraSequenceFileReader: Successful Parsing of Valid File", "[seq]")
         event11   40.0    camC.shooting_speed   0
         event12   50.0    camC.capture_target   internal ram
         event13   60.0    camC.capture_target   memory card
+        event14   -60     camC.late_policy      skip-late 500
     )";
     create_test_file(test_filename, content);
 
@@ -48,92 +50,116 @@ TEST_CASE("CameraSequenceFileReader: Successful Parsing of Valid File", "[seq]")
     cleanup_test_file(test_filename);
 
     const auto& entries = sequence_reader.get_events();
-    REQUIRE(entries.size() == 14);
+    REQUIRE(entries.size() == 15);
 
     // Verify a few specific entries
-    CHECK(entries[0].event_id == "event0");
+    CHECK(to_string(entries[0].event_id) == "event0");
     CHECK(entries[0].event_time_offset_ms == 0);
-    CHECK(entries[0].camera_id == "cama");
+    CHECK(to_string(entries[0].camera_id) == "cama");
     CHECK(entries[0].channel == Channel::shutter_speed);
-    CHECK(entries[0].channel_value == "1/125");
+    CHECK(to_string(entries[0].value.text) == "1/125");
 
-    CHECK(entries[1].event_id == "event1");
+    CHECK(to_string(entries[1].event_id) == "event1");
     CHECK(entries[1].event_time_offset_ms == 1'500);
-    CHECK(entries[1].camera_id == "camb");
+    CHECK(to_string(entries[1].camera_id) == "camb");
     CHECK(entries[1].channel == Channel::fstop);
-    CHECK(entries[1].channel_value == "f/8");
+    CHECK(to_string(entries[1].value.text) == "f/8");
 
-    CHECK(entries[2].event_id == "event2");
+    CHECK(to_string(entries[2].event_id) == "event2");
     CHECK(entries[2].event_time_offset_ms == 2'000);
-    CHECK(entries[2].camera_id == "cama");
+    CHECK(to_string(entries[2].camera_id) == "cama");
     CHECK(entries[2].channel == Channel::iso);
-    CHECK(entries[2].channel_value == "400");
+    CHECK(to_string(entries[2].value.text) == "400");
 
-    CHECK(entries[3].event_id == "event3");
+    CHECK(to_string(entries[3].event_id) == "event3");
     CHECK(entries[3].event_time_offset_ms == 2'100);
-    CHECK(entries[3].camera_id == "camb");
+    CHECK(to_string(entries[3].camera_id) == "camb");
     CHECK(entries[3].channel == Channel::quality);
-    CHECK(entries[3].channel_value == "nef (raw)");
+    CHECK(to_string(entries[3].value.text) == "nef (raw)");
 
-    CHECK(entries[4].event_id == "event4");
+    CHECK(to_string(entries[4].event_id) == "event4");
     CHECK(entries[4].event_time_offset_ms == 2'200);
-    CHECK(entries[4].camera_id == "cama");
+    CHECK(to_string(entries[4].camera_id) == "cama");
     CHECK(entries[4].channel == Channel::fps);
-    CHECK(entries[4].channel_value == "5.0");
+    CHECK(to_string(entries[4].value.text) == "5.0");
 
-    CHECK(entries[5].event_id == "event5");
+    CHECK(to_string(entries[5].event_id) == "event5");
     CHECK(entries[5].event_time_offset_ms == 2'200);
-    CHECK(entries[5].camera_id == "cama");
+    CHECK(to_string(entries[5].camera_id) == "cama");
     CHECK(entries[5].channel == Channel::fps);
-    CHECK(entries[5].channel_value == "start");
+    CHECK(to_string(entries[5].value.text) == "start");
 
-    CHECK(entries[6].event_id == "event6");
+    CHECK(to_string(entries[6].event_id) == "event6");
     CHECK(entries[6].event_time_offset_ms == 5'000);
-    CHECK(entries[6].camera_id == "cama");
+    CHECK(to_string(entries[6].camera_id) == "cama");
     CHECK(entries[6].channel == Channel::fps);
-    CHECK(entries[6].channel_value == "stop");
+    CHECK(to_string(entries[6].value.text) == "stop");
 
-    CHECK(entries[7].event_id == "event7");
+    CHECK(to_string(entries[7].event_id) == "event7");
     CHECK(entries[7].event_time_offset_ms == -10'000);
-    CHECK(entries[7].camera_id == "camc");
+    CHECK(to_string(entries[7].camera_id) == "camc");
     CHECK(entries[7].channel == Channel::shutter_speed);
-    CHECK(entries[7].channel_value == "1/4000");
+    CHECK(to_string(entries[7].value.text) == "1/4000");
 
-    CHECK(entries[8].event_id == "event8");
+    CHECK(to_string(entries[8].event_id) == "event8");
     CHECK(entries[8].event_time_offset_ms == 10'000);
-    CHECK(entries[8].camera_id == "camc");
+    CHECK(to_string(entries[8].camera_id) == "camc");
     CHECK(entries[8].channel == Channel::trigger);
-    CHECK(entries[8].channel_value == "1");
+    CHECK(to_string(entries[8].value.text) == "1");
 
-    CHECK(entries[9].event_id == "event9");
+    CHECK(to_string(entries[9].event_id) == "event9");
     CHECK(entries[9].event_time_offset_ms == 20'000);
-    CHECK(entries[9].camera_id == "camc");
+    CHECK(to_string(entries[9].camera_id) == "camc");
     CHECK(entries[9].channel == Channel::burst_number);
-    CHECK(entries[9].channel_value == "5");
+    CHECK(to_string(entries[9].value.text) == "5");
 
-    CHECK(entries[10].event_id == "event10");
+    CHECK(to_string(entries[10].event_id) == "event10");
     CHECK(entries[10].event_time_offset_ms == 30'000);
-    CHECK(entries[10].camera_id == "camc");
+    CHECK(to_string(entries[10].camera_id) == "camc");
     CHECK(entries[10].channel == Channel::capture_mode);
-    CHECK(entries[10].channel_value == "2");
+    CHECK(to_string(entries[10].value.text) == "2");
 
-    CHECK(entries[11].event_id == "event11");
+    CHECK(to_string(entries[11].event_id) == "event11");
     CHECK(entries[11].event_time_offset_ms == 40'000);
-    CHECK(entries[11].camera_id == "camc");
+    CHECK(to_string(entries[11].camera_id) == "camc");
     CHECK(entries[11].channel == Channel::shooting_speed);
-    CHECK(entries[11].channel_value == "0");
+    CHECK(to_string(entries[11].value.text) == "0");
 
-    CHECK(entries[12].event_id == "event12");
+    CHECK(to_string(entries[12].event_id) == "event12");
     CHECK(entries[12].event_time_offset_ms == 50'000);
-    CHECK(entries[12].camera_id == "camc");
+    CHECK(to_string(entries[12].camera_id) == "camc");
     CHECK(entries[12].channel == Channel::capture_target);
-    CHECK(entries[12].channel_value == "internal ram");
+    CHECK(to_string(entries[12].value.text) == "internal ram");
 
-    CHECK(entries[13].event_id == "event13");
+    CHECK(to_string(entries[13].event_id) == "event13");
     CHECK(entries[13].event_time_offset_ms == 60'000);
-    CHECK(entries[13].camera_id == "camc");
+    CHECK(to_string(entries[13].camera_id) == "camc");
     CHECK(entries[13].channel == Channel::capture_target);
-    CHECK(entries[13].channel_value == "memory card");
+    CHECK(to_string(entries[13].value.text) == "memory card");
+
+    CHECK(to_string(entries[14].event_id) == "event14");
+    CHECK(entries[14].event_time_offset_ms == -60'000);
+    CHECK(to_string(entries[14].camera_id) == "camc");
+    CHECK(entries[14].channel == Channel::late_policy);
+    CHECK(to_string(entries[14].value.text) == "skip-late 500");
+
+    // Values are parsed when the file is read.
+    CHECK(entries[0].value.num == 1);
+    CHECK(entries[0].value.den == 125);
+    CHECK(entries[1].value.num == 8);
+    CHECK(entries[1].value.den == 1);
+    CHECK(entries[2].value.num == 400);
+    CHECK(entries[4].value.num == 50);
+    CHECK(entries[4].value.den == 10);
+    CHECK(entries[5].value.num == 0);
+    CHECK(entries[8].value.num == 1);
+    CHECK(entries[9].value.num == 5);
+    CHECK(entries[14].value.num == static_cast<int>(LatePolicy::Mode::skip_late));
+    CHECK(entries[14].value.den == 500);
+
+    // Ids are interned.
+    CHECK(entries[0].camera_id == entries[2].camera_id);
+    CHECK(entries[0].camera_id != entries[1].camera_id);
 
     sequence_reader.clear();
     CHECK(entries.empty() == true);
@@ -162,13 +188,13 @@ TEST_CASE("CameraSequenceFileReader: Ignores Comments and Blank Lines", "[seq_wh
     const auto& entries = sequence_reader.get_events();
     REQUIRE(entries.size() == 3); // Only 3 actual data lines
 
-    REQUIRE(entries[0].event_id == "event_1");
-    REQUIRE(entries[1].event_id == "event_2");
-    REQUIRE(entries[2].event_id == "event_3");
+    REQUIRE(to_string(entries[0].event_id) == "event_1");
+    REQUIRE(to_string(entries[1].event_id) == "event_2");
+    REQUIRE(to_string(entries[2].event_id) == "event_3");
 
-    REQUIRE(entries[0].channel_value == "100");
-    REQUIRE(entries[1].channel_value == "jpeg fine");
-    REQUIRE(entries[2].channel_value == "29.97");
+    REQUIRE(to_string(entries[0].value.text) == "100");
+    REQUIRE(to_string(entries[1].value.text) == "jpeg fine");
+    REQUIRE(to_string(entries[2].value.text) == "29.97");
 
     cleanup_test_file(test_filename);
 }
@@ -260,6 +286,10 @@ TEST_CASE("CameraSequenceFileReader: Failures", "[seq_bad]")
         // Invalid capture_target.
         "event_start    0.0    camA.capture_target    bad_target\n",
 
+        // Invalid late_policy.
+        "event_start    0.0    camA.late_policy       lenient 100\n",
+        "event_start    0.0    camA.late_policy       compress\n",
+
         // Mixure of valid and invalid lines.
         R"(
             event_1        1.0 camA.iso               100
@@ -289,3 +319,36 @@ TEST_CASE("CameraSequenceFileReader: Failures", "[seq_bad]")
 
     cleanup_test_file(test_filename);
 }
+
+TEST_CASE("CameraSequenceFileReader: Parses Fractional Values", "[seq]")
+{
+    const std::string test_filename = "fractional_values.txt";
+    const std::string content = R"(
+        e1  0  cam.shutter_speed  1/2.5
+        e1  1  cam.shutter_speed  1.3
+        e1  2  cam.shutter_speed  900
+        e1  3  cam.fstop          f/5.6
+        e1  4  cam.iso            auto
+    )";
+    create_test_file(test_filename, content);
+
+    CameraSequenceFileReader sequence_reader;
+    REQUIRE(result::success == sequence_reader.read_file(test_filename));
+    cleanup_test_file(test_filename);
+
+    const auto& entries = sequence_reader.get_events();
+    REQUIRE(entries.size() == 5);
+
+    CHECK(entries[0].value.num == 10);
+    CHECK(entries[0].value.den == 25);
+    CHECK(entries[1].value.num == 13);
+    CHECK(entries[1].value.den == 10);
+    CHECK(entries[2].value.num == 900);
+    CHECK(entries[2].value.den == 1);
+    CHECK(entries[3].value.num == 56);
+    CHECK(entries[3].value.den == 10);
+
+    // Not a number, sent to the camera as written.
+    CHECK(entries[4].value.num == 0);
+    CHECK(to_string(entries[4].value.text) == "auto");
+}
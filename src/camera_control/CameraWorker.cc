@@ -0,0 +1,107 @@
+#include <pthread.h>
+
+#include <camera_control/CameraWorker.h>
+
+#include <common/io.h>
+
+namespace pycontrol
+{
+
+
+const char *
+to_string(CameraJob::Type type)
+{
+    switch (type)
+    {
+        case CameraJob::Type::none: return "none";
+        case CameraJob::Type::read_config: return "read_config";
+        case CameraJob::Type::read_status: return "read_status";
+        case CameraJob::Type::write_config: return "write_config";
+        case CameraJob::Type::trigger: return "trigger";
+        case CameraJob::Type::capture_histogram: return "capture_histogram";
+        case CameraJob::Type::read_choices: return "read_choices";
+    }
+    return "unknown";
+}
+
+
+CameraWorker::
+CameraWorker(const std::string & name, handler run, std::size_t max_pending)
+:
+    _run{std::move(run)},
+    _todo{max_pending},
+    _done{max_pending},
+    _thread{&CameraWorker::_loop, this}
+{
+    // Linux limits thread names to 15 characters.
+    pthread_setname_np(_thread.native_handle(), name.substr(0, 15).c_str());
+}
+
+
+CameraWorker::
+~CameraWorker()
+{
+    _stop.store(true, std::memory_order_release);
+    _wake.release();
+    _thread.join();
+}
+
+
+result
+CameraWorker::
+post(CameraJob && job)
+{
+    if (_in_flight >= _todo.capacity() or not _todo.push(std::move(job)))
+    {
+        return result::failure;
+    }
+    ++_in_flight;
+    _wake.release();
+
+    return result::success;
+}
+
+
+bool
+CameraWorker::
+poll(CameraJob & job)
+{
+    if (not _done.pop(job))
+    {
+        return false;
+    }
+    --_in_flight;
+
+    return true;
+}
+
+
+void
+CameraWorker::
+_loop()
+{
+    CameraJob job;
+    while (true)
+    {
+        _wake.acquire();
+
+        // Any jobs still queued at shutdown are dropped.
+        if (_stop.load(std::memory_order_acquire))
+        {
+            break;
+        }
+
+        if (not _todo.pop(job))
+        {
+            continue;
+        }
+
+        _run(job);
+
+        // Can't fail, post() never lets more than capacity jobs in flight.
+        _done.push(std::move(job));
+    }
+}
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <semaphore>
+#include <string>
+#include <thread>
+
+#include <memory>
+
+#include <common/RingBuffer.h>
+#include <common/types.h>
+
+#include <camera_control/Camera.h>
+#include <camera_control/TriggerGate.h>
+
+namespace pycontrol
+{
+
+// One unit of USB work for a camera.  The control thread fills in the request
+// half, the worker thread fills in the result half and hands it back.
+struct CameraJob
+{
+    enum class Type : unsigned int
+    {
+        none,
+        read_config,
+        read_status,
+        write_config,
+        trigger,
+        capture_histogram,
+        read_choices,
+    };
+
+    // Request.
+    Type          type         {Type::none};
+    Camera::Info  info         {};
+    std::uint32_t version      {0};
+
+    // Triggers released together with other cameras wait at this gate, then
+    // for the monotonic deadline if one is set.
+    std::shared_ptr<TriggerGate> gate {nullptr};
+    nanoseconds   deadline_ns  {0};
+
+    // Trigger latency compensation already taken off deadline_ns.
+    nanoseconds   lead_ns      {0};
+
+    // Calibration shots also wait for the camera's GP_EVENT_FILE_ADDED.
+    bool          calibrate    {false};
+
+    // The setting read_choices reads.
+    std::string   property     {};
+
+    // Result.
+    result        res          {result::success};
+    bool          disconnected {false};
+    int           photos_added {0};
+    hist_vec      hist         {};
+    str_vec       choices      {};
+    nanoseconds   fire_ns      {0};
+    nanoseconds   return_ns    {0};
+    nanoseconds   file_added_ns {0};
+    nanoseconds   usb_ns       {0};  // Time reads spent on USB.
+};
+
+
+const char * to_string(CameraJob::Type type);
+
+
+// Runs CameraJobs for a single camera on a dedicated, non real-time thread so
+// blocking libgphoto2 calls never stall the control loop.  Jobs are executed
+// in the order posted and completed jobs are handed back via poll().
+//
+// post() and poll() must be called from the same thread, the control thread.
+// Jobs travel through SPSC rings in both directions, so neither side takes a
+// lock.
+class CameraWorker
+{
+public:
+
+    using handler = std::function<void(CameraJob &)>;
+
+    CameraWorker(const std::string & name, handler run, std::size_t max_pending = 16);
+    ~CameraWorker();
+
+    // Queues a job for the worker thread, fails when max_pending jobs are
+    // already in flight.
+    result post(CameraJob && job);
+
+    // Moves the oldest completed job into job, returns false if none are done.
+    bool poll(CameraJob & job);
+
+private:
+
+    CameraWorker(const CameraWorker & copy) = delete;
+    CameraWorker & operator=(const CameraWorker & rhs) = delete;
+
+    void _loop();
+
+    handler                   _run;
+
+    SpscRing<CameraJob>       _todo;
+    SpscRing<CameraJob>       _done;
+
+    // Jobs posted but not yet polled, bounded by the ring capacity so the
+    // worker can never find _done full.
+    std::size_t               _in_flight {0};
+
+    std::counting_semaphore<> _wake {0};
+    std::atomic<bool>         _stop {false};
+
+    std::thread               _thread;
+};
+
+
+} /* namespace pycontrol */
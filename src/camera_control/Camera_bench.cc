@@ -0,0 +1,202 @@
+// Cost of Camera::write_config() per flush when nothing, one or every setting
+// changed, against a fake camera that charges for USB per widget.  Drivers
+// with gp_camera_set_single_config() only pay for the widgets written, the
+// others pay for walking the whole config tree on top.  Every setting changed
+// without single config is what each flush cost when all of them were always
+// written.
+//
+//     make -C src/camera_control bench && src/camera_control/Camera_bench_bin
+
+#include <camera_control/Camera.h>
+
+#include <gphoto2cpp/gphoto2cpp.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace pycontrol;
+
+using steady = std::chrono::steady_clock;
+
+
+// Rough numbers for a Nikon Z over USB 2.
+constexpr nanoseconds widget_write_ns = 8'000'000;   // One PTP SetDevicePropValue.
+constexpr nanoseconds tree_widget_ns  = 250'000;     // Per widget walked by set_config.
+constexpr int         tree_widgets    = 180;
+
+
+struct UsbClock : interface::WallClock
+{
+    milliseconds now() override { return monotonic_ns() / 1'000'000; }
+    nanoseconds monotonic_ns() override { return usb_ns; }
+    nanoseconds utc_offset_ns() override { return 0; }
+    void sleep_until_ns(nanoseconds deadline) override { usb_ns = std::max(usb_ns, deadline); }
+
+    nanoseconds usb_ns {0};
+};
+
+
+struct UsbGp2Cpp : interface::GPhoto2Cpp
+{
+    explicit UsbGp2Cpp(UsbClock & clock, bool single) : clock(clock), single(single) {}
+
+    std::vector<std::string> auto_detect() override { return {}; }
+
+    bool list_files(const gphoto2cpp::camera_ptr &, std::vector<std::string> &) override
+    {
+        return true;
+    }
+
+    gphoto2cpp::camera_ptr open_camera(const std::string &) override { return nullptr; }
+
+    std::vector<std::string>
+    read_choices(const gphoto2cpp::camera_ptr &, const std::string &) override
+    {
+        return {};
+    }
+
+    bool read_config(const gphoto2cpp::camera_ptr &) override { return true; }
+
+    bool
+    read_config(const gphoto2cpp::camera_ptr &, const std::vector<std::string> &) override
+    {
+        return true;
+    }
+
+    bool
+    read_property(
+        const gphoto2cpp::camera_ptr &,
+        const std::string & property,
+        std::string & output) override
+    {
+        output = "1";
+        return property != "shootingspeed" and property != "capturemode";
+    }
+
+    void reset_cache(const gphoto2cpp::camera_ptr &) override {}
+    bool trigger(const gphoto2cpp::camera_ptr &) override { return true; }
+
+    bool
+    write_config(gphoto2cpp::camera_ptr &) override
+    {
+        clock.usb_ns += tree_widgets * tree_widget_ns + changed * widget_write_ns;
+        changed = 0;
+        return true;
+    }
+
+    bool
+    write_config(
+        gphoto2cpp::camera_ptr & camera,
+        const std::vector<std::string> & properties) override
+    {
+        if (not single)
+        {
+            return write_config(camera);
+        }
+        clock.usb_ns += static_cast<nanoseconds>(properties.size()) * widget_write_ns;
+        changed = 0;
+        return true;
+    }
+
+    bool
+    write_property(
+        gphoto2cpp::camera_ptr &,
+        const std::string &,
+        const std::string &) override
+    {
+        ++changed;
+        return true;
+    }
+
+    bool
+    wait_for_event(
+        const gphoto2cpp::camera_ptr &,
+        const int,
+        gphoto2cpp::Event & out) override
+    {
+        out.type = GP2::GP_EVENT_TIMEOUT;
+        return true;
+    }
+
+    std::unique_ptr<interface::FileCapture>
+    make_file_capture(const gphoto2cpp::camera_ptr &) override
+    {
+        return nullptr;
+    }
+
+    UsbClock & clock;
+    bool       single;
+    int        changed {0};
+};
+
+
+// Flips the first num_changed settings between two values each flush.
+void
+change(Camera & camera, int num_changed, int flush)
+{
+    const bool odd = flush & 1;
+    if (num_changed > 0) camera.set_shutter(intern(odd ? "1/500" : "1/1000"));
+    if (num_changed > 1) camera.set_mode(intern(odd ? "A" : "M"));
+    if (num_changed > 2) camera.set_fstop(intern(odd ? "f/5.6" : "f/8"));
+    if (num_changed > 3) camera.set_iso(intern(odd ? "200" : "100"));
+    if (num_changed > 4) camera.set_quality(intern(odd ? "JPEG Fine" : "NEF (Raw)"));
+    if (num_changed > 5) camera.set_burst_number(odd ? 2 : 1);
+    if (num_changed > 6) camera.set_capture_target(intern(odd ? "sdram" : "Memory card"));
+}
+
+
+int main()
+{
+    std::cout
+        << std::setw(10) << "changed"
+        << std::setw(16) << "single config"
+        << std::setw(14) << "usb ms"
+        << std::setw(14) << "cpu ns"
+        << "\n";
+
+    constexpr int flushes = 10'000;
+
+    for (const bool single : {true, false})
+    {
+        for (const int num_changed : {0, 1, 7})
+        {
+            UsbClock clock;
+            UsbGp2Cpp gp2cpp(clock, single);
+            gphoto2cpp::camera_ptr handle;
+            Camera camera(gp2cpp, clock, handle, "usb:001,001", "1234", "");
+
+            // Everything starts out dirty, get it on the camera first.
+            change(camera, 7, 0);
+            camera.write_config();
+            clock.usb_ns = 0;
+
+            nanoseconds cpu_ns = 0;
+            for (int flush = 1; flush <= flushes; ++flush)
+            {
+                change(camera, num_changed, flush);
+
+                const auto start = steady::now();
+                if (camera.write_config() != result::success)
+                {
+                    std::cerr << "write_config() failed\n";
+                    return 1;
+                }
+                cpu_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    steady::now() - start).count();
+            }
+
+            std::cout
+                << std::setw(10) << num_changed
+                << std::setw(16) << (single ? "yes" : "no")
+                << std::setw(14) << std::fixed << std::setprecision(2)
+                << clock.usb_ns / 1e6 / flushes
+                << std::setw(14) << std::setprecision(0)
+                << static_cast<double>(cpu_ns) / flushes
+                << "\n";
+        }
+    }
+
+    return 0;
+}
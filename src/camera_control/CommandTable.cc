@@ -0,0 +1,58 @@
+#include <common/str_utils.h>
+#include <camera_control/CommandTable.h>
+
+
+namespace pycontrol
+{
+
+
+bool
+parse_arg(Tokenizer & tok, ArgType type, CommandArg & arg)
+{
+    switch (type)
+    {
+        case ArgType::string:
+        case ArgType::serial:
+        {
+            return tok.next(arg.text);
+        }
+        case ArgType::rest:
+        {
+            if (not tok.rest(arg.text))
+            {
+                return false;
+            }
+            arg.text = stripped(arg.text, ' ');
+            return true;
+        }
+        case ArgType::u32:
+        case ArgType::count:
+        {
+            std::uint32_t value = 0;
+            if (not tok.next(value) or (type == ArgType::count and value == 0))
+            {
+                return false;
+            }
+            arg.integer = value;
+            return true;
+        }
+        case ArgType::i32:
+        {
+            std::int32_t value = 0;
+            if (not tok.next(value))
+            {
+                return false;
+            }
+            arg.integer = value;
+            return true;
+        }
+        case ArgType::f32:
+        {
+            return tok.next(arg.real);
+        }
+    }
+    return false;
+}
+
+
+} /* namespace pycontrol */
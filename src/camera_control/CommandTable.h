@@ -0,0 +1,172 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+#include <common/Tokenizer.h>
+
+namespace pycontrol
+{
+
+
+//-----------------------------------------------------------------------------
+// Commands, see docs/camera_control_commands.md, are looked up by name in a
+// CommandTable and their arguments are read by type from its CommandSpec
+// before its handler runs.  A handler gets the arguments already parsed and
+// only checks what the types can't.
+//
+enum class ArgType : std::uint8_t
+{
+    string,     // One token.
+    serial,     // One token, a camera's serial that must be connected.
+    rest,       // The rest of the line, leading and trailing spaces stripped.
+    u32,
+    count,      // A u32 greater than 0.
+    i32,
+    f32,
+};
+
+struct ArgSpec
+{
+    std::string_view name;
+    ArgType          type;
+};
+
+// A parsed argument, the token it was read from and its value by type.
+struct CommandArg
+{
+    std::string_view text {};
+    std::int64_t     integer {0};
+    float            real {0.0f};
+
+    std::uint32_t u32() const { return static_cast<std::uint32_t>(integer); }
+    std::int32_t i32() const { return static_cast<std::int32_t>(integer); }
+};
+
+inline constexpr std::size_t MAX_COMMAND_ARGS = 12;
+
+using CommandArgs = std::array<CommandArg, MAX_COMMAND_ARGS>;
+
+// Reads the next argument of type, false when it doesn't parse.  A serial
+// only has to parse, whether it's connected is up to the caller.
+bool parse_arg(Tokenizer & tok, ArgType type, CommandArg & arg);
+
+
+template <typename Handler>
+struct CommandSpec
+{
+    std::string_view         name;
+    Handler                  handler;
+    std::span<const ArgSpec> args {};
+
+    // The reject message when an argument doesn't parse, "{arg}" becomes the
+    // argument's name and "{command}" the whole command.
+    std::string_view         parse_error {};
+
+    // Rejects become the message of the responses after, until the next.
+    bool                     remember {true};
+};
+
+
+// FNV-1a, seeded.
+constexpr std::uint32_t
+command_hash(std::string_view name, std::uint32_t seed)
+{
+    std::uint32_t hash = 2166136261u ^ seed;
+    for (const char c : name)
+    {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    return hash;
+}
+
+
+//-----------------------------------------------------------------------------
+// Commands by name through a perfect hash, found at compile time: the first
+// seed that puts every name in a slot of its own.  Finding a name is one hash
+// and one compare.
+//
+//     static constexpr CommandTable commands {std::array{
+//         CommandSpec<Handler>{"trigger", &Foo::_trigger, TRIGGER_ARGS},
+//         ...
+//     }};
+//
+template <typename Spec, std::size_t N, std::size_t SLOTS = 64>
+class CommandTable
+{
+public:
+
+    static_assert(N < SLOTS);
+
+    consteval explicit CommandTable(const std::array<Spec, N> & commands);
+
+    // The command called name, nullptr when there isn't one.
+    constexpr const Spec * find(std::string_view name) const;
+
+    constexpr std::uint32_t seed() const { return _seed; }
+
+private:
+
+    static constexpr std::uint8_t NONE = 0xff;
+    static constexpr std::uint32_t MAX_SEED = 10'000;
+
+    std::array<Spec, N>               _commands;
+    std::array<std::uint8_t, SLOTS>   _slots {};
+    std::uint32_t                     _seed {0};
+};
+
+
+//-----------------------------------------------------------------------------
+// Inline implementations.
+//-----------------------------------------------------------------------------
+template <typename Spec, std::size_t N, std::size_t SLOTS>
+consteval
+CommandTable<Spec, N, SLOTS>::
+CommandTable(const std::array<Spec, N> & commands) : _commands(commands)
+{
+    for (_seed = 0; _seed < MAX_SEED; ++_seed)
+    {
+        _slots.fill(NONE);
+
+        std::size_t i = 0;
+        for (; i < N; ++i)
+        {
+            auto & slot = _slots[command_hash(_commands[i].name, _seed) % SLOTS];
+            if (slot != NONE)
+            {
+                break;
+            }
+            slot = static_cast<std::uint8_t>(i);
+        }
+
+        if (i == N)
+        {
+            return;
+        }
+    }
+
+    // Not a constant expression, so a compile error.
+    throw std::logic_error("no perfect hash for the commands, more SLOTS?");
+}
+
+
+template <typename Spec, std::size_t N, std::size_t SLOTS>
+constexpr
+const Spec *
+CommandTable<Spec, N, SLOTS>::
+find(std::string_view name) const
+{
+    const auto i = _slots[command_hash(name, _seed) % SLOTS];
+    if (i == NONE or _commands[i].name != name)
+    {
+        return nullptr;
+    }
+    return &_commands[i];
+}
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,348 @@
+// Commands parsed and answered per second, and allocations per command, the
+// way CameraControl::_read_command() did it with std::istringstream, an if
+// chain of string compares and std::ostringstream responses, against a
+// CommandTable with a Tokenizer and a reused JsonWriter.  The handlers only
+// keep their arguments, what's measured is getting to them and the response.
+//
+//     make -C src/camera_control bench && src/camera_control/CommandTable_bench_bin
+
+#include <camera_control/CommandTable.h>
+#include <common/JsonWriter.h>
+#include <common/Tokenizer.h>
+#include <common/telemetry_bench.h>
+
+#include <array>
+#include <charconv>
+#include <map>
+#include <sstream>
+
+
+namespace
+{
+    // A mix of what the webapp sends, accepted and rejected.
+    const std::vector<std::string> COMMANDS = {
+        "trigger 0123",
+        "set_choice 0123 shutterspeed 1/250",
+        "timelapse_update 0123 5.0 1/10 1/1000 100 800 10 245 5 15 0 0.05",
+        "read_config 0123",
+        "telem_keyframe",
+        "trigger 9999",
+        "timelapse_update 0123 5.0 1/10 1/1000 100 800 10 245 5 15 0 1.5",
+        "calibrate_trigger 0123 0",
+        "bogus 1 2 3",
+    };
+
+    struct Rig
+    {
+        std::map<std::string, int, std::less<>> cameras {{"0123", 0}};
+        std::uint32_t last_accepted {0};
+        std::uint32_t last_rejected {0};
+        std::string last_message {};
+
+        // What the handlers keep.
+        std::string serial {};
+        float real {0.0f};
+        std::int64_t integer {0};
+    };
+
+
+    //-------------------------------------------------------------------------
+    // As _read_command() was.
+    //
+    struct Streams : Rig
+    {
+        std::string buffer;
+        std::string response;
+
+        void
+        respond(std::uint32_t cmd_id, bool accepted, const std::string & message)
+        {
+            (accepted ? last_accepted : last_rejected) = cmd_id;
+            if (not accepted)
+            {
+                last_message = message;
+            }
+            std::ostringstream oss;
+            oss << "{\"last_accepted_id\":" << last_accepted
+                << ",\"last_rejected_id\":" << last_rejected
+                << ",\"message\":\"" << last_message << "\"}";
+            response = oss.str();
+        }
+
+        void
+        read(const std::string & command_text)
+        {
+            std::istringstream iss(command_text);
+            std::uint32_t cmd_id = 0;
+            std::string command;
+            iss >> cmd_id >> command;
+
+            const auto reject = [&](const auto & ... text)
+            {
+                std::ostringstream msg_oss;
+                (msg_oss << ... << text);
+                respond(cmd_id, false, msg_oss.str());
+            };
+
+            if (command == "trigger" or command == "read_config")
+            {
+                std::string serial_arg;
+                if (not (iss >> serial_arg) or not cameras.contains(serial_arg))
+                {
+                    return reject("serial '", serial_arg, "' does not exist");
+                }
+                serial = serial_arg;
+            }
+            else if (command == "set_choice")
+            {
+                std::string serial_arg, property, value;
+                if (not ((iss >> serial_arg >> property) and std::getline(iss, value)))
+                {
+                    return reject("Failed to parse set_choice command: '", buffer, "'");
+                }
+                serial = serial_arg;
+            }
+            else if (command == "timelapse_update")
+            {
+                float interval, target_percent;
+                std::string shutters[4];
+                int masks[5];
+                if (not (iss >> serial >> interval >> shutters[0] >> shutters[1]
+                         >> shutters[2] >> shutters[3] >> masks[0] >> masks[1]
+                         >> masks[2] >> masks[3] >> masks[4] >> target_percent))
+                {
+                    return reject("Failed to parse timelapse from: '", buffer, "'");
+                }
+                if (target_percent < 0.0f or target_percent > 1.0f)
+                {
+                    return reject("Bad target_percent: ", target_percent);
+                }
+                real = interval;
+            }
+            else if (command == "calibrate_trigger")
+            {
+                std::uint32_t shots = 0;
+                if (not (iss >> serial >> shots) or shots == 0)
+                {
+                    return reject("Failed to parse calibrate_trigger command: '", buffer, "'");
+                }
+                integer = shots;
+            }
+            else if (command != "telem_keyframe")
+            {
+                return reject("Unknown command: '", command, "', ignorning");
+            }
+
+            respond(cmd_id, true, last_message);
+        }
+    };
+
+
+    //-------------------------------------------------------------------------
+    // As _read_command() is.
+    //
+    struct Table : Rig
+    {
+        using Handler = void (Table::*)(std::uint32_t, const CommandArgs &);
+
+        std::string_view buffer;
+        JsonWriter response {512};
+        std::string message;
+
+        void
+        respond(std::uint32_t cmd_id, bool accepted, std::string_view text)
+        {
+            (accepted ? last_accepted : last_rejected) = cmd_id;
+            if (not accepted)
+            {
+                last_message = text;
+            }
+            response.clear();
+            response.begin_object();
+            response.key("last_accepted_id").value(last_accepted);
+            response.key("last_rejected_id").value(last_rejected);
+            response.key("message").value(last_message);
+            response.end_object();
+        }
+
+        template <typename... Text>
+        void
+        reject(std::uint32_t cmd_id, const Text & ... text)
+        {
+            message.clear();
+            (message.append(text), ...);
+            respond(cmd_id, false, message);
+        }
+
+        void
+        serial_only(std::uint32_t cmd_id, const CommandArgs & args)
+        {
+            serial = args[0].text;
+            respond(cmd_id, true, last_message);
+        }
+
+        void
+        set_choice(std::uint32_t cmd_id, const CommandArgs & args)
+        {
+            serial = args[0].text;
+            respond(cmd_id, true, last_message);
+        }
+
+        void
+        timelapse_update(std::uint32_t cmd_id, const CommandArgs & args)
+        {
+            const auto target_percent = args[11].real;
+            if (target_percent < 0.0f or target_percent > 1.0f)
+            {
+                char number[32];
+                const auto end = std::to_chars(
+                    number, number + sizeof(number), target_percent,
+                    std::chars_format::general, 6
+                ).ptr;
+                return reject(cmd_id, "Bad target_percent: ", std::string_view(number, end - number));
+            }
+            serial = args[0].text;
+            real = args[1].real;
+            respond(cmd_id, true, last_message);
+        }
+
+        void
+        calibrate_trigger(std::uint32_t cmd_id, const CommandArgs & args)
+        {
+            serial = args[0].text;
+            integer = args[1].integer;
+            respond(cmd_id, true, last_message);
+        }
+
+        void
+        telem_keyframe(std::uint32_t cmd_id, const CommandArgs &)
+        {
+            respond(cmd_id, true, last_message);
+        }
+
+        void
+        read(std::string_view command_text)
+        {
+            static constexpr ArgSpec SERIAL[] = {{"serial", ArgType::serial}};
+            static constexpr ArgSpec SET_CHOICE[] = {
+                {"serial", ArgType::string},
+                {"property", ArgType::string},
+                {"value", ArgType::rest},
+            };
+            static constexpr ArgSpec TIMELAPSE_UPDATE[] = {
+                {"serial", ArgType::serial},
+                {"interval", ArgType::f32},
+                {"min_shutter", ArgType::string},
+                {"max_shutter", ArgType::string},
+                {"min_iso", ArgType::string},
+                {"max_iso", ArgType::string},
+                {"min_hist_mask", ArgType::i32},
+                {"max_hist_mask", ArgType::i32},
+                {"min_deadband", ArgType::i32},
+                {"max_deadband", ArgType::i32},
+                {"target_offset", ArgType::i32},
+                {"target_percent", ArgType::f32},
+            };
+            static constexpr ArgSpec CALIBRATE_TRIGGER[] = {
+                {"serial", ArgType::string},
+                {"shots", ArgType::count},
+            };
+
+            using Spec = CommandSpec<Handler>;
+            static constexpr CommandTable commands {std::array{
+                Spec{"trigger", &Table::serial_only, SERIAL, "serial '' does not exist"},
+                Spec{"read_config", &Table::serial_only, SERIAL, "serial '' does not exist"},
+                Spec{"set_choice", &Table::set_choice, SET_CHOICE, "Failed to parse set_choice command"},
+                Spec{"timelapse_update", &Table::timelapse_update, TIMELAPSE_UPDATE, "Failed to parse timelapse"},
+                Spec{"calibrate_trigger", &Table::calibrate_trigger, CALIBRATE_TRIGGER, "Failed to parse calibrate_trigger"},
+                Spec{"telem_keyframe", &Table::telem_keyframe},
+            }};
+
+            buffer = command_text;
+            Tokenizer tok(command_text);
+            std::uint32_t cmd_id = 0;
+            std::string_view command;
+            tok.next(cmd_id);
+            tok.next(command);
+
+            const auto * spec = commands.find(command);
+            if (not spec)
+            {
+                return reject(cmd_id, "Unknown command: '", command, "', ignorning");
+            }
+
+            CommandArgs args;
+            for (std::size_t i = 0; i < spec->args.size(); ++i)
+            {
+                const auto & [name, type] = spec->args[i];
+                if (not parse_arg(tok, type, args[i]))
+                {
+                    return reject(cmd_id, spec->parse_error, ": '", buffer, "'");
+                }
+                if (type == ArgType::serial and not cameras.contains(args[i].text))
+                {
+                    return reject(cmd_id, "serial '", args[i].text, "' does not exist");
+                }
+            }
+
+            (this->*spec->handler)(cmd_id, args);
+        }
+    };
+
+
+    template <typename Read>
+    void
+    report_commands(const std::string & name, std::size_t count, Read read)
+    {
+        // Numbered as the webapp sends them.
+        std::vector<std::string> texts;
+        for (std::size_t i = 0; i < COMMANDS.size(); ++i)
+        {
+            texts.push_back(std::to_string(i + 1) + " " + COMMANDS[i]);
+        }
+
+        // Warm up, buffers grow to size.
+        for (const auto & text : texts)
+        {
+            read(text);
+        }
+
+        const auto allocations = g_allocations.load();
+        const auto start = steady::now();
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            read(texts[i % texts.size()]);
+        }
+
+        const std::chrono::duration<double> elapsed = steady::now() - start;
+        const auto per_command = static_cast<double>(g_allocations.load() - allocations) / count;
+
+        std::cout << std::left << std::setw(16) << name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(8) << count / elapsed.count() / 1e6 << " M commands/s "
+                  << std::setw(7) << elapsed.count() / count * 1e9 << " ns/command "
+                  << std::setw(6) << per_command << " allocations/command" << std::endl;
+    }
+}
+
+
+int main()
+{
+    constexpr std::size_t count = 1'000'000;
+
+    Streams streams;
+    report_commands("istringstream", count, [&](const std::string & text)
+    {
+        streams.buffer = text;
+        streams.read(text);
+    });
+
+    Table table;
+    report_commands("CommandTable", count, [&](const std::string & text)
+    {
+        table.read(text);
+    });
+
+    return 0;
+}
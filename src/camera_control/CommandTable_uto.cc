@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CommandTable.h>
+
+#include <string>
+
+using namespace pycontrol;
+
+
+namespace
+{
+    using Handler = int;
+    using Spec = CommandSpec<Handler>;
+
+    constexpr ArgSpec ARGS[] = {
+        {"serial", ArgType::serial},
+        {"interval", ArgType::f32},
+        {"offset", ArgType::i32},
+        {"shots", ArgType::count},
+        {"value", ArgType::rest},
+    };
+
+    constexpr CommandTable COMMANDS {std::array{
+        Spec{"set_camera_id", 1},
+        Spec{"set_events", 2},
+        Spec{"load_sequence", 3},
+        Spec{"read_choices", 4},
+        Spec{"set_choice", 5, ARGS, "bad {arg}"},
+        Spec{"trigger", 6},
+    }};
+}
+
+
+TEST_CASE("CommandTable", "[CommandTable]")
+{
+    //-------------------------------------------------------------------------
+    // Lookup, only exact names.
+    //
+    static_assert(COMMANDS.find("trigger")->handler == 6);
+    static_assert(COMMANDS.find("triggers") == nullptr);
+
+    for (const auto * name : {"set_camera_id", "set_events", "load_sequence", "read_choices", "set_choice", "trigger"})
+    {
+        const auto * spec = COMMANDS.find(name);
+        REQUIRE( spec );
+        CHECK( spec->name == name );
+    }
+
+    CHECK( COMMANDS.find("") == nullptr );
+    CHECK( COMMANDS.find("trigge") == nullptr );
+    CHECK( COMMANDS.find("reset_sequence") == nullptr );
+
+    const auto * spec = COMMANDS.find("set_choice");
+    REQUIRE( spec->args.size() == 5 );
+    CHECK( spec->parse_error == "bad {arg}" );
+    CHECK( spec->remember );
+
+    //-------------------------------------------------------------------------
+    // Arguments by type.
+    //
+    {
+        Tokenizer tok("0123 2.5 -7 3   1/10 s  ");
+        CommandArgs args;
+        for (std::size_t i = 0; i < spec->args.size(); ++i)
+        {
+            REQUIRE( parse_arg(tok, spec->args[i].type, args[i]) );
+        }
+        CHECK( args[0].text == "0123" );
+        CHECK( args[1].real == 2.5f );
+        CHECK( args[2].i32() == -7 );
+        CHECK( args[3].u32() == 3 );
+        CHECK( args[4].text == "1/10 s" );
+        CHECK( tok.eof() );
+    }
+
+    CommandArg arg;
+    {
+        Tokenizer tok("0");
+        CHECK_FALSE( parse_arg(tok, ArgType::count, arg) );
+    }
+    {
+        Tokenizer tok("-1");
+        CHECK_FALSE( parse_arg(tok, ArgType::u32, arg) );
+    }
+    {
+        Tokenizer tok("abc");
+        CHECK_FALSE( parse_arg(tok, ArgType::f32, arg) );
+    }
+    {
+        Tokenizer tok("");
+        CHECK_FALSE( parse_arg(tok, ArgType::serial, arg) );
+        CHECK_FALSE( parse_arg(tok, ArgType::rest, arg) );
+    }
+}
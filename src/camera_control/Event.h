@@ -2,7 +2,9 @@
 
 #include <string>
 #include <string_view>
+#include <type_traits>
 
+#include <common/Symbol.h>
 #include <common/types.h>
 
 
@@ -17,6 +19,7 @@ enum class Channel: unsigned int
     fps,
     fstop,
     iso,
+    late_policy,
     mode,
     quality,
     shooting_speed,
@@ -38,6 +41,7 @@ to_string(Channel ch)
         case Channel::fps:            return "fps";
         case Channel::fstop:          return "fstop";
         case Channel::iso:            return "iso";
+        case Channel::late_policy:    return "late_policy";
         case Channel::mode:           return "mode";
         case Channel::quality:        return "quality";
         case Channel::shooting_speed: return "shooting_speed";
@@ -49,29 +53,38 @@ to_string(Channel ch)
 }
 
 
-struct Event
+// A channel value parsed once when the sequence is read.
+struct ChannelValue
 {
-    std::string  event_id;
-    milliseconds event_time_offset_ms;
-    std::string  camera_id;
-    Channel      channel;
-    std::string  channel_value;
+    // The value as a ratio:
+    //
+    //     shutter_speed  exposure in seconds, 1/2.5 is 10 / 25
+    //     fstop          f-number, f/5.6 is 56 / 10
+    //     fps            frames per second, 0 for start or stop
+    //     iso            sensitivity, 0 if not a number
+    //     burst_number   shot count
+    //     trigger        shot count
+    //     late_policy    LatePolicy::Mode / late ms
+    std::int32_t num {0};
+    std::int32_t den {1};
 
-    // Convenient constructor to enable std::vector::emplace_back().
-    Event(
-        std::string          event_id,
-        const milliseconds & event_time_offset_ms,
-        std::string          camera_id,
-        const Channel &      channel,
-        std::string          channel_value
-    )
-    : event_id(std::move(event_id)),
-      event_time_offset_ms(event_time_offset_ms),
-      camera_id(std::move(camera_id)),
-      channel(channel),
-      channel_value(std::move(channel_value))
-    {}
+    // The value as written, gphoto2 sets choices by their text.
+    Symbol       text {};
 };
 
 
+// A compiled sequence event, a few words with no strings to copy or parse
+// when it fires.
+struct Event
+{
+    Symbol       event_id {};
+    Symbol       camera_id {};
+    milliseconds event_time_offset_ms {0};
+    Channel      channel {Channel::null};
+    ChannelValue value {};
+};
+
+static_assert(std::is_trivially_copyable_v<Event>);
+
+
 } /* namespace */
\ No newline at end of file
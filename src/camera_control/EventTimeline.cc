@@ -0,0 +1,81 @@
+#include <camera_control/EventTimeline.h>
+#include <camera_control/CameraSequence.h>
+
+#include <algorithm>
+
+namespace pycontrol
+{
+
+
+void
+EventTimeline::
+compile(std::vector<Lane> && lanes)
+{
+    _lanes = std::move(lanes);
+    _entries.clear();
+
+    for (std::uint32_t lane = 0; lane < _lanes.size(); ++lane)
+    {
+        const auto & seq = _lanes[lane].sequence;
+        for (std::uint32_t idx = 0; idx < seq->size(); ++idx)
+        {
+            if (seq->time(idx) != MAX_TIME)
+            {
+                _entries.push_back(Entry{seq->time(idx), lane, idx});
+            }
+        }
+    }
+
+    // Each lane is already in time order, a stable sort keeps it that way.
+    std::stable_sort(
+        _entries.begin(),
+        _entries.end(),
+        [](const Entry & lhs, const Entry & rhs) { return lhs.time < rhs.time; }
+    );
+
+    _next = 0;
+    advance();
+}
+
+
+void
+EventTimeline::
+clear()
+{
+    _lanes.clear();
+    _entries.clear();
+    _next = 0;
+}
+
+
+void
+EventTimeline::
+reset(milliseconds utc_time)
+{
+    const auto first = std::partition_point(
+        _entries.begin(),
+        _entries.end(),
+        [utc_time](const Entry & entry) { return entry.time < utc_time; }
+    );
+
+    _next = std::distance(_entries.begin(), first);
+}
+
+
+void
+EventTimeline::
+advance()
+{
+    while (_next < _entries.size())
+    {
+        const auto & entry = _entries[_next];
+        if (not _lanes[entry.lane].sequence->done(entry.idx))
+        {
+            break;
+        }
+        ++_next;
+    }
+}
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <common/types.h>
+
+namespace pycontrol
+{
+
+class Camera;
+class CameraSequence;
+
+
+// Every connected camera's compiled sequence merged into one list sorted by
+// UTC event time.  The next event is always at the front, the control loop
+// doesn't look anything up per tick.  Rebuilt whenever the event times, the
+// sequences or the cameras they map to change.
+class EventTimeline
+{
+public:
+
+    struct Lane
+    {
+        std::shared_ptr<Camera>         camera;
+        std::shared_ptr<CameraSequence> sequence;
+    };
+
+    struct Entry
+    {
+        milliseconds  time;  // UTC
+        std::uint32_t lane;
+        std::uint32_t idx;   // Into the lane's sequence.
+    };
+
+    using entry_vec = std::vector<Entry>;
+
+    // The sequences must be compiled first.  Events without a time yet are
+    // left out.
+    void compile(std::vector<Lane> && lanes);
+    void clear();
+
+    // Binary search for the first event at or after the UTC time, the
+    // sequences must be reset to the same time.
+    void reset(milliseconds utc_time);
+
+    // Moves past events dispatched from the front.
+    void advance();
+
+    const std::vector<Lane> & lanes() const { return _lanes; }
+    const Lane & lane(std::uint32_t idx) const { return _lanes[idx]; }
+
+    // Pending events from the first, events further on may already be
+    // dispatched.
+    entry_vec::const_iterator begin() const { return _entries.begin() + _next; }
+    entry_vec::const_iterator end() const { return _entries.end(); }
+
+    bool empty() const { return _next >= _entries.size(); }
+    const Entry & front() const { return _entries[_next]; }
+    std::size_t size() const { return _entries.size(); }
+
+private:
+
+    std::vector<Lane> _lanes {};
+    entry_vec         _entries {};
+    std::size_t       _next {0};
+};
+
+
+} /* namespace pycontrol */
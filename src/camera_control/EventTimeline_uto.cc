@@ -0,0 +1,133 @@
+#include <memory>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraSequence.h>
+#include <camera_control/EventTimeline.h>
+
+using namespace pycontrol;
+
+
+TEST_CASE("EventTimeline", "[EventTimeline]")
+{
+    auto event = [](const char * event_id, milliseconds offset, const char * camera_id, Channel channel)
+    {
+        return Event{
+            .event_id = intern(event_id),
+            .camera_id = intern(camera_id),
+            .event_time_offset_ms = offset,
+            .channel = channel
+        };
+    };
+
+    const std::vector<Event> events = {
+        event("e2",  0, "z7", Channel::trigger),
+        event("e1", 10, "z7", Channel::shutter_speed),
+        event("e1", 10, "z7", Channel::trigger),
+        event("e1",  0, "z8", Channel::trigger),
+        event("e1", 20, "z8", Channel::trigger),
+        event("e3",  0, "z8", Channel::trigger),
+    };
+
+    auto z7 = std::make_shared<CameraSequence>();
+    auto z8 = std::make_shared<CameraSequence>();
+    REQUIRE( z7->load("z7", events) == result::success );
+    REQUIRE( z8->load("z8", events) == result::success );
+
+    //-------------------------------------------------------------------------
+    // Sequences sort by resolved time, ties keep file order and events
+    // without a time go last.
+    //
+    const event_time_map times = {{"e1", 1000}, {"e2", 1005}};
+    z7->compile(times);
+    z8->compile(times);
+
+    REQUIRE( z7->size() == 3 );
+    CHECK( z7->time(0) == 1005 );
+    CHECK( z7->time(1) == 1010 );
+    CHECK( z7->event(1).channel == Channel::shutter_speed );
+    CHECK( z7->time(2) == 1010 );
+    CHECK( z7->event(2).channel == Channel::trigger );
+
+    // Recompile with e2 earlier moves it to the front.
+    z7->compile({{"e1", 1000}, {"e2", 900}});
+    CHECK( z7->time(0) == 900 );
+    CHECK( z7->event(0).event_id == intern("e2") );
+    z7->compile(times);
+
+    REQUIRE( z8->size() == 3 );
+    CHECK( z8->time(0) == 1000 );
+    CHECK( z8->time(1) == 1020 );
+    CHECK( z8->time(2) == MAX_TIME );
+
+    //-------------------------------------------------------------------------
+    // The timeline merges the lanes and leaves out events without a time.
+    //
+    EventTimeline timeline;
+    timeline.compile({{nullptr, z7}, {nullptr, z8}});
+
+    REQUIRE( timeline.size() == 5 );
+    REQUIRE( not timeline.empty() );
+
+    std::vector<milliseconds> order;
+    for (const auto & entry : timeline)
+    {
+        order.push_back(entry.time);
+    }
+    CHECK( order == std::vector<milliseconds>{1000, 1005, 1010, 1010, 1020} );
+
+    CHECK( timeline.front().time == 1000 );
+    CHECK( timeline.front().lane == 1 );
+
+    //-------------------------------------------------------------------------
+    // Dispatching out of order only moves the front once the front is done.
+    //
+    z7->set_done(0);
+    timeline.advance();
+    CHECK( timeline.front().time == 1000 );
+    CHECK( z7->next() == 1 );
+
+    z8->set_done(0);
+    timeline.advance();
+    CHECK( timeline.front().time == 1010 );
+    CHECK( timeline.front().lane == 0 );
+    CHECK( timeline.front().idx == 1 );
+
+    //-------------------------------------------------------------------------
+    // Dispatched events survive a recompile.
+    //
+    z7->compile(times);
+    z8->compile(times);
+    timeline.compile({{nullptr, z7}, {nullptr, z8}});
+    CHECK( timeline.front().time == 1010 );
+    CHECK( z7->next() == 1 );
+    CHECK( z8->next() == 1 );
+
+    //-------------------------------------------------------------------------
+    // Reset is a binary search, everything before the time is dispatched.
+    //
+    z7->reset(0);
+    z8->reset(0);
+    timeline.reset(0);
+    CHECK( timeline.front().time == 1000 );
+    CHECK( z7->next() == 0 );
+    CHECK( not z7->done(0) );
+
+    z7->reset(1010);
+    z8->reset(1010);
+    timeline.reset(1010);
+    CHECK( timeline.front().time == 1010 );
+    CHECK( z7->next() == 1 );
+    CHECK( z8->next() == 1 );
+    CHECK( z8->done(0) );
+
+    z7->reset(2000);
+    z8->reset(2000);
+    timeline.reset(2000);
+    CHECK( timeline.empty() );
+    CHECK( z7->empty() );
+
+    // The event without a time is still pending.
+    CHECK( not z8->empty() );
+    CHECK( z8->next() == 2 );
+}
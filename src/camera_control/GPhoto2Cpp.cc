@@ -39,6 +39,14 @@ GPhoto2Cpp::read_config(const gphoto2cpp::camera_ptr & camera)
     return gphoto2cpp::read_config(camera);
 }
 
+bool
+GPhoto2Cpp::read_config(
+    const gphoto2cpp::camera_ptr & camera,
+    const std::vector<std::string> & properties)
+{
+    return gphoto2cpp::read_config(camera, properties);
+}
+
 bool
 GPhoto2Cpp::read_property(
     const gphoto2cpp::camera_ptr & camera,
@@ -66,6 +74,14 @@ GPhoto2Cpp::write_config(gphoto2cpp::camera_ptr & camera)
     return gphoto2cpp::write_config(camera);
 }
 
+bool
+GPhoto2Cpp::write_config(
+    gphoto2cpp::camera_ptr & camera,
+    const std::vector<std::string> & properties)
+{
+    return gphoto2cpp::write_config(camera, properties);
+}
+
 bool
 GPhoto2Cpp::write_property(
     gphoto2cpp::camera_ptr & camera,
@@ -28,6 +28,11 @@ public:
     bool
     read_config(const gphoto2cpp::camera_ptr & camera) override;
 
+    bool
+    read_config(
+        const gphoto2cpp::camera_ptr & camera,
+        const std::vector<std::string> & properties) override;
+
     bool
     read_property(
         const gphoto2cpp::camera_ptr & camera,
@@ -43,6 +48,11 @@ public:
     bool
     write_config(gphoto2cpp::camera_ptr & camera) override;
 
+    bool
+    write_config(
+        gphoto2cpp::camera_ptr & camera,
+        const std::vector<std::string> & properties) override;
+
     bool
     write_property(
             gphoto2cpp::camera_ptr & camera,
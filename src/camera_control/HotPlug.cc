@@ -0,0 +1,210 @@
+#include <errno.h>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string.h>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string_view>
+
+#include <camera_control/HotPlug.h>
+
+#include <common/io.h>
+#include <common/str_utils.h>
+
+namespace pycontrol
+{
+
+
+namespace
+{
+
+// The multicast group the kernel sends its uevents to, udev listens to the
+// same group and rebroadcasts on another.
+constexpr unsigned int KERNEL_UEVENTS = 1;
+
+
+UsbPort
+usb_port(int bus, int dev)
+{
+    char port[16];
+    std::snprintf(port, sizeof(port), "usb:%03d,%03d", bus, dev);
+    return port;
+}
+
+} /* namespace */
+
+
+HotPlug::
+HotPlug(const std::string & sysfs)
+:
+    _sysfs(sysfs)
+{
+}
+
+
+HotPlug::
+~HotPlug()
+{
+    if (_socket_fd >= 0)
+    {
+        ::close(_socket_fd);
+    }
+}
+
+
+result
+HotPlug::
+init()
+{
+    ABORT_IF(_socket_fd >= 0, "socket already initialized on fd: " << _socket_fd, result::failure);
+
+    _socket_fd = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    ABORT_IF(
+        _socket_fd < 0,
+        "socket(NETLINK_KOBJECT_UEVENT) failed, errno: " << strerror(errno),
+        result::failure
+    );
+
+    ::sockaddr_nl addr {};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = KERNEL_UEVENTS;
+
+    if (::bind(_socket_fd, reinterpret_cast<::sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+        ERROR_LOG << "bind() to the kernel's uevents failed, errno: " << strerror(errno) << std::endl;
+        ::close(_socket_fd);
+        _socket_fd = -1;
+        return result::failure;
+    }
+
+    return result::success;
+}
+
+
+result
+HotPlug::
+poll(std::vector<Event> & out)
+{
+    ABORT_IF(_socket_fd < 0, "Must call init() first!", result::failure);
+
+    while (true)
+    {
+        ::sockaddr_nl sender {};
+        ::socklen_t sender_size = sizeof(sender);
+
+        const auto bytes_read = ::recvfrom(
+            _socket_fd,
+            _buffer.data(),
+            _buffer.size(),
+            0 /* flags */,
+            reinterpret_cast<::sockaddr *>(&sender),
+            &sender_size
+        );
+
+        if (bytes_read < 0)
+        {
+            if (errno == EAGAIN or errno == EWOULDBLOCK)
+            {
+                return result::success;
+            }
+
+            ABORT_IF(
+                errno == ENOBUFS,
+                "uevents were dropped, falling back to a scan",
+                result::failure
+            );
+
+            ABORT_IF(true, "recvfrom() failed, errno: " << strerror(errno), result::failure);
+        }
+
+        // Only trust the kernel.
+        if (sender.nl_pid != 0)
+        {
+            continue;
+        }
+
+        Event event;
+        if (handle(_buffer.data(), static_cast<std::size_t>(bytes_read), event))
+        {
+            out.push_back(event);
+        }
+    }
+}
+
+
+bool
+HotPlug::
+handle(const char * message, std::size_t size, Event & out) const
+{
+    const std::string_view all(message, size);
+
+    // Skip the ACTION@DEVPATH header, the same is in the KEY=VALUE strings.
+    std::map<std::string_view, std::string_view> env;
+    auto pos = all.find('\0');
+    while (pos != std::string_view::npos and pos + 1 < all.size())
+    {
+        const auto start = pos + 1;
+        pos = all.find('\0', start);
+        const auto pair = all.substr(start, pos == std::string_view::npos ? pos : pos - start);
+        const auto equals = pair.find('=');
+        if (equals != std::string_view::npos)
+        {
+            env[pair.substr(0, equals)] = pair.substr(equals + 1);
+        }
+    }
+
+    if (env["SUBSYSTEM"] != "usb")
+    {
+        return false;
+    }
+
+    const auto action = env["ACTION"];
+    const auto devtype = env["DEVTYPE"];
+
+    // Interface class 6, still image.
+    if (action == "add" and devtype == "usb_interface" and env["INTERFACE"].starts_with("6/"))
+    {
+        // The interface's device is its parent, .../1-1 for .../1-1/1-1:1.0.
+        const auto devpath = std::string(env["DEVPATH"]);
+        const auto slash = devpath.rfind('/');
+        if (slash == std::string::npos)
+        {
+            return false;
+        }
+        const auto device = _sysfs + devpath.substr(0, slash);
+
+        int bus = 0;
+        int dev = 0;
+        if (not (std::ifstream(device + "/busnum") >> bus) or
+            not (std::ifstream(device + "/devnum") >> dev))
+        {
+            ERROR_LOG << "can't read the bus and device numbers of '" << device << "'" << std::endl;
+            return false;
+        }
+
+        out = Event{.type = Event::Type::add, .port = usb_port(bus, dev)};
+        return true;
+    }
+
+    if (action == "remove" and devtype == "usb_device")
+    {
+        int bus = 0;
+        int dev = 0;
+        if (as_type(std::string(env["BUSNUM"]), bus) or as_type(std::string(env["DEVNUM"]), dev))
+        {
+            return false;
+        }
+
+        out = Event{.type = Event::Type::remove, .port = usb_port(bus, dev)};
+        return true;
+    }
+
+    return false;
+}
+
+
+} /* namespace pycontrol */
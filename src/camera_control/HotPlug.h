@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <interface/HotPlug.h>
+
+namespace pycontrol
+{
+
+
+// Listens to the kernel's uevents on a netlink socket.  A camera is added when
+// the kernel adds a still image interface, USB class 6 as PTP cameras have.
+// The kernel doesn't say what a removed device's interfaces were, so every USB
+// device removed is reported and ports that aren't cameras are for the caller
+// to ignore.
+class HotPlug : public interface::HotPlug
+{
+public:
+
+    // Added interfaces' bus and device numbers are read from sysfs.
+    explicit HotPlug(const std::string & sysfs = "/sys");
+    ~HotPlug();
+
+    // Opens the non-blocking uevent socket.
+    result init();
+
+    // Fails if the kernel dropped events because they weren't read in time,
+    // the caller should scan for cameras instead.
+    result poll(std::vector<Event> & out) override;
+
+    // Turns one uevent message, "ACTION@DEVPATH" followed by KEY=VALUE
+    // strings, all NUL terminated, into an event if it's about a camera.
+    bool handle(const char * message, std::size_t size, Event & out) const;
+
+private:
+
+    HotPlug(const HotPlug & copy) = delete;
+    HotPlug & operator=(const HotPlug & rhs) = delete;
+
+    std::string       _sysfs;
+    int               _socket_fd {-1};
+    std::vector<char> _buffer = std::vector<char>(8192);
+};
+
+
+} /* namespace pycontrol */
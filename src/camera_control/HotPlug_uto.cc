@@ -0,0 +1,146 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraControl_uto.h>
+#include <camera_control/HotPlug.h>
+
+using namespace pycontrol;
+
+namespace
+{
+
+// A uevent as the kernel sends it, "ACTION@DEVPATH" then KEY=VALUE strings.
+std::string
+uevent(const std::string & header, const std::vector<std::string> & pairs)
+{
+    std::string out = header;
+    out.push_back('\0');
+    for (const auto & pair : pairs)
+    {
+        out += pair;
+        out.push_back('\0');
+    }
+    return out;
+}
+
+} /* namespace */
+
+
+TEST_CASE("HotPlug: handle", "[HotPlug]")
+{
+    const auto dir = TempFile("hot_plug_sysfs");
+    const auto & sysfs = dir.path;
+    const auto device = sysfs / "devices/pci0000:00/0000:00:14.0/usb1/1-1";
+    std::filesystem::create_directories(device);
+    std::ofstream(device / "busnum") << "1\n";
+    std::ofstream(device / "devnum") << "7\n";
+
+    HotPlug hot_plug(sysfs.string());
+    HotPlug::Event event;
+
+    //-------------------------------------------------------------------------
+    // A still image interface added.
+    //
+    {
+        const auto message = uevent(
+            "add@/devices/pci0000:00/0000:00:14.0/usb1/1-1/1-1:1.0",
+            {
+                "ACTION=add",
+                "DEVPATH=/devices/pci0000:00/0000:00:14.0/usb1/1-1/1-1:1.0",
+                "SUBSYSTEM=usb",
+                "DEVTYPE=usb_interface",
+                "INTERFACE=6/1/1",
+                "SEQNUM=4242",
+            }
+        );
+
+        REQUIRE( hot_plug.handle(message.data(), message.size(), event) );
+        CHECK( event.type == HotPlug::Event::Type::add );
+        CHECK( event.port == "usb:001,007" );
+    }
+
+    //-------------------------------------------------------------------------
+    // Other interfaces and the device itself are ignored on add.
+    //
+    {
+        const auto message = uevent(
+            "add@/devices/pci0000:00/0000:00:14.0/usb1/1-1/1-1:1.0",
+            {
+                "ACTION=add",
+                "DEVPATH=/devices/pci0000:00/0000:00:14.0/usb1/1-1/1-1:1.0",
+                "SUBSYSTEM=usb",
+                "DEVTYPE=usb_interface",
+                "INTERFACE=8/6/80",
+            }
+        );
+        CHECK_FALSE( hot_plug.handle(message.data(), message.size(), event) );
+    }
+    {
+        const auto message = uevent(
+            "add@/devices/pci0000:00/0000:00:14.0/usb1/1-1",
+            {
+                "ACTION=add",
+                "DEVPATH=/devices/pci0000:00/0000:00:14.0/usb1/1-1",
+                "SUBSYSTEM=usb",
+                "DEVTYPE=usb_device",
+                "BUSNUM=001",
+                "DEVNUM=007",
+            }
+        );
+        CHECK_FALSE( hot_plug.handle(message.data(), message.size(), event) );
+    }
+
+    //-------------------------------------------------------------------------
+    // A device removed, sysfs is already gone so the numbers come with it.
+    //
+    {
+        const auto message = uevent(
+            "remove@/devices/pci0000:00/0000:00:14.0/usb1/1-2",
+            {
+                "ACTION=remove",
+                "DEVPATH=/devices/pci0000:00/0000:00:14.0/usb1/1-2",
+                "SUBSYSTEM=usb",
+                "DEVTYPE=usb_device",
+                "BUSNUM=002",
+                "DEVNUM=013",
+            }
+        );
+
+        REQUIRE( hot_plug.handle(message.data(), message.size(), event) );
+        CHECK( event.type == HotPlug::Event::Type::remove );
+        CHECK( event.port == "usb:002,013" );
+    }
+
+    //-------------------------------------------------------------------------
+    // Not USB, or the interface's device isn't in sysfs.
+    //
+    {
+        const auto message = uevent(
+            "add@/devices/virtual/net/tun0",
+            {
+                "ACTION=add",
+                "DEVPATH=/devices/virtual/net/tun0",
+                "SUBSYSTEM=net",
+            }
+        );
+        CHECK_FALSE( hot_plug.handle(message.data(), message.size(), event) );
+    }
+    {
+        const auto message = uevent(
+            "add@/devices/pci0000:00/0000:00:14.0/usb1/1-3/1-3:1.0",
+            {
+                "ACTION=add",
+                "DEVPATH=/devices/pci0000:00/0000:00:14.0/usb1/1-3/1-3:1.0",
+                "SUBSYSTEM=usb",
+                "DEVTYPE=usb_interface",
+                "INTERFACE=6/1/1",
+            }
+        );
+        CHECK_FALSE( hot_plug.handle(message.data(), message.size(), event) );
+    }
+
+    std::filesystem::remove_all(sysfs);
+}
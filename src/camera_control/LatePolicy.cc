@@ -0,0 +1,165 @@
+#include <camera_control/LatePolicy.h>
+
+#include <common/io.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace pycontrol
+{
+
+
+result
+LatePolicy::
+parse(std::string_view text, LatePolicy & out)
+{
+    std::istringstream iss{std::string(text)};
+    std::string mode_str;
+    iss >> mode_str;
+
+    Mode mode = Mode::strict;
+    if (mode_str == "strict")
+    {
+        mode = Mode::strict;
+    }
+    else if (mode_str == "skip-late")
+    {
+        mode = Mode::skip_late;
+    }
+    else if (mode_str == "compress")
+    {
+        mode = Mode::compress;
+    }
+    else
+    {
+        ABORT_IF(true, "unknown late policy '" << text << "'", result::failure);
+    }
+
+    // Only strict can leave out how late is late.
+    milliseconds late_ms = 0;
+    if (not (iss >> late_ms))
+    {
+        ABORT_IF_NOT(
+            mode == Mode::strict and iss.eof(),
+            "late policy '" << text << "' needs a time in ms",
+            result::failure
+        );
+        late_ms = 0;
+    }
+
+    std::string extra;
+    ABORT_IF(
+        late_ms < 0 or (iss >> extra),
+        "bad late policy '" << text << "'",
+        result::failure
+    );
+
+    out.set(mode, late_ms);
+
+    return result::success;
+}
+
+
+void
+LatePolicy::
+set(Mode mode, milliseconds late_ms)
+{
+    _mode = mode;
+    _late_ms = late_ms;
+    if (_mode != Mode::compress)
+    {
+        _compressing = false;
+    }
+}
+
+
+milliseconds
+LatePolicy::
+due(milliseconds time) const
+{
+    if (not _compressing or time < _from)
+    {
+        return time;
+    }
+
+    // Can't finish on time any more, back to back.
+    if (_at >= _end)
+    {
+        return std::max(time, _at);
+    }
+
+    return _at + (time - _from) * (_end - _at) / (_end - _from);
+}
+
+
+bool
+LatePolicy::
+admit(milliseconds time, milliseconds fire_time, milliseconds end_time)
+{
+    const auto scheduled = due(time);
+
+    if (fire_time - scheduled <= _late_ms)
+    {
+        ++_counts.fired;
+        if (scheduled != time)
+        {
+            ++_counts.compressed;
+        }
+        return true;
+    }
+
+    switch (_mode)
+    {
+        case Mode::strict:
+        {
+            break;
+        }
+        case Mode::skip_late:
+        {
+            ++_counts.skipped;
+            return false;
+        }
+        case Mode::compress:
+        {
+            // Respace from here, again if already compressing.
+            _compressing = end_time > time;
+            _from = time;
+            _at = fire_time;
+            _end = end_time;
+            break;
+        }
+    }
+
+    ++_counts.fired;
+    ++_counts.late;
+
+    return true;
+}
+
+
+std::string_view
+to_string(LatePolicy::Mode mode)
+{
+    switch (mode)
+    {
+        case LatePolicy::Mode::strict:    return "strict";
+        case LatePolicy::Mode::skip_late: return "skip-late";
+        case LatePolicy::Mode::compress:  return "compress";
+    }
+    return "to_string(LatePolicy::Mode) error";
+}
+
+
+std::string
+to_string(const LatePolicy & policy)
+{
+    std::string out(to_string(policy.mode()));
+    if (policy.late_ms() > 0 or policy.mode() != LatePolicy::Mode::strict)
+    {
+        out += " " + std::to_string(policy.late_ms());
+    }
+    return out;
+}
+
+
+} /* namespace pycontrol */
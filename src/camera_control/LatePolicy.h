@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include <common/types.h>
+
+namespace pycontrol
+{
+
+
+// What the control loop does with a camera's triggers once the camera falls
+// behind its sequence, e.g. when an earlier burst fills its buffer.
+//
+//     strict      every trigger fires however late, the sequence overruns.
+//     skip-late   triggers more than late_ms late are dropped so the camera
+//                 catches up, settings are always applied.
+//     compress    once a trigger is more than late_ms late, the camera's
+//                 remaining triggers are respaced to finish on its last
+//                 scripted trigger time.
+//
+// Times are the timeline's UTC milliseconds.  Every decision is counted.
+class LatePolicy
+{
+public:
+
+    enum class Mode: std::uint32_t
+    {
+        strict,
+        skip_late,
+        compress,
+    };
+
+    struct Counts
+    {
+        std::uint32_t fired      {0};  // Triggers sent.
+        std::uint32_t late       {0};  // Sent more than late_ms late.
+        std::uint32_t skipped    {0};  // Dropped by skip-late.
+        std::uint32_t compressed {0};  // Sent at a respaced time.
+    };
+
+    LatePolicy() = default;
+    LatePolicy(Mode mode, milliseconds late_ms) : _mode(mode), _late_ms(late_ms) {}
+
+    // "strict [ms]", "skip-late ms" or "compress ms".
+    static result parse(std::string_view text, LatePolicy & out);
+
+    Mode mode() const { return _mode; }
+    milliseconds late_ms() const { return _late_ms; }
+
+    // Changes the mode, the counts carry on.
+    void set(Mode mode, milliseconds late_ms);
+
+    // When the trigger scheduled at time is due, later than scheduled for
+    // the triggers being compressed.
+    milliseconds due(milliseconds time) const;
+
+    // Whether the trigger scheduled at time is sent, given the camera won't
+    // get to it before fire_time.  end_time is the camera's last scripted
+    // trigger, a compress starting here finishes on it.
+    bool admit(milliseconds time, milliseconds fire_time, milliseconds end_time);
+
+    // Stops compressing, the scheduled times it respaced have changed.
+    void rewind() { _compressing = false; }
+
+    bool compressing() const { return _compressing; }
+    const Counts & counts() const { return _counts; }
+
+private:
+
+    Mode         _mode {Mode::strict};
+    milliseconds _late_ms {0};
+    Counts       _counts {};
+
+    // Triggers scheduled from _from to _end are respaced to start at _at.
+    bool         _compressing {false};
+    milliseconds _from {0};
+    milliseconds _at {0};
+    milliseconds _end {0};
+};
+
+
+std::string_view to_string(LatePolicy::Mode mode);
+
+// "skip-late 500"
+std::string to_string(const LatePolicy & policy);
+
+
+} /* namespace pycontrol */
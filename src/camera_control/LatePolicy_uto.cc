@@ -0,0 +1,115 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/LatePolicy.h>
+
+using namespace pycontrol;
+
+
+TEST_CASE("LatePolicy::parse", "[LatePolicy]")
+{
+    LatePolicy policy;
+
+    REQUIRE( LatePolicy::parse("skip-late 500", policy) == result::success );
+    CHECK( policy.mode() == LatePolicy::Mode::skip_late );
+    CHECK( policy.late_ms() == 500 );
+    CHECK( to_string(policy) == "skip-late 500" );
+
+    REQUIRE( LatePolicy::parse("compress 250", policy) == result::success );
+    CHECK( policy.mode() == LatePolicy::Mode::compress );
+    CHECK( policy.late_ms() == 250 );
+
+    REQUIRE( LatePolicy::parse("strict", policy) == result::success );
+    CHECK( policy.mode() == LatePolicy::Mode::strict );
+    CHECK( policy.late_ms() == 0 );
+    CHECK( to_string(policy) == "strict" );
+
+    REQUIRE( LatePolicy::parse("strict 100", policy) == result::success );
+    CHECK( policy.late_ms() == 100 );
+
+    CHECK( LatePolicy::parse("", policy) == result::failure );
+    CHECK( LatePolicy::parse("lenient 100", policy) == result::failure );
+    CHECK( LatePolicy::parse("skip-late", policy) == result::failure );
+    CHECK( LatePolicy::parse("compress -5", policy) == result::failure );
+    CHECK( LatePolicy::parse("compress 5 ms", policy) == result::failure );
+
+    // Failures leave the policy alone.
+    CHECK( to_string(policy) == "strict 100" );
+}
+
+
+TEST_CASE("LatePolicy strict", "[LatePolicy]")
+{
+    LatePolicy policy(LatePolicy::Mode::strict, 100);
+
+    CHECK( policy.admit(1'000, 1'050, 5'000) );
+    CHECK( policy.admit(2'000, 2'500, 5'000) );
+    CHECK( policy.due(3'000) == 3'000 );
+
+    CHECK( policy.counts().fired == 2 );
+    CHECK( policy.counts().late == 1 );
+    CHECK( policy.counts().skipped == 0 );
+    CHECK( policy.counts().compressed == 0 );
+}
+
+
+TEST_CASE("LatePolicy skip-late", "[LatePolicy]")
+{
+    LatePolicy policy(LatePolicy::Mode::skip_late, 100);
+
+    CHECK( policy.admit(1'000, 1'100, 5'000) );
+    CHECK_FALSE( policy.admit(1'250, 1'400, 5'000) );
+    CHECK( policy.admit(1'500, 1'500, 5'000) );
+
+    CHECK( policy.counts().fired == 2 );
+    CHECK( policy.counts().late == 0 );
+    CHECK( policy.counts().skipped == 1 );
+
+    // Switching mode keeps the counts.
+    policy.set(LatePolicy::Mode::strict, 0);
+    CHECK( policy.admit(2'000, 2'400, 5'000) );
+    CHECK( policy.counts().fired == 3 );
+    CHECK( policy.counts().late == 1 );
+    CHECK( policy.counts().skipped == 1 );
+}
+
+
+TEST_CASE("LatePolicy compress", "[LatePolicy]")
+{
+    LatePolicy policy(LatePolicy::Mode::compress, 100);
+
+    CHECK( policy.admit(1'000, 1'000, 2'000) );
+    CHECK_FALSE( policy.compressing() );
+
+    // 500 ms late at 1.2 s, 1.2 s to 2.0 s is respaced over 1.7 s to 2.0 s.
+    CHECK( policy.admit(1'200, 1'700, 2'000) );
+    CHECK( policy.compressing() );
+    CHECK( policy.due(1'100) == 1'100 );
+    CHECK( policy.due(1'200) == 1'700 );
+    CHECK( policy.due(1'600) == 1'850 );
+    CHECK( policy.due(2'000) == 2'000 );
+
+    CHECK( policy.admit(1'600, 1'850, 2'000) );
+    CHECK( policy.admit(2'000, 2'000, 2'000) );
+
+    CHECK( policy.counts().fired == 4 );
+    CHECK( policy.counts().late == 1 );
+    CHECK( policy.counts().compressed == 1 );
+
+    // Falling behind again while compressing respaces from there.
+    policy.rewind();
+    CHECK( policy.admit(1'200, 1'700, 2'000) );
+    CHECK( policy.admit(1'600, 2'000, 2'000) );
+    CHECK( policy.due(1'800) == 2'000 );
+    CHECK( policy.counts().late == 3 );
+
+    // Past the end already, what's left goes back to back.
+    policy.rewind();
+    CHECK( policy.admit(1'000, 2'500, 2'000) );
+    CHECK( policy.due(1'500) == 2'500 );
+    CHECK( policy.due(2'000) == 2'500 );
+
+    // The last trigger has nothing after it to respace.
+    policy.rewind();
+    CHECK( policy.admit(2'000, 2'500, 2'000) );
+    CHECK_FALSE( policy.compressing() );
+}
@@ -0,0 +1,280 @@
+#include <camera_control/SequenceBinary.h>
+
+#include <common/io.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+
+namespace pycontrol
+{
+
+namespace
+{
+
+// A read only mapping of a whole file.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    ~MappedFile()
+    {
+        if (_data)
+        {
+            ::munmap(_data, _size);
+        }
+    }
+
+    result open(const std::string & filename)
+    {
+        const int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        ABORT_IF(fd < 0, "error opening file '" << filename << "'", result::failure);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            ABORT_IF(true, "fstat('" << filename << "') failed", result::failure);
+        }
+
+        _size = static_cast<std::size_t>(st.st_size);
+        if (_size > 0)
+        {
+            void * data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            ABORT_IF(data == MAP_FAILED, "mmap('" << filename << "') failed", result::failure);
+            _data = data;
+        }
+        else
+        {
+            ::close(fd);
+        }
+
+        return result::success;
+    }
+
+    const char * data() const { return static_cast<const char *>(_data); }
+    std::size_t size() const { return _size; }
+
+private:
+    void *      _data {nullptr};
+    std::size_t _size {0};
+};
+
+
+std::uint64_t
+fnv1a_64(const char * data, std::size_t size)
+{
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+} /* namespace */
+
+
+result
+checksum_file(const std::string & filename, std::uint64_t & size, std::uint64_t & checksum)
+{
+    MappedFile file;
+    ABORT_ON_FAILURE(file.open(filename), "failed", result::failure);
+
+    size = file.size();
+    checksum = fnv1a_64(file.data(), file.size());
+
+    return result::success;
+}
+
+
+result
+write_sequence_binary(
+    const std::string & filename,
+    const std::string & source,
+    const std::vector<Event> & events)
+{
+    seqb::Header header {};
+    std::memcpy(header.magic, seqb::MAGIC, sizeof(header.magic));
+    header.version = seqb::VERSION;
+    header.num_events = static_cast<std::uint32_t>(events.size());
+
+    ABORT_ON_FAILURE(
+        checksum_file(source, header.source_size, header.source_checksum),
+        "failed to checksum '" << source << "'",
+        result::failure
+    );
+
+    // Each distinct string once.
+    std::unordered_map<Symbol, std::uint32_t> index;
+    std::vector<std::uint32_t> offsets {0};
+    std::string chars;
+
+    auto string_index = [&](Symbol sym)
+    {
+        const auto [itor, added] = index.try_emplace(sym, static_cast<std::uint32_t>(offsets.size() - 1));
+        if (added)
+        {
+            chars += to_string(sym);
+            offsets.push_back(static_cast<std::uint32_t>(chars.size()));
+        }
+        return itor->second;
+    };
+
+    std::vector<seqb::Record> records;
+    records.reserve(events.size());
+    for (const auto & event : events)
+    {
+        records.push_back(
+            seqb::Record{
+                .event_time_offset_ms = event.event_time_offset_ms,
+                .event_id = string_index(event.event_id),
+                .camera_id = string_index(event.camera_id),
+                .channel = static_cast<std::uint32_t>(event.channel),
+                .num = event.value.num,
+                .den = event.value.den,
+                .text = string_index(event.value.text)
+            }
+        );
+    }
+
+    header.num_strings = static_cast<std::uint32_t>(offsets.size() - 1);
+    header.strings_size = static_cast<std::uint32_t>(chars.size());
+
+    // Write a temporary and rename it over the original so a reader never
+    // maps a half written file.
+    const auto temp = filename + ".tmp";
+    {
+        std::ofstream fout(temp, std::ios::binary | std::ios::trunc);
+        ABORT_IF_NOT(fout.is_open(), "error opening file '" << temp << "'", result::failure);
+
+        fout.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        fout.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(seqb::Record));
+        fout.write(reinterpret_cast<const char *>(offsets.data()), offsets.size() * sizeof(std::uint32_t));
+        fout.write(chars.data(), chars.size());
+
+        ABORT_IF_NOT(fout.good(), "error writing file '" << temp << "'", result::failure);
+    }
+
+    ABORT_IF(
+        std::rename(temp.c_str(), filename.c_str()) != 0,
+        "error renaming '" << temp << "' to '" << filename << "'",
+        result::failure
+    );
+
+    return result::success;
+}
+
+
+result
+read_sequence_binary(
+    const std::string & filename,
+    const std::string & source,
+    std::vector<Event> & out)
+{
+    out.clear();
+
+    MappedFile file;
+    ABORT_ON_FAILURE(file.open(filename), "failed", result::failure);
+
+    ABORT_IF(file.size() < sizeof(seqb::Header), filename << ": too short", result::failure);
+
+    const auto & header = *reinterpret_cast<const seqb::Header *>(file.data());
+
+    ABORT_IF(
+        std::memcmp(header.magic, seqb::MAGIC, sizeof(header.magic)) != 0,
+        filename << ": not a compiled sequence",
+        result::failure
+    );
+    ABORT_IF(
+        header.version != seqb::VERSION,
+        filename << ": version " << header.version << ", expecting " << seqb::VERSION,
+        result::failure
+    );
+
+    const std::uint64_t records_at = sizeof(seqb::Header);
+    const std::uint64_t offsets_at = records_at + std::uint64_t{header.num_events} * sizeof(seqb::Record);
+    const std::uint64_t chars_at = offsets_at + (std::uint64_t{header.num_strings} + 1) * sizeof(std::uint32_t);
+    const std::uint64_t file_size = chars_at + header.strings_size;
+
+    ABORT_IF(
+        file_size != file.size(),
+        filename << ": size " << file.size() << ", header says " << file_size,
+        result::failure
+    );
+
+    std::uint64_t source_size = 0;
+    std::uint64_t source_checksum = 0;
+    ABORT_ON_FAILURE(
+        checksum_file(source, source_size, source_checksum),
+        "failed to checksum '" << source << "'",
+        result::failure
+    );
+    ABORT_IF(
+        source_size != header.source_size or source_checksum != header.source_checksum,
+        filename << ": stale, '" << source << "' changed since it was compiled",
+        result::failure
+    );
+
+    const auto * records = reinterpret_cast<const seqb::Record *>(file.data() + records_at);
+    const auto * offsets = reinterpret_cast<const std::uint32_t *>(file.data() + offsets_at);
+    const auto * chars = file.data() + chars_at;
+
+    // Intern the string table, the records are read in place.
+    std::vector<Symbol> symbols(header.num_strings);
+    for (std::uint32_t i = 0; i < header.num_strings; ++i)
+    {
+        ABORT_IF(
+            offsets[i] > offsets[i + 1] or offsets[i + 1] > header.strings_size,
+            filename << ": bad string table",
+            result::failure
+        );
+        symbols[i] = intern(std::string_view(chars + offsets[i], offsets[i + 1] - offsets[i]));
+    }
+
+    out.reserve(header.num_events);
+    for (std::uint32_t i = 0; i < header.num_events; ++i)
+    {
+        const auto & record = records[i];
+
+        ABORT_IF(
+            record.event_id >= header.num_strings or
+            record.camera_id >= header.num_strings or
+            record.text >= header.num_strings or
+            record.channel >= static_cast<std::uint32_t>(Channel::null),
+            filename << ": bad event " << i,
+            result::failure
+        );
+
+        out.push_back(
+            Event{
+                .event_id = symbols[record.event_id],
+                .camera_id = symbols[record.camera_id],
+                .event_time_offset_ms = record.event_time_offset_ms,
+                .channel = static_cast<Channel>(record.channel),
+                .value = ChannelValue{
+                    .num = record.num,
+                    .den = record.den,
+                    .text = symbols[record.text]
+                }
+            }
+        );
+    }
+
+    return result::success;
+}
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <common/types.h>
+#include <camera_control/Event.h>
+
+namespace pycontrol
+{
+
+
+//-----------------------------------------------------------------------------
+// Compiled .seqb sequence files.
+//
+// A .seq file compiles to a .seqb next to it holding the parsed events, so
+// loading a long sequence maps the file and reads the records in place rather
+// than parsing text.  Only the string table is interned on load.  The header
+// carries the size and checksum of the text it was compiled from, a .seqb that
+// doesn't match its .seq is stale and ignored.
+//
+// Layout, native byte order:
+//
+//     seqb::Header
+//     seqb::Record[num_events]
+//     std::uint32_t[num_strings + 1]  string offsets into the character data
+//     char[strings_size]              character data
+//
+namespace seqb
+{
+
+constexpr char MAGIC[8] = {'P', 'Y', 'S', 'E', 'Q', 'B', '\0', '\0'};
+
+// Bumped whenever the layout or the Channel numbering changes.
+constexpr std::uint32_t VERSION = 2;
+
+struct Header
+{
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t num_events;
+    std::uint32_t num_strings;
+    std::uint32_t strings_size;
+    std::uint64_t source_size;
+    std::uint64_t source_checksum;
+};
+
+struct Record
+{
+    std::int64_t  event_time_offset_ms;
+    std::uint32_t event_id;   // Index into the string table.
+    std::uint32_t camera_id;  // Index into the string table.
+    std::uint32_t channel;
+    std::int32_t  num;
+    std::int32_t  den;
+    std::uint32_t text;       // Index into the string table.
+};
+
+static_assert(sizeof(Header) == 40);
+static_assert(sizeof(Record) == 32);
+
+} /* namespace seqb */
+
+
+// 64 bit FNV-1a of a file's contents.
+result checksum_file(const std::string & filename, std::uint64_t & size, std::uint64_t & checksum);
+
+// Writes events compiled from the source text file.
+result write_sequence_binary(
+    const std::string & filename,
+    const std::string & source,
+    const std::vector<Event> & events);
+
+// Maps and reads a .seqb, failing if it's malformed or wasn't compiled from
+// the source's current contents.
+result read_sequence_binary(
+    const std::string & filename,
+    const std::string & source,
+    std::vector<Event> & out);
+
+
+} /* namespace pycontrol */
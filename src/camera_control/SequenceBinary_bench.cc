@@ -0,0 +1,95 @@
+// Load time of a .seq parsed as text against the same sequence compiled to a
+// .seqb and mapped, at 1k, 100k and 1M events.
+//
+//     make -C src/camera_control bench && src/camera_control/SequenceBinary_bench_bin
+
+#include <camera_control/CameraSequenceFileReader.h>
+#include <camera_control/SequenceBinary.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace pycontrol;
+
+using steady = std::chrono::steady_clock;
+
+
+void
+write_sequence(const std::string & filename, std::size_t num_events)
+{
+    static const char * lines[] = {
+        "z7.shutter_speed  1/2.5",
+        "z8.fstop          f/5.6",
+        "z7.iso            400",
+        "z8.quality        nef (raw)",
+        "z7.trigger        1",
+        "z8.fps            5.0",
+    };
+
+    std::ofstream fout(filename, std::ios::trunc);
+    for (std::size_t i = 0; i < num_events; ++i)
+    {
+        fout << "e" << (i / 100) << "  " << (i % 100) * 0.1 << "  " << lines[i % 6] << "\n";
+    }
+}
+
+
+template <typename Op>
+double
+time_ms(Op op)
+{
+    const auto start = steady::now();
+    op();
+    return std::chrono::duration<double, std::milli>(steady::now() - start).count();
+}
+
+
+int main()
+{
+    std::cout
+        << std::setw(10) << "events"
+        << std::setw(14) << "text ms"
+        << std::setw(14) << "seqb ms"
+        << std::setw(10) << "speedup"
+        << "\n";
+
+    for (const std::size_t num_events : {1'000, 100'000, 1'000'000})
+    {
+        const std::string source = "/tmp/SequenceBinary_bench.seq";
+        const std::string binary = source + "b";
+
+        std::remove(binary.c_str());
+        write_sequence(source, num_events);
+
+        CameraSequenceFileReader reader;
+        const auto text_ms = time_ms([&] { reader.read_file(source); });
+
+        if (write_sequence_binary(binary, source, reader.get_events()) != result::success)
+        {
+            return 1;
+        }
+
+        const auto seqb_ms = time_ms([&] { reader.read_file(source); });
+        if (not reader.from_binary() or reader.get_events().size() != num_events)
+        {
+            std::cerr << "failed to load " << binary << "\n";
+            return 1;
+        }
+
+        std::cout
+            << std::setw(10) << num_events
+            << std::setw(14) << std::fixed << std::setprecision(2) << text_ms
+            << std::setw(14) << seqb_ms
+            << std::setw(9) << std::setprecision(1) << text_ms / seqb_ms << "x"
+            << "\n";
+
+        std::remove(source.c_str());
+        std::remove(binary.c_str());
+    }
+
+    return 0;
+}
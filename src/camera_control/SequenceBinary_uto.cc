@@ -0,0 +1,149 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraSequenceFileReader.h>
+#include <camera_control/SequenceBinary.h>
+
+using namespace pycontrol;
+
+
+namespace
+{
+
+void
+write_file(const std::string & filename, const std::string & content)
+{
+    std::ofstream fout(filename, std::ios::binary | std::ios::trunc);
+    REQUIRE( fout.is_open() );
+    fout << content;
+}
+
+
+std::string
+read_whole_file(const std::string & filename)
+{
+    std::ifstream fin(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+}
+
+
+bool
+same_events(const std::vector<Event> & lhs, const std::vector<Event> & rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        const auto & a = lhs[i];
+        const auto & b = rhs[i];
+        if (a.event_id != b.event_id or
+            a.camera_id != b.camera_id or
+            a.event_time_offset_ms != b.event_time_offset_ms or
+            a.channel != b.channel or
+            a.value.num != b.value.num or
+            a.value.den != b.value.den or
+            a.value.text != b.value.text)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} /* namespace */
+
+
+TEST_CASE("SequenceBinary", "[seqb]")
+{
+    const std::string source = "seqb_uto.seq";
+    const std::string binary = source + "b";
+
+    write_file(source, R"(
+        c1    -10     z7.shutter_speed  1/2.5
+        c1     -5     z8.fstop          f/5.6
+        c2      0     z7.trigger        1
+        c2      0     z8.iso            400
+        c2    0.5     z8.quality        nef (raw)
+        c3      0     z7.fps            5.0
+        c3     10     z7.fps            stop
+    )");
+
+    CameraSequenceFileReader text;
+    REQUIRE( text.read_file(source) == result::success );
+    REQUIRE( not text.from_binary() );
+    REQUIRE( text.get_events().size() == 7 );
+
+    REQUIRE( write_sequence_binary(binary, source, text.get_events()) == result::success );
+
+    //-------------------------------------------------------------------------
+    // Round trip.
+    //
+    std::vector<Event> events;
+    REQUIRE( read_sequence_binary(binary, source, events) == result::success );
+    CHECK( same_events(events, text.get_events()) );
+    CHECK( events[0].value.num == 10 );
+    CHECK( events[0].value.den == 25 );
+    CHECK( to_string(events[4].value.text) == "nef (raw)" );
+
+    //-------------------------------------------------------------------------
+    // The reader prefers the current .seqb.
+    //
+    CameraSequenceFileReader reader;
+    REQUIRE( reader.read_file(source) == result::success );
+    CHECK( reader.from_binary() );
+    CHECK( same_events(reader.get_events(), text.get_events()) );
+    CHECK( reader.get_camera_ids() == text.get_camera_ids() );
+
+    //-------------------------------------------------------------------------
+    // Corrupt or truncated files are rejected.
+    //
+    const auto good = read_whole_file(binary);
+
+    auto bad = good;
+    bad[0] = 'X';
+    write_file(binary, bad);
+    CHECK( read_sequence_binary(binary, source, events) == result::failure );
+
+    write_file(binary, good.substr(0, good.size() - 1));
+    CHECK( read_sequence_binary(binary, source, events) == result::failure );
+
+    write_file(binary, good.substr(0, 10));
+    CHECK( read_sequence_binary(binary, source, events) == result::failure );
+
+    // A string index past the table.
+    bad = good;
+    const std::uint32_t index = 1000;
+    std::memcpy(&bad[sizeof(seqb::Header) + 8], &index, sizeof(index));
+    write_file(binary, bad);
+    CHECK( read_sequence_binary(binary, source, events) == result::failure );
+
+    // The reader falls back to the text.
+    REQUIRE( reader.read_file(source) == result::success );
+    CHECK( not reader.from_binary() );
+    CHECK( same_events(reader.get_events(), text.get_events()) );
+
+    //-------------------------------------------------------------------------
+    // Editing the text makes the .seqb stale.
+    //
+    write_file(binary, good);
+    REQUIRE( read_sequence_binary(binary, source, events) == result::success );
+
+    write_file(source, R"(
+        c1    -10     z7.shutter_speed  1/2.5
+    )");
+    CHECK( read_sequence_binary(binary, source, events) == result::failure );
+
+    REQUIRE( reader.read_file(source) == result::success );
+    CHECK( not reader.from_binary() );
+    CHECK( reader.get_events().size() == 1 );
+
+    std::remove(source.c_str());
+    std::remove(binary.c_str());
+}
@@ -0,0 +1,187 @@
+#include <pthread.h>
+
+#include <camera_control/CameraSequenceFileReader.h>
+#include <camera_control/SequenceLoader.h>
+
+#include <common/io.h>
+
+namespace pycontrol
+{
+
+
+SequenceLoader::
+~SequenceLoader()
+{
+    if (_thread.joinable())
+    {
+        _stop.store(true, std::memory_order_release);
+        _wake.release();
+        _thread.join();
+    }
+
+    delete _todo.exchange(nullptr);
+    delete _done.exchange(nullptr);
+    delete _garbage.exchange(nullptr);
+}
+
+
+void
+SequenceLoader::
+start_thread()
+{
+    if (_thread.joinable())
+    {
+        return;
+    }
+
+    _thread = std::thread(&SequenceLoader::_loop, this);
+    pthread_setname_np(_thread.native_handle(), "seq_loader");
+}
+
+
+result
+SequenceLoader::
+load(std::unique_ptr<SequenceLoad> && request)
+{
+    ABORT_IF(_busy, "a sequence is already loading", result::failure);
+
+    _busy = true;
+    _percent.store(0, std::memory_order_relaxed);
+
+    if (not _thread.joinable())
+    {
+        _run(*request);
+        _done.store(request.release(), std::memory_order_release);
+        return result::success;
+    }
+
+    _todo.store(request.release(), std::memory_order_release);
+    _wake.release();
+
+    return result::success;
+}
+
+
+std::unique_ptr<SequenceLoad>
+SequenceLoader::
+poll()
+{
+    if (not _busy)
+    {
+        return nullptr;
+    }
+
+    auto done = std::unique_ptr<SequenceLoad>(_done.exchange(nullptr, std::memory_order_acq_rel));
+    if (done)
+    {
+        _busy = false;
+    }
+
+    return done;
+}
+
+
+void
+SequenceLoader::
+recycle(std::unique_ptr<SequenceLoad> && load)
+{
+    if (not _thread.joinable())
+    {
+        return;
+    }
+
+    // The loader frees one at a time, the last one is freed here if it's
+    // still waiting.
+    delete _garbage.exchange(load.release(), std::memory_order_acq_rel);
+    _wake.release();
+}
+
+
+void
+SequenceLoader::
+_loop()
+{
+    while (true)
+    {
+        _wake.acquire();
+
+        delete _garbage.exchange(nullptr, std::memory_order_acq_rel);
+
+        if (_stop.load(std::memory_order_acquire))
+        {
+            break;
+        }
+
+        auto * job = _todo.exchange(nullptr, std::memory_order_acq_rel);
+        if (not job)
+        {
+            continue;
+        }
+
+        _run(*job);
+
+        _done.store(job, std::memory_order_release);
+    }
+}
+
+
+void
+SequenceLoader::
+_run(SequenceLoad & job)
+{
+    CameraSequenceFileReader reader;
+    if (result::failure == reader.read_file(job.filename, &_percent))
+    {
+        job.res = result::failure;
+        job.message = "failed to parse camera sequence file '" + job.filename + "'";
+        return;
+    }
+
+    const auto & events = reader.get_events();
+    for (const auto & id : reader.get_camera_ids())
+    {
+        auto seq = std::make_shared<CameraSequence>();
+        if (result::failure == seq->load(id, events))
+        {
+            job.res = result::failure;
+            job.message = "CameraSequence.load() failed";
+            return;
+        }
+        seq->compile(job.event_times);
+        job.sequences[id] = std::move(seq);
+    }
+
+    std::vector<EventTimeline::Lane> lanes;
+    for (const auto & [camera, id] : job.cameras)
+    {
+        const auto seq = job.sequences.find(id);
+        if (seq != job.sequences.end())
+        {
+            lanes.push_back(EventTimeline::Lane{camera, seq->second});
+        }
+    }
+    job.timeline.compile(std::move(lanes));
+
+    // Predict what the cameras can't keep up with, event ids without a time
+    // yet are simulated at 0 so the events around each are still checked.
+    if (job.models)
+    {
+        auto event_times = job.event_times;
+        for (const auto & event : events)
+        {
+            event_times.try_emplace(to_string(event.event_id), 0);
+        }
+
+        for (const auto & [id, seq] : job.sequences)
+        {
+            auto simulated = *seq;
+            simulated.compile(event_times);
+            job.predictions[id] = simulate_sequence(simulated, find_camera_model(*job.models, id));
+        }
+    }
+
+    _percent.store(100, std::memory_order_relaxed);
+}
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <common/types.h>
+
+#include <camera_control/CameraSequence.h>
+#include <camera_control/EventTimeline.h>
+#include <camera_control/SequenceSimulator.h>
+
+namespace pycontrol
+{
+
+class Camera;
+
+
+// A sequence file read, split per camera and compiled into a timeline, ready
+// to swap in for the one the control loop is running.  The control thread
+// fills in the request half, the loader fills in the result half.
+struct SequenceLoad
+{
+    using sequence_map = std::map<CamId, std::shared_ptr<CameraSequence>>;
+    using camera_ids = std::vector<std::pair<std::shared_ptr<Camera>, CamId>>;
+    using prediction_map = std::map<CamId, SequencePrediction>;
+
+    // Request.
+    std::uint32_t  cmd_id     {0};
+    std::string    filename   {};
+    event_time_map event_times {};
+
+    // The connected cameras with an id, in timeline lane order.  The cameras
+    // are only carried into the lanes, never touched off the control thread.
+    camera_ids     cameras    {};
+
+    // Bumped by the control thread each time the inputs above change, a load
+    // that finishes with a stale generation is recompiled after the swap.
+    std::uint64_t  generation {0};
+
+    // When set, each camera's sequence is simulated against its model.
+    std::shared_ptr<const camera_model_map> models {};
+
+    // Result.
+    result         res        {result::success};
+    std::string    message    {};
+    sequence_map   sequences  {};
+    EventTimeline  timeline   {};
+    prediction_map predictions {};
+};
+
+
+// Runs SequenceLoads one at a time so a long sequence file never stalls the
+// control loop.  Without a thread, load() runs the load before returning.
+//
+// load(), poll() and busy() must be called from the same thread, the control
+// thread.  A finished load is handed back with a single pointer swap.
+class SequenceLoader
+{
+public:
+
+    SequenceLoader() = default;
+    ~SequenceLoader();
+
+    // Loads from here on run on a background thread.
+    void start_thread();
+
+    // Fails if a load is already in progress.
+    result load(std::unique_ptr<SequenceLoad> && request);
+
+    // The finished load, or nullptr if it's still running.
+    std::unique_ptr<SequenceLoad> poll();
+
+    bool busy() const { return _busy; }
+
+    // Frees a finished load, holding the sequence it replaced, on the loader
+    // thread rather than the caller's.  Without a thread it's freed here.
+    void recycle(std::unique_ptr<SequenceLoad> && load);
+
+    // Progress of the load in progress, 0 to 100.
+    std::uint32_t percent() const { return _percent.load(std::memory_order_relaxed); }
+
+private:
+
+    SequenceLoader(const SequenceLoader & copy) = delete;
+    SequenceLoader & operator=(const SequenceLoader & rhs) = delete;
+
+    void _loop();
+    void _run(SequenceLoad & job);
+
+    std::atomic<SequenceLoad *> _todo {nullptr};
+    std::atomic<SequenceLoad *> _done {nullptr};
+    std::atomic<SequenceLoad *> _garbage {nullptr};
+    std::atomic<std::uint32_t>  _percent {0};
+    bool                        _busy {false};
+
+    std::counting_semaphore<>   _wake {0};
+    std::atomic<bool>           _stop {false};
+
+    std::thread                 _thread {};
+};
+
+
+} /* namespace pycontrol */
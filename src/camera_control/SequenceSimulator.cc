@@ -0,0 +1,307 @@
+#include <camera_control/SequenceSimulator.h>
+#include <camera_control/CameraSequence.h>
+
+#include <common/io.h>
+#include <common/str_utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace pycontrol
+{
+
+namespace
+{
+
+// "c2 -00:00:09.750" for a warning.
+std::string
+describe(const Event & event)
+{
+    return to_string(event.event_id) + " " + convert_milliseconds_to_hms(event.event_time_offset_ms);
+}
+
+} /* namespace */
+
+
+result
+read_camera_models(const std::string & filename, camera_model_map & out)
+{
+    out.clear();
+
+    std::ifstream fin(filename);
+    ABORT_IF_NOT(fin.is_open(), "error opening file '" << filename << "'", result::failure);
+
+    std::string line;
+    unsigned int line_number = 0;
+    while (std::getline(fin, line))
+    {
+        ++line_number;
+
+        const auto comment = line.find('#');
+        if (comment != std::string::npos)
+        {
+            line.resize(comment);
+        }
+
+        std::istringstream iss(line);
+        std::string camera;
+        std::string parameter;
+        double value = 0.0;
+
+        if (not (iss >> camera))
+        {
+            continue;
+        }
+
+        ABORT_IF_NOT(
+            (iss >> parameter >> value) and value >= 0.0,
+            filename << "(" << line_number << "): expecting 'camera parameter value'",
+            result::failure
+        );
+
+        auto & model = out[camera];
+
+        if (parameter == "trigger_latency")
+        {
+            model.trigger_latency_ms = static_cast<milliseconds>(value);
+        }
+        else if (parameter == "config_latency")
+        {
+            model.config_latency_ms = static_cast<milliseconds>(value);
+        }
+        else if (parameter == "buffer_depth")
+        {
+            model.buffer_depth = static_cast<std::uint32_t>(value);
+        }
+        else if (parameter == "write_fps")
+        {
+            std::string quality;
+            std::getline(iss, quality);
+            strip(quality, ' ');
+            std::transform(quality.begin(), quality.end(), quality.begin(), ::tolower);
+
+            if (quality.empty())
+            {
+                model.write_fps = value;
+            }
+            else
+            {
+                model.quality_write_fps[quality] = value;
+            }
+        }
+        else
+        {
+            ABORT_IF(
+                true,
+                filename << "(" << line_number << "): unknown parameter '" << parameter << "'",
+                result::failure
+            );
+        }
+    }
+
+    return result::success;
+}
+
+
+CameraModel
+find_camera_model(const camera_model_map & models, const CamId & id)
+{
+    auto itor = models.find(id);
+    if (itor == models.end())
+    {
+        itor = models.find("*");
+    }
+    if (itor == models.end())
+    {
+        return CameraModel{};
+    }
+
+    // Fill in what the camera leaves out from '*'.
+    auto model = itor->second;
+    const auto any = models.find("*");
+    if (any != models.end() and itor != any)
+    {
+        const auto & defaults = any->second;
+        if (model.trigger_latency_ms == 0) model.trigger_latency_ms = defaults.trigger_latency_ms;
+        if (model.config_latency_ms == 0) model.config_latency_ms = defaults.config_latency_ms;
+        if (model.buffer_depth == 0) model.buffer_depth = defaults.buffer_depth;
+        if (model.write_fps == 0.0) model.write_fps = defaults.write_fps;
+        model.quality_write_fps.insert(
+            defaults.quality_write_fps.begin(),
+            defaults.quality_write_fps.end()
+        );
+    }
+
+    return model;
+}
+
+
+SequencePrediction
+simulate_sequence(
+    const CameraSequence & sequence,
+    const CameraModel & model,
+    milliseconds tolerance_ms)
+{
+    SequencePrediction out;
+
+    // When the camera is free for the next USB request.
+    milliseconds busy = std::numeric_limits<milliseconds>::min();
+
+    // Frames waiting in the buffer as of drained_at, drained at write_fps.
+    double buffered = 0.0;
+    milliseconds drained_at = 0;
+    double write_fps = model.write_fps;
+
+    std::int32_t burst = 1;
+    milliseconds exposure_ms = 0;
+
+    auto drain = [&](milliseconds to)
+    {
+        if (write_fps > 0.0 and to > drained_at)
+        {
+            buffered = std::max(0.0, buffered - write_fps * (to - drained_at) / 1000.0);
+        }
+        drained_at = std::max(drained_at, to);
+    };
+
+    bool first = true;
+    for (std::size_t idx = 0; idx < sequence.size(); ++idx)
+    {
+        const auto time = sequence.time(idx);
+        if (time == MAX_TIME)
+        {
+            break;
+        }
+
+        const auto & event = sequence.event(idx);
+
+        if (first)
+        {
+            drained_at = time;
+            out.predicted_end = time;
+            first = false;
+        }
+
+        // Handled by the control loop, never sent to the camera.
+        if (event.channel == Channel::late_policy)
+        {
+            continue;
+        }
+
+        milliseconds start = 0;
+
+        if (event.channel == Channel::trigger)
+        {
+            // Sent early by the learned latency so the exposure lands on time.
+            start = busy == std::numeric_limits<milliseconds>::min() ?
+                    time :
+                    std::max(time, busy + model.trigger_latency_ms);
+
+            const auto frames = static_cast<std::uint32_t>(std::max(1, burst) * std::max(1, event.value.num));
+
+            // A full buffer holds the shutter until enough has been written.
+            drain(start);
+            if (model.buffer_depth > 0 and write_fps > 0.0 and
+                buffered + frames > model.buffer_depth)
+            {
+                const auto wait_ms = static_cast<milliseconds>(
+                    std::ceil((buffered + frames - model.buffer_depth) * 1000.0 / write_fps)
+                );
+                start += wait_ms;
+                drain(start);
+
+                if (out.saturations++ == 0)
+                {
+                    out.first_saturation_idx = idx;
+                }
+            }
+
+            if (model.buffer_depth > 0)
+            {
+                buffered += frames;
+            }
+
+            busy = start + exposure_ms;
+            out.triggers += 1;
+            out.frames += frames;
+
+            // Settings only matter as far as they hold up a trigger.
+            const auto drift = start - time;
+            if (drift > out.max_drift_ms)
+            {
+                out.max_drift_ms = drift;
+                out.max_drift_idx = idx;
+            }
+        }
+        else
+        {
+            start = busy == std::numeric_limits<milliseconds>::min() ?
+                    time :
+                    std::max(time, busy);
+            busy = start + model.config_latency_ms;
+
+            switch (event.channel)
+            {
+                case Channel::quality:
+                {
+                    // Frames already buffered drain at the old rate.
+                    drain(start);
+                    const auto rate = model.quality_write_fps.find(to_string(event.value.text));
+                    write_fps = rate != model.quality_write_fps.end() ? rate->second : model.write_fps;
+                    break;
+                }
+                case Channel::shutter_speed:
+                {
+                    exposure_ms = event.value.den > 0 ? 1000LL * event.value.num / event.value.den : 0;
+                    break;
+                }
+                case Channel::burst_number:
+                {
+                    burst = event.value.num;
+                    break;
+                }
+                default:
+                {
+                    break;
+                }
+            }
+        }
+
+        out.scheduled_end = time;
+        out.predicted_end = std::max(out.predicted_end, busy);
+    }
+
+    // The rest of the buffer goes to the card after the last event.
+    drain(out.predicted_end);
+    out.card_done = out.predicted_end;
+    if (buffered > 0.0 and write_fps > 0.0)
+    {
+        out.card_done += static_cast<milliseconds>(std::ceil(buffered * 1000.0 / write_fps));
+    }
+
+    //-------------------------------------------------------------------------
+    // Warnings.
+    //
+    if (out.max_drift_ms > tolerance_ms)
+    {
+        std::ostringstream oss;
+        oss << "falls behind by up to " << out.max_drift_ms << " ms, at "
+            << describe(sequence.event(out.max_drift_idx));
+        out.warnings.push_back(oss.str());
+    }
+
+    if (out.saturations > 0)
+    {
+        std::ostringstream oss;
+        oss << "buffer full for " << out.saturations << " of " << out.triggers
+            << " triggers, first at " << describe(sequence.event(out.first_saturation_idx));
+        out.warnings.push_back(oss.str());
+    }
+
+    return out;
+}
+
+
+} /* namespace pycontrol */
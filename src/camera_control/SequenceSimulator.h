@@ -0,0 +1,83 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <common/types.h>
+
+namespace pycontrol
+{
+
+class CameraSequence;
+
+
+//-----------------------------------------------------------------------------
+// How fast a camera can actually work through a sequence.
+//
+// Read from a camera models file, one parameter per line:
+//
+//     # camera  parameter        value  [quality]
+//     *         trigger_latency  40     # ms from trigger call to exposure
+//     z7        config_latency   120    # ms to write one setting
+//     z7        buffer_depth     23     # frames the camera buffers
+//     z7        write_fps        2.33   # frames/s drained to the card
+//     z7        write_fps        1.8    nef (raw)
+//
+// A camera without its own parameter uses the one for '*'.  A zero buffer
+// depth or write rate is unlimited.
+//
+struct CameraModel
+{
+    milliseconds trigger_latency_ms {0};
+    milliseconds config_latency_ms {0};
+    std::uint32_t buffer_depth {0};
+    double write_fps {0.0};
+
+    // Write rate by the quality channel value, lowercase.
+    std::map<std::string, double> quality_write_fps {};
+};
+
+using camera_model_map = std::map<CamId, CameraModel>;
+
+result read_camera_models(const std::string & filename, camera_model_map & out);
+
+// The camera's model, falling back to '*' and then to an ideal camera.
+CameraModel find_camera_model(const camera_model_map & models, const CamId & id);
+
+
+//-----------------------------------------------------------------------------
+// What a camera's sequence looks like when run against its model.  Times are
+// UTC milliseconds as compiled into the sequence.
+//
+struct SequencePrediction
+{
+    std::uint32_t triggers {0};
+    std::uint32_t frames {0};
+
+    // Latest a trigger fires after its scheduled time, and which one.
+    milliseconds max_drift_ms {0};
+    std::size_t max_drift_idx {0};
+
+    // Triggers that had to wait for room in the buffer.
+    std::uint32_t saturations {0};
+    std::size_t first_saturation_idx {0};
+
+    milliseconds scheduled_end {0};  // The last event's time.
+    milliseconds predicted_end {0};  // When the camera is done with the last event.
+    milliseconds card_done {0};      // When the last frame is on the card.
+
+    std::vector<std::string> warnings {};
+};
+
+// Steps through the compiled sequence's timed events in order.  Triggers go
+// out trigger_latency early, as the control loop sends them, but never before
+// the camera is free and has room in its buffer.  Warnings are added when an
+// event runs more than tolerance_ms late or the buffer fills.
+SequencePrediction simulate_sequence(
+    const CameraSequence & sequence,
+    const CameraModel & model,
+    milliseconds tolerance_ms = 100);
+
+
+} /* namespace pycontrol */
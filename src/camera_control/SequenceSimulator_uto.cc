@@ -0,0 +1,215 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraSequence.h>
+#include <camera_control/SequenceSimulator.h>
+
+using namespace pycontrol;
+
+
+namespace
+{
+
+// Sequence for z7 with every event id at time 0.
+CameraSequence
+compile(const std::string & content)
+{
+    const std::string filename = "simulator_uto.seq";
+    {
+        std::ofstream fout(filename);
+        fout << content;
+    }
+
+    CameraSequenceFileReader reader;
+    REQUIRE( reader.read_file(filename) == result::success );
+    std::remove(filename.c_str());
+
+    CameraSequence sequence;
+    REQUIRE( sequence.load("z7", reader.get_events()) == result::success );
+    sequence.compile({{"c2", 0}});
+
+    return sequence;
+}
+
+} /* namespace */
+
+
+TEST_CASE("read_camera_models", "[SequenceSimulator]")
+{
+    const std::string filename = "camera_models_uto.config";
+    {
+        std::ofstream fout(filename);
+        fout << R"(
+            # camera  parameter  value
+            *   config_latency   100
+            *   write_fps        9.0     jpeg fine
+            z7  trigger_latency  430     # 2.33 FPS
+            z7  buffer_depth     23
+            z7  write_fps        3.5
+            z7  write_fps        1.5     NEF (Raw)
+        )";
+    }
+
+    camera_model_map models;
+    REQUIRE( read_camera_models(filename, models) == result::success );
+    REQUIRE( models.size() == 2 );
+
+    const auto z7 = find_camera_model(models, "z7");
+    CHECK( z7.trigger_latency_ms == 430 );
+    CHECK( z7.config_latency_ms == 100 );
+    CHECK( z7.buffer_depth == 23 );
+    CHECK( z7.write_fps == 3.5 );
+    CHECK( z7.quality_write_fps.at("nef (raw)") == 1.5 );
+    CHECK( z7.quality_write_fps.at("jpeg fine") == 9.0 );
+
+    const auto z8 = find_camera_model(models, "z8");
+    CHECK( z8.trigger_latency_ms == 0 );
+    CHECK( z8.config_latency_ms == 100 );
+
+    CHECK( find_camera_model({}, "z7").trigger_latency_ms == 0 );
+
+    {
+        std::ofstream fout(filename);
+        fout << "z7 shutter_lag 10\n";
+    }
+    CHECK( read_camera_models(filename, models) == result::failure );
+
+    {
+        std::ofstream fout(filename);
+        fout << "z7 trigger_latency\n";
+    }
+    CHECK( read_camera_models(filename, models) == result::failure );
+
+    std::remove(filename.c_str());
+}
+
+
+TEST_CASE("simulate_sequence", "[SequenceSimulator]")
+{
+    //-------------------------------------------------------------------------
+    // An ideal camera keeps up with anything.
+    //
+    auto sequence = compile(R"(
+        c2  -2.0  z7.shutter_speed  1/500
+        c2  -1.0  z7.trigger        1
+        c2  -0.9  z7.trigger        1
+        c2  -0.8  z7.trigger        1
+    )");
+
+    auto prediction = simulate_sequence(sequence, CameraModel{});
+    CHECK( prediction.triggers == 3 );
+    CHECK( prediction.frames == 3 );
+    CHECK( prediction.max_drift_ms == 0 );
+    CHECK( prediction.saturations == 0 );
+    CHECK( prediction.scheduled_end == -800 );
+    CHECK( prediction.predicted_end == -798 );
+    CHECK( prediction.card_done == -798 );
+    CHECK( prediction.warnings.empty() );
+
+    //-------------------------------------------------------------------------
+    // Triggers faster than the camera drift further behind each time.
+    //
+    CameraModel model;
+    model.trigger_latency_ms = 250;
+
+    prediction = simulate_sequence(sequence, model);
+    CHECK( prediction.max_drift_ms == 2 * (252 - 100) );
+    CHECK( prediction.max_drift_idx == 3 );
+    CHECK( prediction.predicted_end == -1000 + 2 * 252 + 2 );
+    REQUIRE( prediction.warnings.size() == 1 );
+    CHECK( prediction.warnings[0] == "falls behind by up to 304 ms, at c2 -00:00:00.800" );
+
+    // Within tolerance.
+    prediction = simulate_sequence(sequence, model, 500);
+    CHECK( prediction.max_drift_ms == 304 );
+    CHECK( prediction.warnings.empty() );
+
+    //-------------------------------------------------------------------------
+    // Writing settings holds up the trigger behind them.
+    //
+    sequence = compile(R"(
+        c2  -1.0  z7.iso      400
+        c2  -1.0  z7.fstop    f/8
+        c2  -1.0  z7.trigger  1
+    )");
+    model = CameraModel{};
+    model.config_latency_ms = 150;
+
+    prediction = simulate_sequence(sequence, model);
+    CHECK( prediction.max_drift_ms == 300 );
+    CHECK( prediction.max_drift_idx == 2 );
+
+    //-------------------------------------------------------------------------
+    // Bursts fill the buffer, the shutter waits for the card to catch up and
+    // the card finishes after the last trigger.
+    //
+    sequence = compile(R"(
+        c2  -10.0  z7.quality       nef (raw)
+        c2  -10.0  z7.burst_number  5
+        c2   -9.0  z7.trigger       1
+        c2   -8.0  z7.trigger       1
+        c2   -7.0  z7.trigger       1
+        c2   -6.0  z7.trigger       1
+    )");
+    model = CameraModel{};
+    model.buffer_depth = 12;
+    model.write_fps = 10.0;
+    model.quality_write_fps["nef (raw)"] = 2.0;
+
+    prediction = simulate_sequence(sequence, model);
+    CHECK( prediction.triggers == 4 );
+    CHECK( prediction.frames == 20 );
+
+    // 9 frames still buffered at the fourth trigger, it waits a second for
+    // 2 of them to be written.
+    CHECK( prediction.saturations == 1 );
+    CHECK( prediction.first_saturation_idx == 5 );
+    CHECK( prediction.max_drift_ms == 1'000 );
+    CHECK( prediction.predicted_end == -5'000 );
+    CHECK( prediction.card_done == -5'000 + 6'000 );
+    REQUIRE( prediction.warnings.size() == 2 );
+    CHECK( prediction.warnings[1] == "buffer full for 1 of 4 triggers, first at c2 -00:00:06.000" );
+
+    // JPEGs write fast enough.
+    sequence = compile(R"(
+        c2  -10.0  z7.quality       jpeg fine
+        c2  -10.0  z7.burst_number  5
+        c2   -9.0  z7.trigger       1
+        c2   -8.0  z7.trigger       1
+        c2   -7.0  z7.trigger       1
+        c2   -6.0  z7.trigger       1
+    )");
+    prediction = simulate_sequence(sequence, model);
+    CHECK( prediction.saturations == 0 );
+    CHECK( prediction.warnings.empty() );
+}
+
+
+TEST_CASE("simulate_sequence speed", "[SequenceSimulator]")
+{
+    // A few minutes of 4 FPS, well past any sequence in sequences/.
+    std::ostringstream content;
+    content << "c2 -1000 z7.quality nef (raw)\n";
+    for (int i = 0; i < 4000; ++i)
+    {
+        content << "c2 " << -1000 + i * 0.25 << " z7.trigger 1\n";
+    }
+    const auto sequence = compile(content.str());
+
+    CameraModel model;
+    model.trigger_latency_ms = 215;
+    model.buffer_depth = 79;
+    model.write_fps = 3.0;
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto prediction = simulate_sequence(sequence, model);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    CHECK( prediction.triggers == 4000 );
+    CHECK( prediction.saturations > 0 );
+    CHECK( elapsed < std::chrono::milliseconds(50) );
+}
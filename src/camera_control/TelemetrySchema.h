@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace pycontrol
+{
+
+//-----------------------------------------------------------------------------
+// The keys binary telemetry refers to by index, see BinaryWriter.h.  Keys are
+// only ever appended, bumping TELEMETRY_VERSION, and webapp/telem_binary.py
+// keeps the same list.  Keys not listed still work, spelled out in full.
+//
+inline constexpr std::uint16_t TELEMETRY_VERSION = 3;
+
+inline constexpr std::string_view TELEMETRY_KEYS[] = {
+    "seq",
+    "state",
+    "time",
+    "clock",
+    "utc_offset_ms",
+    "steps",
+    "last_step_ms",
+    "command_response",
+    "detected_cameras",
+    "connected",
+    "serial",
+    "port",
+    "desc",
+    "mode",
+    "shutter",
+    "fstop",
+    "iso",
+    "quality",
+    "batt",
+    "num_photos",
+    "usb_pending",
+    "num_avail",
+    "burst_number",
+    "fire_offset_us",
+    "trigger_lateness_us",
+    "count",
+    "min",
+    "p50",
+    "p99",
+    "max",
+    "poll_usb_us",
+    "full",
+    "total",
+    "trigger_latency",
+    "us",
+    "dev_us",
+    "samples",
+    "file_added_us",
+    "calibrating",
+    "late_policy",
+    "late_ms",
+    "compressing",
+    "fired",
+    "late",
+    "skipped",
+    "compressed",
+    "trigger_skew",
+    "groups",
+    "cameras",
+    "skew_us",
+    "max_skew_us",
+    "timeouts",
+    "camera_open",
+    "ms",
+    "ready_ms",
+    "events",
+    "sequence",
+    "sequence_state",
+    "num_events",
+    "id",
+    "warnings",
+    "pos",
+    "event_id",
+    "event_time_offset",
+    "eta",
+    "channel",
+    "value",
+    "timelapse",
+    "histogram",
+    "interval",
+    "min_shutter",
+    "max_shutter",
+    "min_iso",
+    "max_iso",
+    "min_hist_mask",
+    "max_hist_mask",
+    "min_deadband",
+    "max_deadband",
+    "current_bin",
+    "target_bin",
+    "target_offset",
+    "target_percent",
+    "target_error",
+    "num_captures",
+    "pixel_count",
+    "command_queue_us",
+    "last_accepted_id",
+    "last_rejected_id",
+    "message",
+    "loading",
+    "percent",
+    "data",
+};
+
+} /* namespace pycontrol */
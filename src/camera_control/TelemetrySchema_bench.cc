@@ -0,0 +1,48 @@
+// Encode time, bytes and allocations per message of a telemetry sized message
+// as JSON and as binary telemetry.  Given a directory, also writes one of each
+// there for timing the webapp's decoding:
+//
+//     make -C src/camera_control bench
+//     src/camera_control/TelemetrySchema_bench_bin /tmp
+//     python3 -m webapp.bench_telem_decode /tmp/telemetry.json /tmp/telemetry.bin
+
+#include <camera_control/TelemetrySchema.h>
+#include <common/BinaryWriter.h>
+#include <common/JsonWriter.h>
+#include <common/telemetry_bench.h>
+
+#include <filesystem>
+#include <fstream>
+
+
+int main(int argc, char ** argv)
+{
+    constexpr std::size_t count = 100'000;
+
+    const auto fixture = make_fixture();
+
+    JsonWriter json;
+    report("JsonWriter", count, [&]()
+    {
+        write_telemetry(json, fixture);
+        return json.size();
+    });
+
+    BinaryWriter binary(TELEMETRY_KEYS, TELEMETRY_VERSION);
+    report("BinaryWriter", count, [&]()
+    {
+        write_telemetry(binary, fixture);
+        return binary.size();
+    });
+
+    if (argc > 1)
+    {
+        const std::filesystem::path dir = argv[1];
+        std::ofstream(dir / "telemetry.json", std::ios::binary) << json.view();
+        std::ofstream(dir / "telemetry.bin", std::ios::binary) << binary.view();
+        std::cout << "wrote " << (dir / "telemetry.json").string() << " and "
+                  << (dir / "telemetry.bin").string() << std::endl;
+    }
+
+    return 0;
+}
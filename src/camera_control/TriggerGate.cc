@@ -0,0 +1,166 @@
+#include <camera_control/TriggerGate.h>
+
+#include <thread>
+
+namespace pycontrol
+{
+
+
+void
+TriggerGate::
+join()
+{
+    _joined.fetch_add(1, std::memory_order_acq_rel);
+}
+
+
+void
+TriggerGate::
+close()
+{
+    _closed.store(true, std::memory_order_release);
+    _notify();
+}
+
+
+void
+TriggerGate::
+expire()
+{
+    if (_open() or _timed_out.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    const auto now_ns = std::chrono::steady_clock::now().time_since_epoch().count();
+    if (now_ns < _deadline_ns.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    _timed_out.store(true, std::memory_order_release);
+    _notify();
+}
+
+
+bool
+TriggerGate::
+_open() const
+{
+    return _closed.load(std::memory_order_acquire) and
+           _arrived.load(std::memory_order_acquire) >= _joined.load(std::memory_order_acquire);
+}
+
+
+void
+TriggerGate::
+reset()
+{
+    _joined.store(0, std::memory_order_relaxed);
+    _arrived.store(0, std::memory_order_relaxed);
+    _fired.store(0, std::memory_order_relaxed);
+    _closed.store(false, std::memory_order_relaxed);
+    _timed_out.store(false, std::memory_order_relaxed);
+    _deadline_ns.store(INT64_MAX, std::memory_order_relaxed);
+    _first_ns.store(INT64_MAX, std::memory_order_relaxed);
+    _last_ns.store(INT64_MIN, std::memory_order_release);
+}
+
+
+void
+TriggerGate::
+_notify()
+{
+    _epoch.fetch_add(1, std::memory_order_acq_rel);
+    _epoch.notify_all();
+}
+
+
+bool
+TriggerGate::
+arrive_and_wait(std::chrono::nanoseconds timeout)
+{
+    // The earliest deadline of the waiting workers is the one expire() keeps.
+    const auto now = std::chrono::steady_clock::now();
+    const std::int64_t deadline_ns = (now + timeout).time_since_epoch().count();
+    auto current = _deadline_ns.load(std::memory_order_relaxed);
+    while (deadline_ns < current and
+           not _deadline_ns.compare_exchange_weak(current, deadline_ns, std::memory_order_acq_rel))
+    {
+    }
+
+    _arrived.fetch_add(1, std::memory_order_acq_rel);
+    _notify();
+
+    // Spin first, the release has to reach every waiting worker well within a
+    // millisecond.  Yielding keeps the spin from starving the workers still on
+    // their way to the gate.
+    const auto spin_until = now + SPIN;
+    while (not _open())
+    {
+        if (std::chrono::steady_clock::now() >= spin_until)
+        {
+            break;
+        }
+        std::this_thread::yield();
+    }
+
+    // Then sleep, woken by every arrival, the close and the timeout.
+    while (true)
+    {
+        const auto epoch = _epoch.load(std::memory_order_acquire);
+        if (_open())
+        {
+            return true;
+        }
+        if (_timed_out.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        _epoch.wait(epoch, std::memory_order_acquire);
+    }
+}
+
+
+void
+TriggerGate::
+fired(std::int64_t fire_ns)
+{
+    auto first = _first_ns.load(std::memory_order_relaxed);
+    while (fire_ns < first and
+           not _first_ns.compare_exchange_weak(first, fire_ns, std::memory_order_acq_rel))
+    {
+    }
+
+    auto last = _last_ns.load(std::memory_order_relaxed);
+    while (fire_ns > last and
+           not _last_ns.compare_exchange_weak(last, fire_ns, std::memory_order_acq_rel))
+    {
+    }
+
+    _fired.fetch_add(1, std::memory_order_acq_rel);
+}
+
+
+bool
+TriggerGate::
+complete() const
+{
+    return _closed.load(std::memory_order_acquire) and
+           _fired.load(std::memory_order_acquire) >= _joined.load(std::memory_order_acquire);
+}
+
+
+std::int64_t
+TriggerGate::
+skew_ns() const
+{
+    if (not complete() or _fired.load(std::memory_order_acquire) == 0)
+    {
+        return 0;
+    }
+    return _last_ns.load(std::memory_order_acquire) - _first_ns.load(std::memory_order_acquire);
+}
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace pycontrol
+{
+
+
+// Start barrier for a group of camera triggers due at the same instant.
+//
+// The control thread join()s once for every trigger it queues to a camera
+// worker and close()s the gate once all of them are queued.  Each worker
+// calls arrive_and_wait() right before sending its trigger, so the first
+// camera to get there waits for the slowest instead of firing one USB round
+// trip ahead of it.  Workers then record their fire time with fired().
+//
+// Only atomics are used, the control thread never blocks on the gate.  A
+// waiting worker spins briefly and then sleeps on the atomic, the control
+// thread's expire() wakes it once the timeout has passed.
+class TriggerGate
+{
+public:
+
+    // How long an early camera waits for the rest before firing anyway.
+    static constexpr std::chrono::milliseconds TIMEOUT {200};
+
+    // Control thread.
+    void join();
+    void close();
+
+    // Releases the waiting workers once the earliest of their timeouts has
+    // passed, called every control tick.
+    void expire();
+
+    // Makes the gate ready for a new group, only once no worker holds it.
+    void reset();
+
+    // Worker threads, returns false if the gate timed out.
+    bool arrive_and_wait(std::chrono::nanoseconds timeout = TIMEOUT);
+    void fired(std::int64_t fire_ns);
+
+    // Number of cameras in the group.
+    std::uint32_t size() const { return _joined.load(std::memory_order_acquire); }
+
+    // True once every camera in the group has fired.
+    bool complete() const;
+
+    bool timed_out() const { return _timed_out.load(std::memory_order_acquire); }
+
+    // Earliest fire time and the spread between the first and last camera,
+    // valid once complete().
+    std::int64_t first_fire_ns() const { return _first_ns.load(std::memory_order_acquire); }
+    std::int64_t skew_ns() const;
+
+private:
+
+    // How long an arriving worker spins before sleeping, most gates open
+    // within microseconds of the last camera arriving.
+    static constexpr std::chrono::microseconds SPIN {50};
+
+    bool _open() const;
+
+    // Wakes the sleeping workers to check the gate again.
+    void _notify();
+
+    std::atomic<std::uint32_t> _joined {0};
+    std::atomic<std::uint32_t> _arrived {0};
+    std::atomic<std::uint32_t> _fired {0};
+    std::atomic<bool>          _closed {false};
+    std::atomic<bool>          _timed_out {false};
+    std::atomic<std::uint32_t> _epoch {0};
+    std::atomic<std::int64_t>  _deadline_ns {INT64_MAX};
+    std::atomic<std::int64_t>  _first_ns {INT64_MAX};
+    std::atomic<std::int64_t>  _last_ns {INT64_MIN};
+};
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,117 @@
+#include <camera_control/TriggerLatency.h>
+
+#include <common/io.h>
+#include <common/str_utils.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+namespace pycontrol
+{
+
+
+void
+TriggerLatency::
+add(nanoseconds sample)
+{
+    // A running mean for the first few samples, then an exponential average
+    // so the estimate follows slow drift, e.g. a warming body.
+    constexpr nanoseconds max_weight = 16;
+
+    ++samples;
+    const auto weight = std::min<nanoseconds>(samples, max_weight);
+    const auto error = sample - estimate_ns;
+
+    estimate_ns += error / weight;
+    deviation_ns += (std::abs(error) - deviation_ns) / weight;
+
+    if (samples == 1)
+    {
+        deviation_ns = 0;
+    }
+}
+
+
+result
+read_trigger_latencies(const std::string & filename, trigger_latency_map & out)
+{
+    out.clear();
+
+    std::ifstream fin(filename);
+
+    ABORT_IF_NOT(fin.is_open(), "error opening file '" << filename << "'", result::failure);
+
+    std::string line;
+    while (std::getline(fin, line))
+    {
+        auto tokens = split(line);
+
+        if (tokens.empty() or tokens[0][0] == '#')
+        {
+            continue;
+        }
+
+        ABORT_IF(
+            tokens.size() != 5,
+            filename << ": expecting 'serial estimate_us deviation_us samples file_added_us', got '" << line << "'",
+            result::failure
+        );
+
+        TriggerLatency latency;
+        nanoseconds estimate_us = 0;
+        nanoseconds deviation_us = 0;
+        nanoseconds file_added_us = 0;
+
+        ABORT_ON_FAILURE(as_type(tokens[1], estimate_us), "bad estimate_us", result::failure);
+        ABORT_ON_FAILURE(as_type(tokens[2], deviation_us), "bad deviation_us", result::failure);
+        ABORT_ON_FAILURE(as_type(tokens[3], latency.samples), "bad samples", result::failure);
+        ABORT_ON_FAILURE(as_type(tokens[4], file_added_us), "bad file_added_us", result::failure);
+
+        latency.estimate_ns = estimate_us * 1000;
+        latency.deviation_ns = deviation_us * 1000;
+        latency.file_added_ns = file_added_us * 1000;
+
+        out[tokens[0]] = latency;
+    }
+
+    return result::success;
+}
+
+
+result
+write_trigger_latencies(const std::string & filename, const trigger_latency_map & in)
+{
+    // Write a temporary and rename it over the original so a crash never
+    // leaves a half written file.
+    const auto temp = filename + ".tmp";
+    {
+        std::ofstream fout(temp);
+
+        ABORT_IF_NOT(fout.is_open(), "error opening file '" << temp << "'", result::failure);
+
+        fout << "# serial  estimate_us  deviation_us  samples  file_added_us\n";
+        for (const auto & [serial, latency] : in)
+        {
+            fout << serial << "  "
+                 << latency.estimate_ns / 1000 << "  "
+                 << latency.deviation_ns / 1000 << "  "
+                 << latency.samples << "  "
+                 << latency.file_added_ns / 1000 << "\n";
+        }
+
+        ABORT_IF_NOT(fout.good(), "error writing file '" << temp << "'", result::failure);
+    }
+
+    ABORT_IF(
+        std::rename(temp.c_str(), filename.c_str()) != 0,
+        "error renaming '" << temp << "' to '" << filename << "'",
+        result::failure
+    );
+
+    return result::success;
+}
+
+
+} /* namespace pycontrol */
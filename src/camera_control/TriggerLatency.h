@@ -0,0 +1,44 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <common/types.h>
+
+namespace pycontrol
+{
+
+
+// Learned delay between asking a camera to trigger and its shutter opening.
+//
+// Each sample is the time gp_camera_trigger_capture() took to return, the
+// camera acknowledges the capture as the shutter is released.  Calibration
+// shots also time the GP_EVENT_FILE_ADDED that follows, reported as an upper
+// bound.  The scheduler issues triggers lead_ns() early so exposures land on
+// the scripted time.
+struct TriggerLatency
+{
+    // Samples needed before the estimate is used.
+    static constexpr std::uint32_t MIN_SAMPLES = 3;
+
+    nanoseconds   estimate_ns   {0};
+    nanoseconds   deviation_ns  {0};
+    std::uint32_t samples       {0};
+    nanoseconds   file_added_ns {0};
+
+    void add(nanoseconds sample);
+    void reset() { *this = TriggerLatency(); }
+
+    nanoseconds lead_ns() const { return samples >= MIN_SAMPLES ? estimate_ns : 0; }
+};
+
+
+using trigger_latency_map = std::map<Serial, TriggerLatency>;
+
+
+// One camera per line: serial estimate_us deviation_us samples file_added_us
+result read_trigger_latencies(const std::string & filename, trigger_latency_map & out);
+result write_trigger_latencies(const std::string & filename, const trigger_latency_map & in);
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,99 @@
+#include <filesystem>
+#include <fstream>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <camera_control/CameraControl_uto.h>
+#include <camera_control/TriggerLatency.h>
+
+using namespace pycontrol;
+
+
+TEST_CASE("TriggerLatency", "[TriggerLatency]")
+{
+    TriggerLatency latency;
+
+    CHECK( latency.samples == 0 );
+    CHECK( latency.lead_ns() == 0 );
+
+    //-------------------------------------------------------------------------
+    // A running mean until there are enough samples to trust.
+    //
+    latency.add(10'000'000);
+    latency.add(20'000'000);
+
+    CHECK( latency.samples == 2 );
+    CHECK( latency.estimate_ns == 15'000'000 );
+    CHECK( latency.deviation_ns == 5'000'000 );
+    CHECK( latency.lead_ns() == 0 );
+
+    latency.add(15'000'000);
+
+    CHECK( latency.samples == 3 );
+    CHECK( latency.estimate_ns == 15'000'000 );
+    CHECK( latency.deviation_ns == 3'333'334 );
+    CHECK( latency.lead_ns() == 15'000'000 );
+
+    //-------------------------------------------------------------------------
+    // Then an exponential average that only moves a sixteenth of the error.
+    //
+    while (latency.samples < 16)
+    {
+        latency.add(15'000'000);
+    }
+    CHECK( latency.estimate_ns == 15'000'000 );
+
+    latency.add(31'000'000);
+
+    CHECK( latency.samples == 17 );
+    CHECK( latency.estimate_ns == 16'000'000 );
+    CHECK( latency.lead_ns() == 16'000'000 );
+
+    latency.reset();
+
+    CHECK( latency.samples == 0 );
+    CHECK( latency.estimate_ns == 0 );
+    CHECK( latency.lead_ns() == 0 );
+}
+
+
+TEST_CASE("TriggerLatency: read and write", "[TriggerLatency]")
+{
+    const auto file = TempFile("trigger_latency.config");
+    const auto filename = file.path.string();
+
+    trigger_latency_map out;
+    out["1234"] = TriggerLatency{
+        .estimate_ns = 42'000'000,
+        .deviation_ns = 1'500'000,
+        .samples = 20,
+        .file_added_ns = 650'000'000
+    };
+    out["5678"] = TriggerLatency{.estimate_ns = 7'000, .samples = 1};
+
+    REQUIRE( write_trigger_latencies(filename, out) == result::success );
+
+    trigger_latency_map in;
+    REQUIRE( read_trigger_latencies(filename, in) == result::success );
+
+    REQUIRE( in.size() == 2 );
+    CHECK( in["1234"].estimate_ns == 42'000'000 );
+    CHECK( in["1234"].deviation_ns == 1'500'000 );
+    CHECK( in["1234"].samples == 20 );
+    CHECK( in["1234"].file_added_ns == 650'000'000 );
+    CHECK( in["5678"].estimate_ns == 7'000 );
+    CHECK( in["5678"].samples == 1 );
+
+    //-------------------------------------------------------------------------
+    // Malformed lines are an error.
+    //
+    {
+        std::ofstream fout(filename);
+        fout << "# serial  estimate_us  deviation_us  samples  file_added_us\n"
+             << "1234  42000  1500\n";
+    }
+    CHECK( read_trigger_latencies(filename, in) == result::failure );
+
+    std::filesystem::remove(filename);
+    CHECK( read_trigger_latencies(filename, in) == result::failure );
+}
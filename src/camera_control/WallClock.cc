@@ -4,6 +4,9 @@
 #include <ctime>
 #include <iomanip>
 
+#include <errno.h>
+#include <time.h>
+
 
 namespace pycontrol
 {
@@ -17,6 +20,55 @@ WallClock::now()
 }
 
 
+namespace
+{
+
+nanoseconds
+read_ns(clockid_t clock_id)
+{
+    struct timespec ts;
+    clock_gettime(clock_id, &ts);
+    return static_cast<nanoseconds>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+}
+
+
+nanoseconds
+WallClock::monotonic_ns()
+{
+    return read_ns(CLOCK_MONOTONIC);
+}
+
+
+nanoseconds
+WallClock::utc_offset_ns()
+{
+    // Bracket the UTC read with two monotonic reads and pair it with their
+    // midpoint.
+    const auto mono0 = read_ns(CLOCK_MONOTONIC);
+    const auto utc = read_ns(CLOCK_REALTIME);
+    const auto mono1 = read_ns(CLOCK_MONOTONIC);
+
+    return utc - (mono0 + (mono1 - mono0) / 2);
+}
+
+
+void
+WallClock::sleep_until_ns(nanoseconds deadline)
+{
+    // An absolute deadline, so a signal interrupting the sleep doesn't add
+    // drift when it is restarted.
+    struct timespec ts;
+    ts.tv_sec = deadline / 1'000'000'000;
+    ts.tv_nsec = deadline % 1'000'000'000;
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+    {
+    }
+}
+
+
 std::string
 format_iso8601_utc(pycontrol::milliseconds ms_since_epoch)
 {
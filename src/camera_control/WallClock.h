@@ -10,6 +10,9 @@ class WallClock : public interface::WallClock
 public:
 
     milliseconds now() override;
+    nanoseconds monotonic_ns() override;
+    nanoseconds utc_offset_ns() override;
+    void sleep_until_ns(nanoseconds deadline) override;
 };
 
 
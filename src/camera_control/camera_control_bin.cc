@@ -1,6 +1,8 @@
 #include <camera_control/CameraControl.h>
 #include <camera_control/GPhoto2Cpp.h>
+#include <camera_control/HotPlug.h>
 #include <camera_control/WallClock.h>
+#include <common/ShmTelemetry.h>
 #include <common/UdpSocket.h>
 #include <common/str_utils.h>
 
@@ -57,6 +59,17 @@ protected:
 //     telem_port        10018          # Writes telemetry messages on this port.
 //     period            50             # 20 Hz or 50 ms dispatch period.
 //     camera_aliases    filename       # A file to persistently map camera serial numbers to short names.
+//     camera_workers    1              # 1: USB I/O runs on a thread per camera, 0: on the control thread.
+//     trigger_fanout    1              # 1: release simultaneous triggers on all cameras together, needs camera_workers.
+//     trigger_latency   filename       # A file to persist each camera's learned trigger latency.
+//     camera_profiles   filename       # A file to persist each camera model's properties and choices.
+//     camera_models     filename       # Camera performance models to check loaded sequences against.
+//     late_policy       strict         # strict, skip-late or compress, what cameras do with triggers they fall behind on.
+//     late_policy_ms    0              # How late a trigger is late for skip-late and compress.
+//     hot_plug          1              # 1: find cameras from the kernel's USB events, 0: poll libgphoto2 at 1 Hz.
+//     telem_keyframe_ms 0              # Whole telemetry this often and only what changed in between, 0: always whole.
+//     telem_encoding    json           # json or binary, see docs/camera_control_commands.md.
+//     telem_shm         name           # Also publish the latest telemetry to /dev/shm/name for readers on this host.
 //
 //-----------------------------------------------------------------------------
 
@@ -67,6 +80,16 @@ struct cc_config_t
     std::uint16_t telem_port;
     milliseconds  control_period;
     kv_pair_vec   camera_to_ids;
+    bool          camera_workers;
+    bool          trigger_fanout;
+    std::string   trigger_latency;
+    std::string   camera_profiles;
+    std::string   camera_models;
+    LatePolicy    late_policy;
+    bool          hot_plug;
+    milliseconds  telem_keyframe_ms;
+    bool          binary_telemetry;
+    std::string   telem_shm;
 };
 
 result
@@ -83,6 +106,17 @@ read_camera_control_config(const std::string & filename, cc_config_t & out)
     auto command_port = std::uint16_t {0};
     auto telem_port = std::uint16_t {0};
     kv_pair_vec cam_to_ids;
+    int camera_workers = 1;
+    int trigger_fanout = 1;
+    std::string trigger_latency = "";
+    std::string camera_profiles = "";
+    std::string camera_models = "";
+    std::string late_policy = "strict";
+    std::string late_policy_ms = "";
+    int hot_plug = 1;
+    milliseconds telem_keyframe_ms = 0;
+    std::string telem_encoding = "json";
+    std::string telem_shm = "";
 
     for (const auto & pair : config_pairs)
     {
@@ -122,19 +156,118 @@ read_camera_control_config(const std::string & filename, cc_config_t & out)
         {
             ABORT_ON_FAILURE(read_config(pair.value, cam_to_ids), "Failed to read camera_aliases", result::failure);
         }
+        else
+        if (pair.key == "camera_workers")
+        {
+            ABORT_ON_FAILURE(
+                as_type<int>(pair.value, camera_workers),
+                "as_type<int>(" << pair.value <<") failed",
+                result::failure
+            );
+        }
+        else
+        if (pair.key == "trigger_fanout")
+        {
+            ABORT_ON_FAILURE(
+                as_type<int>(pair.value, trigger_fanout),
+                "as_type<int>(" << pair.value <<") failed",
+                result::failure
+            );
+        }
+        else
+        if (pair.key == "trigger_latency")
+        {
+            trigger_latency = pair.value;
+        }
+        else
+        if (pair.key == "camera_profiles")
+        {
+            camera_profiles = pair.value;
+        }
+        else
+        if (pair.key == "camera_models")
+        {
+            camera_models = pair.value;
+        }
+        else
+        if (pair.key == "late_policy")
+        {
+            late_policy = pair.value;
+        }
+        else
+        if (pair.key == "late_policy_ms")
+        {
+            late_policy_ms = pair.value;
+        }
+        else
+        if (pair.key == "hot_plug")
+        {
+            ABORT_ON_FAILURE(
+                as_type<int>(pair.value, hot_plug),
+                "as_type<int>(" << pair.value <<") failed",
+                result::failure
+            );
+        }
+        else
+        if (pair.key == "telem_keyframe_ms")
+        {
+            ABORT_ON_FAILURE(
+                as_type<milliseconds>(pair.value, telem_keyframe_ms),
+                "as_type<milliseconds>(" << pair.value <<") failed",
+                result::failure
+            );
+        }
+        else
+        if (pair.key == "telem_encoding")
+        {
+            telem_encoding = pair.value;
+        }
+        else
+        if (pair.key == "telem_shm")
+        {
+            telem_shm = pair.value;
+        }
     }
 
+    LatePolicy policy;
+    ABORT_ON_FAILURE(
+        LatePolicy::parse(late_policy + " " + late_policy_ms, policy),
+        "bad late_policy",
+        result::failure
+    );
+
     ABORT_IF_NOT(udp_ip.starts_with("239."), "Please use a local multicast IP address", result::failure);
     ABORT_IF(command_port < 1024, "command_port too low, pick a higher port", result::failure);
     ABORT_IF(telem_port < 1024, "telem_port too low, pick a higher port", result::failure);
     ABORT_IF(period < 10, "100+ Hz is probably too fast", result::failure);
+    ABORT_IF(telem_keyframe_ms < 0, "telem_keyframe_ms can't be negative", result::failure);
+    ABORT_IF(
+        telem_encoding != "json" and telem_encoding != "binary",
+        "telem_encoding must be json or binary, got '" << telem_encoding << "'",
+        result::failure
+    );
+    ABORT_IF(
+        telem_shm.find('/') != std::string::npos,
+        "telem_shm is a name in /dev/shm, not a path, got '" << telem_shm << "'",
+        result::failure
+    );
 
     out = cc_config_t {
         .udp_ip         = udp_ip,
         .command_port   = command_port,
         .telem_port     = telem_port,
         .control_period = period,
-        .camera_to_ids  = cam_to_ids
+        .camera_to_ids  = cam_to_ids,
+        .camera_workers = camera_workers != 0,
+        .trigger_fanout = trigger_fanout != 0,
+        .trigger_latency = trigger_latency,
+        .camera_profiles = camera_profiles,
+        .camera_models = camera_models,
+        .late_policy = policy,
+        .hot_plug = hot_plug != 0,
+        .telem_keyframe_ms = telem_keyframe_ms,
+        .binary_telemetry = telem_encoding == "binary",
+        .telem_shm = telem_shm
     };
 
     return result::success;
@@ -157,6 +290,16 @@ int main(int argc, char ** argv)
     INFO_LOG << "init():   command_port: " << cfg.command_port << "\n";
     INFO_LOG << "init():     telem_port: " << cfg.telem_port << "\n";
     INFO_LOG << "init(): control_period: " << cfg.control_period << " ms\n";
+    INFO_LOG << "init(): camera_workers: " << cfg.camera_workers << "\n";
+    INFO_LOG << "init(): trigger_fanout: " << cfg.trigger_fanout << "\n";
+    INFO_LOG << "init(): trigger_latency: " << cfg.trigger_latency << "\n";
+    INFO_LOG << "init(): camera_profiles: " << cfg.camera_profiles << "\n";
+    INFO_LOG << "init(): camera_models: " << cfg.camera_models << "\n";
+    INFO_LOG << "init(): late_policy: " << to_string(cfg.late_policy) << "\n";
+    INFO_LOG << "init(): hot_plug: " << cfg.hot_plug << "\n";
+    INFO_LOG << "init(): telem_keyframe_ms: " << cfg.telem_keyframe_ms << "\n";
+    INFO_LOG << "init(): telem_encoding: " << (cfg.binary_telemetry ? "binary" : "json") << "\n";
+    INFO_LOG << "init(): telem_shm: " << cfg.telem_shm << "\n";
 
     UdpSocket command_socket;
 
@@ -173,6 +316,50 @@ int main(int argc, char ** argv)
     CameraControl cc(
         command_socket, telem_socket, gp2cpp, clock, cfg.camera_to_ids);
 
+    cc.enable_camera_workers(cfg.camera_workers);
+    cc.enable_trigger_fanout(cfg.trigger_fanout);
+    cc.enable_background_loading(true);
+    cc.enable_background_open(true);
+    cc.set_control_period(cfg.control_period);
+    cc.set_late_policy(cfg.late_policy);
+    cc.enable_telem_delta(cfg.telem_keyframe_ms);
+    cc.enable_binary_telemetry(cfg.binary_telemetry);
+
+    if (not cfg.trigger_latency.empty())
+    {
+        ABORT_ON_FAILURE(cc.load_trigger_latencies(cfg.trigger_latency), "failure", 1);
+    }
+
+    if (not cfg.camera_profiles.empty())
+    {
+        ABORT_ON_FAILURE(cc.load_camera_profiles(cfg.camera_profiles), "failure", 1);
+    }
+
+    if (not cfg.camera_models.empty())
+    {
+        ABORT_ON_FAILURE(cc.load_camera_models(cfg.camera_models), "failure", 1);
+    }
+
+    ShmPublisher telem_shm;
+    if (not cfg.telem_shm.empty())
+    {
+        ABORT_ON_FAILURE(telem_shm.open(cfg.telem_shm), "failure", 1);
+        cc.enable_shm_telemetry(&telem_shm);
+    }
+
+    HotPlug hot_plug;
+    if (cfg.hot_plug)
+    {
+        if (result::success == hot_plug.init())
+        {
+            cc.enable_hot_plug(&hot_plug);
+        }
+        else
+        {
+            ERROR_LOG << "hot_plug.init() failed, polling for cameras instead" << std::endl;
+        }
+    }
+
     // Construct the Runtime config.
     Thread::Config config;
 
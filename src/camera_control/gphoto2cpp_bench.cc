@@ -0,0 +1,217 @@
+// Cost of finding the status widgets in a synthetic 500 widget config tree,
+// about the size of a Nikon Z's.  Walking the tree is what every
+// read_property() paid after each read_config() dropped the property cache,
+// the flat index is built with one walk per read_config() and then each
+// lookup is a hash.
+//
+//     make -C src/camera_control bench && src/camera_control/gphoto2cpp_bench_bin
+
+#include <gphoto2cpp/gphoto2cpp.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using steady = std::chrono::steady_clock;
+
+
+constexpr int sections            = 10;
+constexpr int widgets_per_section = 50;
+
+// Polled every scan, spread over the back half of the tree as on the camera.
+const std::vector<std::string> status_properties = {
+    "batterylevel",
+    "shutterspeed",
+    "expprogram",
+    "f-number",
+    "iso",
+    "imagequality",
+    "availableshots",
+    "burstnumber",
+    "capturemode",
+    "shootingspeed",
+    "capturetarget",
+};
+
+
+gphoto2cpp::root_widget_ptr
+make_tree()
+{
+    GP2::CameraWidget * root {nullptr};
+    GP2::gp_widget_new(GP2::GP_WIDGET_WINDOW, "Camera and Driver Configuration", &root);
+    GP2::gp_widget_set_name(root, "main");
+
+    std::size_t next_status = 0;
+
+    for (int s = 0; s < sections; ++s)
+    {
+        GP2::CameraWidget * section {nullptr};
+        const auto section_name = "section" + std::to_string(s);
+        GP2::gp_widget_new(GP2::GP_WIDGET_SECTION, section_name.c_str(), &section);
+        GP2::gp_widget_set_name(section, section_name.c_str());
+        GP2::gp_widget_append(root, section);
+
+        for (int w = 0; w < widgets_per_section; ++w)
+        {
+            std::string name = "widget" + std::to_string(s) + "_" + std::to_string(w);
+            if (s >= sections / 2 and w % 20 == 19 and next_status < status_properties.size())
+            {
+                name = status_properties[next_status++];
+            }
+            const auto label = "Label " + name;
+
+            GP2::CameraWidget * child {nullptr};
+            GP2::gp_widget_new(GP2::GP_WIDGET_TEXT, label.c_str(), &child);
+            GP2::gp_widget_set_name(child, name.c_str());
+            GP2::gp_widget_append(section, child);
+        }
+    }
+
+    // The rest go in the last section.
+    GP2::CameraWidget * last {nullptr};
+    GP2::gp_widget_get_child(root, sections - 1, &last);
+    for (; next_status < status_properties.size(); ++next_status)
+    {
+        const auto & name = status_properties[next_status];
+        GP2::CameraWidget * child {nullptr};
+        GP2::gp_widget_new(GP2::GP_WIDGET_TEXT, ("Label " + name).c_str(), &child);
+        GP2::gp_widget_set_name(child, name.c_str());
+        GP2::gp_widget_append(last, child);
+    }
+
+    return gphoto2cpp::make_root_widget(root);
+}
+
+
+// What read_property() did on a cache miss, from gphoto2/actions.c
+// _find_widget_by_name().
+int
+walk_tree(GP2::CameraWidget * widget, const char * name, GP2::CameraWidget ** result)
+{
+    if (GP2::gp_widget_get_child_by_name(widget, name, result) == GP2::OK)
+    {
+        return GP2::OK;
+    }
+
+    if (GP2::gp_widget_get_child_by_label(widget, name, result) == GP2::OK)
+    {
+        return GP2::OK;
+    }
+
+    const int count = GP2::gp_widget_count_children(widget);
+    for (int i = 0; i < count; i++)
+    {
+        GP2::CameraWidget * child {nullptr};
+        if (GP2::gp_widget_get_child(widget, i, &child) < GP2::OK)
+        {
+            continue;
+        }
+
+        if (walk_tree(child, name, result) == GP2::OK)
+        {
+            return GP2::OK;
+        }
+    }
+
+    return GP2::ERROR_BAD_PARAMETERS;
+}
+
+
+template <typename Func>
+double
+time_ns(int iterations, Func && func)
+{
+    const auto start = steady::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        func();
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        steady::now() - start).count();
+    return static_cast<double>(elapsed) / iterations;
+}
+
+
+int main()
+{
+    const auto root = make_tree();
+
+    gphoto2cpp::widget_index index;
+    gphoto2cpp::_index_widgets(root.get(), index);
+    gphoto2cpp::_index_slots(index);
+
+    for (const auto & property : status_properties)
+    {
+        GP2::CameraWidget * child {nullptr};
+        if (walk_tree(root.get(), property.c_str(), &child) != GP2::OK or
+            not index.slots.contains(property) or
+            index.widgets[index.slots[property]].widget != child)
+        {
+            std::cerr << "lookup of '" << property << "' failed\n";
+            return 1;
+        }
+    }
+
+    constexpr int polls = 2'000;
+
+    std::size_t found = 0;
+
+    const auto walk_ns = time_ns(polls, [&]()
+    {
+        for (const auto & property : status_properties)
+        {
+            GP2::CameraWidget * child {nullptr};
+            found += walk_tree(root.get(), property.c_str(), &child) == GP2::OK;
+        }
+    });
+
+    const auto build_ns = time_ns(polls, [&]()
+    {
+        gphoto2cpp::widget_index fresh;
+        fresh.widgets.reserve(index.widgets.size());
+        gphoto2cpp::_index_widgets(root.get(), fresh);
+        found += fresh.layout == index.layout;
+    });
+
+    const auto rebuild_ns = time_ns(polls, [&]()
+    {
+        gphoto2cpp::widget_index fresh;
+        gphoto2cpp::_index_widgets(root.get(), fresh);
+        gphoto2cpp::_index_slots(fresh);
+        found += fresh.slots.size();
+    });
+
+    const auto lookup_ns = time_ns(polls, [&]()
+    {
+        for (const auto & property : status_properties)
+        {
+            auto itor = index.slots.find(property);
+            found += itor != index.slots.end() and index.widgets[itor->second].widget;
+        }
+    });
+
+    std::cout
+        << index.widgets.size() << " widgets, "
+        << status_properties.size() << " status properties per poll\n\n"
+        << std::setw(36) << std::left << "" << std::right
+        << std::setw(14) << "ns"
+        << "\n";
+
+    const auto row = [](const char * what, double ns)
+    {
+        std::cout
+            << std::setw(36) << std::left << what << std::right
+            << std::setw(14) << std::fixed << std::setprecision(0) << ns
+            << "\n";
+    };
+
+    row("walk tree, per poll", walk_ns);
+    row("index lookups, per poll", lookup_ns);
+    row("index refresh, same layout", build_ns);
+    row("index build, new layout", rebuild_ns);
+
+    // Keeps the loops from being optimized away.
+    return found == 0;
+}
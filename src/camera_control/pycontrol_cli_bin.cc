@@ -2,12 +2,14 @@
 #include <common/types.h>
 #include <camera_control/Camera.h>
 #include <camera_control/GPhoto2Cpp.h>
+#include <camera_control/WallClock.h>
 
 using namespace pycontrol;
 
 int main(int argc, char ** argv)
 {
     GPhoto2Cpp gp2cpp;
+    WallClock clock;
 
     const auto & all_detected_ports = gp2cpp.auto_detect();
 
@@ -45,7 +47,7 @@ int main(int argc, char ** argv)
             continue;
         }
 
-        auto cam = Camera(gp2cpp, gp2_camera, port, serial, "camera.config");
+        auto cam = Camera(gp2cpp, clock, gp2_camera, port, serial, "camera.config");
 
         cam.read_config();
 
@@ -87,7 +89,7 @@ int main(int argc, char ** argv)
             // Trigger the camera.
 
             INFO_LOG << "Trying 'Memory Card'\n";
-            cam.set_capture_target("Memory Card");
+            cam.set_capture_target(intern("Memory Card"));
             cam.write_config();
 
             for (int i = 0; i < 10; ++i)
@@ -0,0 +1,51 @@
+// Compiles a .seq sequence file into the .seqb that load_sequence maps
+// instead of parsing the text.
+//
+//     seq_compile_bin sequences/spain-2026.seq [sequences/spain-2026.seqb]
+
+#include <common/io.h>
+#include <common/types.h>
+#include <camera_control/CameraSequenceFileReader.h>
+#include <camera_control/SequenceBinary.h>
+
+#include <filesystem>
+
+using namespace pycontrol;
+
+int main(int argc, char ** argv)
+{
+    if (argc < 2 or argc > 3)
+    {
+        ERROR_LOG << "usage: " << argv[0] << " input.seq [output.seqb]" << std::endl;
+        return 1;
+    }
+
+    const std::string input = argv[1];
+    const std::string output = argc == 3 ? argv[2] : input + "b";
+
+    // Remove the default output first, the reader would load it instead of
+    // the text when it's current.
+    if (output == input + "b")
+    {
+        std::filesystem::remove(output);
+    }
+
+    CameraSequenceFileReader reader;
+    if (reader.read_file(input) != result::success)
+    {
+        ERROR_LOG << "Failed to read " << input << std::endl;
+        return 1;
+    }
+
+    if (write_sequence_binary(output, input, reader.get_events()) != result::success)
+    {
+        ERROR_LOG << "Failed to write " << output << std::endl;
+        return 1;
+    }
+
+    INFO_LOG
+        << "Wrote " << reader.get_events().size() << " events to " << output
+        << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+// Predicts whether each camera can keep up with a .seq file, given a camera
+// models file.  Event ids without a time given are put at 0, so times print
+// as offsets from them.
+//
+//     seq_simulate_bin config/camera_models.config sequences/c2_4.0_fps.seq [c2 0 c3 60000 ...]
+
+#include <common/io.h>
+#include <common/str_utils.h>
+#include <common/types.h>
+#include <camera_control/CameraSequence.h>
+#include <camera_control/CameraSequenceFileReader.h>
+#include <camera_control/SequenceSimulator.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace pycontrol;
+
+int main(int argc, char ** argv)
+{
+    if (argc < 3 or argc % 2 == 0)
+    {
+        ERROR_LOG
+            << "usage: " << argv[0] << " camera_models.config input.seq [event_id time_ms]..."
+            << std::endl;
+        return 1;
+    }
+
+    camera_model_map models;
+    if (read_camera_models(argv[1], models) != result::success)
+    {
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    CameraSequenceFileReader reader;
+    if (reader.read_file(argv[2]) != result::success)
+    {
+        ERROR_LOG << "Failed to read " << argv[2] << std::endl;
+        return 1;
+    }
+
+    event_time_map event_times;
+    for (const auto & event : reader.get_events())
+    {
+        event_times[to_string(event.event_id)] = 0;
+    }
+    for (int i = 3; i + 1 < argc; i += 2)
+    {
+        milliseconds time = 0;
+        if (as_type<milliseconds>(argv[i + 1], time) != result::success)
+        {
+            return 1;
+        }
+        event_times[argv[i]] = time;
+    }
+
+    std::cout
+        << std::left
+        << std::setw(10) << "camera"
+        << std::right
+        << std::setw(10) << "triggers"
+        << std::setw(10) << "frames"
+        << std::setw(12) << "drift ms"
+        << std::setw(8)  << "full"
+        << std::setw(14) << "scheduled"
+        << std::setw(14) << "predicted"
+        << std::setw(14) << "on card"
+        << "\n";
+
+    int num_warnings = 0;
+    for (const auto & id : reader.get_camera_ids())
+    {
+        CameraSequence sequence;
+        sequence.load(id, reader.get_events());
+        sequence.compile(event_times);
+
+        const auto prediction = simulate_sequence(sequence, find_camera_model(models, id));
+
+        std::cout
+            << std::left
+            << std::setw(10) << id
+            << std::right
+            << std::setw(10) << prediction.triggers
+            << std::setw(10) << prediction.frames
+            << std::setw(12) << prediction.max_drift_ms
+            << std::setw(8)  << prediction.saturations
+            << std::setw(14) << convert_milliseconds_to_hms(prediction.scheduled_end)
+            << std::setw(14) << convert_milliseconds_to_hms(prediction.predicted_end)
+            << std::setw(14) << convert_milliseconds_to_hms(prediction.card_done)
+            << "\n";
+
+        for (const auto & warning : prediction.warnings)
+        {
+            std::cout << "    WARNING: " << warning << "\n";
+            ++num_warnings;
+        }
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout
+        << "simulated in "
+        << std::chrono::duration<double, std::milli>(elapsed).count() << " ms\n";
+
+    return num_warnings > 0 ? 2 : 0;
+}
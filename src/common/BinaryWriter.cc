@@ -0,0 +1,268 @@
+#include <common/BinaryWriter.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace pycontrol
+{
+
+
+BinaryWriter::
+BinaryWriter(
+    std::span<const std::string_view> keys,
+    std::uint16_t version,
+    std::size_t capacity)
+:
+    _keys(keys.first(std::min<std::size_t>(keys.size(), 256))),
+    _version(version),
+    _sorted(_keys.size()),
+    _buffer(std::max<std::size_t>(capacity, 64), '\0')
+{
+    std::iota(_sorted.begin(), _sorted.end(), 0);
+    std::sort(
+        _sorted.begin(),
+        _sorted.end(),
+        [this](std::uint8_t a, std::uint8_t b) { return _keys[a] < _keys[b]; }
+    );
+
+    clear();
+}
+
+
+void
+BinaryWriter::
+clear()
+{
+    _size = 0;
+    auto * out = std::copy(MAGIC.begin(), MAGIC.end(), _reserve(HEADER_SIZE));
+    out = _put<2>(_version, out);
+    _size = _put<2>(0, out) - _buffer.data();
+    _next_key = 0;
+}
+
+
+BinaryWriter &
+BinaryWriter::
+begin_object()
+{
+    _tag(Tag::object);
+    return *this;
+}
+
+
+BinaryWriter &
+BinaryWriter::
+end_object()
+{
+    _tag(Tag::end);
+    return *this;
+}
+
+
+BinaryWriter &
+BinaryWriter::
+begin_array()
+{
+    _tag(Tag::array);
+    return *this;
+}
+
+
+BinaryWriter &
+BinaryWriter::
+end_array()
+{
+    _tag(Tag::end);
+    return *this;
+}
+
+
+BinaryWriter &
+BinaryWriter::
+key(std::string_view name)
+{
+    if (_next_key < _keys.size() and _keys[_next_key] == name)
+    {
+        _tagged<1>(Tag::key_index, _next_key++);
+        return *this;
+    }
+
+    const auto found = std::lower_bound(
+        _sorted.begin(),
+        _sorted.end(),
+        name,
+        [this](std::uint8_t index, std::string_view name) { return _keys[index] < name; }
+    );
+
+    if (found != _sorted.end() and _keys[*found] == name)
+    {
+        _tagged<1>(Tag::key_index, *found);
+        _next_key = *found + 1u;
+        return *this;
+    }
+
+    _bytes<1>(Tag::key_string, name, MAX_KEY);
+    return *this;
+}
+
+
+BinaryWriter &
+BinaryWriter::
+value(std::string_view text)
+{
+    _bytes<2>(Tag::string, text, MAX_STRING);
+    return *this;
+}
+
+
+BinaryWriter &
+BinaryWriter::
+value(bool b)
+{
+    _tag(b ? Tag::true_value : Tag::false_value);
+    return *this;
+}
+
+
+BinaryWriter &
+BinaryWriter::
+value(float number)
+{
+    if (not std::isfinite(number))
+    {
+        _tag(Tag::null);
+        return *this;
+    }
+    _tagged<4>(Tag::float32, std::bit_cast<std::uint32_t>(number));
+    return *this;
+}
+
+
+BinaryWriter &
+BinaryWriter::
+value(double number)
+{
+    if (not std::isfinite(number))
+    {
+        _tag(Tag::null);
+        return *this;
+    }
+    _tagged<8>(Tag::float64, std::bit_cast<std::uint64_t>(number));
+    return *this;
+}
+
+
+BinaryWriter &
+BinaryWriter::
+begin_string()
+{
+    _tagged<2>(Tag::string, 0);
+    _string_at = _size - 2;
+    return *this;
+}
+
+
+BinaryWriter &
+BinaryWriter::
+append(std::string_view text)
+{
+    const auto length = _size - _string_at - 2;
+    text = text.substr(0, MAX_STRING - std::min(length, MAX_STRING));
+    std::copy(text.begin(), text.end(), _reserve(text.size()));
+    _size += text.size();
+    return *this;
+}
+
+
+BinaryWriter &
+BinaryWriter::
+end_string()
+{
+    _put<2>(_size - _string_at - 2, _buffer.data() + _string_at);
+    return *this;
+}
+
+
+BinaryWriter &
+BinaryWriter::
+raw(std::string_view json)
+{
+    _bytes<2>(Tag::json, json, MAX_STRING);
+    return *this;
+}
+
+
+BinaryWriter &
+BinaryWriter::
+_unsigned(std::uint64_t number)
+{
+    if (number <= std::numeric_limits<std::uint8_t>::max())
+    {
+        _tagged<1>(Tag::uint8, number);
+    }
+    else if (number <= std::numeric_limits<std::uint16_t>::max())
+    {
+        _tagged<2>(Tag::uint16, number);
+    }
+    else if (number <= std::numeric_limits<std::uint32_t>::max())
+    {
+        _tagged<4>(Tag::uint32, number);
+    }
+    else
+    {
+        _tagged<8>(Tag::uint64, number);
+    }
+    return *this;
+}
+
+
+BinaryWriter &
+BinaryWriter::
+_signed(std::int64_t number)
+{
+    const auto bits = static_cast<std::uint64_t>(number);
+    if (number >= std::numeric_limits<std::int8_t>::min())
+    {
+        _tagged<1>(Tag::int8, bits);
+    }
+    else if (number >= std::numeric_limits<std::int16_t>::min())
+    {
+        _tagged<2>(Tag::int16, bits);
+    }
+    else if (number >= std::numeric_limits<std::int32_t>::min())
+    {
+        _tagged<4>(Tag::int32, bits);
+    }
+    else
+    {
+        _tagged<8>(Tag::int64, bits);
+    }
+    return *this;
+}
+
+
+template <std::size_t SIZE>
+void
+BinaryWriter::
+_bytes(Tag tag, std::string_view text, std::size_t max)
+{
+    text = text.substr(0, max);
+    auto * out = _reserve(1 + SIZE + text.size());
+    *out++ = static_cast<char>(tag);
+    out = _put<SIZE>(text.size(), out);
+    _size = std::copy(text.begin(), text.end(), out) - _buffer.data();
+}
+
+
+void
+BinaryWriter::
+_grow(std::size_t needed)
+{
+    _buffer.resize(std::max(needed, _buffer.size() * 2), '\0');
+}
+
+
+} /* namespace pycontrol */
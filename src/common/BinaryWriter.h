@@ -0,0 +1,214 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace pycontrol
+{
+
+
+//-----------------------------------------------------------------------------
+// Writes the same messages JsonWriter does, with the same calls, as compact
+// little-endian binary.
+//
+// A message starts with an 8 byte header, the magic "PCTB", the schema version
+// as a uint16 and a reserved uint16 of 0.  Then comes a single value, each
+// value a one byte tag followed by its payload:
+//
+//     0x00 null   0x01 false   0x02 true
+//     0x10 uint8  0x11 uint16  0x12 uint32  0x13 uint64
+//     0x14 int8   0x15 int16   0x16 int32   0x17 int64
+//     0x18 float32  0x19 float64
+//     0x20 string, uint16 length and UTF-8 bytes
+//     0x21 JSON, uint16 length and JSON text
+//     0x30 array, values up to end
+//     0x31 object, key and value pairs up to end
+//     0x32 end
+//     0x40 key, a uint8 index into the schema's keys
+//     0x41 key, uint8 length and UTF-8 bytes, for keys not in the schema
+//
+// Integers take the smallest tag that holds them, unsigned unless negative.
+// NaN and infinity are null.  Strings are cut at 65535 bytes and keys not in
+// the schema at 255, a UDP datagram can't be much longer anyway.  The schema
+// is the keys, in order, a reader needs the same list for the same version.
+//
+// Like JsonWriter the buffer is reused, so once warmed up writing a message
+// never allocates.
+//
+class BinaryWriter
+{
+public:
+
+    BinaryWriter(
+        std::span<const std::string_view> keys,
+        std::uint16_t version,
+        std::size_t capacity = 4096);
+
+    static constexpr std::string_view MAGIC = "PCTB";
+
+    enum class Tag : std::uint8_t
+    {
+        null        = 0x00,
+        false_value = 0x01,
+        true_value  = 0x02,
+        uint8       = 0x10,
+        uint16      = 0x11,
+        uint32      = 0x12,
+        uint64      = 0x13,
+        int8        = 0x14,
+        int16       = 0x15,
+        int32       = 0x16,
+        int64       = 0x17,
+        float32     = 0x18,
+        float64     = 0x19,
+        string      = 0x20,
+        json        = 0x21,
+        array       = 0x30,
+        object      = 0x31,
+        end         = 0x32,
+        key_index   = 0x40,
+        key_string  = 0x41,
+    };
+
+    // Starts the next message, keeping the buffer.
+    void clear();
+
+    BinaryWriter & begin_object();
+    BinaryWriter & end_object();
+    BinaryWriter & begin_array();
+    BinaryWriter & end_array();
+
+    BinaryWriter & key(std::string_view name);
+
+    BinaryWriter & value(std::string_view text);
+    BinaryWriter & value(const char * text) { return value(std::string_view(text)); }
+    BinaryWriter & value(bool b);
+    BinaryWriter & value(float number);
+    BinaryWriter & value(double number);
+
+    template <typename T>
+        requires (std::is_integral_v<T> and not std::is_same_v<T, bool>)
+    BinaryWriter & value(T number);
+
+    // A string value written in pieces.
+    BinaryWriter & begin_string();
+    BinaryWriter & append(std::string_view text);
+    BinaryWriter & end_string();
+
+    // Already serialized JSON, sent as JSON text.
+    BinaryWriter & raw(std::string_view json);
+
+    // The message, NULs and all.
+    std::string_view view() const { return {_buffer.data(), _size}; }
+
+    std::size_t size() const { return _size; }
+    std::size_t capacity() const { return _buffer.size(); }
+
+private:
+
+    BinaryWriter(const BinaryWriter & copy) = delete;
+    BinaryWriter & operator=(const BinaryWriter & rhs) = delete;
+
+    static constexpr std::size_t HEADER_SIZE = 8;
+    static constexpr std::size_t MAX_STRING = 0xffff;
+    static constexpr std::size_t MAX_KEY = 0xff;
+
+    BinaryWriter & _unsigned(std::uint64_t number);
+    BinaryWriter & _signed(std::int64_t number);
+    void _tag(Tag tag) { _tagged<0>(tag, 0); }
+
+    // The tag and the low SIZE bytes of number, little-endian.
+    template <std::size_t SIZE>
+    void _tagged(Tag tag, std::uint64_t number);
+
+    template <std::size_t SIZE>
+    void _bytes(Tag tag, std::string_view text, std::size_t max);
+
+    // Little-endian, the low SIZE bytes of number.
+    template <std::size_t SIZE>
+    static char * _put(std::uint64_t number, char * out);
+
+    // Room for count more bytes, returns where the next goes.
+    char * _reserve(std::size_t count);
+    void _grow(std::size_t needed);
+
+    std::span<const std::string_view> _keys;
+    std::uint16_t _version;
+
+    // Indices into _keys in key order, for looking keys up, and the index
+    // after the last key found, as keys mostly follow one another.
+    std::vector<std::uint8_t> _sorted;
+    std::size_t _next_key {0};
+
+    std::string _buffer;
+    std::size_t _size {0};
+
+    // Where the length of the string begin_string() started goes.
+    std::size_t _string_at {0};
+};
+
+
+//-----------------------------------------------------------------------------
+// Inline implementations.
+//-----------------------------------------------------------------------------
+template <typename T>
+    requires (std::is_integral_v<T> and not std::is_same_v<T, bool>)
+BinaryWriter &
+BinaryWriter::
+value(T number)
+{
+    if constexpr (std::is_signed_v<T>)
+    {
+        if (number < 0)
+        {
+            return _signed(number);
+        }
+    }
+    return _unsigned(static_cast<std::uint64_t>(number));
+}
+
+
+template <std::size_t SIZE>
+char *
+BinaryWriter::
+_put(std::uint64_t number, char * out)
+{
+    for (std::size_t i = 0; i < SIZE; ++i)
+    {
+        out[i] = static_cast<char>(number >> (8 * i));
+    }
+    return out + SIZE;
+}
+
+
+template <std::size_t SIZE>
+void
+BinaryWriter::
+_tagged(Tag tag, std::uint64_t number)
+{
+    auto * out = _reserve(1 + SIZE);
+    *out++ = static_cast<char>(tag);
+    _size = _put<SIZE>(number, out) - _buffer.data();
+}
+
+
+inline
+char *
+BinaryWriter::
+_reserve(std::size_t count)
+{
+    const auto needed = _size + count;
+    if (needed > _buffer.size())
+    {
+        _grow(needed);
+    }
+    return _buffer.data() + _size;
+}
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <common/BinaryWriter.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+using namespace pycontrol;
+
+
+namespace
+{
+    constexpr std::string_view KEYS[] = {"state", "time", "list"};
+
+    std::string
+    bytes(std::initializer_list<int> list)
+    {
+        std::string out;
+        for (const auto b : list)
+        {
+            out += static_cast<char>(b);
+        }
+        return out;
+    }
+
+    const std::string HEADER = "PCTB" + bytes({3, 0, 0, 0});
+}
+
+
+TEST_CASE("BinaryWriter", "[BinaryWriter]")
+{
+    BinaryWriter out(KEYS, 3);
+
+    //-------------------------------------------------------------------------
+    // Just the header, then keys by index, or spelled out when not in the
+    // schema.
+    //
+    CHECK( out.view() == HEADER );
+
+    out.begin_object();
+    out.key("state").value("idle");
+    out.key("list").begin_array().value(true).value(false).end_array();
+    out.key("other").raw("{}");
+    out.end_object();
+
+    CHECK( out.view() == HEADER + bytes({
+        0x31,
+            0x40, 0, 0x20, 4, 0, 'i', 'd', 'l', 'e',
+            0x40, 2, 0x30, 0x02, 0x01, 0x32,
+            0x41, 5, 'o', 't', 'h', 'e', 'r', 0x21, 2, 0, '{', '}',
+        0x32}) );
+
+    //-------------------------------------------------------------------------
+    // Integers in as few bytes as they fit, little-endian.
+    //
+    out.clear();
+    out.begin_array();
+    out.value(std::uint64_t{200});
+    out.value(std::int64_t{0x1234});
+    out.value(0x12345678);
+    out.value(std::numeric_limits<std::uint64_t>::max());
+    out.value(-1);
+    out.value(-200);
+    out.value(std::numeric_limits<std::int32_t>::min());
+    out.value(std::numeric_limits<std::int64_t>::min());
+    out.end_array();
+
+    CHECK( out.view() == HEADER + bytes({
+        0x30,
+            0x10, 200,
+            0x11, 0x34, 0x12,
+            0x12, 0x78, 0x56, 0x34, 0x12,
+            0x13, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0x14, 0xff,
+            0x15, 0x38, 0xff,
+            0x16, 0x00, 0x00, 0x00, 0x80,
+            0x17, 0, 0, 0, 0, 0, 0, 0, 0x80,
+        0x32}) );
+
+    //-------------------------------------------------------------------------
+    // Floats, NaN and infinity are null.
+    //
+    out.clear();
+    out.begin_array();
+    out.value(1.0f);
+    out.value(-2.0);
+    out.value(std::numeric_limits<float>::quiet_NaN());
+    out.value(std::numeric_limits<double>::infinity());
+    out.end_array();
+
+    CHECK( out.view() == HEADER + bytes({
+        0x30,
+            0x18, 0x00, 0x00, 0x80, 0x3f,
+            0x19, 0, 0, 0, 0, 0, 0, 0x00, 0xc0,
+            0x00,
+            0x00,
+        0x32}) );
+
+    //-------------------------------------------------------------------------
+    // Strings written in pieces.
+    //
+    out.clear();
+    out.begin_string().append("z7").append(".").append("iso").end_string();
+
+    CHECK( out.view() == HEADER + bytes({0x20, 6, 0, 'z', '7', '.', 'i', 's', 'o'}) );
+
+    //-------------------------------------------------------------------------
+    // Grows and then reuses its buffer, long strings are cut.
+    //
+    BinaryWriter small(KEYS, 3, 64);
+    const auto long_text = std::string(70'000, 'x');
+
+    small.value(long_text);
+    CHECK( small.size() == HEADER.size() + 3 + 0xffff );
+    CHECK( small.view().substr(HEADER.size(), 3) == bytes({0x20, 0xff, 0xff}) );
+
+    const auto * buffer = small.view().data();
+    const auto capacity = small.capacity();
+    for (int i = 0; i < 10; ++i)
+    {
+        small.clear();
+        small.value(long_text);
+    }
+    CHECK( small.view().data() == buffer );
+    CHECK( small.capacity() == capacity );
+}
@@ -0,0 +1,338 @@
+#include <common/JsonDelta.h>
+#include <common/JsonWriter.h>
+
+#include <charconv>
+
+namespace pycontrol
+{
+
+
+namespace
+{
+    // Deeper than any telemetry, bounds the recursion.
+    constexpr std::size_t MAX_DEPTH = 64;
+
+    constexpr auto npos = std::string_view::npos;
+
+    std::string_view
+    path(const std::string & paths, std::size_t begin, std::size_t end)
+    {
+        return std::string_view(paths).substr(begin, end - begin);
+    }
+}
+
+
+void
+JsonDelta::
+set_keyframe(std::string_view json)
+{
+    _keyframe.assign(json);
+    _has_keyframe = _scan(_keyframe, _keyframe_leaves);
+}
+
+
+void
+JsonDelta::
+clear()
+{
+    _has_keyframe = false;
+}
+
+
+bool
+JsonDelta::
+diff(std::string_view json, JsonWriter & out)
+{
+    if (not _has_keyframe or not _scan(json, _leaves))
+    {
+        return false;
+    }
+
+    const auto & before = _keyframe_leaves.leaves;
+    const auto & after = _leaves.leaves;
+
+    if (before.size() != after.size())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < after.size(); ++i)
+    {
+        if (path(_keyframe_leaves.paths, before[i].path_begin, before[i].path_end) !=
+            path(_leaves.paths, after[i].path_begin, after[i].path_end))
+        {
+            return false;
+        }
+    }
+
+    const std::string_view keyframe(_keyframe);
+    for (std::size_t i = 0; i < after.size(); ++i)
+    {
+        const auto value = json.substr(after[i].begin, after[i].end - after[i].begin);
+        if (value != keyframe.substr(before[i].begin, before[i].end - before[i].begin))
+        {
+            out.key(path(_leaves.paths, after[i].path_begin, after[i].path_end));
+            out.raw(value);
+        }
+    }
+
+    return true;
+}
+
+
+bool
+JsonDelta::
+_scan(std::string_view json, Leaves & out)
+{
+    out.leaves.clear();
+    out.paths.clear();
+    _path.clear();
+    _depth = 0;
+
+    const auto pos = _value(json, 0, out);
+    return pos != npos and _skip_space(json, pos) == json.size();
+}
+
+
+std::size_t
+JsonDelta::
+_value(std::string_view json, std::size_t pos, Leaves & out)
+{
+    pos = _skip_space(json, pos);
+    if (pos >= json.size())
+    {
+        return npos;
+    }
+
+    if (json[pos] == '{')
+    {
+        return _object(json, pos, out);
+    }
+
+    // Arrays of objects are walked into, any other array is a leaf.
+    if (json[pos] == '[')
+    {
+        const auto first = _skip_space(json, pos + 1);
+        if (first < json.size() and json[first] == '{')
+        {
+            return _array(json, pos, out);
+        }
+    }
+
+    const auto end = _skip_value(json, pos);
+    if (end == npos)
+    {
+        return npos;
+    }
+
+    const auto path_begin = out.paths.size();
+    out.paths.append(_path);
+    out.leaves.push_back({path_begin, out.paths.size(), pos, end});
+
+    return end;
+}
+
+
+std::size_t
+JsonDelta::
+_object(std::string_view json, std::size_t pos, Leaves & out)
+{
+    auto next = _skip_space(json, pos + 1);
+
+    // An empty object has nothing to walk into, it's a leaf.
+    if (next < json.size() and json[next] == '}')
+    {
+        const auto path_begin = out.paths.size();
+        out.paths.append(_path);
+        out.leaves.push_back({path_begin, out.paths.size(), pos, next + 1});
+        return next + 1;
+    }
+
+    if (++_depth > MAX_DEPTH)
+    {
+        return npos;
+    }
+
+    const auto path_size = _path.size();
+
+    while (next < json.size() and json[next] == '"')
+    {
+        const auto key_end = _skip_string(json, next);
+        if (key_end == npos)
+        {
+            return npos;
+        }
+
+        // JSON Pointer escapes '~' and '/' in keys.
+        _path += '/';
+        for (const auto c : json.substr(next + 1, key_end - next - 2))
+        {
+            switch (c)
+            {
+                case '~': _path += "~0"; break;
+                case '/': _path += "~1"; break;
+                default:  _path += c;
+            }
+        }
+
+        next = _skip_space(json, key_end);
+        if (next >= json.size() or json[next] != ':')
+        {
+            return npos;
+        }
+
+        next = _value(json, next + 1, out);
+        if (next == npos)
+        {
+            return npos;
+        }
+        _path.resize(path_size);
+
+        next = _skip_space(json, next);
+        if (next < json.size() and json[next] == ',')
+        {
+            next = _skip_space(json, next + 1);
+            continue;
+        }
+        if (next < json.size() and json[next] == '}')
+        {
+            --_depth;
+            return next + 1;
+        }
+        return npos;
+    }
+
+    return npos;
+}
+
+
+std::size_t
+JsonDelta::
+_array(std::string_view json, std::size_t pos, Leaves & out)
+{
+    if (++_depth > MAX_DEPTH)
+    {
+        return npos;
+    }
+
+    const auto path_size = _path.size();
+
+    auto next = pos + 1;
+    for (std::size_t index = 0; ; ++index)
+    {
+        char digits[24];
+        _path += '/';
+        _path.append(digits, std::to_chars(digits, digits + sizeof(digits), index).ptr);
+
+        next = _value(json, next, out);
+        if (next == npos)
+        {
+            return npos;
+        }
+        _path.resize(path_size);
+
+        next = _skip_space(json, next);
+        if (next < json.size() and json[next] == ',')
+        {
+            ++next;
+            continue;
+        }
+        if (next < json.size() and json[next] == ']')
+        {
+            --_depth;
+            return next + 1;
+        }
+        return npos;
+    }
+}
+
+
+std::size_t
+JsonDelta::
+_skip_value(std::string_view json, std::size_t pos)
+{
+    if (json[pos] == '"')
+    {
+        return _skip_string(json, pos);
+    }
+
+    if (json[pos] == '{' or json[pos] == '[')
+    {
+        std::size_t depth = 0;
+        while (pos < json.size())
+        {
+            switch (json[pos])
+            {
+                case '"':
+                {
+                    pos = _skip_string(json, pos);
+                    if (pos == npos)
+                    {
+                        return npos;
+                    }
+                    continue;
+                }
+                case '{':
+                case '[':
+                {
+                    ++depth;
+                    break;
+                }
+                case '}':
+                case ']':
+                {
+                    if (--depth == 0)
+                    {
+                        return pos + 1;
+                    }
+                    break;
+                }
+            }
+            ++pos;
+        }
+        return npos;
+    }
+
+    // A number, true, false or null.
+    const auto end = json.find_first_of(",}] \t\r\n", pos);
+    if (end == pos)
+    {
+        return npos;
+    }
+    return end == npos ? json.size() : end;
+}
+
+
+std::size_t
+JsonDelta::
+_skip_string(std::string_view json, std::size_t pos)
+{
+    for (++pos; pos < json.size(); ++pos)
+    {
+        if (json[pos] == '\\')
+        {
+            ++pos;
+        }
+        else if (json[pos] == '"')
+        {
+            return pos + 1;
+        }
+    }
+    return npos;
+}
+
+
+std::size_t
+JsonDelta::
+_skip_space(std::string_view json, std::size_t pos)
+{
+    while (pos < json.size() and
+           (json[pos] == ' ' or json[pos] == '\t' or json[pos] == '\r' or json[pos] == '\n'))
+    {
+        ++pos;
+    }
+    return pos;
+}
+
+
+} /* namespace pycontrol */
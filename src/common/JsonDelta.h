@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pycontrol
+{
+
+class JsonWriter;
+
+
+//-----------------------------------------------------------------------------
+// Finds what changed in a JSON message since a keyframe, as JSON Pointer paths
+// to the values that changed.
+//
+// A message is taken apart into leaves.  Objects are walked into, as are arrays
+// of objects by index, anything else is a leaf, including arrays of numbers or
+// strings, which change as a whole.  Keys are taken as written, they're
+// expected to need no escaping.
+//
+//     delta.set_keyframe(R"({"seq":1,"cams":[{"iso":"64"}],"hist":[1,2]})");
+//
+//     out.begin_object();
+//     delta.diff(R"({"seq":2,"cams":[{"iso":"100"}],"hist":[1,2]})", out);
+//     out.end_object();
+//
+//     // {"/seq":2,"/cams/0/iso":"100"}
+//
+// Once warmed up neither allocates.
+//
+class JsonDelta
+{
+public:
+
+    JsonDelta() = default;
+
+    // Remembers json as the keyframe deltas are taken against.
+    void set_keyframe(std::string_view json);
+
+    // Forgets the keyframe, diff() fails until the next one.
+    void clear();
+
+    bool has_keyframe() const { return _has_keyframe; }
+
+    // Writes each leaf of json that differs from the keyframe as a "path":value
+    // member of out's open object.  Fails, writing nothing, when there's no
+    // keyframe or json doesn't have the keyframe's leaves, a camera came or
+    // went say, a new keyframe is needed then.
+    bool diff(std::string_view json, JsonWriter & out);
+
+private:
+
+    JsonDelta(const JsonDelta & copy) = delete;
+    JsonDelta & operator=(const JsonDelta & rhs) = delete;
+
+    struct Leaf
+    {
+        // Into the paths and the message.
+        std::size_t path_begin;
+        std::size_t path_end;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    struct Leaves
+    {
+        std::vector<Leaf> leaves;
+        std::string       paths;
+    };
+
+    // Takes json apart into leaves, fails if it isn't well formed.
+    bool _scan(std::string_view json, Leaves & out);
+
+    // Each returns just past what it read, or npos.
+    std::size_t _value(std::string_view json, std::size_t pos, Leaves & out);
+    std::size_t _object(std::string_view json, std::size_t pos, Leaves & out);
+    std::size_t _array(std::string_view json, std::size_t pos, Leaves & out);
+
+    static std::size_t _skip_value(std::string_view json, std::size_t pos);
+    static std::size_t _skip_string(std::string_view json, std::size_t pos);
+    static std::size_t _skip_space(std::string_view json, std::size_t pos);
+
+    bool        _has_keyframe {false};
+    std::string _keyframe;
+    Leaves      _keyframe_leaves;
+    Leaves      _leaves;
+
+    // The path of the value being read.
+    std::string _path;
+    std::size_t _depth {0};
+};
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <common/JsonDelta.h>
+#include <common/JsonWriter.h>
+
+#include <string>
+
+using namespace pycontrol;
+
+
+namespace
+{
+    // The delta as an object, or "failed".
+    std::string
+    diff(JsonDelta & delta, const std::string & json)
+    {
+        JsonWriter out;
+        out.clear();
+        out.begin_object();
+        if (not delta.diff(json, out))
+        {
+            return "failed";
+        }
+        out.end_object();
+        return std::string(out.view());
+    }
+}
+
+
+TEST_CASE("JsonDelta", "[JsonDelta]")
+{
+    JsonDelta delta;
+
+    //-------------------------------------------------------------------------
+    // Nothing to diff against yet.
+    //
+    CHECK( delta.has_keyframe() == false );
+    CHECK( diff(delta, "{\"seq\":1}") == "failed" );
+
+    //-------------------------------------------------------------------------
+    // Only what changed, objects and arrays of objects are walked into, other
+    // arrays change as a whole.
+    //
+    const std::string keyframe =
+        "{\"seq\":1,\"state\":\"monitor\",\"empty\":{},\"ids\":[],"
+        "\"cams\":[{\"serial\":\"1111\",\"iso\":\"64\"},{\"serial\":\"2222\",\"iso\":\"64\"}],"
+        "\"response\":{\"last_accepted_id\":3,\"message\":\"a, \\\"b\\\" [c]\"},"
+        "\"timelapse\":{\"histogram\":[1,2,3]}}";
+
+    delta.set_keyframe(keyframe);
+    CHECK( delta.has_keyframe() == true );
+
+    CHECK( diff(delta, keyframe) == "{}" );
+
+    CHECK( diff(delta,
+        "{\"seq\":2,\"state\":\"monitor\",\"empty\":{},\"ids\":[],"
+        "\"cams\":[{\"serial\":\"1111\",\"iso\":\"64\"},{\"serial\":\"2222\",\"iso\":\"100\"}],"
+        "\"response\":{\"last_accepted_id\":3,\"message\":\"a, \\\"b\\\" [d]\"},"
+        "\"timelapse\":{\"histogram\":[1,2,4]}}") ==
+        "{\"/seq\":2,\"/cams/1/iso\":\"100\","
+        "\"/response/message\":\"a, \\\"b\\\" [d]\","
+        "\"/timelapse/histogram\":[1,2,4]}" );
+
+    // Always against the keyframe, not the last diff.
+    CHECK( diff(delta,
+        "{\"seq\":3,\"state\":\"executing\",\"empty\":{},\"ids\":[\"z7\"],"
+        "\"cams\":[{\"serial\":\"1111\",\"iso\":\"64\"},{\"serial\":\"2222\",\"iso\":\"64\"}],"
+        "\"response\":{\"last_accepted_id\":3,\"message\":\"a, \\\"b\\\" [c]\"},"
+        "\"timelapse\":{\"histogram\":[1,2,3]}}") ==
+        "{\"/seq\":3,\"/state\":\"executing\",\"/ids\":[\"z7\"]}" );
+
+    //-------------------------------------------------------------------------
+    // A camera more, or a member less, needs a new keyframe.
+    //
+    CHECK( diff(delta,
+        "{\"seq\":4,\"state\":\"monitor\",\"empty\":{},\"ids\":[],"
+        "\"cams\":[{\"serial\":\"1111\",\"iso\":\"64\"},{\"serial\":\"2222\",\"iso\":\"64\"},"
+        "{\"serial\":\"3333\",\"iso\":\"64\"}],"
+        "\"response\":{\"last_accepted_id\":3,\"message\":\"\"},"
+        "\"timelapse\":{\"histogram\":[1,2,3]}}") == "failed" );
+
+    CHECK( diff(delta,
+        "{\"seq\":4,\"state\":\"monitor\",\"empty\":{},\"ids\":[],"
+        "\"cams\":[{\"serial\":\"1111\",\"iso\":\"64\"},{\"serial\":\"2222\",\"iso\":\"64\"}],"
+        "\"response\":{\"last_accepted_id\":3,\"message\":\"\"},"
+        "\"timelapse\":{}}") == "failed" );
+
+    // Not JSON.
+    CHECK( diff(delta, "{\"seq\":4,") == "failed" );
+    CHECK( diff(delta, "{\"seq\":4}}") == "failed" );
+
+    //-------------------------------------------------------------------------
+    // Keys with '/' or '~' are escaped in paths.
+    //
+    delta.set_keyframe("{\"a/b\":{\"c~d\":1}}");
+    CHECK( diff(delta, "{\"a/b\":{\"c~d\":2}}") == "{\"/a~1b/c~0d\":2}" );
+
+    //-------------------------------------------------------------------------
+    // Cleared, or a keyframe that isn't JSON, diffs nothing.
+    //
+    delta.clear();
+    CHECK( diff(delta, "{\"a/b\":{\"c~d\":2}}") == "failed" );
+
+    delta.set_keyframe("{\"seq\":");
+    CHECK( delta.has_keyframe() == false );
+    CHECK( diff(delta, "{\"seq\":1}") == "failed" );
+}
@@ -0,0 +1,278 @@
+#include <common/JsonWriter.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace pycontrol
+{
+
+
+JsonWriter::
+JsonWriter(std::size_t capacity)
+:
+    _buffer(std::max<std::size_t>(capacity, 64), '\0')
+{
+}
+
+
+void
+JsonWriter::
+clear()
+{
+    _size = 0;
+    _has_items = 0;
+    _depth = 0;
+    _after_key = false;
+    _buffer[0] = '\0';
+}
+
+
+JsonWriter &
+JsonWriter::
+begin_object()
+{
+    _open('{');
+    return *this;
+}
+
+
+JsonWriter &
+JsonWriter::
+end_object()
+{
+    _close('}');
+    return *this;
+}
+
+
+JsonWriter &
+JsonWriter::
+begin_array()
+{
+    _open('[');
+    return *this;
+}
+
+
+JsonWriter &
+JsonWriter::
+end_array()
+{
+    _close(']');
+    return *this;
+}
+
+
+JsonWriter &
+JsonWriter::
+key(std::string_view name)
+{
+    auto * out = _begin(name.size() * MAX_ESCAPED + 3);
+    *out++ = '"';
+    out = _escape(name, out);
+    *out++ = '"';
+    *out++ = ':';
+    _commit(out);
+    _after_key = true;
+    return *this;
+}
+
+
+JsonWriter &
+JsonWriter::
+value(std::string_view text)
+{
+    auto * out = _begin(text.size() * MAX_ESCAPED + 2);
+    *out++ = '"';
+    out = _escape(text, out);
+    *out++ = '"';
+    _commit(out);
+    return *this;
+}
+
+
+JsonWriter &
+JsonWriter::
+value(bool b)
+{
+    return raw(b ? "true" : "false");
+}
+
+
+JsonWriter &
+JsonWriter::
+value(float number)
+{
+    if (not std::isfinite(number))
+    {
+        return raw("null");
+    }
+    auto * out = _begin(MAX_NUMBER);
+    _commit(std::to_chars(out, out + MAX_NUMBER, number).ptr);
+    return *this;
+}
+
+
+JsonWriter &
+JsonWriter::
+value(double number)
+{
+    if (not std::isfinite(number))
+    {
+        return raw("null");
+    }
+    auto * out = _begin(MAX_NUMBER);
+    _commit(std::to_chars(out, out + MAX_NUMBER, number).ptr);
+    return *this;
+}
+
+
+JsonWriter &
+JsonWriter::
+begin_string()
+{
+    auto * out = _begin(1);
+    *out++ = '"';
+    _commit(out);
+    return *this;
+}
+
+
+JsonWriter &
+JsonWriter::
+append(std::string_view text)
+{
+    _commit(_escape(text, _reserve(text.size() * MAX_ESCAPED)));
+    return *this;
+}
+
+
+JsonWriter &
+JsonWriter::
+end_string()
+{
+    auto * out = _reserve(1);
+    *out++ = '"';
+    _commit(out);
+    return *this;
+}
+
+
+JsonWriter &
+JsonWriter::
+raw(std::string_view json)
+{
+    auto * out = _begin(json.size());
+    _commit(std::copy(json.begin(), json.end(), out));
+    return *this;
+}
+
+
+char *
+JsonWriter::
+_begin(std::size_t count)
+{
+    // Room for a comma as well.
+    auto * out = _reserve(count + 1);
+
+    // A member's value follows its key directly.
+    if (_after_key)
+    {
+        _after_key = false;
+        return out;
+    }
+
+    if (_depth > 0)
+    {
+        const auto bit = std::uint64_t{1} << (_depth - 1);
+        if (_has_items & bit)
+        {
+            *out++ = ',';
+        }
+        _has_items |= bit;
+    }
+
+    return out;
+}
+
+
+void
+JsonWriter::
+_open(char bracket)
+{
+    auto * out = _begin(1);
+    *out++ = bracket;
+    _commit(out);
+
+    ++_depth;
+    _has_items &= ~(std::uint64_t{1} << (_depth - 1));
+}
+
+
+void
+JsonWriter::
+_close(char bracket)
+{
+    auto * out = _reserve(1);
+    *out++ = bracket;
+    _commit(out);
+
+    --_depth;
+}
+
+
+void
+JsonWriter::
+_grow(std::size_t needed)
+{
+    _buffer.resize(std::max(needed, _buffer.size() * 2), '\0');
+}
+
+
+char *
+JsonWriter::
+_escape(std::string_view text, char * out)
+{
+    constexpr char hex[] = "0123456789abcdef";
+
+    // Copies runs of plain chars in one go, most strings have nothing to
+    // escape.
+    const auto * run = text.data();
+    const auto * end = text.data() + text.size();
+    for (const auto * pos = run; pos != end; ++pos)
+    {
+        const auto u = static_cast<unsigned char>(*pos);
+        if (u >= 0x20 and u != '"' and u != '\\')
+        {
+            continue;
+        }
+
+        out = std::copy(run, pos, out);
+        run = pos + 1;
+
+        *out++ = '\\';
+        switch (u)
+        {
+            case '"':  *out++ = '"';  break;
+            case '\\': *out++ = '\\'; break;
+            case '\b': *out++ = 'b';  break;
+            case '\f': *out++ = 'f';  break;
+            case '\n': *out++ = 'n';  break;
+            case '\r': *out++ = 'r';  break;
+            case '\t': *out++ = 't';  break;
+            default:
+            {
+                *out++ = 'u';
+                *out++ = '0';
+                *out++ = '0';
+                *out++ = hex[u >> 4];
+                *out++ = hex[u & 0xf];
+            }
+        }
+    }
+
+    return std::copy(run, end, out);
+}
+
+
+} /* namespace pycontrol */
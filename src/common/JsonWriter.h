@@ -0,0 +1,149 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace pycontrol
+{
+
+
+//-----------------------------------------------------------------------------
+// Writes JSON into a buffer that's reused from message to message.
+//
+// Commas between members and elements are written as needed, strings are
+// escaped and numbers are formatted with std::to_chars.  The buffer only grows,
+// doubling, when a message outgrows it, so once warmed up writing a message
+// never allocates.  Containers nest at most 64 deep.
+//
+//     json.clear();
+//     json.begin_object();
+//     json.key("time").value(1750627393194);
+//     json.key("ids").begin_array().value("z7").value("z8").end_array();
+//     json.end_object();
+//
+//     socket.send(json.str());
+//
+class JsonWriter
+{
+public:
+
+    explicit JsonWriter(std::size_t capacity = 4096);
+
+    // Starts the next message, keeping the buffer.
+    void clear();
+
+    JsonWriter & begin_object();
+    JsonWriter & end_object();
+    JsonWriter & begin_array();
+    JsonWriter & end_array();
+
+    // An object member's name, the next value or container is its value.
+    JsonWriter & key(std::string_view name);
+
+    JsonWriter & value(std::string_view text);
+    JsonWriter & value(const char * text) { return value(std::string_view(text)); }
+    JsonWriter & value(bool b);
+
+    // Shortest round trip representation, NaN and infinity are null.
+    JsonWriter & value(float number);
+    JsonWriter & value(double number);
+
+    template <typename T>
+        requires (std::is_integral_v<T> and not std::is_same_v<T, bool>)
+    JsonWriter & value(T number);
+
+    // A string value written in pieces, each escaped.
+    JsonWriter & begin_string();
+    JsonWriter & append(std::string_view text);
+    JsonWriter & end_string();
+
+    // Already serialized JSON, written as the next value as is.
+    JsonWriter & raw(std::string_view json);
+
+    // The whole buffer, NUL terminated after the message as UdpSocket::send()
+    // sends up to the first NUL.
+    const std::string & str() const { return _buffer; }
+
+    // Just the message.
+    std::string_view view() const { return {_buffer.data(), _size}; }
+
+    std::size_t size() const { return _size; }
+    std::size_t capacity() const { return _buffer.size(); }
+
+private:
+
+    JsonWriter(const JsonWriter & copy) = delete;
+    JsonWriter & operator=(const JsonWriter & rhs) = delete;
+
+    // Room for the longest number to_chars() writes, and for one char once
+    // escaped.
+    static constexpr std::size_t MAX_NUMBER = 32;
+    static constexpr std::size_t MAX_ESCAPED = 6;
+
+    // Makes room for count more chars and writes the comma the next member
+    // or element needs, returns where it goes.
+    char * _begin(std::size_t count);
+    void _open(char bracket);
+    void _close(char bracket);
+
+    // Room for count more chars and the NUL, returns where the next goes.
+    char * _reserve(std::size_t count);
+    void _grow(std::size_t needed);
+    void _commit(char * end);
+
+    static char * _escape(std::string_view text, char * out);
+
+    std::string   _buffer;
+    std::size_t   _size {0};
+
+    // A bit per open container, set once it has a member or element.
+    std::uint64_t _has_items {0};
+    std::size_t   _depth {0};
+    bool          _after_key {false};
+};
+
+
+//-----------------------------------------------------------------------------
+// Inline implementations.
+//-----------------------------------------------------------------------------
+template <typename T>
+    requires (std::is_integral_v<T> and not std::is_same_v<T, bool>)
+JsonWriter &
+JsonWriter::
+value(T number)
+{
+    auto * out = _begin(MAX_NUMBER);
+    _commit(std::to_chars(out, out + MAX_NUMBER, number).ptr);
+    return *this;
+}
+
+
+inline
+char *
+JsonWriter::
+_reserve(std::size_t count)
+{
+    const auto needed = _size + count + 1;
+    if (needed > _buffer.size())
+    {
+        _grow(needed);
+    }
+    return _buffer.data() + _size;
+}
+
+
+inline
+void
+JsonWriter::
+_commit(char * end)
+{
+    _size = static_cast<std::size_t>(end - _buffer.data());
+    *end = '\0';
+}
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,94 @@
+// Throughput and allocations per message of a telemetry sized JSON message,
+// written with JsonWriter and with the std::stringstream it replaces in
+// CameraControl::_send_telemetry().
+//
+//     make -C src/common bench && src/common/JsonWriter_bench_bin
+
+#include <common/JsonWriter.h>
+#include <common/telemetry_bench.h>
+
+#include <cstring>
+#include <sstream>
+
+
+// The replaced implementation, a stream rewound for each message.
+void
+write_stream(std::stringstream & out, const Fixture & f)
+{
+    out.seekp(0, std::ios::beg);
+
+    out << "{\"state\":\"" << f.state << "\",";
+    out << "\"time\":" << f.time << ",";
+    out << "\"command_response\":" << f.command_response << ",";
+    out << "\"detected_cameras\":[";
+    std::size_t idx = 0;
+    for (const auto & cam : f.cameras)
+    {
+        out << std::boolalpha
+            << "{\"connected\":" << true << ","
+            << "\"serial\":\"" << cam.serial << "\","
+            << "\"port\":\"" << cam.port << "\","
+            << "\"desc\":\"" << cam.desc << "\","
+            << "\"mode\":\"M\",\"shutter\":\"1/1000\",\"fstop\":\"f/8\",\"iso\":\"64\","
+            << "\"trigger_lateness_us\":{"
+            << "\"count\":" << cam.lateness[0] << ","
+            << "\"min\":" << cam.lateness[1] << ","
+            << "\"p50\":" << cam.lateness[2] << ","
+            << "\"p99\":" << cam.lateness[3] << ","
+            << "\"max\":" << cam.lateness[4] << "}}";
+        if (++idx < f.cameras.size()) out << ",";
+    }
+    out << "],\"sequence_state\":[";
+    idx = 0;
+    for (const auto & events : f.sequences)
+    {
+        out << "{\"events\":[";
+        for (const auto & event : events)
+        {
+            out << "{\"event_id\":\"" << event.event_id << "\","
+                << "\"event_time_offset\":\"" << convert_milliseconds_to_hms(event.offset_ms) << "\","
+                << "\"eta\":\"" << convert_milliseconds_to_hms(event.eta_ms) << "\","
+                << "\"channel\":\"" << event.channel << "\","
+                << "\"value\":\"" << event.value << "\"},";
+        }
+        out.seekp(out.tellp() - std::streamoff(1));
+        out << "]}";
+        if (++idx < f.sequences.size()) out << ",";
+    }
+    out << "],\"timelapse\":{\"histogram\":[";
+    const auto hist = f.histogram;
+    for (const auto h : hist)
+    {
+        out << h << ",";
+    }
+    out.seekp(-1, std::ios_base::cur);
+    out << "]}}" << '\0';
+    out.seekp(0, std::ios::beg);
+}
+
+
+int main()
+{
+    constexpr std::size_t count = 100'000;
+
+    const auto fixture = make_fixture();
+
+    std::stringstream stream(std::string(4096, '\0'));
+    report("stringstream", count, [&]()
+    {
+        write_stream(stream, fixture);
+
+        // As UdpSocket::send() got it.
+        const auto message = stream.str();
+        return std::strlen(message.c_str());
+    });
+
+    JsonWriter json;
+    report("JsonWriter", count, [&]()
+    {
+        write_telemetry(json, fixture);
+        return std::strlen(json.str().c_str());
+    });
+
+    return 0;
+}
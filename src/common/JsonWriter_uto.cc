@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <common/JsonWriter.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+using namespace pycontrol;
+
+
+TEST_CASE("JsonWriter", "[JsonWriter]")
+{
+    JsonWriter json;
+
+    //-------------------------------------------------------------------------
+    // Commas only between members and elements, however nested.
+    //
+    json.clear();
+    json.begin_object();
+    json.key("state").value("monitor");
+    json.key("time").value(std::int64_t{1750627393194});
+    json.key("empty").begin_object().end_object();
+    json.key("list").begin_array();
+    json.value(1).value(2);
+    json.begin_array().end_array();
+    json.begin_object().key("a").value(true).key("b").value(false).end_object();
+    json.end_array();
+    json.key("raw").raw("{\"last_accepted_id\":0}");
+    json.end_object();
+
+    CHECK( json.view() ==
+        "{\"state\":\"monitor\",\"time\":1750627393194,\"empty\":{},"
+        "\"list\":[1,2,[],{\"a\":true,\"b\":false}],"
+        "\"raw\":{\"last_accepted_id\":0}}" );
+
+    // NUL terminated for UdpSocket::send().
+    CHECK( std::strlen(json.str().c_str()) == json.size() );
+
+    //-------------------------------------------------------------------------
+    // Numbers.
+    //
+    json.clear();
+    json.begin_array();
+    json.value(std::numeric_limits<std::int64_t>::min());
+    json.value(std::numeric_limits<std::uint64_t>::max());
+    json.value(-7);
+    json.value(0.05f);
+    json.value(0.5);
+    json.value(std::nanf(""));
+    json.value(std::numeric_limits<double>::infinity());
+    json.end_array();
+
+    CHECK( json.view() ==
+        "[-9223372036854775808,18446744073709551615,-7,0.05,0.5,null,null]" );
+
+    //-------------------------------------------------------------------------
+    // Strings are escaped, keys too.
+    //
+    json.clear();
+    json.begin_object();
+    json.key("say \"hi\"").value("back\\slash\nnew line\ttab\x01");
+    json.key("channel").begin_string().append("z7").append(".").append("\"iso\"").end_string();
+    json.end_object();
+
+    CHECK( json.view() ==
+        "{\"say \\\"hi\\\"\":\"back\\\\slash\\nnew line\\ttab\\u0001\","
+        "\"channel\":\"z7.\\\"iso\\\"\"}" );
+
+    //-------------------------------------------------------------------------
+    // Grows when a message outgrows the buffer, then reuses it.
+    //
+    JsonWriter small(64);
+    const auto long_text = std::string(1000, 'x');
+
+    small.clear();
+    small.begin_array().value(long_text).value(long_text).end_array();
+
+    CHECK( small.size() == 2 * 1002 + 3 );
+    CHECK( small.capacity() > small.size() );
+    CHECK( small.view().substr(0, 5) == "[\"xxx" );
+    CHECK( small.view().substr(small.size() - 5) == "xxx\"]" );
+
+    const auto * buffer = small.str().data();
+    const auto capacity = small.capacity();
+    for (int i = 0; i < 100; ++i)
+    {
+        small.clear();
+        small.begin_array().value(long_text).value(long_text).end_array();
+    }
+    CHECK( small.str().data() == buffer );
+    CHECK( small.capacity() == capacity );
+
+    //-------------------------------------------------------------------------
+    // Cleared, starts over.
+    //
+    small.clear();
+    CHECK( small.view().empty() );
+    small.begin_object().key("a").value(1).end_object();
+    CHECK( small.view() == "{\"a\":1}" );
+}
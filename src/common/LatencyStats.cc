@@ -0,0 +1,79 @@
+#include <common/LatencyStats.h>
+
+#include <algorithm>
+
+namespace pycontrol
+{
+
+
+LatencyStats::
+LatencyStats(std::size_t window)
+:
+    _samples(std::max<std::size_t>(window, 1), 0),
+    _scratch(_samples.size(), 0)
+{
+}
+
+
+void
+LatencyStats::
+add(std::int64_t sample)
+{
+    _samples[_next] = sample;
+    _next = (_next + 1) % _samples.size();
+    ++_count;
+}
+
+
+void
+LatencyStats::
+reset()
+{
+    _next = 0;
+    _count = 0;
+}
+
+
+LatencyStats::Summary
+LatencyStats::
+summary() const
+{
+    Summary out;
+    out.count = _count;
+
+    const auto n = static_cast<std::size_t>(
+        std::min<std::uint64_t>(_count, _samples.size())
+    );
+
+    if (n == 0)
+    {
+        return out;
+    }
+
+    const auto first = _scratch.begin();
+    const auto last = first + n;
+
+    std::copy_n(_samples.begin(), n, first);
+
+    auto rank = [n](int percent)
+    {
+        return (n - 1) * percent / 100;
+    };
+
+    // Each nth_element leaves everything before the nth smaller, so the next,
+    // higher rank only has to search the rest.
+    auto p50 = first + rank(50);
+    std::nth_element(first, p50, last);
+    out.p50 = *p50;
+    out.min = *std::min_element(first, p50 + 1);
+
+    auto p99 = first + rank(99);
+    std::nth_element(p50, p99, last);
+    out.p99 = *p99;
+    out.max = *std::max_element(p99, last);
+
+    return out;
+}
+
+
+} /* namespace pycontrol */
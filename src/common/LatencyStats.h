@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pycontrol
+{
+
+
+//-----------------------------------------------------------------------------
+// Distribution of the most recent timing samples, e.g. how late triggers
+// fired.
+//
+// Keeps a fixed window of samples, older samples are overwritten.  All storage
+// is allocated by the constructor so add() and summary() are safe to call from
+// the control thread.
+//
+class LatencyStats
+{
+public:
+
+    struct Summary
+    {
+        std::uint64_t count {0};  // Samples ever added.
+        std::int64_t  min   {0};  // The rest are over the window.
+        std::int64_t  p50   {0};
+        std::int64_t  p99   {0};
+        std::int64_t  max   {0};
+    };
+
+    explicit LatencyStats(std::size_t window = 1024);
+
+    void add(std::int64_t sample);
+    void reset();
+
+    std::uint64_t count() const { return _count; }
+
+    // O(window), partially sorts a copy of the window.
+    Summary summary() const;
+
+private:
+
+    std::vector<std::int64_t>         _samples;
+    mutable std::vector<std::int64_t> _scratch;
+    std::size_t                       _next {0};
+    std::uint64_t                     _count {0};
+};
+
+
+} /* namespace pycontrol */
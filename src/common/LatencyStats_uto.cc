@@ -0,0 +1,51 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <common/LatencyStats.h>
+
+using namespace pycontrol;
+
+
+TEST_CASE("LatencyStats", "[LatencyStats]")
+{
+    LatencyStats stats(100);
+
+    auto s = stats.summary();
+    CHECK( s.count == 0 );
+    CHECK( s.min == 0 );
+    CHECK( s.p50 == 0 );
+    CHECK( s.p99 == 0 );
+    CHECK( s.max == 0 );
+
+    stats.add(-5);
+    s = stats.summary();
+    CHECK( s.count == 1 );
+    CHECK( s.min == -5 );
+    CHECK( s.p50 == -5 );
+    CHECK( s.p99 == -5 );
+    CHECK( s.max == -5 );
+
+    // 1..100 in a scrambled order.
+    stats.reset();
+    for (int i = 0; i < 100; ++i)
+    {
+        stats.add((i * 37) % 100 + 1);
+    }
+    s = stats.summary();
+    CHECK( s.count == 100 );
+    CHECK( s.min == 1 );
+    CHECK( s.p50 == 50 );
+    CHECK( s.p99 == 99 );
+    CHECK( s.max == 100 );
+
+    // The window only holds the latest 100.
+    for (int i = 0; i < 100; ++i)
+    {
+        stats.add(1000 + i);
+    }
+    s = stats.summary();
+    CHECK( s.count == 200 );
+    CHECK( s.min == 1000 );
+    CHECK( s.p50 == 1049 );
+    CHECK( s.p99 == 1098 );
+    CHECK( s.max == 1099 );
+}
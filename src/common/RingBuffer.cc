@@ -0,0 +1,20 @@
+#include <common/RingBuffer.h>
+
+#include <bit>
+
+namespace pycontrol
+{
+
+
+std::size_t
+ring_capacity(std::size_t requested)
+{
+    if (requested < 2)
+    {
+        return 2;
+    }
+    return std::bit_ceil(requested);
+}
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,328 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace pycontrol
+{
+
+// Indices written by different threads live on their own cache line so the
+// producer and consumer don't false share.  Hardcoded as gcc warns about
+// std::hardware_destructive_interference_size not being ABI stable.
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+// Rounds the requested capacity up to a power of two, at least 2.
+std::size_t ring_capacity(std::size_t requested);
+
+
+//-----------------------------------------------------------------------------
+// Bounded single producer, single consumer ring.
+//
+// All storage is allocated by the constructor, push() and pop() never
+// allocate, never block and complete in a bounded number of steps (wait-free).
+// Values are moved in and out of pre-constructed slots, so T must be default
+// constructible and move assignable.
+//
+template <typename T>
+class SpscRing
+{
+public:
+
+    explicit SpscRing(std::size_t capacity);
+
+    // Producer side, returns false when full.
+    bool push(const T & value);
+    bool push(T && value);
+
+    // Consumer side, returns false when empty.
+    bool pop(T & out);
+
+    std::size_t capacity() const { return _mask + 1; }
+
+    // Exact only when called from the producer or consumer with the other
+    // side idle, otherwise a snapshot.
+    std::size_t size() const;
+    bool empty() const { return size() == 0; }
+
+private:
+
+    SpscRing(const SpscRing & copy) = delete;
+    SpscRing & operator=(const SpscRing & rhs) = delete;
+
+    template <typename U>
+    bool _push(U && value);
+
+    const std::size_t    _mask;
+    std::unique_ptr<T[]> _slots;
+
+    // Producer owned.
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> _tail {0};
+    std::size_t                                       _head_cache {0};
+
+    // Consumer owned.
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> _head {0};
+    std::size_t                                       _tail_cache {0};
+};
+
+
+//-----------------------------------------------------------------------------
+// Bounded multi producer, single consumer ring.
+//
+// Same storage rules as SpscRing.  Each slot carries a sequence number, see
+// Dmitry Vyukov's bounded MPMC queue.  pop() is wait-free, push() is lock-free:
+// a producer only retries when another producer claimed the same slot first.
+//
+template <typename T>
+class MpscRing
+{
+public:
+
+    explicit MpscRing(std::size_t capacity);
+
+    // Any thread, returns false when full.
+    bool push(const T & value);
+    bool push(T && value);
+
+    // Single consumer, returns false when empty.
+    bool pop(T & out);
+
+    std::size_t capacity() const { return _mask + 1; }
+    std::size_t size() const;
+    bool empty() const { return size() == 0; }
+
+private:
+
+    MpscRing(const MpscRing & copy) = delete;
+    MpscRing & operator=(const MpscRing & rhs) = delete;
+
+    template <typename U>
+    bool _push(U && value);
+
+    struct Slot
+    {
+        std::atomic<std::size_t> seq {0};
+        T                        value {};
+    };
+
+    const std::size_t       _mask;
+    std::unique_ptr<Slot[]> _slots;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> _tail {0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> _head {0};
+};
+
+
+//-----------------------------------------------------------------------------
+// SpscRing implementation.
+//
+template <typename T>
+SpscRing<T>::
+SpscRing(std::size_t capacity)
+:
+    _mask{ring_capacity(capacity) - 1},
+    _slots{std::make_unique<T[]>(_mask + 1)}
+{
+    static_assert(std::is_default_constructible_v<T>);
+    static_assert(std::is_move_assignable_v<T>);
+}
+
+
+template <typename T>
+bool
+SpscRing<T>::
+push(const T & value)
+{
+    return _push(value);
+}
+
+
+template <typename T>
+bool
+SpscRing<T>::
+push(T && value)
+{
+    return _push(std::move(value));
+}
+
+
+template <typename T>
+template <typename U>
+bool
+SpscRing<T>::
+_push(U && value)
+{
+    const auto tail = _tail.load(std::memory_order_relaxed);
+
+    // Only reload the consumer's index when the cached copy says full.
+    if (tail - _head_cache > _mask)
+    {
+        _head_cache = _head.load(std::memory_order_acquire);
+        if (tail - _head_cache > _mask)
+        {
+            return false;
+        }
+    }
+
+    _slots[tail & _mask] = std::forward<U>(value);
+    _tail.store(tail + 1, std::memory_order_release);
+
+    return true;
+}
+
+
+template <typename T>
+bool
+SpscRing<T>::
+pop(T & out)
+{
+    const auto head = _head.load(std::memory_order_relaxed);
+
+    // Only reload the producer's index when the cached copy says empty.
+    if (head == _tail_cache)
+    {
+        _tail_cache = _tail.load(std::memory_order_acquire);
+        if (head == _tail_cache)
+        {
+            return false;
+        }
+    }
+
+    out = std::move(_slots[head & _mask]);
+    _head.store(head + 1, std::memory_order_release);
+
+    return true;
+}
+
+
+template <typename T>
+std::size_t
+SpscRing<T>::
+size() const
+{
+    const auto head = _head.load(std::memory_order_acquire);
+    const auto tail = _tail.load(std::memory_order_acquire);
+    return tail - head;
+}
+
+
+//-----------------------------------------------------------------------------
+// MpscRing implementation.
+//
+template <typename T>
+MpscRing<T>::
+MpscRing(std::size_t capacity)
+:
+    _mask{ring_capacity(capacity) - 1},
+    _slots{std::make_unique<Slot[]>(_mask + 1)}
+{
+    static_assert(std::is_default_constructible_v<T>);
+    static_assert(std::is_move_assignable_v<T>);
+
+    for (std::size_t i = 0; i <= _mask; ++i)
+    {
+        _slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
+
+
+template <typename T>
+bool
+MpscRing<T>::
+push(const T & value)
+{
+    return _push(value);
+}
+
+
+template <typename T>
+bool
+MpscRing<T>::
+push(T && value)
+{
+    return _push(std::move(value));
+}
+
+
+template <typename T>
+template <typename U>
+bool
+MpscRing<T>::
+_push(U && value)
+{
+    auto tail = _tail.load(std::memory_order_relaxed);
+    Slot * slot = nullptr;
+
+    while (true)
+    {
+        slot = &_slots[tail & _mask];
+        const auto seq = slot->seq.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(tail);
+
+        // Slot is free, try to claim it.
+        if (diff == 0)
+        {
+            if (_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+
+        // Slot still holds an unconsumed value from the previous lap.
+        else if (diff < 0)
+        {
+            return false;
+        }
+
+        // Another producer got here first.
+        else
+        {
+            tail = _tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->value = std::forward<U>(value);
+    slot->seq.store(tail + 1, std::memory_order_release);
+
+    return true;
+}
+
+
+template <typename T>
+bool
+MpscRing<T>::
+pop(T & out)
+{
+    const auto head = _head.load(std::memory_order_relaxed);
+    auto & slot = _slots[head & _mask];
+
+    if (slot.seq.load(std::memory_order_acquire) != head + 1)
+    {
+        return false;
+    }
+
+    out = std::move(slot.value);
+
+    // Hand the slot back to the producers for the next lap.
+    slot.seq.store(head + _mask + 1, std::memory_order_release);
+    _head.store(head + 1, std::memory_order_release);
+
+    return true;
+}
+
+
+template <typename T>
+std::size_t
+MpscRing<T>::
+size() const
+{
+    const auto head = _head.load(std::memory_order_acquire);
+    const auto tail = _tail.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+}
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,190 @@
+// Throughput and latency microbenchmark for SpscRing and MpscRing, with a
+// std::mutex + std::deque queue as the baseline they replace.
+//
+//     make -C src/common bench && src/common/RingBuffer_bench_bin
+
+#include <common/RingBuffer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pycontrol;
+
+using steady = std::chrono::steady_clock;
+
+
+// Spins on op() and yields once it has spun a while, so the benchmark still
+// completes when the two threads share a core.
+template <typename Op>
+void
+spin(Op op)
+{
+    for (unsigned int i = 0; not op(); ++i)
+    {
+        if (i >= 256) std::this_thread::yield();
+    }
+}
+
+
+// Mutex protected queue with the same push/pop interface.
+template <typename T>
+class MutexQueue
+{
+public:
+    explicit MutexQueue(std::size_t capacity) : _capacity{capacity} {}
+
+    bool push(T value)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_queue.size() >= _capacity) return false;
+        _queue.push_back(std::move(value));
+        return true;
+    }
+
+    bool pop(T & out)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_queue.empty()) return false;
+        out = std::move(_queue.front());
+        _queue.pop_front();
+        return true;
+    }
+
+private:
+    const std::size_t _capacity;
+    std::mutex        _mutex;
+    std::deque<T>     _queue;
+};
+
+
+template <typename Queue>
+double
+throughput(std::size_t num_producers, std::uint64_t count_per_producer)
+{
+    Queue queue(1024);
+
+    const auto start = steady::now();
+
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < num_producers; ++p)
+    {
+        producers.emplace_back([&queue, count_per_producer]()
+        {
+            for (std::uint64_t i = 0; i < count_per_producer; ++i)
+            {
+                spin([&]() { return queue.push(i); });
+            }
+        });
+    }
+
+    const auto total = count_per_producer * num_producers;
+    std::uint64_t received = 0;
+    std::uint64_t value = 0;
+    while (received < total)
+    {
+        spin([&]() { return queue.pop(value); });
+        ++received;
+    }
+
+    for (auto & t : producers) t.join();
+
+    const std::chrono::duration<double> elapsed = steady::now() - start;
+
+    return static_cast<double>(total) / elapsed.count();
+}
+
+
+// Round trip time of one item bounced between two threads.
+template <typename Queue>
+std::vector<std::int64_t>
+round_trip(std::size_t samples)
+{
+    Queue ping(64);
+    Queue pong(64);
+
+    std::thread echo([&]()
+    {
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < samples; ++i)
+        {
+            spin([&]() { return ping.pop(value); });
+            spin([&]() { return pong.push(value); });
+        }
+    });
+
+    std::vector<std::int64_t> out;
+    out.reserve(samples);
+
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < samples; ++i)
+    {
+        const auto t0 = steady::now();
+        spin([&]() { return ping.push(i); });
+        spin([&]() { return pong.pop(value); });
+        const auto t1 = steady::now();
+        out.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+
+    echo.join();
+
+    std::sort(out.begin(), out.end());
+
+    return out;
+}
+
+
+void
+report_latency(const std::string & name, const std::vector<std::int64_t> & sorted)
+{
+    auto pct = [&sorted](double p)
+    {
+        return sorted[static_cast<std::size_t>(p * (sorted.size() - 1))];
+    };
+
+    std::cout << std::left << std::setw(22) << name << std::right
+              << " min " << std::setw(7) << sorted.front()
+              << " p50 " << std::setw(7) << pct(0.50)
+              << " p99 " << std::setw(7) << pct(0.99)
+              << " max " << std::setw(9) << sorted.back()
+              << " ns" << std::endl;
+}
+
+
+void
+report_throughput(const std::string & name, double per_second)
+{
+    std::cout << std::left << std::setw(22) << name << std::right
+              << std::fixed << std::setprecision(1)
+              << std::setw(8) << per_second / 1e6 << " M items/s" << std::endl;
+}
+
+
+int main()
+{
+    constexpr std::uint64_t count = 5'000'000;
+    constexpr std::size_t samples = 200'000;
+
+    std::cout << "Throughput, 1 producer:" << std::endl;
+    report_throughput("  SpscRing", throughput<SpscRing<std::uint64_t>>(1, count));
+    report_throughput("  MpscRing", throughput<MpscRing<std::uint64_t>>(1, count));
+    report_throughput("  mutex + deque", throughput<MutexQueue<std::uint64_t>>(1, count));
+
+    std::cout << "Throughput, 4 producers:" << std::endl;
+    report_throughput("  MpscRing", throughput<MpscRing<std::uint64_t>>(4, count / 4));
+    report_throughput("  mutex + deque", throughput<MutexQueue<std::uint64_t>>(4, count / 4));
+
+    std::cout << "Round trip latency:" << std::endl;
+    report_latency("  SpscRing", round_trip<SpscRing<std::uint64_t>>(samples));
+    report_latency("  MpscRing", round_trip<MpscRing<std::uint64_t>>(samples));
+    report_latency("  mutex + deque", round_trip<MutexQueue<std::uint64_t>>(samples));
+
+    return 0;
+}
@@ -0,0 +1,200 @@
+#include <common/RingBuffer.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pycontrol;
+
+
+TEST_CASE("ring_capacity", "[RingBuffer]")
+{
+    CHECK( ring_capacity(0) == 2 );
+    CHECK( ring_capacity(1) == 2 );
+    CHECK( ring_capacity(2) == 2 );
+    CHECK( ring_capacity(3) == 4 );
+    CHECK( ring_capacity(16) == 16 );
+    CHECK( ring_capacity(17) == 32 );
+    CHECK( ring_capacity(1000) == 1024 );
+}
+
+
+TEST_CASE("SpscRing", "[RingBuffer][SpscRing]")
+{
+    SpscRing<int> ring(3);
+
+    CHECK( ring.capacity() == 4 );
+    CHECK( ring.empty() );
+
+    int value = -1;
+    CHECK_FALSE( ring.pop(value) );
+    CHECK( value == -1 );
+
+    //-------------------------------------------------------------------------
+    // Fill it up.
+    //
+    CHECK( ring.push(1) );
+    CHECK( ring.push(2) );
+    CHECK( ring.push(3) );
+    CHECK( ring.push(4) );
+    CHECK( ring.size() == 4 );
+    CHECK_FALSE( ring.push(5) );
+
+    //-------------------------------------------------------------------------
+    // FIFO order, wrapping around the end of the storage a few times.
+    //
+    int expected = 1;
+    int next = 5;
+    for (int i = 0; i < 10; ++i)
+    {
+        REQUIRE( ring.pop(value) );
+        CHECK( value == expected++ );
+        CHECK( ring.push(next++) );
+    }
+    while (ring.pop(value))
+    {
+        CHECK( value == expected++ );
+    }
+    CHECK( expected == next );
+    CHECK( ring.empty() );
+
+    //-------------------------------------------------------------------------
+    // Values are moved in and out.
+    //
+    SpscRing<std::unique_ptr<std::string>> ptr_ring(2);
+    auto ptr = std::make_unique<std::string>("camera");
+    CHECK( ptr_ring.push(std::move(ptr)) );
+    CHECK( ptr == nullptr );
+
+    std::unique_ptr<std::string> out;
+    REQUIRE( ptr_ring.pop(out) );
+    REQUIRE( out != nullptr );
+    CHECK( *out == "camera" );
+}
+
+
+TEST_CASE("SpscRing threads", "[RingBuffer][SpscRing]")
+{
+    constexpr std::uint64_t count = 1'000'000;
+
+    SpscRing<std::uint64_t> ring(64);
+
+    std::thread producer([&ring]()
+    {
+        for (std::uint64_t i = 0; i < count; ++i)
+        {
+            while (not ring.push(i))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::uint64_t expected = 0;
+    std::uint64_t num_out_of_order = 0;
+    while (expected < count)
+    {
+        std::uint64_t value;
+        if (ring.pop(value))
+        {
+            if (value != expected) ++num_out_of_order;
+            ++expected;
+        }
+    }
+    producer.join();
+
+    CHECK( num_out_of_order == 0 );
+    CHECK( ring.empty() );
+}
+
+
+TEST_CASE("MpscRing", "[RingBuffer][MpscRing]")
+{
+    MpscRing<std::string> ring(4);
+
+    CHECK( ring.capacity() == 4 );
+    CHECK( ring.empty() );
+
+    std::string value;
+    CHECK_FALSE( ring.pop(value) );
+
+    CHECK( ring.push("a") );
+    CHECK( ring.push("b") );
+    CHECK( ring.push("c") );
+    CHECK( ring.push("d") );
+    CHECK( ring.size() == 4 );
+    CHECK_FALSE( ring.push("e") );
+
+    for (const auto * expected : {"a", "b", "c", "d"})
+    {
+        REQUIRE( ring.pop(value) );
+        CHECK( value == expected );
+    }
+    CHECK_FALSE( ring.pop(value) );
+
+    // Slots are reusable after a full lap.
+    CHECK( ring.push("f") );
+    REQUIRE( ring.pop(value) );
+    CHECK( value == "f" );
+    CHECK( ring.empty() );
+}
+
+
+TEST_CASE("MpscRing threads", "[RingBuffer][MpscRing]")
+{
+    constexpr std::uint32_t num_producers = 4;
+    constexpr std::uint32_t count = 250'000;
+
+    struct Item
+    {
+        std::uint32_t producer {0};
+        std::uint32_t index {0};
+    };
+
+    MpscRing<Item> ring(128);
+
+    std::vector<std::thread> producers;
+    for (std::uint32_t p = 0; p < num_producers; ++p)
+    {
+        producers.emplace_back([&ring, p]()
+        {
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                while (not ring.push(Item{p, i}))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Each producer's items must arrive in the order they were pushed.
+    std::vector<std::uint32_t> next(num_producers, 0);
+    std::uint64_t num_out_of_order = 0;
+    std::uint64_t total = 0;
+    while (total < std::uint64_t{num_producers} * count)
+    {
+        Item item;
+        if (ring.pop(item))
+        {
+            if (item.index != next[item.producer]) ++num_out_of_order;
+            next[item.producer] = item.index + 1;
+            ++total;
+        }
+    }
+
+    for (auto & t : producers)
+    {
+        t.join();
+    }
+
+    CHECK( num_out_of_order == 0 );
+    for (std::uint32_t p = 0; p < num_producers; ++p)
+    {
+        CHECK( next[p] == count );
+    }
+    CHECK( ring.empty() );
+}
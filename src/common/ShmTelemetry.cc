@@ -0,0 +1,224 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string.h>
+
+#include <algorithm>
+#include <thread>
+
+#include <common/io.h>
+#include <common/ShmTelemetry.h>
+
+
+namespace pycontrol
+{
+
+
+namespace
+{
+    // Readers give up after this many snapshots written over while copying.
+    constexpr int MAX_READ_ATTEMPTS = 100;
+
+    std::int64_t
+    monotonic_ns()
+    {
+        ::timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        return std::int64_t(now.tv_sec) * 1'000'000'000 + now.tv_nsec;
+    }
+
+    char *
+    snapshot_of(ShmHeader * header)
+    {
+        return reinterpret_cast<char *>(header) + sizeof(ShmHeader);
+    }
+
+    const char *
+    snapshot_of(const ShmHeader * header)
+    {
+        return reinterpret_cast<const char *>(header) + sizeof(ShmHeader);
+    }
+}
+
+
+ShmPublisher::
+~ShmPublisher()
+{
+    if (_header)
+    {
+        ::munmap(_header, _length);
+    }
+}
+
+
+result
+ShmPublisher::
+open(const std::string & name, std::size_t capacity)
+{
+    ABORT_IF(_header, "ShmPublisher already open", result::failure);
+
+    const auto path = "/" + name;
+    const int fd = ::shm_open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    ABORT_IF(fd < 0, "shm_open(" << path << ") failed, errno: " << strerror(errno), result::failure);
+
+    const auto length = sizeof(ShmHeader) + capacity;
+    const auto res = ::ftruncate(fd, length);
+    if (res < 0)
+    {
+        ERROR_LOG << "ftruncate(" << path << ", " << length << ") failed, errno: "
+                  << strerror(errno) << std::endl;
+        ::close(fd);
+        return result::failure;
+    }
+
+    // The mapping keeps the memory, the fd isn't needed.
+    auto * mapped = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    ABORT_IF(mapped == MAP_FAILED, "mmap(" << path << ") failed, errno: " << strerror(errno), result::failure);
+
+    _header = static_cast<ShmHeader *>(mapped);
+    _length = length;
+
+    //-------------------------------------------------------------------------
+    // A previous run may have died mid publish, leaving seq odd.  Readers
+    // skip the torn snapshot until the next.
+    //
+    auto & header = *_header;
+    const auto seq = header.seq.load(std::memory_order_relaxed);
+    header.seq.store(seq + (seq & 1u), std::memory_order_relaxed);
+
+    std::copy(SHM_MAGIC.begin(), SHM_MAGIC.end(), header.magic);
+    header.version = SHM_VERSION;
+    header.capacity = capacity;
+
+    return result::success;
+}
+
+
+result
+ShmPublisher::
+publish(std::string_view snapshot)
+{
+    ABORT_IF_NOT(_header, "Must call open() first!", result::failure);
+    ABORT_IF(
+        snapshot.size() > _header->capacity,
+        "telemetry snapshot of " << snapshot.size() << " bytes doesn't fit in "
+        << _header->capacity,
+        result::failure
+    );
+
+    auto & header = *_header;
+    const auto seq = header.seq.load(std::memory_order_relaxed);
+
+    header.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::copy(snapshot.begin(), snapshot.end(), snapshot_of(_header));
+    header.size.store(snapshot.size(), std::memory_order_relaxed);
+    header.frame.fetch_add(1, std::memory_order_relaxed);
+    header.time_ns.store(monotonic_ns(), std::memory_order_relaxed);
+
+    header.seq.store(seq + 2, std::memory_order_release);
+
+    return result::success;
+}
+
+
+ShmReader::
+~ShmReader()
+{
+    if (_header)
+    {
+        ::munmap(const_cast<ShmHeader *>(_header), _length);
+    }
+}
+
+
+result
+ShmReader::
+open(const std::string & name)
+{
+    ABORT_IF(_header, "ShmReader already open", result::failure);
+
+    const auto path = "/" + name;
+    const int fd = ::shm_open(path.c_str(), O_RDONLY, 0);
+    ABORT_IF(fd < 0, "shm_open(" << path << ") failed, errno: " << strerror(errno), result::failure);
+
+    struct ::stat info;
+    const auto res = ::fstat(fd, &info);
+    if (res < 0 or std::size_t(info.st_size) < sizeof(ShmHeader))
+    {
+        ERROR_LOG << path << " is too small for telemetry" << std::endl;
+        ::close(fd);
+        return result::failure;
+    }
+
+    auto * mapped = ::mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    ABORT_IF(mapped == MAP_FAILED, "mmap(" << path << ") failed, errno: " << strerror(errno), result::failure);
+
+    const auto & header = *static_cast<const ShmHeader *>(mapped);
+    if (std::string_view(header.magic, 4) != SHM_MAGIC
+        or header.version != SHM_VERSION
+        or sizeof(ShmHeader) + header.capacity > std::size_t(info.st_size))
+    {
+        ERROR_LOG << path << " isn't version " << SHM_VERSION << " telemetry" << std::endl;
+        ::munmap(mapped, info.st_size);
+        return result::failure;
+    }
+
+    _header = &header;
+    _length = info.st_size;
+
+    return result::success;
+}
+
+
+bool
+ShmReader::
+read(std::string & out, std::uint64_t & frame, std::int64_t & time_ns) const
+{
+    if (not _header)
+    {
+        return false;
+    }
+
+    const auto & header = *_header;
+
+    for (int i = 0; i < MAX_READ_ATTEMPTS; ++i)
+    {
+        const auto seq = header.seq.load(std::memory_order_acquire);
+        if (seq == 0)
+        {
+            return false;
+        }
+
+        if (seq & 1u)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const auto size = std::min<std::uint64_t>(
+            header.size.load(std::memory_order_relaxed),
+            header.capacity
+        );
+        frame = header.frame.load(std::memory_order_relaxed);
+        time_ns = header.time_ns.load(std::memory_order_relaxed);
+        out.assign(snapshot_of(_header), size);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header.seq.load(std::memory_order_relaxed) == seq)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+} /* namespace pycontrol */
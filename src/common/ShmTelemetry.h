@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <common/RingBuffer.h>
+#include <common/types.h>
+
+namespace pycontrol
+{
+
+
+//-----------------------------------------------------------------------------
+// The latest telemetry in shared memory, for readers on the same host.
+//
+// A file in /dev/shm holds a header then room for one snapshot.  The header is
+// guarded by a seqlock: seq is odd while the publisher writes and bumped to
+// even after, so a reader copies the snapshot out and keeps it only if seq was
+// even and unchanged throughout.  Readers never block the publisher and always
+// get the newest snapshot, there is no backlog to drain.
+//
+//     offset  0  "PCTS"
+//     offset  4  u32 version
+//     offset  8  u64 capacity, the snapshot bytes after the header
+//     offset 64  u64 seq
+//     offset 72  u64 frame, snapshots published
+//     offset 80  u64 size, of this snapshot
+//     offset 88  i64 time_ns, CLOCK_MONOTONIC when published
+//     offset 128 the snapshot
+//
+// Native byte order, it never leaves the host.  webapp/telem_shm.py reads it.
+//
+inline constexpr std::string_view SHM_MAGIC = "PCTS";
+inline constexpr std::uint32_t SHM_VERSION = 1;
+inline constexpr std::size_t SHM_CAPACITY = 64 * 1024;
+
+struct ShmHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t capacity;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> seq;
+    std::atomic<std::uint64_t> frame;
+    std::atomic<std::uint64_t> size;
+    std::atomic<std::int64_t> time_ns;
+};
+
+static_assert(sizeof(ShmHeader) == 128, "the snapshot follows at offset 128");
+
+
+class ShmPublisher
+{
+public:
+
+    ShmPublisher() = default;
+    ~ShmPublisher();
+
+    // Creates or reuses /dev/shm/<name>.  Frames carry on from a previous run
+    // so readers don't mistake a restart for old news.
+    result open(const std::string & name, std::size_t capacity = SHM_CAPACITY);
+
+    bool is_open() const { return _header != nullptr; }
+
+    // Replaces the snapshot, fails only when it doesn't fit.
+    result publish(std::string_view snapshot);
+
+private:
+
+    ShmPublisher(const ShmPublisher & copy) = delete;
+    ShmPublisher & operator=(const ShmPublisher & rhs) = delete;
+
+    ShmHeader * _header {nullptr};
+    std::size_t _length {0};
+};
+
+
+class ShmReader
+{
+public:
+
+    ShmReader() = default;
+    ~ShmReader();
+
+    // Maps /dev/shm/<name>, fails when there's no publisher.
+    result open(const std::string & name);
+
+    bool is_open() const { return _header != nullptr; }
+
+    // Copies out the newest snapshot and its frame, false when nothing has
+    // been published yet or the publisher kept writing over it.
+    bool read(std::string & out, std::uint64_t & frame, std::int64_t & time_ns) const;
+
+private:
+
+    ShmReader(const ShmReader & copy) = delete;
+    ShmReader & operator=(const ShmReader & rhs) = delete;
+
+    const ShmHeader * _header {nullptr};
+    std::size_t _length {0};
+};
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,211 @@
+// A telemetry sized message from publisher to a reader on the same host, over
+// shared memory and over UDP frames on loopback.  Cost per message with both
+// sides on one thread, then latency from send to the reader having it with
+// the reader on its own thread and a message every millisecond.
+//
+//     make -C src/common bench && src/common/ShmTelemetry_bench_bin
+
+#include <common/JsonWriter.h>
+#include <common/LatencyStats.h>
+#include <common/ShmTelemetry.h>
+#include <common/UdpFrame.h>
+#include <common/UdpSocket.h>
+#include <common/telemetry_bench.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <thread>
+
+
+namespace
+{
+    std::int64_t
+    now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            steady::now().time_since_epoch()).count();
+    }
+
+    // A loopback socket on an ephemeral port, returns its port.
+    std::uint16_t
+    bind_loopback(int fd)
+    {
+        sockaddr_in addr {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+        ::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+
+        const int buffer = 4 * 1024 * 1024;
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+
+        const timeval timeout {1, 0};
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        socklen_t length = sizeof(addr);
+        ::getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &length);
+        return ::ntohs(addr.sin_port);
+    }
+
+    // Receives chunks until a frame is whole, returns its id, 0 on timeout.
+    std::uint32_t
+    recv_frame(int fd, std::string & datagram, std::string & frame)
+    {
+        while (true)
+        {
+            const auto bytes = ::recv(fd, datagram.data(), datagram.size(), 0);
+            FrameHeader header;
+            if (bytes <= 0 or not read_frame_header({datagram.data(), std::size_t(bytes)}, header))
+            {
+                return 0;
+            }
+            if (header.index == 0)
+            {
+                frame.clear();
+            }
+            frame.append(datagram.data() + FRAME_HEADER_SIZE, bytes - FRAME_HEADER_SIZE);
+            if (header.index + 1u == header.count)
+            {
+                return header.frame_id;
+            }
+        }
+    }
+
+    void
+    report_latency(const std::string & name, const LatencyStats & stats)
+    {
+        const auto s = stats.summary();
+        std::cout << std::left << std::setw(16) << name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(7) << s.count << " msgs "
+                  << std::setw(8) << s.p50 / 1e3 << " us p50 "
+                  << std::setw(8) << s.p99 / 1e3 << " us p99 "
+                  << std::setw(8) << s.max / 1e3 << " us max" << std::endl;
+    }
+}
+
+
+int main()
+{
+    constexpr std::size_t count = 20'000;
+    constexpr std::size_t latency_count = 2'000;
+
+    const auto fixture = make_fixture();
+
+    JsonWriter json;
+    write_telemetry(json, fixture);
+
+    const auto name = "pycontrol_bench_" + std::to_string(::getpid());
+
+    ShmPublisher publisher;
+    ShmReader reader;
+    if (publisher.open(name) != result::success or reader.open(name) != result::success)
+    {
+        return 1;
+    }
+
+    const int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    UdpSocket socket;
+    if (socket.init("127.0.0.1", bind_loopback(fd)) != result::success)
+    {
+        return 1;
+    }
+
+    //-------------------------------------------------------------------------
+    // Cost per message.
+    //
+    std::string snapshot;
+    std::uint64_t frame = 0;
+    std::int64_t time_ns = 0;
+
+    report("shm", count, [&]()
+    {
+        publisher.publish(json.view());
+        reader.read(snapshot, frame, time_ns);
+        return snapshot.size();
+    });
+
+    std::string datagram(MAX_DATAGRAM, '\0');
+    std::string received;
+
+    report("udp frames", count, [&]()
+    {
+        socket.send_frame(json.view());
+        recv_frame(fd, datagram, received);
+        return received.size();
+    });
+
+    //-------------------------------------------------------------------------
+    // Latency, the reader on its own thread.
+    //
+    std::vector<std::atomic<std::int64_t>> sent_ns(latency_count + 1);
+
+    const auto publish_every_ms = [&](auto send)
+    {
+        for (std::size_t i = 1; i <= latency_count; ++i)
+        {
+            sent_ns[i] = now_ns();
+            send();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+
+    LatencyStats shm_stats(latency_count);
+    {
+        std::uint64_t base = 0;
+        reader.read(snapshot, base, time_ns);
+
+        std::thread read_thread([&]()
+        {
+            // Polls, as a reader that wants every frame the moment it's out.
+            std::uint64_t last = base;
+            while (last < base + latency_count)
+            {
+                if (reader.read(snapshot, frame, time_ns) and frame != last)
+                {
+                    shm_stats.add(now_ns() - sent_ns[frame - base]);
+                    last = frame;
+                }
+            }
+        });
+
+        publish_every_ms([&]() { publisher.publish(json.view()); });
+        read_thread.join();
+    }
+
+    LatencyStats udp_stats(latency_count);
+    {
+        const std::uint32_t base = count + 10;
+
+        std::thread read_thread([&]()
+        {
+            while (true)
+            {
+                const auto id = recv_frame(fd, datagram, received);
+                if (id == 0)
+                {
+                    break;
+                }
+                udp_stats.add(now_ns() - sent_ns[id - base]);
+                if (id - base == latency_count)
+                {
+                    break;
+                }
+            }
+        });
+
+        publish_every_ms([&]() { socket.send_frame(json.view()); });
+        read_thread.join();
+    }
+
+    report_latency("shm", shm_stats);
+    report_latency("udp frames", udp_stats);
+
+    ::close(fd);
+    ::shm_unlink(("/" + name).c_str());
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <common/ShmTelemetry.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+using namespace pycontrol;
+
+
+TEST_CASE("ShmTelemetry", "[ShmTelemetry]")
+{
+    const auto name = "pycontrol_uto_" + std::to_string(::getpid());
+
+    std::string out;
+    std::uint64_t frame = 0;
+    std::int64_t time_ns = 0;
+
+    {
+        ShmReader reader;
+        CHECK( reader.open(name) == result::failure );
+        CHECK_FALSE( reader.is_open() );
+        CHECK_FALSE( reader.read(out, frame, time_ns) );
+    }
+
+    ShmPublisher publisher;
+    REQUIRE( publisher.open(name, 64) == result::success );
+
+    ShmReader reader;
+    REQUIRE( reader.open(name) == result::success );
+
+    // Nothing published yet.
+    CHECK_FALSE( reader.read(out, frame, time_ns) );
+
+    //-------------------------------------------------------------------------
+    // The newest snapshot, no backlog.
+    //
+    REQUIRE( publisher.publish(R"({"seq":1})") == result::success );
+    REQUIRE( publisher.publish(R"({"seq":2,"state":"monitor"})") == result::success );
+
+    REQUIRE( reader.read(out, frame, time_ns) );
+    CHECK( out == R"({"seq":2,"state":"monitor"})" );
+    CHECK( frame == 2 );
+    CHECK( time_ns > 0 );
+
+    CHECK( publisher.publish(std::string(65, 'x')) == result::failure );
+    REQUIRE( publisher.publish(std::string(64, 'x')) == result::success );
+    REQUIRE( reader.read(out, frame, time_ns) );
+    CHECK( out == std::string(64, 'x') );
+    CHECK( frame == 3 );
+
+    //-------------------------------------------------------------------------
+    // A restarted publisher carries on counting frames.
+    //
+    {
+        ShmPublisher restarted;
+        REQUIRE( restarted.open(name, 64) == result::success );
+        REQUIRE( restarted.publish("{}") == result::success );
+    }
+
+    REQUIRE( reader.read(out, frame, time_ns) );
+    CHECK( out == "{}" );
+    CHECK( frame == 4 );
+
+    //-------------------------------------------------------------------------
+    // Reading while publishing never sees a torn snapshot.
+    //
+    std::atomic<bool> done {false};
+    std::atomic<std::size_t> reads {0};
+    std::thread writer([&]()
+    {
+        for (std::size_t i = 0; reads < 1000 and i < 10'000'000; ++i)
+        {
+            // Frame 5 onwards, i + 5 repeated in a length that varies with it.
+            const auto text = std::to_string(i + 5);
+            std::string snapshot;
+            for (std::size_t n = 0; n < 1 + i % 7; ++n)
+            {
+                snapshot += text + ",";
+            }
+            publisher.publish(snapshot);
+        }
+        done = true;
+    });
+
+    std::size_t torn = 0;
+    while (not done)
+    {
+        if (not reader.read(out, frame, time_ns) or frame < 5)
+        {
+            continue;
+        }
+        ++reads;
+
+        const auto text = std::to_string(frame) + ",";
+        std::string expected;
+        for (std::size_t n = 0; n < 1 + (frame - 5) % 7; ++n)
+        {
+            expected += text;
+        }
+        torn += out != expected;
+    }
+    writer.join();
+
+    CHECK( reads > 0 );
+    CHECK( torn == 0 );
+
+    ::shm_unlink(("/" + name).c_str());
+}
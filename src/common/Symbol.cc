@@ -0,0 +1,92 @@
+#include <common/io.h>
+#include <common/Symbol.h>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace pycontrol
+{
+
+namespace
+{
+
+// Strings are stored in fixed size chunks that never move, so to_string()
+// reads them without the lock and a thread interning new strings never holds
+// up one only looking them up.
+constexpr std::uint32_t CHUNK_BITS = 10;
+constexpr std::uint32_t CHUNK_SIZE = 1u << CHUNK_BITS;
+constexpr std::uint32_t MAX_CHUNKS = 4096;
+
+struct SymbolTable
+{
+    std::atomic<std::string *> chunks[MAX_CHUNKS] {};
+    std::uint32_t size {0};
+    std::unordered_map<std::string_view, std::uint32_t> index {};
+    std::mutex mutex;
+
+    SymbolTable()
+    {
+        chunks[0].store(new std::string[CHUNK_SIZE], std::memory_order_release);
+        size = 1;
+        index.emplace(chunks[0].load()[0], 0);
+    }
+};
+
+SymbolTable &
+table()
+{
+    static SymbolTable instance;
+    return instance;
+}
+
+} /* namespace */
+
+
+Symbol
+intern(std::string_view str)
+{
+    auto & t = table();
+    std::lock_guard<std::mutex> lock(t.mutex);
+
+    const auto itor = t.index.find(str);
+    if (itor != t.index.end())
+    {
+        return Symbol{itor->second};
+    }
+
+    const auto id = t.size;
+    const auto chunk = id >> CHUNK_BITS;
+    if (chunk >= MAX_CHUNKS)
+    {
+        ERROR_LOG << "symbol table full, interning '" << str << "' as ''" << std::endl;
+        return Symbol{};
+    }
+
+    auto * strings = t.chunks[chunk].load(std::memory_order_relaxed);
+    if (not strings)
+    {
+        strings = new std::string[CHUNK_SIZE];
+        t.chunks[chunk].store(strings, std::memory_order_release);
+    }
+
+    auto & text = strings[id & (CHUNK_SIZE - 1)];
+    text = str;
+    t.index.emplace(text, id);
+    ++t.size;
+
+    return Symbol{id};
+}
+
+
+const std::string &
+to_string(Symbol sym)
+{
+    // Whoever handed us sym saw the string written.
+    const auto id = static_cast<std::uint32_t>(sym);
+    const auto * strings = table().chunks[id >> CHUNK_BITS].load(std::memory_order_acquire);
+    return strings[id & (CHUNK_SIZE - 1)];
+}
+
+
+} /* namespace pycontrol */
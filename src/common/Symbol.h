@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace pycontrol
+{
+
+
+//-----------------------------------------------------------------------------
+// A small integer handle for a string that repeats, e.g. an event or camera
+// id.
+//
+// Interned strings live for the life of the process, so a Symbol copies and
+// compares as an integer and to_string() never allocates.  Symbol{} is the
+// empty string.
+//
+enum class Symbol : std::uint32_t {};
+
+Symbol intern(std::string_view str);
+
+const std::string & to_string(Symbol sym);
+
+inline
+std::ostream & operator<<(std::ostream & out, Symbol sym)
+{
+    return out << to_string(sym);
+}
+
+
+} /* namespace pycontrol */
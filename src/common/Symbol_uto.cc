@@ -0,0 +1,63 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <common/Symbol.h>
+
+#include <sstream>
+#include <thread>
+
+using namespace pycontrol;
+
+
+TEST_CASE("Symbol", "[Symbol]")
+{
+    CHECK( intern("") == Symbol{} );
+    CHECK( to_string(Symbol{}).empty() );
+
+    const auto z7 = intern("z7");
+    const auto z8 = intern("z8");
+
+    CHECK( z7 != z8 );
+    CHECK( intern("z7") == z7 );
+    CHECK( intern(std::string("z8")) == z8 );
+
+    CHECK( to_string(z7) == "z7" );
+    CHECK( to_string(z8) == "z8" );
+
+    // The text doesn't move as more strings are interned.
+    const auto * text = &to_string(z7);
+    for (int i = 0; i < 1000; ++i)
+    {
+        intern("symbol_" + std::to_string(i));
+    }
+    CHECK( &to_string(z7) == text );
+    CHECK( to_string(intern("symbol_999")) == "symbol_999" );
+
+    std::ostringstream oss;
+    oss << z7 << "." << z8;
+    CHECK( oss.str() == "z7.z8" );
+}
+
+
+TEST_CASE("Symbol lookups while interning", "[Symbol]")
+{
+    const auto z7 = intern("z7");
+
+    std::thread writer([]
+    {
+        for (int i = 0; i < 5000; ++i)
+        {
+            intern("writer_" + std::to_string(i));
+        }
+    });
+
+    std::size_t length = 0;
+    for (int i = 0; i < 5000; ++i)
+    {
+        length += to_string(z7).size();
+    }
+
+    writer.join();
+
+    CHECK( length == 10000 );
+    CHECK( to_string(intern("writer_4999")) == "writer_4999" );
+}
@@ -0,0 +1,79 @@
+#include <common/Tokenizer.h>
+
+
+namespace pycontrol
+{
+
+
+namespace
+{
+    // As std::isspace() in the "C" locale.
+    constexpr bool
+    is_space(char c)
+    {
+        return c == ' ' or (c >= '\t' and c <= '\r');
+    }
+}
+
+
+void
+Tokenizer::
+_skip_space()
+{
+    while (_pos < _text.size() and is_space(_text[_pos]))
+    {
+        ++_pos;
+    }
+}
+
+
+bool
+Tokenizer::
+next(std::string_view & token)
+{
+    _skip_space();
+
+    const auto first = _pos;
+    while (_pos < _text.size() and not is_space(_text[_pos]))
+    {
+        ++_pos;
+    }
+
+    if (_pos == first)
+    {
+        return false;
+    }
+
+    token = _text.substr(first, _pos - first);
+    return true;
+}
+
+
+bool
+Tokenizer::
+rest(std::string_view & line)
+{
+    if (eof())
+    {
+        return false;
+    }
+
+    const auto first = _pos;
+    const auto newline = _text.find('\n', first);
+
+    if (newline == std::string_view::npos)
+    {
+        _pos = _text.size();
+        line = _text.substr(first);
+    }
+    else
+    {
+        _pos = newline + 1;
+        line = _text.substr(first, newline - first);
+    }
+
+    return true;
+}
+
+
+} /* namespace pycontrol */
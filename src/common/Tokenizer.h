@@ -0,0 +1,102 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+namespace pycontrol
+{
+
+
+//-----------------------------------------------------------------------------
+// Reads whitespace separated tokens and numbers out of a line of text the way
+// std::istringstream's >> does, without copying or allocating.  Tokens are
+// views into the text, numbers are read with std::from_chars().
+//
+//     Tokenizer tok("12 trigger 0123 2.5");
+//
+//     std::uint32_t id;
+//     std::string_view command;
+//     tok.next(id);          // 12
+//     tok.next(command);     // "trigger"
+//
+// Unlike >>, a failed read doesn't stop the reads after it, a negative number
+// isn't read into an unsigned one and nan or inf isn't a number.
+//
+class Tokenizer
+{
+public:
+
+    explicit Tokenizer(std::string_view text) : _text(text) {}
+
+    // The next token, false when there's none left.
+    bool next(std::string_view & token);
+
+    // A number at the start of the next token, anything after it in the
+    // token is left for the next read, as 12 then "abc" out of "12abc".
+    template <typename T>
+        requires (std::is_arithmetic_v<T> and not std::is_same_v<T, bool>)
+    bool next(T & number);
+
+    // The rest of the line after the last read, as std::getline() reads it,
+    // false when there's nothing left at all.
+    bool rest(std::string_view & line);
+
+    // Everything's been read, as std::istream::eof() after a read.
+    bool eof() const { return _pos == _text.size(); }
+
+private:
+
+    void _skip_space();
+
+    std::string_view _text;
+    std::size_t      _pos {0};
+};
+
+
+//-----------------------------------------------------------------------------
+// Inline implementations.
+//-----------------------------------------------------------------------------
+template <typename T>
+    requires (std::is_arithmetic_v<T> and not std::is_same_v<T, bool>)
+bool
+Tokenizer::
+next(T & number)
+{
+    _skip_space();
+
+    const char * first = _text.data() + _pos;
+    const char * last = _text.data() + _text.size();
+
+    // >> reads a leading '+', std::from_chars() doesn't.
+    if (first != last and *first == '+')
+    {
+        ++first;
+        if (first != last and *first == '-')
+        {
+            return false;
+        }
+    }
+
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        const char * digit = (first != last and *first == '-') ? first + 1 : first;
+        if (digit == last or not ((*digit >= '0' and *digit <= '9') or *digit == '.'))
+        {
+            return false;
+        }
+    }
+
+    const auto [end, error] = std::from_chars(first, last, number);
+    if (error != std::errc())
+    {
+        return false;
+    }
+
+    _pos = static_cast<std::size_t>(end - _text.data());
+    return true;
+}
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,149 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <common/Tokenizer.h>
+#include <common/types.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+using namespace pycontrol;
+
+
+TEST_CASE("Tokenizer", "[Tokenizer]")
+{
+    std::string_view token;
+
+    //-------------------------------------------------------------------------
+    // Tokens, any whitespace between them.
+    //
+    {
+        Tokenizer tok("  12 set_events\te1 4000\r\ne2  ");
+
+        std::uint32_t id = 0;
+        REQUIRE( tok.next(id) );
+        CHECK( id == 12 );
+
+        REQUIRE( tok.next(token) );
+        CHECK( token == "set_events" );
+        REQUIRE( tok.next(token) );
+        CHECK( token == "e1" );
+
+        milliseconds ms = 0;
+        REQUIRE( tok.next(ms) );
+        CHECK( ms == 4000 );
+
+        REQUIRE( tok.next(token) );
+        CHECK( token == "e2" );
+        CHECK_FALSE( tok.eof() );
+
+        CHECK_FALSE( tok.next(token) );
+        CHECK( tok.eof() );
+    }
+
+    //-------------------------------------------------------------------------
+    // Numbers, read as >> reads them.
+    //
+    {
+        Tokenizer tok("+7 -3 5.0 1/10 .5 -0.25 12abc");
+
+        int i = 0;
+        REQUIRE( tok.next(i) );
+        CHECK( i == 7 );
+        REQUIRE( tok.next(i) );
+        CHECK( i == -3 );
+
+        // The rest of the token is left for the next read.
+        REQUIRE( tok.next(i) );
+        CHECK( i == 5 );
+        REQUIRE( tok.next(token) );
+        CHECK( token == ".0" );
+
+        float f = 0.0f;
+        REQUIRE( tok.next(f) );
+        CHECK( f == 1.0f );
+        REQUIRE( tok.next(token) );
+        CHECK( token == "/10" );
+
+        REQUIRE( tok.next(f) );
+        CHECK( f == 0.5f );
+        REQUIRE( tok.next(f) );
+        CHECK( f == -0.25f );
+
+        std::uint32_t u = 0;
+        REQUIRE( tok.next(u) );
+        CHECK( u == 12 );
+        REQUIRE( tok.next(token) );
+        CHECK( token == "abc" );
+
+        CHECK_FALSE( tok.next(u) );
+    }
+
+    //-------------------------------------------------------------------------
+    // Not numbers.
+    //
+    {
+        for (const auto * text : {"abc", "", "  ", "+-1", "-", "99999999999"})
+        {
+            Tokenizer tok(text);
+            int i = 0;
+            CHECK_FALSE( tok.next(i) );
+        }
+
+        for (const auto * text : {"nan", "inf", "-inf", ".", "x1.0"})
+        {
+            Tokenizer tok(text);
+            float f = 0.0f;
+            CHECK_FALSE( tok.next(f) );
+        }
+
+        Tokenizer tok("-1");
+        std::uint32_t u = 0;
+        CHECK_FALSE( tok.next(u) );
+    }
+
+    //-------------------------------------------------------------------------
+    // The rest of the line, as std::getline() after >>.
+    //
+    {
+        const std::string text = "8 set_choice 0123 shutterspeed 1/10 s";
+
+        Tokenizer tok(text);
+        std::istringstream iss(text);
+
+        std::string a, b, c, d;
+        iss >> a >> b >> c >> d;
+        for (int i = 0; i < 4; ++i)
+        {
+            tok.next(token);
+        }
+
+        std::string_view line;
+        REQUIRE( tok.rest(line) );
+        REQUIRE( std::getline(iss, a) );
+        CHECK( line == a );
+        CHECK( line == " 1/10 s" );
+        CHECK( tok.eof() );
+
+        CHECK_FALSE( tok.rest(line) );
+    }
+    {
+        // Nothing after the last token isn't an empty line.
+        Tokenizer tok("8 set_choice 0123 shutterspeed");
+        for (int i = 0; i < 4; ++i)
+        {
+            tok.next(token);
+        }
+
+        std::string_view line;
+        CHECK_FALSE( tok.rest(line) );
+    }
+    {
+        Tokenizer tok("one\ntwo");
+        std::string_view line;
+        REQUIRE( tok.rest(line) );
+        CHECK( line == "one" );
+        REQUIRE( tok.rest(line) );
+        CHECK( line == "two" );
+    }
+}
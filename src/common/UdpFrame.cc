@@ -0,0 +1,73 @@
+#include <common/UdpFrame.h>
+
+#include <algorithm>
+
+
+namespace pycontrol
+{
+
+
+namespace
+{
+    char *
+    put(std::uint64_t number, std::size_t size, char * out)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            *out++ = static_cast<char>(number >> (8 * i));
+        }
+        return out;
+    }
+
+    std::uint64_t
+    get(const char * in, std::size_t size)
+    {
+        std::uint64_t number = 0;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            number |= std::uint64_t(static_cast<unsigned char>(in[i])) << (8 * i);
+        }
+        return number;
+    }
+}
+
+
+std::size_t
+frame_chunks(std::size_t size)
+{
+    const auto count = std::max<std::size_t>(1, (size + MAX_CHUNK - 1) / MAX_CHUNK);
+    return count <= MAX_CHUNKS ? count : 0;
+}
+
+
+void
+write_frame_header(const FrameHeader & header, char * out)
+{
+    out = std::copy(FRAME_MAGIC.begin(), FRAME_MAGIC.end(), out);
+    out = put(header.frame_id, 4, out);
+    out = put(header.index, 2, out);
+    out = put(header.count, 2, out);
+    put(header.size, 4, out);
+}
+
+
+bool
+read_frame_header(std::string_view datagram, FrameHeader & out)
+{
+    if (datagram.size() < FRAME_HEADER_SIZE or not datagram.starts_with(FRAME_MAGIC))
+    {
+        return false;
+    }
+
+    const auto * in = datagram.data() + FRAME_MAGIC.size();
+
+    out.frame_id = static_cast<std::uint32_t>(get(in, 4));
+    out.index = static_cast<std::uint16_t>(get(in + 4, 2));
+    out.count = static_cast<std::uint16_t>(get(in + 6, 2));
+    out.size = static_cast<std::uint32_t>(get(in + 8, 4));
+
+    return out.index < out.count;
+}
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace pycontrol
+{
+
+
+//-----------------------------------------------------------------------------
+// Telemetry framing.  A message, a frame, is sent as one or more chunks, each
+// a datagram that fits a 1500 byte MTU so nothing is fragmented or truncated
+// along the way.  A chunk is a header then its slice of the frame:
+//
+//     "PCTF"  u32 frame_id  u16 index  u16 count  u32 size  payload
+//
+// All little-endian.  frame_id counts up one per frame, index is the chunk's
+// place in the frame, count how many chunks it has and size its total bytes.
+// Every chunk but the last carries MAX_CHUNK bytes.  webapp/udp_socket.py puts
+// the frames back together.
+//
+inline constexpr std::string_view FRAME_MAGIC = "PCTF";
+inline constexpr std::size_t FRAME_HEADER_SIZE = 16;
+
+// 1500 less the 20 byte IPv4 and 8 byte UDP headers.
+inline constexpr std::size_t MAX_DATAGRAM = 1472;
+inline constexpr std::size_t MAX_CHUNK = MAX_DATAGRAM - FRAME_HEADER_SIZE;
+inline constexpr std::size_t MAX_CHUNKS = 0xffff;
+
+struct FrameHeader
+{
+    std::uint32_t frame_id {0};
+    std::uint16_t index {0};
+    std::uint16_t count {0};
+    std::uint32_t size {0};
+};
+
+// How many chunks a frame of size bytes is sent in, 0 when too big to send.
+std::size_t frame_chunks(std::size_t size);
+
+// Writes header to the FRAME_HEADER_SIZE bytes at out.
+void write_frame_header(const FrameHeader & header, char * out);
+
+// Reads the header a chunk starts with, false when datagram isn't a chunk.
+bool read_frame_header(std::string_view datagram, FrameHeader & out);
+
+
+} /* namespace pycontrol */
@@ -0,0 +1,110 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <common/UdpFrame.h>
+#include <common/UdpSocket.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+using namespace pycontrol;
+
+
+TEST_CASE("UdpFrame", "[UdpFrame]")
+{
+    //-------------------------------------------------------------------------
+    // Chunks per frame.
+    //
+    CHECK( MAX_CHUNK == 1456 );
+    CHECK( frame_chunks(1) == 1 );
+    CHECK( frame_chunks(MAX_CHUNK) == 1 );
+    CHECK( frame_chunks(MAX_CHUNK + 1) == 2 );
+    CHECK( frame_chunks(7615) == 6 );
+    CHECK( frame_chunks(MAX_CHUNK * MAX_CHUNKS) == MAX_CHUNKS );
+    CHECK( frame_chunks(MAX_CHUNK * MAX_CHUNKS + 1) == 0 );
+
+    //-------------------------------------------------------------------------
+    // Headers, little-endian.
+    //
+    std::string bytes(FRAME_HEADER_SIZE, '\0');
+    write_frame_header({.frame_id = 0x01020304, .index = 2, .count = 6, .size = 7615}, bytes.data());
+
+    CHECK( bytes == std::string("PCTF\x04\x03\x02\x01\x02\x00\x06\x00\xbf\x1d\x00\x00", 16) );
+
+    FrameHeader header;
+    REQUIRE( read_frame_header(bytes + "payload", header) );
+    CHECK( header.frame_id == 0x01020304 );
+    CHECK( header.index == 2 );
+    CHECK( header.count == 6 );
+    CHECK( header.size == 7615 );
+
+    CHECK_FALSE( read_frame_header(bytes.substr(0, 15), header) );
+    CHECK_FALSE( read_frame_header(R"({"state":"monitor","time":1750627393194})", header) );
+
+    write_frame_header({.frame_id = 1, .index = 6, .count = 6, .size = 7615}, bytes.data());
+    CHECK_FALSE( read_frame_header(bytes, header) );
+}
+
+
+TEST_CASE("UdpSocket::send_frame", "[UdpFrame]")
+{
+    // A socket on an ephemeral loopback port to catch the chunks.
+    const int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    REQUIRE( fd >= 0 );
+
+    sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+    REQUIRE( ::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0 );
+
+    socklen_t length = sizeof(addr);
+    REQUIRE( ::getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &length) == 0 );
+
+    UdpSocket socket;
+    REQUIRE( socket.init("127.0.0.1", ::ntohs(addr.sin_port)) == result::success );
+
+    std::string frame;
+    for (int i = 0; frame.size() < 2 * MAX_CHUNK + 100; ++i)
+    {
+        frame += std::to_string(i) + ",";
+    }
+
+    const auto receive = [&](std::size_t count, std::uint32_t frame_id)
+    {
+        std::string out;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::string datagram(2 * MAX_DATAGRAM, '\0');
+            const auto bytes = ::recv(fd, datagram.data(), datagram.size(), 0);
+            REQUIRE( bytes > 0 );
+            datagram.resize(bytes);
+
+            CHECK( datagram.size() <= MAX_DATAGRAM );
+
+            FrameHeader header;
+            REQUIRE( read_frame_header(datagram, header) );
+            CHECK( header.frame_id == frame_id );
+            CHECK( header.index == i );
+            CHECK( header.count == count );
+            CHECK( header.size == frame.size() );
+
+            out += datagram.substr(FRAME_HEADER_SIZE);
+        }
+        return out;
+    };
+
+    REQUIRE( socket.send_frame(frame) == result::success );
+    CHECK( receive(3, 1) == frame );
+
+    // Small frames are one chunk.
+    frame = R"({"state":"monitor"})";
+    REQUIRE( socket.send_frame(frame) == result::success );
+    CHECK( receive(1, 2) == frame );
+
+    CHECK( socket.send_frame("") == result::failure );
+
+    ::close(fd);
+}
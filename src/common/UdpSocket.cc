@@ -1,19 +1,23 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include <netinet/in.h>
-#include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <string.h>
 
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 #include <common/io.h>
 #include <common/str_utils.h>
+#include <common/UdpFrame.h>
 #include <common/UdpSocket.h>
 
 
@@ -21,6 +25,23 @@ namespace pycontrol
 {
 
 
+struct UdpSocket::FrameBatch
+{
+    std::vector<std::array<char, FRAME_HEADER_SIZE>> headers;
+    std::vector<::iovec> iovecs;
+    std::vector<::mmsghdr> messages;
+};
+
+
+struct UdpSocket::RecvBatch
+{
+    std::vector<std::array<char, RECV_SIZE>> buffers;
+    std::vector<std::array<char, CMSG_SPACE(sizeof(::timespec))>> controls;
+    std::vector<::iovec> iovecs;
+    std::vector<::mmsghdr> messages;
+};
+
+
 result
 UdpSocket::
 init(const std::string & ipv4, const std::uint16_t & port)
@@ -82,6 +103,15 @@ bind()
         return result::failure;
     }
 
+    // Datagrams are stamped with when the kernel received them, for how long
+    // they waited in the queue, see recv_all().
+    const int enable = 1;
+    if (::setsockopt(_socket_fd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) < 0)
+    {
+        ERROR_LOG << "setsockopt(SO_TIMESTAMPNS) failed on port: " << _port
+                  << ", errno: " << strerror(errno) << ", ignoring" << std::endl;
+    }
+
     _bound = true;
 
     return result::success;
@@ -92,24 +122,32 @@ result
 UdpSocket::
 send(const std::string & msg)
 {
-    const auto num_bytes = ::strlen(msg.data());
+    return send_binary(std::string_view(msg.data(), ::strlen(msg.data())));
+}
+
+
+result
+UdpSocket::
+send_binary(std::string_view msg)
+{
     ABORT_IF(
-        num_bytes == 0,
+        msg.empty(),
         "send(), refusing to send 0 bytes on port: " << _port,
         result::failure
     );
 
     const auto res = ::sendto(
         _socket_fd,
-        msg.c_str(),
-        num_bytes,
+        msg.data(),
+        msg.size(),
         0 /* flags */,
         reinterpret_cast<sockaddr *>(_sockaddr.get()),
         sizeof(sockaddr_in)
     );
 
+    // errno only means something when sendto() failed.
     ABORT_IF(
-        res < 0 or (errno != 0 and errno != EAGAIN),
+        res < 0 and errno != EAGAIN,
         "sendto() failed on port: " << _port << ", errno: " << strerror(errno),
         result::failure
     );
@@ -118,6 +156,91 @@ send(const std::string & msg)
 }
 
 
+result
+UdpSocket::
+send_frame(std::string_view msg)
+{
+    ABORT_IF(
+        msg.empty(),
+        "send_frame(), refusing to send 0 bytes on port: " << _port,
+        result::failure
+    );
+
+    const auto count = frame_chunks(msg.size());
+    ABORT_IF(
+        count == 0,
+        "send_frame(), " << msg.size() << " bytes is too big a frame on port: " << _port,
+        result::failure
+    );
+
+    if (not _batch)
+    {
+        _batch = std::make_shared<FrameBatch>();
+    }
+
+    auto & batch = *_batch;
+    batch.headers.resize(count);
+    batch.iovecs.resize(2 * count);
+    batch.messages.resize(count);
+
+    ++_frame_id;
+
+    //-------------------------------------------------------------------------
+    // Each chunk is its header and a slice of msg, gathered by the kernel so
+    // msg isn't copied.
+    //
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto header = FrameHeader {
+            .frame_id = _frame_id,
+            .index = static_cast<std::uint16_t>(i),
+            .count = static_cast<std::uint16_t>(count),
+            .size = static_cast<std::uint32_t>(msg.size())
+        };
+        write_frame_header(header, batch.headers[i].data());
+
+        const auto payload = msg.substr(i * MAX_CHUNK, MAX_CHUNK);
+
+        auto * iov = &batch.iovecs[2 * i];
+        iov[0] = {batch.headers[i].data(), FRAME_HEADER_SIZE};
+        iov[1] = {const_cast<char *>(payload.data()), payload.size()};
+
+        auto & message = batch.messages[i];
+        message = {};
+        message.msg_hdr.msg_name = _sockaddr.get();
+        message.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        message.msg_hdr.msg_iov = iov;
+        message.msg_hdr.msg_iovlen = 2;
+    }
+
+    //-------------------------------------------------------------------------
+    // One sendmmsg() normally sends them all, it returns early only if
+    // interrupted part way.
+    //
+    std::size_t sent = 0;
+    while (sent < count)
+    {
+        const auto res = ::sendmmsg(
+            _socket_fd,
+            batch.messages.data() + sent,
+            count - sent,
+            0 /* flags */
+        );
+
+        ABORT_IF(
+            res < 0 and errno != EINTR,
+            "sendmmsg() failed on port: " << _port << " after " << sent << " of "
+            << count << " chunks of frame " << _frame_id << ", errno: " << strerror(errno),
+            result::failure
+        );
+
+        sent += std::max(0, res);
+    }
+
+    return result::success;
+}
+
+
 result
 UdpSocket::
 recv(std::string & msg)
@@ -127,25 +250,15 @@ recv(std::string & msg)
     constexpr auto MAX_MSG_SIZE = 1024;
     msg.resize(MAX_MSG_SIZE);
 
-    // Try to peek at how many bytes are avialable for reading on the socket.
-    unsigned long bytes_available = 0;
-    const auto res = ::ioctl(_socket_fd, FIONREAD, &bytes_available);
-    if (res < 0 or bytes_available == 0)
-    {
-        // No message avialable, mark the buffer as empty and return.
-        msg.clear();
-        return result::success;
-    }
-
-    // Okay, a message is present.
     struct ::sockaddr_in client_addr;
     ::socklen_t sizeof_sockaddr_in = sizeof(::sockaddr_in);
 
+    // Doesn't block, an empty queue is EAGAIN.
     const auto bytes_read = ::recvfrom(
         _socket_fd,
         msg.data(),
         msg.size(),
-        0 /* flags */,
+        MSG_DONTWAIT,
         (struct sockaddr *)&client_addr,
         &sizeof_sockaddr_in
     );
@@ -157,9 +270,9 @@ recv(std::string & msg)
         result::failure
     );
 
-    if (bytes_read == 0)
+    if (bytes_read <= 0)
     {
-        // Got an empty packet or need to try again.
+        // No message avialable, or an empty packet.
         msg.clear();
     }
     else
@@ -171,4 +284,117 @@ recv(std::string & msg)
 }
 
 
+result
+UdpSocket::
+recv_all(std::vector<interface::Datagram> & out, std::size_t & count)
+{
+    ABORT_IF_NOT(_bound, "Must call bind() first!", result::failure);
+
+    count = 0;
+
+    if (not _recv_batch)
+    {
+        _recv_batch = std::make_shared<RecvBatch>();
+        auto & batch = *_recv_batch;
+        batch.buffers.resize(RECV_BATCH);
+        batch.controls.resize(RECV_BATCH);
+        batch.iovecs.resize(RECV_BATCH);
+        batch.messages.resize(RECV_BATCH);
+    }
+
+    auto & batch = *_recv_batch;
+
+    //-------------------------------------------------------------------------
+    // A batch at a time until the queue is empty, or MAX_RECV_ALL have been
+    // read so a flood can't hold up the control loop, the rest are read next
+    // time.
+    //
+    while (count < MAX_RECV_ALL)
+    {
+        for (std::size_t i = 0; i < RECV_BATCH; ++i)
+        {
+            batch.iovecs[i] = {batch.buffers[i].data(), batch.buffers[i].size()};
+
+            auto & message = batch.messages[i];
+            message = {};
+            message.msg_hdr.msg_iov = &batch.iovecs[i];
+            message.msg_hdr.msg_iovlen = 1;
+            message.msg_hdr.msg_control = batch.controls[i].data();
+            message.msg_hdr.msg_controllen = batch.controls[i].size();
+        }
+
+        const auto res = ::recvmmsg(
+            _socket_fd,
+            batch.messages.data(),
+            RECV_BATCH,
+            MSG_DONTWAIT,
+            nullptr /* timeout */
+        );
+
+        if (res < 0 and errno == EINTR)
+        {
+            continue;
+        }
+
+        if (res < 0 and (errno == EAGAIN or errno == EWOULDBLOCK))
+        {
+            break;
+        }
+
+        ABORT_IF(
+            res < 0,
+            "recvmmsg() failed on port: " << _port << ", errno: " << strerror(errno),
+            result::failure
+        );
+
+        for (int i = 0; i < res; ++i)
+        {
+            const auto & message = batch.messages[i];
+
+            if (message.msg_hdr.msg_flags & MSG_TRUNC)
+            {
+                ERROR_LOG << "dropped a datagram bigger than " << RECV_SIZE
+                          << " bytes on port: " << _port << std::endl;
+                continue;
+            }
+
+            if (message.msg_len == 0)
+            {
+                continue;
+            }
+
+            if (count == out.size())
+            {
+                out.emplace_back();
+            }
+
+            auto & datagram = out[count++];
+            datagram.data.assign(batch.buffers[i].data(), message.msg_len);
+            datagram.utc_ns = 0;
+
+            // The kernel's receive time, see bind().
+            for (auto * cmsg = CMSG_FIRSTHDR(&message.msg_hdr);
+                 cmsg != nullptr;
+                 cmsg = CMSG_NXTHDR(const_cast<::msghdr *>(&message.msg_hdr), cmsg))
+            {
+                if (cmsg->cmsg_level == SOL_SOCKET and cmsg->cmsg_type == SCM_TIMESTAMPNS)
+                {
+                    ::timespec received;
+                    ::memcpy(&received, CMSG_DATA(cmsg), sizeof(received));
+                    datagram.utc_ns = nanoseconds(received.tv_sec) * 1'000'000'000 + received.tv_nsec;
+                }
+            }
+        }
+
+        // The queue's empty.
+        if (res < static_cast<int>(RECV_BATCH))
+        {
+            break;
+        }
+    }
+
+    return result::success;
+}
+
+
 } /* namespace pycontrol */
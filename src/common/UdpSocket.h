@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <interface/UdpSocket.h>
 
@@ -25,8 +27,18 @@ public:
     result bind();
 
     result send(const std::string & msg) override;
+    result send_binary(std::string_view msg) override;
+    result send_frame(std::string_view msg) override;
     result recv(std::string & msg) override;
 
+    // With recvmmsg(), RECV_BATCH datagrams a call, the kernel's receive
+    // times from SO_TIMESTAMPNS.  Datagrams bigger than RECV_SIZE are dropped.
+    result recv_all(std::vector<interface::Datagram> & out, std::size_t & count) override;
+
+    static constexpr std::size_t RECV_SIZE = 4096;
+    static constexpr std::size_t RECV_BATCH = 32;
+    static constexpr std::size_t MAX_RECV_ALL = 8 * RECV_BATCH;
+
 private:
 
     explicit UdpSocket(const UdpSocket & copy) = delete;
@@ -34,10 +46,22 @@ private:
 
     using socketaddr_ptr = std::shared_ptr<sockaddr_in>;
 
+    // The chunk headers, iovecs and mmsghdrs send_frame() hands sendmmsg().
+    struct FrameBatch;
+    using frame_batch_ptr = std::shared_ptr<FrameBatch>;
+
+    // The buffers, iovecs and mmsghdrs recv_all() hands recvmmsg().
+    struct RecvBatch;
+    using recv_batch_ptr = std::shared_ptr<RecvBatch>;
+
     unsigned int _port {0};
     int _socket_fd { -1 };
     socketaddr_ptr _sockaddr {nullptr};
     bool _bound {false};
+
+    std::uint32_t _frame_id {0};
+    frame_batch_ptr _batch {nullptr};
+    recv_batch_ptr _recv_batch {nullptr};
 };
 
 
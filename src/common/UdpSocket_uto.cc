@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <common/UdpSocket.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+using namespace pycontrol;
+
+
+namespace
+{
+    // A free loopback port, from binding to an ephemeral one.
+    std::uint16_t
+    free_port()
+    {
+        const int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in addr {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+        ::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+
+        socklen_t length = sizeof(addr);
+        ::getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &length);
+        ::close(fd);
+        return ::ntohs(addr.sin_port);
+    }
+
+    nanoseconds
+    utc_ns()
+    {
+        ::timespec now;
+        ::clock_gettime(CLOCK_REALTIME, &now);
+        return nanoseconds(now.tv_sec) * 1'000'000'000 + now.tv_nsec;
+    }
+}
+
+
+TEST_CASE("UdpSocket::recv_all", "[UdpSocket]")
+{
+    const auto port = free_port();
+
+    UdpSocket receiver;
+    REQUIRE( receiver.init("127.0.0.1", port) == result::success );
+    REQUIRE( receiver.bind() == result::success );
+
+    UdpSocket sender;
+    REQUIRE( sender.init("127.0.0.1", port) == result::success );
+
+    std::vector<interface::Datagram> out;
+    std::size_t count = 99;
+
+    // Nothing queued doesn't block.
+    REQUIRE( receiver.recv_all(out, count) == result::success );
+    CHECK( count == 0 );
+
+    //-------------------------------------------------------------------------
+    // A burst, more than a batch, all of it in order.
+    //
+    const auto before_ns = utc_ns();
+
+    const std::size_t burst = UdpSocket::RECV_BATCH + 5;
+    for (std::size_t i = 1; i <= burst; ++i)
+    {
+        REQUIRE( sender.send(std::to_string(i) + " telem_keyframe") == result::success );
+    }
+
+    REQUIRE( receiver.recv_all(out, count) == result::success );
+    REQUIRE( count == burst );
+    REQUIRE( out.size() >= burst );
+
+    const auto after_ns = utc_ns();
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        CHECK( out[i].data == std::to_string(i + 1) + " telem_keyframe" );
+        CHECK( out[i].utc_ns >= before_ns - 1'000'000 );
+        CHECK( out[i].utc_ns <= after_ns + 1'000'000 );
+    }
+    CHECK( out[0].utc_ns <= out[count - 1].utc_ns );
+
+    // Drained.
+    REQUIRE( receiver.recv_all(out, count) == result::success );
+    CHECK( count == 0 );
+
+    //-------------------------------------------------------------------------
+    // Too big is dropped, the rest still come through.
+    //
+    REQUIRE( sender.send(std::string(UdpSocket::RECV_SIZE + 1, 'x')) == result::success );
+    REQUIRE( sender.send("1 trigger 0123") == result::success );
+
+    REQUIRE( receiver.recv_all(out, count) == result::success );
+    REQUIRE( count == 1 );
+    CHECK( out[0].data == "1 trigger 0123" );
+
+    //-------------------------------------------------------------------------
+    // recv() one at a time.
+    //
+    REQUIRE( sender.send("2 trigger 0123") == result::success );
+
+    std::string msg;
+    REQUIRE( receiver.recv(msg) == result::success );
+    CHECK( msg == "2 trigger 0123" );
+    REQUIRE( receiver.recv(msg) == result::success );
+    CHECK( msg.empty() );
+}
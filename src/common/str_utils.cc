@@ -1,10 +1,13 @@
 #include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 
 #include <common/io.h>
@@ -125,6 +128,16 @@ void strip(std::string &str, char tok)
     rstrip(str, tok);
 }
 
+std::string_view stripped(std::string_view str, char tok)
+{
+    const auto first = str.find_first_not_of(tok);
+    if (first == std::string_view::npos)
+    {
+        return {};
+    }
+    return str.substr(first, str.find_last_not_of(tok) - first + 1);
+}
+
 std::ostream & operator<<(std::ostream & out, const kv_pair_vec & rhs)
 {
     out << "[{";
@@ -240,8 +253,8 @@ convert_hms_to_milliseconds(
 }
 
 
-std::string
-convert_milliseconds_to_hms(const milliseconds & total_milliseconds)
+std::size_t
+format_milliseconds_as_hms(const milliseconds & total_milliseconds, char * out)
 {
     auto total_ms = total_milliseconds;
 
@@ -265,29 +278,47 @@ convert_milliseconds_to_hms(const milliseconds & total_milliseconds)
 
     total_ms -= seconds * 1'000;
 
-    std::stringstream ss;
-    ss << std::setfill('0');
+    auto * pos = out;
 
-    if (is_negative)
-    {
-        ss << "-";
-    }
-    else
-    {
-        ss << " ";
-    }
+    *pos++ = is_negative ? '-' : ' ';
 
     if (days != 0)
     {
-        ss << days << " days ";
+        pos = std::to_chars(pos, out + HMS_SIZE, days).ptr;
+        for (const char c : std::string_view(" days "))
+        {
+            *pos++ = c;
+        }
     }
 
-    ss << std::setw(2) << hours << ":"
-       << std::setw(2) << minutes << ":"
-       << std::setw(2) << seconds << "."
-       << std::setw(3) << total_ms;
+    // Zero padded to width digits.
+    auto put = [&pos](milliseconds value, int width)
+    {
+        for (int i = width - 1; i >= 0; --i)
+        {
+            pos[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        pos += width;
+    };
+
+    put(hours, 2);
+    *pos++ = ':';
+    put(minutes, 2);
+    *pos++ = ':';
+    put(seconds, 2);
+    *pos++ = '.';
+    put(total_ms, 3);
+
+    return static_cast<std::size_t>(pos - out);
+}
+
 
-    return ss.str();
+std::string
+convert_milliseconds_to_hms(const milliseconds & total_milliseconds)
+{
+    char hms[HMS_SIZE];
+    return std::string(hms, format_milliseconds_as_hms(total_milliseconds, hms));
 }
 
 
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <common/io.h>
@@ -17,6 +18,9 @@ void lstrip(std::string &str, char tok);
 void rstrip(std::string &str, char tok);
 void strip(std::string &str, char tok);
 
+// The same without copying, a view of str less leading and trailing toks.
+std::string_view stripped(std::string_view str, char tok);
+
 std::ostream & operator<<(std::ostream & out, const kv_pair_vec & rhs);
 std::ostream & operator<<(std::ostream & out, const str_vec & rhs);
 
@@ -34,6 +38,13 @@ convert_hms_to_milliseconds(
 std::string
 convert_milliseconds_to_hms(const milliseconds & total_milliseconds);
 
+// The same without allocating, writes at most HMS_SIZE chars to out and returns
+// how many.
+constexpr std::size_t HMS_SIZE = 32;
+
+std::size_t
+format_milliseconds_as_hms(const milliseconds & total_milliseconds, char * out);
+
 //-----------------------------------------------------------------------------
 // Inline implementations.
 //-----------------------------------------------------------------------------
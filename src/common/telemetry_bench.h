@@ -0,0 +1,199 @@
+#pragma once
+
+// What the telemetry benchmarks share: a telemetry sized message, written with
+// any of the writers, and a report of throughput and allocations per message.
+// Only include it from a benchmark's main(), it replaces operator new.
+
+#include <common/str_utils.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace pycontrol;
+
+using steady = std::chrono::steady_clock;
+
+
+//-----------------------------------------------------------------------------
+// Counts every heap allocation in the process.  gcc can't tell the replaced
+// operator new is malloc() underneath.
+//
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+std::atomic<std::uint64_t> g_allocations {0};
+
+void *
+operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto * ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void * ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void * ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+
+//-----------------------------------------------------------------------------
+// What a busy rig reports, 4 cameras each with 10 upcoming events, and a
+// timelapse histogram.
+//
+struct Camera
+{
+    std::string serial;
+    std::string port;
+    std::string desc;
+    std::int64_t lateness[5];
+};
+
+struct Event
+{
+    std::string event_id;
+    milliseconds offset_ms;
+    milliseconds eta_ms;
+    std::string channel;
+    std::string value;
+};
+
+struct Fixture
+{
+    std::string state = "executing";
+    milliseconds time = 1750627393194;
+    std::string command_response = "{\"last_accepted_id\":12,\"last_rejected_id\":0,\"message\":\"\"}";
+    std::vector<Camera> cameras;
+    std::vector<std::vector<Event>> sequences;
+    std::vector<std::uint64_t> histogram = std::vector<std::uint64_t>(256, 12345);
+};
+
+Fixture
+make_fixture()
+{
+    Fixture out;
+    for (int i = 0; i < 4; ++i)
+    {
+        const auto n = std::to_string(i + 1);
+        out.cameras.push_back({"300651" + n, "usb:001,00" + n, "Nikon Corporation Z 7 #" + n, {12, 30, 41, 90, 120}});
+
+        std::vector<Event> events;
+        for (int j = 0; j < 10; ++j)
+        {
+            events.push_back({"c2", -60'000 + j * 500, 3'600'000 + j * 500, "z7_" + n + ".shutter_speed", "1/1000"});
+        }
+        out.sequences.push_back(events);
+    }
+    return out;
+}
+
+
+// Either writer, they share their calls.
+template <typename Writer>
+void
+write_telemetry(Writer & out, const Fixture & f)
+{
+    out.clear();
+    out.begin_object();
+    out.key("state").value(f.state);
+    out.key("time").value(f.time);
+    out.key("command_response").raw(f.command_response);
+    out.key("detected_cameras").begin_array();
+    for (const auto & cam : f.cameras)
+    {
+        out.begin_object();
+        out.key("connected").value(true);
+        out.key("serial").value(cam.serial);
+        out.key("port").value(cam.port);
+        out.key("desc").value(cam.desc);
+        out.key("mode").value("M");
+        out.key("shutter").value("1/1000");
+        out.key("fstop").value("f/8");
+        out.key("iso").value("64");
+        out.key("trigger_lateness_us").begin_object();
+        out.key("count").value(cam.lateness[0]);
+        out.key("min").value(cam.lateness[1]);
+        out.key("p50").value(cam.lateness[2]);
+        out.key("p99").value(cam.lateness[3]);
+        out.key("max").value(cam.lateness[4]);
+        out.end_object();
+        out.end_object();
+    }
+    out.end_array();
+    out.key("sequence_state").begin_array();
+    for (const auto & events : f.sequences)
+    {
+        out.begin_object();
+        out.key("events").begin_array();
+        for (const auto & event : events)
+        {
+            char hms[HMS_SIZE];
+            out.begin_object();
+            out.key("event_id").value(event.event_id);
+            out.key("event_time_offset").value(std::string_view(hms, format_milliseconds_as_hms(event.offset_ms, hms)));
+            out.key("eta").value(std::string_view(hms, format_milliseconds_as_hms(event.eta_ms, hms)));
+            out.key("channel").value(event.channel);
+            out.key("value").value(event.value);
+            out.end_object();
+        }
+        out.end_array();
+        out.end_object();
+    }
+    out.end_array();
+    out.key("timelapse").begin_object();
+    out.key("histogram").begin_array();
+    for (const auto h : f.histogram)
+    {
+        out.value(h);
+    }
+    out.end_array();
+    out.end_object();
+    out.end_object();
+}
+
+
+template <typename Write>
+void
+report(const std::string & name, std::size_t count, Write write)
+{
+    // Warm up, buffers grow to size.
+    std::size_t bytes = 0;
+    for (int i = 0; i < 10; ++i)
+    {
+        bytes = write();
+    }
+
+    const auto allocations = g_allocations.load();
+    const auto start = steady::now();
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        bytes = write();
+    }
+
+    const std::chrono::duration<double> elapsed = steady::now() - start;
+    const auto per_message = static_cast<double>(g_allocations.load() - allocations) / count;
+
+    std::cout << std::left << std::setw(16) << name << std::right
+              << std::fixed << std::setprecision(1)
+              << std::setw(7) << bytes << " bytes "
+              << std::setw(8) << static_cast<double>(bytes * count) / elapsed.count() / 1e6 << " MB/s "
+              << std::setw(7) << elapsed.count() / count * 1e6 << " us/msg "
+              << std::setw(7) << per_message << " allocations/msg" << std::endl;
+}
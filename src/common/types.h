@@ -16,6 +16,7 @@ using Serial = std::string;
 using CamId = std::string;
 using UsbPort = std::string;
 using milliseconds = std::int64_t;
+using nanoseconds = std::int64_t;
 
 constexpr milliseconds MAX_TIME = std::numeric_limits<milliseconds>::max();
 
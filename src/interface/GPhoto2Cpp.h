@@ -65,6 +65,13 @@ public:
     bool
     read_config(const gphoto2cpp::camera_ptr & camera) = 0;
 
+    // Only refreshes the properties listed.
+    virtual
+    bool
+    read_config(
+        const gphoto2cpp::camera_ptr & camera,
+        const std::vector<std::string> & properties) = 0;
+
     virtual
     bool
     read_property(
@@ -84,6 +91,13 @@ public:
     bool
     write_config(gphoto2cpp::camera_ptr & camera) = 0;
 
+    // Only sends the properties listed, if they changed.
+    virtual
+    bool
+    write_config(
+        gphoto2cpp::camera_ptr & camera,
+        const std::vector<std::string> & properties) = 0;
+
     virtual
     bool
     write_property(
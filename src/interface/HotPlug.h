@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+
+#include <common/types.h>
+
+namespace pycontrol
+{
+namespace interface
+{
+
+
+// USB cameras plugged in or unplugged, as the kernel reports them.
+class HotPlug
+{
+public:
+    virtual ~HotPlug() = default;
+
+    struct Event
+    {
+        enum class Type {add, remove};
+
+        Type    type {Type::add};
+        UsbPort port {};        // As libgphoto2 names it, "usb:BUS,DEV".
+    };
+
+    // Never blocks, appends the events since the last call to out.
+    virtual result poll(std::vector<Event> & out) = 0;
+};
+
+
+} /* namespace interface */
+} /* namespace pycontrol */
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <common/types.h>
 
 namespace pycontrol
@@ -9,13 +12,44 @@ namespace interface
 {
 
 
+// A received datagram and when the kernel received it, UTC in nanoseconds,
+// 0 when not known.
+struct Datagram
+{
+    std::string data {};
+    nanoseconds utc_ns {0};
+};
+
+
 class UdpSocket
 {
 public:
     virtual ~UdpSocket() = default;
 
     virtual result recv(std::string & msg) = 0;
+
+    // Every datagram queued, oldest first, without blocking.  The first count
+    // of out are set, out only grows so its strings are reused.  By default
+    // just the one recv() returns.
+    virtual result recv_all(std::vector<Datagram> & out, std::size_t & count)
+    {
+        if (out.empty())
+        {
+            out.resize(1);
+        }
+        out[0].utc_ns = 0;
+        const auto res = recv(out[0].data);
+        count = out[0].data.empty() ? 0 : 1;
+        return res;
+    }
+
     virtual result send(const std::string & msg) = 0;
+
+    // Sends msg as is, NULs and all, where send() stops at the first NUL.
+    virtual result send_binary(std::string_view msg) = 0;
+
+    // Sends msg as a frame of MTU sized chunks, see common/UdpFrame.h.
+    virtual result send_frame(std::string_view msg) = 0;
 };
 
 
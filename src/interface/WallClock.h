@@ -13,7 +13,19 @@ class WallClock
 public:
     virtual ~WallClock() = default;
 
+    // UTC milliseconds since the epoch, jumps when the system clock is stepped.
     virtual milliseconds now() = 0;
+
+    // Nanoseconds since an arbitrary start, never steps.
+    virtual nanoseconds monotonic_ns() = 0;
+
+    // UTC time minus monotonic time, sampled now.  Only changes when the
+    // system clock is slewed or stepped.
+    virtual nanoseconds utc_offset_ns() = 0;
+
+    // Sleeps until monotonic_ns() reaches deadline, returns at once if it
+    // already has.
+    virtual void sleep_until_ns(nanoseconds deadline) = 0;
 };
 
 
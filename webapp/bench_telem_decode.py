@@ -0,0 +1,32 @@
+"""
+Decode time per message of the telemetry written by
+src/camera_control/TelemetrySchema_bench_bin, as JSON and as binary:
+
+    python3 -m webapp.bench_telem_decode /tmp/telemetry.json /tmp/telemetry.bin
+"""
+import json
+import sys
+import timeit
+
+from webapp import telem_binary
+
+
+def report(name, data, decode, count=20000):
+    seconds = timeit.timeit(lambda: decode(data), number=count)
+    print(f"{name:<12} {len(data):6d} bytes {seconds / count * 1e6:8.1f} us/msg")
+
+
+def main(json_path, binary_path):
+    with open(json_path, "rb") as fin:
+        text = fin.read()
+    with open(binary_path, "rb") as fin:
+        binary = fin.read()
+
+    assert telem_binary.decode(binary) == json.loads(text)
+
+    report("json", text, json.loads)
+    report("binary", binary, telem_binary.decode)
+
+
+if __name__ == "__main__":
+    main(*sys.argv[1:3])
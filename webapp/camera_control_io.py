@@ -12,6 +12,8 @@ import socket
 import threading
 import time
 
+from webapp import telem_binary
+from webapp import telem_shm
 from webapp import udp_socket
 from webapp import utils
 
@@ -93,6 +95,19 @@ class CameraControlIo:
         self._serial_id_cam_id = dict()
         self._telem = dict(command_response=dict(last_accepted_id=0, last_rejected_id=0))
 
+        # With telem_keyframe_ms set, telemetry between keyframes is just what
+        # changed since the last one.
+        self._keyframe = None
+        self._resync_thread = None
+
+        # Telemetry comes in MTU sized chunks, put back together here.
+        self._frames = udp_socket.FrameAssembler()
+
+        # On the same host, the newest telemetry is read from shared memory
+        # instead, see telem_shm in config/camera_control.config.
+        self._shm = telem_shm.ShmReader(config["telem_shm"]) if config.get("telem_shm") else None
+        self._shm_frame = None
+
         self._retry_count = 15
         self._retry_sleep = 0.500
 
@@ -234,18 +249,44 @@ class CameraControlIo:
         cmd = f"timelapse_disable"
         return self._send_command(cmd)
 
+    def telem_keyframe(self):
+        """
+        Asks CameraControl to send the whole telemetry next.
+        """
+        return self._send_command("telem_keyframe")
+
+    def clock_sync(self):
+        """
+        Applies a system clock step CameraControl is holding, see clock.held_ms
+        in the telemetry.
+        """
+        return self._send_command("clock_sync")
+
     def start(self):
         assert self._read_thread is None, "Read thread already started!"
+        if self._shm is not None:
+            # No thread, read() takes the newest telemetry itself.
+            self._read_thread = True
+            return
         self._read_thread = threading.Thread(target=self._read_in_thread)
         self._read_thread.daemon = True
         self._read_thread.start()
 
     def read(self):
         assert self._read_thread, "Please call start() first!"
+        if self._shm is not None:
+            self._read_shm()
         with self._read_lock:
             telem = copy.deepcopy(self._telem)
         return telem
 
+    def telem_frames(self):
+        """
+        Counts of the telemetry frames received, dropped and incomplete.
+        """
+        with self._read_lock:
+            return self._frames.stats()
+
     def _read_in_thread(self):
 
         sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
@@ -268,13 +309,86 @@ class CameraControlIo:
                 data, addr = sock.recvfrom(buffer_size)
             except socket.timeout:
                 continue
-            try:
-                telem = json.loads(data.decode('utf-8'))
-            except:
-                print("failed to parse telem:\n" + repr(data.decode('utf-8')) + "\n")
-                with open('telem.json', 'w') as fout:
-                    fout.write(data.decode('utf-8') + "\n")
-                raise
+
+            lost = self._frames.dropped + self._frames.incomplete
+            with self._read_lock:
+                data = self._frames.add(data)
+            if self._frames.dropped + self._frames.incomplete != lost:
+                print(f"lost telemetry frames: {self._frames.stats()}")
+            if data is None:
+                continue
+
+            telem = self._decode(data)
+
+            if "delta" in telem:
+                telem = self._apply_delta(telem)
+                if telem is None:
+                    continue
+            else:
+                self._keyframe = telem
 
             with self._read_lock:
                 self._telem = telem
+
+    def _read_shm(self):
+        """
+        Takes the newest telemetry from shared memory, decoding it only when
+        it's a new frame.
+        """
+        snapshot = self._shm.read()
+        if snapshot is None:
+            return
+        frame, _, data = snapshot
+        if frame == self._shm_frame:
+            return
+        telem = self._decode(data)
+        with self._read_lock:
+            self._shm_frame = frame
+            self._telem = telem
+
+    @staticmethod
+    def _decode(data):
+        if telem_binary.is_binary(data):
+            return telem_binary.decode(data)
+        try:
+            return json.loads(data.decode('utf-8'))
+        except:
+            print("failed to parse telem:\n" + repr(data.decode('utf-8')) + "\n")
+            with open('telem.json', 'w') as fout:
+                fout.write(data.decode('utf-8') + "\n")
+            raise
+
+    def _apply_delta(self, message):
+        """
+        Returns the keyframe the delta message was taken against with the delta
+        applied, or None when we don't have that keyframe, asking for a new one.
+        """
+        if self._keyframe is None or self._keyframe.get("seq") != message["keyframe"]:
+            self._resync()
+            return None
+
+        telem = copy.deepcopy(self._keyframe)
+        for path, value in message["delta"].items():
+            *parents, last = [
+                part.replace("~1", "/").replace("~0", "~")
+                for part in path.split("/")[1:]
+            ]
+            node = telem
+            for part in parents:
+                node = node[int(part)] if isinstance(node, list) else node[part]
+            if isinstance(node, list):
+                node[int(last)] = value
+            else:
+                node[last] = value
+        return telem
+
+    def _resync(self):
+        """
+        Commands a keyframe from another thread, _send_command() waits on this
+        one's telemetry.
+        """
+        if self._resync_thread and self._resync_thread.is_alive():
+            return
+        self._resync_thread = threading.Thread(target=self.telem_keyframe)
+        self._resync_thread.daemon = True
+        self._resync_thread.start()
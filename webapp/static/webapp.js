@@ -664,6 +664,13 @@ function create_control_table_for_camera(camera_data) {
         header_row.appendChild(th);
     });
 
+    // What the camera model predicts it can't keep up with.
+    if (camera_data.warnings && camera_data.warnings.length > 0) {
+        const caption = table.createCaption();
+        caption.classList.add("sequence-warning");
+        caption.textContent = camera_data.warnings.join("; ");
+    }
+
     const data_body = table.createTBody();
 
     camera_data.events.forEach((event_obj) => {
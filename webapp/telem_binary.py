@@ -0,0 +1,232 @@
+"""
+Decodes CameraControl's binary telemetry, see src/common/BinaryWriter.h for the
+encoding and src/camera_control/TelemetrySchema.h for the keys.
+"""
+import json
+import struct
+
+MAGIC = b"PCTB"
+VERSION = 3
+
+# The same keys, in the same order, as TELEMETRY_KEYS in TelemetrySchema.h.
+KEYS = (
+    "seq",
+    "state",
+    "time",
+    "clock",
+    "utc_offset_ms",
+    "steps",
+    "last_step_ms",
+    "command_response",
+    "detected_cameras",
+    "connected",
+    "serial",
+    "port",
+    "desc",
+    "mode",
+    "shutter",
+    "fstop",
+    "iso",
+    "quality",
+    "batt",
+    "num_photos",
+    "usb_pending",
+    "num_avail",
+    "burst_number",
+    "fire_offset_us",
+    "trigger_lateness_us",
+    "count",
+    "min",
+    "p50",
+    "p99",
+    "max",
+    "poll_usb_us",
+    "full",
+    "total",
+    "trigger_latency",
+    "us",
+    "dev_us",
+    "samples",
+    "file_added_us",
+    "calibrating",
+    "late_policy",
+    "late_ms",
+    "compressing",
+    "fired",
+    "late",
+    "skipped",
+    "compressed",
+    "trigger_skew",
+    "groups",
+    "cameras",
+    "skew_us",
+    "max_skew_us",
+    "timeouts",
+    "camera_open",
+    "ms",
+    "ready_ms",
+    "events",
+    "sequence",
+    "sequence_state",
+    "num_events",
+    "id",
+    "warnings",
+    "pos",
+    "event_id",
+    "event_time_offset",
+    "eta",
+    "channel",
+    "value",
+    "timelapse",
+    "histogram",
+    "interval",
+    "min_shutter",
+    "max_shutter",
+    "min_iso",
+    "max_iso",
+    "min_hist_mask",
+    "max_hist_mask",
+    "min_deadband",
+    "max_deadband",
+    "current_bin",
+    "target_bin",
+    "target_offset",
+    "target_percent",
+    "target_error",
+    "num_captures",
+    "pixel_count",
+    "command_queue_us",
+    "last_accepted_id",
+    "last_rejected_id",
+    "message",
+    "loading",
+    "percent",
+    "data",
+)
+
+# Tag: struct format of the number that follows.
+_NUMBERS = {
+    0x10: struct.Struct("<B"),
+    0x11: struct.Struct("<H"),
+    0x12: struct.Struct("<I"),
+    0x13: struct.Struct("<Q"),
+    0x14: struct.Struct("<b"),
+    0x15: struct.Struct("<h"),
+    0x16: struct.Struct("<i"),
+    0x17: struct.Struct("<q"),
+    0x19: struct.Struct("<d"),
+}
+_FLOAT = struct.Struct("<f")
+_LENGTH = struct.Struct("<H")
+_HEADER = struct.Struct("<4sHH")
+
+_CONSTANTS = {0x00: None, 0x01: False, 0x02: True}
+
+_STRING = 0x20
+_JSON = 0x21
+_ARRAY = 0x30
+_OBJECT = 0x31
+_END = 0x32
+_KEY_INDEX = 0x40
+_KEY_STRING = 0x41
+
+_DONE = object()
+
+
+def is_binary(data):
+    return data[:len(MAGIC)] == MAGIC
+
+
+def _shortest(number):
+    """
+    A float32 as JSON writes it, 0.05 rather than 0.05000000074505806.
+    """
+    packed = _FLOAT.pack(number)
+    for digits in range(6, 10):
+        candidate = float(f"{number:.{digits}g}")
+        if _FLOAT.pack(candidate) == packed:
+            return candidate
+    return number
+
+
+def _value(data, pos):
+    """
+    Returns the value at pos and the position after it, _DONE at an end tag.
+    """
+    tag = data[pos]
+    pos += 1
+
+    number = _NUMBERS.get(tag)
+    if number:
+        return number.unpack_from(data, pos)[0], pos + number.size
+
+    if tag in _CONSTANTS:
+        return _CONSTANTS[tag], pos
+
+    if tag == 0x18:
+        return _shortest(_FLOAT.unpack_from(data, pos)[0]), pos + _FLOAT.size
+
+    if tag == _STRING or tag == _JSON:
+        (length,) = _LENGTH.unpack_from(data, pos)
+        pos += _LENGTH.size
+        text = data[pos:pos + length].decode("utf-8")
+        return (text if tag == _STRING else json.loads(text)), pos + length
+
+    if tag == _ARRAY:
+        # Numbers inline, lists like the timelapse histogram are mostly them.
+        out = []
+        while True:
+            number = _NUMBERS.get(data[pos])
+            if number:
+                out.append(number.unpack_from(data, pos + 1)[0])
+                pos += 1 + number.size
+                continue
+            item, pos = _value(data, pos)
+            if item is _DONE:
+                return out, pos
+            out.append(item)
+
+    if tag == _OBJECT:
+        out = {}
+        while True:
+            tag = data[pos]
+            if tag == _END:
+                return out, pos + 1
+            if tag == _KEY_INDEX:
+                key = KEYS[data[pos + 1]]
+                pos += 2
+            elif tag == _KEY_STRING:
+                length = data[pos + 1]
+                key = data[pos + 2:pos + 2 + length].decode("utf-8")
+                pos += 2 + length
+            else:
+                raise ValueError(f"expected a key at {pos}, got tag {tag:#x}")
+            if data[pos] == _STRING:
+                # Strings inline, most values are.
+                (length,) = _LENGTH.unpack_from(data, pos + 1)
+                pos += 1 + _LENGTH.size
+                out[key] = data[pos:pos + length].decode("utf-8")
+                pos += length
+                continue
+            out[key], pos = _value(data, pos)
+
+    if tag == _END:
+        return _DONE, pos
+
+    raise ValueError(f"unknown tag {tag:#x} at {pos - 1}")
+
+
+def decode(data):
+    """
+    Returns binary telemetry as the dict the JSON telemetry parses to.
+    """
+    magic, version, _ = _HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("not binary telemetry")
+    if version != VERSION:
+        raise ValueError(f"binary telemetry version {version}, expected {VERSION}")
+
+    out, pos = _value(data, _HEADER.size)
+    if pos != len(data):
+        raise ValueError(f"{len(data) - pos} bytes left over in binary telemetry")
+    return out
@@ -0,0 +1,79 @@
+"""
+Reads the latest telemetry CameraControl publishes to /dev/shm, see
+src/common/ShmTelemetry.h for the layout.
+"""
+import mmap
+import os
+import struct
+import time
+
+MAGIC = b"PCTS"
+VERSION = 1
+
+_HEADER = struct.Struct("=4sIQ")
+_SEQ = struct.Struct("=Q")
+_SNAPSHOT_HEADER = struct.Struct("=QQQq")
+_SEQ_OFFSET = 64
+_SNAPSHOT_OFFSET = 128
+
+# Give up after this many snapshots written over while copying.
+_MAX_READ_ATTEMPTS = 100
+
+
+class ShmReader:
+    """
+    The newest snapshot, with no socket, no loss and no backlog.  Only on the
+    same host as camera_control_bin.
+    """
+    def __init__(self, name, root="/dev/shm"):
+        self._path = os.path.join(root, name)
+        self._mmap = None
+        self._capacity = 0
+
+    def _open(self):
+        try:
+            with open(self._path, "rb") as fin:
+                mapped = mmap.mmap(fin.fileno(), 0, access=mmap.ACCESS_READ)
+        except (FileNotFoundError, ValueError):
+            return False
+
+        magic, version, capacity = _HEADER.unpack_from(mapped, 0)
+        if magic != MAGIC or version != VERSION or _SNAPSHOT_OFFSET + capacity > len(mapped):
+            mapped.close()
+            return False
+
+        self._mmap = mapped
+        self._capacity = capacity
+        return True
+
+    def read(self):
+        """
+        Returns (frame, age_ns, snapshot bytes), None when there's no
+        publisher yet or it kept writing over the snapshot.  age_ns is how
+        long ago it was published.
+        """
+        if self._mmap is None and not self._open():
+            return None
+
+        data = self._mmap
+        for _ in range(_MAX_READ_ATTEMPTS):
+            (seq,) = _SEQ.unpack_from(data, _SEQ_OFFSET)
+            if seq == 0:
+                return None
+            if seq & 1:
+                time.sleep(0)
+                continue
+
+            _, frame, size, time_ns = _SNAPSHOT_HEADER.unpack_from(data, _SEQ_OFFSET)
+            size = min(size, self._capacity)
+            snapshot = data[_SNAPSHOT_OFFSET:_SNAPSHOT_OFFSET + size]
+
+            if _SEQ.unpack_from(data, _SEQ_OFFSET) == (seq,):
+                return frame, time.monotonic_ns() - time_ns, snapshot
+
+        return None
+
+    def close(self):
+        if self._mmap is not None:
+            self._mmap.close()
+            self._mmap = None
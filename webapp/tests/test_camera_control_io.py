@@ -1,11 +1,14 @@
 import json
 import socket
+import struct
 import threading
 import time
 from unittest.mock import MagicMock, patch, mock_open
 
 import pytest
+from webapp import telem_shm
 from webapp.camera_control_io import CameraControlIo
+from webapp.tests.test_telem_shm import publish
 
 
 @pytest.fixture
@@ -313,3 +316,125 @@ def test_read_in_thread_parse_error(camera_control_io):
                 with pytest.raises(Exception): # The internal raise
                     camera_control_io._read_in_thread()
                 mock_file.assert_called_with('telem.json', 'w')
+
+
+def test_read_in_thread_delta(camera_control_io):
+    keyframe = {
+        "seq": 7,
+        "state": "monitor",
+        "detected_cameras": [{"serial": "1111", "iso": "64"}],
+        "timelapse": {"histogram": [1, 2]},
+    }
+    mock_sock = MagicMock()
+    mock_sock.recvfrom.side_effect = [
+        (json.dumps(keyframe).encode(), ("127.0.0.1", 1234)),
+        (b'{"keyframe":7,"delta":{"/seq":8,"/detected_cameras/0/iso":"100","/timelapse/histogram":[3,4]}}', ("127.0.0.1", 1234)),
+        Exception("exit loop")
+    ]
+
+    with patch("socket.socket", return_value=mock_sock):
+        with patch("socket.inet_aton"):
+            with pytest.raises(Exception, match="exit loop"):
+                camera_control_io._read_in_thread()
+
+    assert camera_control_io._telem == {
+        "seq": 8,
+        "state": "monitor",
+        "detected_cameras": [{"serial": "1111", "iso": "100"}],
+        "timelapse": {"histogram": [3, 4]},
+    }
+
+    # The keyframe is kept as is for the next delta.
+    assert camera_control_io._keyframe == keyframe
+
+
+def test_read_in_thread_delta_resync(camera_control_io):
+    mock_sock = MagicMock()
+    mock_sock.recvfrom.side_effect = [
+        (b'{"keyframe":7,"delta":{"/seq":8}}', ("127.0.0.1", 1234)),
+        Exception("exit loop")
+    ]
+
+    with patch("socket.socket", return_value=mock_sock):
+        with patch("socket.inet_aton"):
+            with patch("threading.Thread") as mock_thread:
+                with pytest.raises(Exception, match="exit loop"):
+                    camera_control_io._read_in_thread()
+
+                # Asks for a keyframe, keeping the telemetry it had.
+                mock_thread.assert_called_once_with(target=camera_control_io.telem_keyframe)
+                mock_thread.return_value.start.assert_called_once()
+
+    assert camera_control_io._telem == {"command_response": {"last_accepted_id": 0, "last_rejected_id": 0}}
+
+
+def test_telem_keyframe(camera_control_io):
+    with patch.object(camera_control_io, "_send_command") as mock_send:
+        camera_control_io.telem_keyframe()
+        mock_send.assert_called_once_with("telem_keyframe")
+
+
+def test_clock_sync(camera_control_io):
+    with patch.object(camera_control_io, "_send_command") as mock_send:
+        camera_control_io.clock_sync()
+        mock_send.assert_called_once_with("clock_sync")
+
+
+def test_read_in_thread_binary(camera_control_io):
+    # {"seq": 3, "state": "monitor"} as binary telemetry.
+    data = (
+        b"PCTB\x03\x00\x00\x00"
+        b"\x31" b"\x40\x00\x10\x03" b"\x40\x01\x20\x07\x00monitor" b"\x32"
+    )
+    mock_sock = MagicMock()
+    mock_sock.recvfrom.side_effect = [
+        (data, ("127.0.0.1", 1234)),
+        Exception("exit loop")
+    ]
+
+    with patch("socket.socket", return_value=mock_sock):
+        with patch("socket.inet_aton"):
+            with pytest.raises(Exception, match="exit loop"):
+                camera_control_io._read_in_thread()
+
+    assert camera_control_io._telem == {"seq": 3, "state": "monitor"}
+
+
+def test_read_in_thread_framed(camera_control_io):
+    telem = json.dumps({"seq": 3, "histogram": list(range(1000))}).encode()
+    header = struct.Struct("<4sIHHI")
+    first = header.pack(b"PCTF", 9, 0, 2, len(telem)) + telem[:1456]
+    second = header.pack(b"PCTF", 9, 1, 2, len(telem)) + telem[1456:]
+
+    mock_sock = MagicMock()
+    mock_sock.recvfrom.side_effect = [
+        (first, ("127.0.0.1", 1234)),
+        (second, ("127.0.0.1", 1234)),
+        (header.pack(b"PCTF", 11, 0, 2, 2000) + bytes(1456), ("127.0.0.1", 1234)),
+        Exception("exit loop")
+    ]
+
+    with patch("socket.socket", return_value=mock_sock):
+        with patch("socket.inet_aton"):
+            with pytest.raises(Exception, match="exit loop"):
+                camera_control_io._read_in_thread()
+
+    assert camera_control_io._telem == json.loads(telem)
+    assert camera_control_io.telem_frames() == {"frames": 1, "dropped": 1, "incomplete": 0}
+
+
+def test_read_shm(camera_control_io, tmp_path):
+    camera_control_io._shm = telem_shm.ShmReader("telem", root=tmp_path)
+    camera_control_io.start()
+    assert camera_control_io._read_thread is True
+
+    # Nothing published yet.
+    assert camera_control_io.read() == {"command_response": {"last_accepted_id": 0, "last_rejected_id": 0}}
+
+    publish(tmp_path / "telem", 5, b'{"seq":5,"state":"monitor"}')
+    assert camera_control_io.read() == {"seq": 5, "state": "monitor"}
+
+    # Only decoded again for a new frame.
+    with patch.object(camera_control_io, "_decode") as mock_decode:
+        assert camera_control_io.read() == {"seq": 5, "state": "monitor"}
+        mock_decode.assert_not_called()
@@ -0,0 +1,86 @@
+import os
+import re
+import struct
+
+import pytest
+from webapp import telem_binary
+
+
+SCHEMA_H = os.path.join(
+    os.path.dirname(__file__), "..", "..", "src", "camera_control", "TelemetrySchema.h"
+)
+
+
+def frame(*body, version=telem_binary.VERSION):
+    return b"PCTB" + struct.pack("<HH", version, 0) + bytes(body)
+
+
+def key(name):
+    return (0x40, telem_binary.KEYS.index(name))
+
+
+def test_schema_matches_cpp():
+    with open(SCHEMA_H) as fin:
+        text = fin.read()
+
+    version = re.search(r"TELEMETRY_VERSION = (\d+);", text)
+    assert int(version.group(1)) == telem_binary.VERSION
+
+    keys = re.search(r"TELEMETRY_KEYS\[\] = \{(.*?)\};", text, re.S)
+    assert tuple(re.findall(r'"(\w+)"', keys.group(1))) == telem_binary.KEYS
+
+
+def test_decode():
+    data = frame(
+        0x31,
+            *key("state"), 0x20, 4, 0, *b"idle",
+            *key("time"), 0x13, *struct.pack("<Q", 1750627393194),
+            *key("command_response"), 0x21, 22, 0, *b'{"last_accepted_id":3}',
+            *key("histogram"), 0x30, 0x10, 200, 0x11, 0x34, 0x12, 0x12, *struct.pack("<I", 70000), 0x32,
+            *key("min_hist_mask"), 0x14, 0xff,
+            *key("utc_offset_ms"), 0x17, *struct.pack("<q", -1750627393194),
+            *key("target_percent"), 0x18, *struct.pack("<f", 0.05),
+            *key("interval"), 0x19, *struct.pack("<d", 2.5),
+            *key("connected"), 0x02,
+            *key("compressing"), 0x01,
+            *key("min_shutter"), 0x00,
+            *key("events"), 0x31, 0x41, 2, *b"e1", 0x16, *struct.pack("<i", -1000), 0x32,
+            *key("warnings"), 0x30, 0x32,
+        0x32,
+    )
+
+    assert telem_binary.is_binary(data)
+    assert telem_binary.decode(data) == {
+        "state": "idle",
+        "time": 1750627393194,
+        "command_response": {"last_accepted_id": 3},
+        "histogram": [200, 0x1234, 70000],
+        "min_hist_mask": -1,
+        "utc_offset_ms": -1750627393194,
+        "target_percent": 0.05,
+        "interval": 2.5,
+        "connected": True,
+        "compressing": False,
+        "min_shutter": None,
+        "events": {"e1": -1000},
+        "warnings": [],
+    }
+
+
+def test_decode_errors():
+    assert not telem_binary.is_binary(b'{"state":"idle"}')
+
+    with pytest.raises(ValueError, match="not binary telemetry"):
+        telem_binary.decode(b"JSON" + bytes(8))
+
+    with pytest.raises(ValueError, match=f"version {telem_binary.VERSION + 1}"):
+        telem_binary.decode(frame(0x00, version=telem_binary.VERSION + 1))
+
+    with pytest.raises(ValueError, match="left over"):
+        telem_binary.decode(frame(0x00, 0x00))
+
+    with pytest.raises(ValueError, match="unknown tag"):
+        telem_binary.decode(frame(0x7f))
+
+    with pytest.raises(ValueError, match="expected a key"):
+        telem_binary.decode(frame(0x31, 0x00, 0x32))
@@ -0,0 +1,68 @@
+import os
+import re
+import struct
+import time
+
+from webapp import telem_shm
+
+
+SHM_H = os.path.join(
+    os.path.dirname(__file__), "..", "..", "src", "common", "ShmTelemetry.h"
+)
+
+
+def publish(path, frame, snapshot, seq=None, capacity=256):
+    """
+    Writes the layout ShmPublisher does.
+    """
+    seq = 2 * frame if seq is None else seq
+    data = bytearray(128 + capacity)
+    struct.pack_into("=4sIQ", data, 0, b"PCTS", telem_shm.VERSION, capacity)
+    struct.pack_into("=QQQq", data, 64, seq, frame, len(snapshot), time.monotonic_ns())
+    data[128:128 + len(snapshot)] = snapshot
+    with open(path, "wb") as fout:
+        fout.write(data)
+
+
+def test_layout_matches_cpp():
+    with open(SHM_H) as fin:
+        text = fin.read()
+
+    assert re.search(r'SHM_MAGIC = "(\w+)";', text).group(1).encode() == telem_shm.MAGIC
+    assert int(re.search(r"SHM_VERSION = (\d+);", text).group(1)) == telem_shm.VERSION
+
+    offsets = dict(
+        (name, int(offset))
+        for offset, name in re.findall(r"//\s+offset\s+(\d+)\s+\S+ (\w+)", text)
+    )
+    assert offsets == {"version": 4, "capacity": 8, "seq": 64, "frame": 72, "size": 80, "time_ns": 88, "snapshot": 128}
+
+
+def test_read(tmp_path):
+    reader = telem_shm.ShmReader("telem", root=tmp_path)
+
+    # No publisher yet.
+    assert reader.read() is None
+
+    publish(tmp_path / "telem", 0, b"", seq=0)
+    assert reader.read() is None
+
+    publish(tmp_path / "telem", 3, b'{"seq":3}')
+    reader.close()
+    frame, age_ns, snapshot = reader.read()
+    assert frame == 3
+    assert snapshot == b'{"seq":3}'
+    assert 0 <= age_ns < 10e9
+
+
+def test_read_torn(tmp_path):
+    # Written over throughout, the publisher never finishes.
+    publish(tmp_path / "telem", 3, b'{"seq":3}', seq=7)
+    reader = telem_shm.ShmReader("telem", root=tmp_path)
+    assert reader.read() is None
+
+
+def test_read_not_telemetry(tmp_path):
+    with open(tmp_path / "telem", "wb") as fout:
+        fout.write(b"JSON" + bytes(200))
+    assert telem_shm.ShmReader("telem", root=tmp_path).read() is None
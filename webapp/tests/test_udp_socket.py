@@ -0,0 +1,73 @@
+import struct
+
+from webapp import udp_socket
+
+
+def chunks(frame_id, data, size=1456):
+    parts = [data[i:i + size] for i in range(0, len(data), size)] or [b""]
+    return [
+        struct.pack("<4sIHHI", b"PCTF", frame_id, index, len(parts), len(data)) + part
+        for index, part in enumerate(parts)
+    ]
+
+
+def test_frame_assembler():
+    assembler = udp_socket.FrameAssembler()
+    data = bytes(range(256)) * 20
+
+    one, two, three, four = chunks(1, data)
+    assert assembler.add(one) is None
+    assert assembler.add(three) is None
+    assert assembler.add(two) is None
+    assert assembler.add(four) == data
+
+    # Unframed datagrams pass through.
+    assert assembler.add(b'{"state":"idle"}') == b'{"state":"idle"}'
+
+    (small,) = chunks(2, b'{"seq":2}')
+    assert assembler.add(small) == b'{"seq":2}'
+
+    # A late repeat is ignored.
+    assert assembler.add(small) is None
+    assert assembler.add(one) is None
+
+    assert assembler.stats() == {"frames": 2, "dropped": 0, "incomplete": 0}
+
+
+def test_frame_assembler_lost():
+    assembler = udp_socket.FrameAssembler()
+    data = b"x" * 3000
+
+    assert assembler.add(chunks(1, data)[0]) is None
+
+    # Frame 1 is given up on, 2 and 3 never came.
+    (small,) = chunks(4, b"{}")
+    assert assembler.add(small) == b"{}"
+    assert assembler.stats() == {"frames": 1, "dropped": 2, "incomplete": 1}
+
+    # Frame ids wrap.
+    assembler = udp_socket.FrameAssembler()
+    (last,) = chunks(2**32 - 1, b"{}")
+    (first,) = chunks(0, b"[]")
+    assert assembler.add(last) == b"{}"
+    assert assembler.add(first) == b"[]"
+    assert assembler.add(last) is None
+    assert assembler.stats() == {"frames": 2, "dropped": 0, "incomplete": 0}
+
+
+def test_frame_assembler_errors():
+    assembler = udp_socket.FrameAssembler()
+    data = b"x" * 3000
+    one, two, three = chunks(1, data)
+
+    assert assembler.add(one) is None
+
+    # Bad chunks are dropped without upsetting the frame being assembled.
+    assert assembler.add(b"PCTF\x01") is None
+    assert assembler.add(struct.pack("<4sIHHI", b"PCTF", 1, 2, 2, 10)) is None
+    assert assembler.add(struct.pack("<4sIHHI", b"PCTF", 1, 0, 0, 10)) is None
+    assert assembler.add(chunks(1, b"y" * 100)[0]) is None
+
+    assert assembler.add(two) is None
+    assert assembler.add(three) == data
+    assert assembler.stats() == {"frames": 1, "dropped": 4, "incomplete": 0}
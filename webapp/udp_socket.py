@@ -1,4 +1,5 @@
 import socket
+import struct
 
 def send_message(message, target_ip, target_port):
     """
@@ -38,3 +39,91 @@ def send_message(message, target_ip, target_port):
     finally:
         # Close the socket
         sock.close()
+
+
+FRAME_MAGIC = b"PCTF"
+_FRAME_HEADER = struct.Struct("<4sIHHI")
+
+
+class FrameAssembler:
+    """
+    Puts CameraControl's telemetry frames back together from their chunks, see
+    src/common/UdpFrame.h, counting the frames that didn't make it.
+
+    frames:     complete frames.
+    dropped:    frames none of whose chunks arrived, and chunks too mangled
+                to place, e.g. cut short or from another sender.
+    incomplete: frames missing chunks, given up on once a later frame starts.
+    """
+    def __init__(self):
+        self.frames = 0
+        self.dropped = 0
+        self.incomplete = 0
+        self._last_id = None
+        self._chunks = None
+        self._missing = 0
+        self._size = 0
+
+    def add(self, datagram):
+        """
+        Returns the frame datagram completes, None until then.  A datagram
+        that isn't a chunk is a whole frame as is.  A bad chunk is counted as
+        dropped, the read thread carries on.
+        """
+        if datagram[:len(FRAME_MAGIC)] != FRAME_MAGIC:
+            return datagram
+
+        if len(datagram) < _FRAME_HEADER.size:
+            self.dropped += 1
+            return None
+
+        _, frame_id, index, count, size = _FRAME_HEADER.unpack_from(datagram)
+        if index >= count:
+            self.dropped += 1
+            return None
+
+        if frame_id != self._last_id:
+            # Frame ids wrap at 2^32, ones from before the last are late.
+            gap = (frame_id - self._last_id) % 2**32 if self._last_id is not None else 1
+            if gap >= 2**31:
+                return None
+            if self._chunks is not None:
+                self.incomplete += 1
+            self.dropped += gap - 1
+            self._last_id = frame_id
+            self._chunks = [None] * count
+            self._missing = count
+            self._size = size
+
+        elif self._chunks is None:
+            # A chunk repeated after its frame was done with.
+            return None
+
+        # The same frame id with another shape isn't this sender's.
+        if count != len(self._chunks) or size != self._size:
+            self.dropped += 1
+            return None
+
+        if self._chunks[index] is not None:
+            return None
+
+        self._chunks[index] = datagram[_FRAME_HEADER.size:]
+        self._missing -= 1
+        if self._missing:
+            return None
+
+        frame = b"".join(self._chunks)
+        self._chunks = None
+        if len(frame) != self._size:
+            self.incomplete += 1
+            return None
+
+        self.frames += 1
+        return frame
+
+    def stats(self):
+        return {
+            "frames": self.frames,
+            "dropped": self.dropped,
+            "incomplete": self.incomplete,
+        }